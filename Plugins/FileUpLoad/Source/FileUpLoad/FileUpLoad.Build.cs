@@ -38,7 +38,11 @@ public class FileUpLoad : ModuleRules
 				"Projects",
 				"EditorFramework",
 				"ToolMenus",
-				"EditorSubsystem"
+				"EditorSubsystem",
+				"DirectoryWatcher",
+				"Sockets",
+				"AssetRegistry",
+				"SourceControl"
 			}
 		);
 
@@ -1,7 +1,7 @@
 #include "FileManager.h"
+#include "FtpBufferPool.h"
 #include "HAL/PlatformFilemanager.h"
 #include "Misc/Paths.h"
-#include "Misc/FileHelper.h"
 
 UFileManager::UFileManager()
 {
@@ -116,13 +116,39 @@ bool UFileManager::CopyFile(const FString& SourcePath, const FString& DestPath)
         return false;
     }
 
-    FString FileContent;
-    if (FFileHelper::LoadFileToString(FileContent, *SourcePath))
+    // 파일 전체를 메모리에 올리지 않고 풀 버퍼 하나로 청크 복사한다 (바이너리도 그대로 보존)
+    PlatformFile->CreateDirectoryTree(*FPaths::GetPath(DestPath));
+    TUniquePtr<IFileHandle> Source(PlatformFile->OpenRead(*SourcePath));
+    TUniquePtr<IFileHandle> Dest(Source ? PlatformFile->OpenWrite(*DestPath) : nullptr);
+    if (!Source || !Dest)
     {
-        return FFileHelper::SaveStringToFile(FileContent, *DestPath);
+        UE_LOG(LogTemp, Warning, TEXT("파일 복사 실패: %s -> %s"), *SourcePath, *DestPath);
+        return false;
     }
-    
-    return false;
+
+    FFtpPooledBuffer Buffer = FFtpBufferPool::Acquire(FFtpBufferPool::MaxSlabSize);
+    int64 Remaining = Source->Size();
+    bool bSuccess = true;
+    while (Remaining > 0)
+    {
+        const int64 ChunkSize = FMath::Min<int64>(Remaining, Buffer.GetSize());
+        if (!Source->Read(Buffer.GetData(), ChunkSize) || !Dest->Write(Buffer.GetData(), ChunkSize))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("파일 복사 중 입출력 오류: %s -> %s"), *SourcePath, *DestPath);
+            bSuccess = false;
+            break;
+        }
+        Remaining -= ChunkSize;
+    }
+
+    Source.Reset();
+    Dest.Reset();
+
+    if (!bSuccess)
+    {
+        PlatformFile->DeleteFile(*DestPath);
+    }
+    return bSuccess;
 }
 
 bool UFileManager::MoveFile(const FString& SourcePath, const FString& DestPath)
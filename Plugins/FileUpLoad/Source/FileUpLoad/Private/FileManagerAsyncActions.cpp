@@ -0,0 +1,287 @@
+#include "FileManagerAsyncActions.h"
+#include "FtpBufferPool.h"
+#include "Async/Async.h"
+#include "HAL/PlatformFilemanager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Paths.h"
+
+namespace FileManagerAsync
+{
+    // 복사 청크 크기와 진행 알림 간격
+    constexpr int64 CopyChunkSize = 1024 * 1024;
+    constexpr double ProgressInterval = 0.1;
+
+    // PlatformFile::FindFiles와 같은 규칙 - "*"와 "*.*"는 모든 파일
+    static bool MatchesAnyPattern(const TCHAR* Path, const TArray<FString>& Patterns)
+    {
+        if (Patterns.Num() == 0)
+        {
+            return true;
+        }
+
+        const FString FileName = FPaths::GetCleanFilename(Path);
+        for (const FString& Pattern : Patterns)
+        {
+            if (Pattern.IsEmpty() || Pattern == TEXT("*") || Pattern == TEXT("*.*") || FileName.MatchesWildcard(Pattern))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+UFileManagerAsyncActionBase::UFileManagerAsyncActionBase()
+    : CancelFlag(MakeShared<TAtomic<bool>, ESPMode::ThreadSafe>(false))
+{
+}
+
+void UFileManagerAsyncActionBase::Cancel()
+{
+    *CancelFlag = true;
+}
+
+bool UFileManagerAsyncActionBase::IsCancelRequested() const
+{
+    return *CancelFlag;
+}
+
+void UFileManagerAsyncActionBase::Activate()
+{
+    // 에디터 유틸리티 위젯에는 게임 인스턴스가 없으므로 끝날 때까지 루트에 묶어 둔다
+    AddToRoot();
+
+    Async(EAsyncExecution::Thread, [this]()
+    {
+        RunInBackground();
+    });
+}
+
+void UFileManagerAsyncActionBase::RunOnGameThread(TFunction<void()>&& Callback)
+{
+    TWeakObjectPtr<UFileManagerAsyncActionBase> WeakThis(this);
+    AsyncTask(ENamedThreads::GameThread, [WeakThis, Callback = MoveTemp(Callback)]()
+    {
+        if (WeakThis.IsValid())
+        {
+            Callback();
+        }
+    });
+}
+
+void UFileManagerAsyncActionBase::Finish()
+{
+    check(IsInGameThread());
+    RemoveFromRoot();
+    SetReadyToDestroy();
+}
+
+UFileManagerListAsyncAction* UFileManagerListAsyncAction::FindFilesRecursivelyAsync(const FString& DirectoryPath, const TArray<FString>& FilePatterns, int32 BatchSize)
+{
+    UFileManagerListAsyncAction* Action = NewObject<UFileManagerListAsyncAction>();
+    Action->DirectoryPath = DirectoryPath;
+    Action->FilePatterns = FilePatterns;
+    Action->BatchSize = FMath::Max(BatchSize, 1);
+    return Action;
+}
+
+UFileManagerListAsyncAction* UFileManagerListAsyncAction::GetSubDirectoriesAsync(const FString& DirectoryPath, int32 BatchSize)
+{
+    UFileManagerListAsyncAction* Action = NewObject<UFileManagerListAsyncAction>();
+    Action->DirectoryPath = DirectoryPath;
+    Action->BatchSize = FMath::Max(BatchSize, 1);
+    Action->bDirectoriesOnly = true;
+    return Action;
+}
+
+void UFileManagerListAsyncAction::RunInBackground()
+{
+    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+
+    TArray<FString> Batch;
+    if (!PlatformFile.DirectoryExists(*DirectoryPath))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("디렉토리가 존재하지 않습니다: %s"), *DirectoryPath);
+    }
+    else
+    {
+        auto Visitor = [this, &Batch](const TCHAR* FilenameOrDirectory, bool bIsDirectory)
+        {
+            if (*CancelFlag)
+            {
+                return false;
+            }
+
+            if (bDirectoriesOnly ? bIsDirectory : (!bIsDirectory && FileManagerAsync::MatchesAnyPattern(FilenameOrDirectory, FilePatterns)))
+            {
+                Batch.Add(FilenameOrDirectory);
+                if (Batch.Num() >= BatchSize)
+                {
+                    FlushBatch(Batch);
+                }
+            }
+            return true;
+        };
+
+        // 여러 패턴을 한 번의 순회로 검사하므로 패턴마다 트리를 다시 돌거나 중복이 생기지 않는다
+        if (bDirectoriesOnly)
+        {
+            PlatformFile.IterateDirectory(*DirectoryPath, Visitor);
+        }
+        else
+        {
+            PlatformFile.IterateDirectoryRecursively(*DirectoryPath, Visitor);
+        }
+    }
+
+    FlushBatch(Batch);
+
+    const bool bCancelled = *CancelFlag;
+    RunOnGameThread([this, bCancelled]()
+    {
+        if (bCancelled)
+        {
+            OnCancelled.Broadcast(Found);
+        }
+        else
+        {
+            OnCompleted.Broadcast(Found);
+        }
+        Finish();
+    });
+}
+
+void UFileManagerListAsyncAction::FlushBatch(TArray<FString>& Batch)
+{
+    if (Batch.Num() == 0)
+    {
+        return;
+    }
+
+    RunOnGameThread([this, Paths = MoveTemp(Batch)]()
+    {
+        Found.Append(Paths);
+        OnBatch.Broadcast(Paths);
+    });
+    Batch.Reset();
+}
+
+UFileManagerTransferAsyncAction* UFileManagerTransferAsyncAction::CopyFileAsync(const FString& SourcePath, const FString& DestPath)
+{
+    UFileManagerTransferAsyncAction* Action = NewObject<UFileManagerTransferAsyncAction>();
+    Action->SourcePath = SourcePath;
+    Action->DestPath = DestPath;
+    return Action;
+}
+
+UFileManagerTransferAsyncAction* UFileManagerTransferAsyncAction::MoveFileAsync(const FString& SourcePath, const FString& DestPath)
+{
+    UFileManagerTransferAsyncAction* Action = CopyFileAsync(SourcePath, DestPath);
+    Action->bMove = true;
+    return Action;
+}
+
+void UFileManagerTransferAsyncAction::RunInBackground()
+{
+    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+
+    bool bSuccess = false;
+    if (!PlatformFile.FileExists(*SourcePath))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("소스 파일이 존재하지 않습니다: %s"), *SourcePath);
+    }
+    else
+    {
+        PlatformFile.CreateDirectoryTree(*FPaths::GetPath(DestPath));
+
+        // 같은 볼륨이면 이름만 바꾸면 된다 - 실패하면(다른 볼륨 등) 복사 후 원본 삭제
+        if (bMove && PlatformFile.MoveFile(*DestPath, *SourcePath))
+        {
+            const int64 Size = PlatformFile.FileSize(*DestPath);
+            RunOnGameThread([this, Size]()
+            {
+                OnProgress.Broadcast(Size, Size);
+            });
+            bSuccess = true;
+        }
+        else
+        {
+            bSuccess = CopyChunked();
+            if (bSuccess && bMove)
+            {
+                bSuccess = PlatformFile.DeleteFile(*SourcePath);
+            }
+        }
+    }
+
+    const bool bCancelled = *CancelFlag;
+    RunOnGameThread([this, bSuccess, bCancelled]()
+    {
+        if (bCancelled && !bSuccess)
+        {
+            OnCancelled.Broadcast(false);
+        }
+        else
+        {
+            OnCompleted.Broadcast(bSuccess);
+        }
+        Finish();
+    });
+}
+
+bool UFileManagerTransferAsyncAction::CopyChunked()
+{
+    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+
+    TUniquePtr<IFileHandle> Source(PlatformFile.OpenRead(*SourcePath));
+    TUniquePtr<IFileHandle> Dest(Source ? PlatformFile.OpenWrite(*DestPath) : nullptr);
+    if (!Source || !Dest)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("파일 복사 실패: %s -> %s"), *SourcePath, *DestPath);
+        return false;
+    }
+
+    const int64 Total = Source->Size();
+    int64 Done = 0;
+    double LastProgressTime = 0.0;
+
+    FFtpPooledBuffer Buffer = FFtpBufferPool::Acquire((int32)FileManagerAsync::CopyChunkSize);
+
+    bool bSuccess = true;
+    while (Done < Total)
+    {
+        if (*CancelFlag)
+        {
+            bSuccess = false;
+            break;
+        }
+
+        const int64 ChunkSize = FMath::Min(Total - Done, FileManagerAsync::CopyChunkSize);
+        if (!Source->Read(Buffer.GetData(), ChunkSize) || !Dest->Write(Buffer.GetData(), ChunkSize))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("파일 복사 중 입출력 오류: %s -> %s"), *SourcePath, *DestPath);
+            bSuccess = false;
+            break;
+        }
+        Done += ChunkSize;
+
+        const double Now = FPlatformTime::Seconds();
+        if (Now - LastProgressTime >= FileManagerAsync::ProgressInterval || Done == Total)
+        {
+            LastProgressTime = Now;
+            RunOnGameThread([this, Done, Total]()
+            {
+                OnProgress.Broadcast(Done, Total);
+            });
+        }
+    }
+
+    Source.Reset();
+    Dest.Reset();
+
+    if (!bSuccess)
+    {
+        PlatformFile.DeleteFile(*DestPath);
+    }
+    return bSuccess;
+}
@@ -17,8 +17,28 @@
 #include "HAL/PlatformProcess.h"
 #include "Misc/FileHelper.h"
 #include "HAL/PlatformFilemanager.h"
+#include "HAL/FileManager.h"
 #include "Containers/Set.h"
 #include "Misc/DateTime.h"
+#include "Async/Async.h"
+#include "FileUpLoadStats.h"
+#include "FtpSystem.h"
+#include "FtpTransferHistory.h"
+#include "FtpDirectoryWatcher.h"
+#include "FtpFanOutUpload.h"
+#include "SFtpFileListView.h"
+#include "FtpFileListModel.h"
+#include "FtpTransferPlan.h"
+#include "FtpUploadOrder.h"
+#include "FtpChangeDiscovery.h"
+#include "FtpCookStreamer.h"
+#include "FtpDerivedDataStore.h"
+#include "FtpBufferPool.h"
+#include "Engine/Engine.h"
+#include "Misc/CommandLine.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/Parse.h"
+#include "Widgets/Layout/SBox.h"
 
 // 탭 이름 상수들
 static const FName FileUpLoadTabName(TEXT("FileUpLoad"));
@@ -26,58 +46,47 @@ static const FName FtpClientTabName(TEXT("FtpClient"));
 static const FName FileManagerTabName(TEXT("FileManager"));
 static const FName UploadHistoryTabName(TEXT("UploadHistory"));
 
+// 종료 때 남은 백그라운드 업로드를 기다리는 최대 시간
+static constexpr double BackgroundDrainSeconds = 30.0;
+
 #define LOCTEXT_NAMESPACE "FFileUpLoadModule"
 
-// FTP 사용자 설정 구조체
-struct FFtpUserConfig
-{
-    FString Username;
-    FString Password;
-    FString HomeDirectory;
-    TArray<FString> Permissions;
-
-    FFtpUserConfig()
-    {
-        Username = TEXT("");
-        Password = TEXT("");
-        HomeDirectory = TEXT("/");
-        Permissions = { TEXT("Read") };
-    }
-};
-
-// 보안 설정 구조체
-struct FFtpSecurityConfig
-{
-    int32 MaxLoginAttempts = 5;
-    int32 LockoutDuration = 300; // 5분
-    bool EnableLogging = true;
-
-    FFtpSecurityConfig()
-    {
-        MaxLoginAttempts = 5;
-        LockoutDuration = 300;
-        EnableLogging = true;
-    }
-};
-
-// 전역 변수들
-static TArray<FFtpUserConfig> GFtpUsers;
-static FFtpSecurityConfig GFtpSecurityConfig;
-static FString GServerAddress = TEXT("192.168.0.35");
-static int32 GServerPort = 21;
-static TMap<FString, int32> GLoginAttempts;
-static TMap<FString, FDateTime> GLockoutTimes;
+DECLARE_CYCLE_STAT(TEXT("StartupModule"), STAT_FileUpLoad_StartupModule, STATGROUP_FileUpLoad);
 
 //2025.07.24 KDG
 //플러그인이 로드될 때 호출되는 초기화 함수
-//여기서 ToolMenus 콜백을 등록해 툴바를 확장하는 작업을 수행합니다.
+//저장 이벤트 구독과 명령/탭/메뉴 콜백 등록만 하고, 나머지는 엔진 초기화 뒤(StartOptionalServices)나 처음 쓸 때로 미룹니다.
 void FFileUpLoadModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
 	
-	FFileUpLoadStyle::Initialize();
-	FFileUpLoadStyle::ReloadTextures();
+	SCOPE_CYCLE_COUNTER(STAT_FileUpLoad_StartupModule);
+	const double StartTime = FPlatformTime::Seconds();
+
+	Lifetime = MakeShared<FFileUpLoadModule*, ESPMode::ThreadSafe>(this);
+
+	// 저장된 패키지 기록은 커맨드렛(리세이브 등)에서도 모은다
+	FtpChangeDiscovery::StartTracking();
+
+	// 쿡 스트리밍 같은 선택 기능은 엔진 초기화가 끝난 뒤에 켠다. 버퍼 예산과 공유 파생 데이터 저장소는 처음 쓸 때 읽는다
+	if (GEngine != nullptr && GEngine->IsInitialized())
+	{
+		StartOptionalServices();
+	}
+	else
+	{
+		PostEngineInitHandle = FCoreDelegates::OnPostEngineInit.AddRaw(this, &FFileUpLoadModule::StartOptionalServices);
+	}
+
+	// 커맨드렛(UnrealEditor-Cmd -run=FtpSync 등)에서는 Slate 스타일, 탭, 메뉴 등록을 모두 건너뛴다
+	bUIRegistered = !IsRunningCommandlet();
+	if (!bUIRegistered)
+	{
+		return;
+	}
 
+	// 스타일 텍스처는 탭이 처음 열릴 때 로드하고(EnsureStyleInitialized),
+	// FTP 사용자/설정은 처음 사용할 때 초기화한다(EnsureFtpSystemInitialized)
 	FFileUpLoadCommands::Register();
 	
 	PluginCommands = MakeShareable(new FUICommandList);
@@ -108,669 +117,347 @@ void FFileUpLoadModule::StartupModule()
 
 	UToolMenus::RegisterStartupCallback(FSimpleMulticastDelegate::FDelegate::CreateRaw(this, &FFileUpLoadModule::RegisterMenus));
 
-	// FTP 시스템 초기화
-	InitializeFtpSystem();
-
-	// FTP 시스템 초기화
-	InitializeFtpSystem();
+	UE_LOG(LogTemp, Log, TEXT("FileUpLoad startup: %.3f ms"), (FPlatformTime::Seconds() - StartTime) * 1000.0);
 }
 
-void FFileUpLoadModule::ShutdownModule()
+void FFileUpLoadModule::StartOptionalServices()
 {
-	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
-	// we call this function before unloading the module.
-
-	// 탭 스폰어 등록 해제
-	FGlobalTabmanager::Get()->UnregisterNomadTabSpawner(FileUpLoadTabName);
-	FGlobalTabmanager::Get()->UnregisterNomadTabSpawner(FtpClientTabName);
-	FGlobalTabmanager::Get()->UnregisterNomadTabSpawner(FileManagerTabName);
-	FGlobalTabmanager::Get()->UnregisterNomadTabSpawner(UploadHistoryTabName);
+	FCoreDelegates::OnPostEngineInit.Remove(PostEngineInitHandle);
+	PostEngineInitHandle.Reset();
 
-	UToolMenus::UnRegisterStartupCallback(this);
-
-	UToolMenus::UnregisterOwner(this);
-
-	FFileUpLoadStyle::Shutdown();
-
-	FFileUpLoadCommands::Unregister();
-}
-
-void FFileUpLoadModule::InitializeFtpSystem()
-{
-	// 기본 사용자 설정
-	FFtpUserConfig TestUser;
-	TestUser.Username = TEXT("test");
-	TestUser.Password = TEXT("test");
-	TestUser.HomeDirectory = TEXT("/test");
-	TestUser.Permissions = { TEXT("Read"), TEXT("Write"), TEXT("Delete") };
-	GFtpUsers.Add(TestUser);
-
-	FFtpUserConfig AdminUser;
-	AdminUser.Username = TEXT("admin");
-	AdminUser.Password = TEXT("admin");
-	AdminUser.HomeDirectory = TEXT("/admin");
-	AdminUser.Permissions = { TEXT("Read"), TEXT("Write"), TEXT("Delete"), TEXT("Admin") };
-	GFtpUsers.Add(AdminUser);
-
-	// 보안 설정
-	GFtpSecurityConfig.MaxLoginAttempts = 5;
-	GFtpSecurityConfig.LockoutDuration = 300; // 5분
-	GFtpSecurityConfig.EnableLogging = true;
-
-	// 서버 설정
-	GServerAddress = TEXT("192.168.0.35");
-	GServerPort = 21;
-
-	UE_LOG(LogTemp, Log, TEXT("FTP System initialized successfully"));
-}
-
-// 전방 선언
-bool IsUserLocked(const FString& Username);
-FFtpUserConfig* GetUser(const FString& Username);
-void RecordLoginAttempt(const FString& Username, bool bSuccess, const FString& IpAddress);
-
-// 로그 출력 함수
-void LogFtpMessage(const FString& Message, bool bIsError = false)
-{
-	if (GFtpSecurityConfig.EnableLogging)
+	// 쿡 커맨드렛에 -FtpStreamCook=<작업 명세.json>이 있으면 쿡된 패키지를 쿡 도중에 올린다 (쿡은 엔진 초기화 뒤에 시작한다)
+	FString CookStreamSpec;
+	FFtpCookStreamSettings CookStreamSettings;
+	if (FParse::Value(FCommandLine::Get(), TEXT("FtpStreamCook="), CookStreamSpec) && FFtpCookStreamer::LoadSettings(CookStreamSpec, CookStreamSettings))
 	{
-		if (bIsError)
+		CookStreamer = MakeUnique<FFtpCookStreamer>(CookStreamSettings);
+		if (CookStreamer->Start())
 		{
-			UE_LOG(LogTemp, Error, TEXT("FTP System: %s"), *Message);
+			EnginePreExitHandle = FCoreDelegates::OnEnginePreExit.AddRaw(this, &FFileUpLoadModule::FinishCookStreaming);
 		}
 		else
 		{
-			UE_LOG(LogTemp, Log, TEXT("FTP System: %s"), *Message);
+			CookStreamer.Reset();
 		}
 	}
 }
 
-// 사용자 인증
-bool AuthenticateUser(const FString& Username, const FString& Password)
+FFtpDerivedDataStore* FFileUpLoadModule::GetDerivedDataStore()
 {
-	// 계정 잠금 확인
-	if (IsUserLocked(Username))
-	{
-		LogFtpMessage(FString::Printf(TEXT("Login attempt on locked account: %s"), *Username), true);
-		return false;
-	}
+	check(IsInGameThread());
 
-	FFtpUserConfig* User = GetUser(Username);
-	if (User == nullptr)
+	// -FtpDerivedData=<작업 명세.json>이 있으면 처음 부를 때 연다 (에디터, 커맨드렛 모두)
+	if (!bDerivedDataStoreChecked)
 	{
-		RecordLoginAttempt(Username, false, TEXT("unknown"));
-		return false;
-	}
-
-	bool bIsValid = User->Password.Equals(Password, ESearchCase::CaseSensitive);
-	RecordLoginAttempt(Username, bIsValid, TEXT("unknown"));
-
-	if (bIsValid)
-	{
-		// 성공 시 로그인 시도 횟수 초기화
-		GLoginAttempts.Remove(Username);
-		GLockoutTimes.Remove(Username);
-	}
-
-	return bIsValid;
-}
+		bDerivedDataStoreChecked = true;
 
-// 사용자 정보 조회
-FFtpUserConfig* GetUser(const FString& Username)
-{
-	for (FFtpUserConfig& User : GFtpUsers)
-	{
-		if (User.Username.Equals(Username, ESearchCase::IgnoreCase))
+		FString DerivedDataSpec;
+		FFtpDerivedDataSettings DerivedDataSettings;
+		if (FParse::Value(FCommandLine::Get(), TEXT("FtpDerivedData="), DerivedDataSpec) && FFtpDerivedDataStore::LoadSettings(DerivedDataSpec, DerivedDataSettings))
 		{
-			return &User;
+			DerivedDataStore = MakeUnique<FFtpDerivedDataStore>(DerivedDataSettings);
+			if (!DerivedDataStore->Start())
+			{
+				DerivedDataStore.Reset();
+			}
 		}
 	}
-	return nullptr;
-}
-
-// 사용자 권한 확인
-bool HasPermission(const FString& Username, const FString& Permission)
-{
-	FFtpUserConfig* User = GetUser(Username);
-	if (User == nullptr)
-		return false;
-
-	return User->Permissions.Contains(Permission);
+	return DerivedDataStore.Get();
 }
 
-// 로그인 시도 기록
-void RecordLoginAttempt(const FString& Username, bool bSuccess, const FString& IpAddress)
+void FFileUpLoadModule::EnsureStyleInitialized()
 {
-	if (!bSuccess)
+	if (!bStyleInitialized)
 	{
-		int32* AttemptsPtr = GLoginAttempts.Find(Username);
-		int32 Attempts = AttemptsPtr ? *AttemptsPtr + 1 : 1;
-		GLoginAttempts.Add(Username, Attempts);
-		
-		LogFtpMessage(FString::Printf(TEXT("Login failed: %s from %s, attempts: %d"), *Username, *IpAddress, Attempts), true);
-
-		if (Attempts >= GFtpSecurityConfig.MaxLoginAttempts)
-		{
-			FDateTime LockoutTime = FDateTime::UtcNow() + FTimespan::FromSeconds(GFtpSecurityConfig.LockoutDuration);
-			GLockoutTimes.Add(Username, LockoutTime);
-			
-			LogFtpMessage(FString::Printf(TEXT("Account locked: %s until %s"), *Username, *LockoutTime.ToString()), true);
-		}
-	}
-	else
-	{
-		LogFtpMessage(FString::Printf(TEXT("Login successful: %s from %s"), *Username, *IpAddress), false);
+		FFileUpLoadStyle::Initialize();
+		FFileUpLoadStyle::ReloadTextures();
+		bStyleInitialized = true;
 	}
 }
 
-// 사용자 잠금 확인
-bool IsUserLocked(const FString& Username)
+void FFileUpLoadModule::ShutdownModule()
 {
-	FDateTime* LockoutTimePtr = GLockoutTimes.Find(Username);
-	if (LockoutTimePtr)
+	// This function may be called during shutdown to clean up your module.  For modules that support dynamic reloading,
+	// we call this function before unloading the module.
+
+	// 끝나지 않은 계획/업로드의 완료 콜백이 더는 모듈에 닿지 않게 끊고, 전송이 마무리되기를 잠깐 기다린다
+	Lifetime.Reset();
+	const double DrainDeadline = FPlatformTime::Seconds() + BackgroundDrainSeconds;
+	for (TFuture<void>& Task : BackgroundTasks)
 	{
-		if (FDateTime::UtcNow() < *LockoutTimePtr)
+		const double Remaining = DrainDeadline - FPlatformTime::Seconds();
+		if (Remaining <= 0.0 || !Task.WaitFor(FTimespan::FromSeconds(Remaining)))
 		{
-			return true;
-		}
-		else
-		{
-			// 잠금 시간이 지났으면 잠금 해제
-			GLockoutTimes.Remove(Username);
-			GLoginAttempts.Remove(Username);
+			UE_LOG(LogTemp, Warning, TEXT("FileUpLoad: background upload still running at shutdown"));
+			break;
 		}
 	}
+	BackgroundTasks.Empty();
 
-	return false;
-}
+	ContentWatcher.Reset();
+	FtpChangeDiscovery::StopTracking();
 
-// CURL 명령어 실행
-bool ExecuteCurlCommand(const FString& Command, FString& Output, FString& Error)
-{
-	int32 ReturnCode;
-	FString StdOut, StdErr;
-	
-	bool bSuccess = FPlatformProcess::ExecProcess(TEXT("curl.exe"), *Command, &ReturnCode, &StdOut, &StdErr);
-	
-	Output = StdOut;
-	Error = StdErr;
-	
-	return bSuccess && ReturnCode == 0;
-}
+	FCoreDelegates::OnPostEngineInit.Remove(PostEngineInitHandle);
 
-// FTP URL 생성
-FString CreateFtpUrl(const FString& Username, const FString& RemotePath)
-{
-	FFtpUserConfig* User = GetUser(Username);
-	if (!User)
-		return TEXT("");
+	// 종료 전 정리를 못 했으면 (모듈만 내려가는 경우) 전송만 멈춘다
+	FCoreDelegates::OnEnginePreExit.Remove(EnginePreExitHandle);
+	CookStreamer.Reset();
 
-	FString BaseUrl = FString::Printf(TEXT("ftp://%s:%d"), *GServerAddress, GServerPort);
-	
-	// 루트 디렉토리인 경우
-	if (RemotePath.IsEmpty() || RemotePath == TEXT("/"))
+	// 뒤에 쓰는 Put이 서버까지 가도록 잠깐 기다린다
+	if (DerivedDataStore.IsValid())
 	{
-		return BaseUrl + TEXT("/");
+		DerivedDataStore->WaitForPending(30.0);
+		DerivedDataStore.Reset();
 	}
-	
-	if (RemotePath.StartsWith(TEXT("/")))
+
+	// 쉬고 있는 전송 버퍼를 돌려준다
+	FFtpBufferPool::Trim();
+
+	if (!bUIRegistered)
 	{
-		return BaseUrl + RemotePath;
+		return;
 	}
-	else
+
+	// 탭 스폰어 등록 해제
+	FGlobalTabmanager::Get()->UnregisterNomadTabSpawner(FileUpLoadTabName);
+	FGlobalTabmanager::Get()->UnregisterNomadTabSpawner(FtpClientTabName);
+	FGlobalTabmanager::Get()->UnregisterNomadTabSpawner(FileManagerTabName);
+	FGlobalTabmanager::Get()->UnregisterNomadTabSpawner(UploadHistoryTabName);
+
+	UToolMenus::UnRegisterStartupCallback(this);
+
+	UToolMenus::UnregisterOwner(this);
+
+	if (bStyleInitialized)
 	{
-		return BaseUrl + TEXT("/") + RemotePath;
+		FFileUpLoadStyle::Shutdown();
+		bStyleInitialized = false;
 	}
+
+	FFileUpLoadCommands::Unregister();
 }
 
-// FTP 파일 업로드
-bool UploadFile(const FString& Username, const FString& LocalPath, const FString& RemotePath)
+void FFileUpLoadModule::ToggleContentWatch()
 {
-	if (!HasPermission(Username, TEXT("Write")))
+	if (ContentWatcher.IsValid() && ContentWatcher->IsWatching())
 	{
-		LogFtpMessage(FString::Printf(TEXT("Upload failed: User %s lacks write permission"), *Username), true);
-		return false;
+		ContentWatcher.Reset();
+		UE_LOG(LogTemp, Log, TEXT("Content 감시 모드 종료"));
+		return;
 	}
 
-	if (!FPaths::FileExists(LocalPath))
+	const FString User = TEXT("test");
+	const FString Pass = TEXT("test");
+	if (!AuthenticateUser(User, Pass))
 	{
-		LogFtpMessage(FString::Printf(TEXT("Upload failed: Local file does not exist: %s"), *LocalPath), true);
-		return false;
+		UE_LOG(LogTemp, Error, TEXT("사용자 인증 실패: %s"), *User);
+		return;
 	}
 
-	FFtpUserConfig* User = GetUser(Username);
-	if (!User)
-		return false;
+	// 테스트 업로드와 같은 원격 경로로 변경분만 미러링
+	TArray<FFtpWatchRoot> Roots;
+	FFtpWatchRoot& ContentRoot = Roots.AddDefaulted_GetRef();
+	ContentRoot.LocalDirectory = FPaths::ProjectContentDir();
+	ContentRoot.RemoteDirectory = TEXT("upload/content");
 
-	FString FtpUrl = CreateFtpUrl(Username, RemotePath);
-	FString Command = FString::Printf(TEXT("-T \"%s\" \"%s\" --user %s:%s --ftp-pasv --ftp-create-dirs"), 
-		*LocalPath, *FtpUrl, *User->Username, *User->Password);
-
-	FString Output, Error;
-	bool bSuccess = ExecuteCurlCommand(Command, Output, Error);
-
-	if (bSuccess)
+	ContentWatcher = MakeShared<FFtpDirectoryWatcher>(User, Roots);
+	if (ContentWatcher->Start())
 	{
-		LogFtpMessage(FString::Printf(TEXT("Upload successful: %s -> %s"), *LocalPath, *RemotePath), false);
+		UE_LOG(LogTemp, Log, TEXT("Content 감시 모드 시작"));
 	}
 	else
 	{
-		LogFtpMessage(FString::Printf(TEXT("Upload failed: %s"), *Error), true);
+		ContentWatcher.Reset();
 	}
+}
 
-	return bSuccess;
+void FFileUpLoadModule::RunInBackground(TUniqueFunction<void()> Work)
+{
+	check(IsInGameThread());
+	BackgroundTasks.RemoveAll([](const TFuture<void>& Task) { return Task.IsReady(); });
+	BackgroundTasks.Add(Async(EAsyncExecution::Thread, MoveTemp(Work)));
 }
 
-// FTP 파일 다운로드
-bool DownloadFile(const FString& Username, const FString& RemotePath, const FString& LocalPath)
+void FFileUpLoadModule::ReturnToGameThread(const TWeakPtr<FFileUpLoadModule*, ESPMode::ThreadSafe>& WeakSelf, TUniqueFunction<void(FFileUpLoadModule&)> Callback)
 {
-	if (!HasPermission(Username, TEXT("Read")))
+	AsyncTask(ENamedThreads::GameThread, [WeakSelf, Callback = MoveTemp(Callback)]()
 	{
-		LogFtpMessage(FString::Printf(TEXT("Download failed: User %s lacks read permission"), *Username), true);
-		return false;
+		const TSharedPtr<FFileUpLoadModule*, ESPMode::ThreadSafe> Self = WeakSelf.Pin();
+		if (Self.IsValid())
+		{
+			Callback(**Self);
+		}
+	});
+}
+
+void FFileUpLoadModule::BuildContentPlan()
+{
+	if (bPlanBusy)
+	{
+		return;
 	}
 
-	FFtpUserConfig* User = GetUser(Username);
-	if (!User)
-		return false;
+	bPlanBusy = true;
+	PlanSummary = LOCTEXT("PlanBuilding", "Planning...");
 
-	FString FtpUrl = CreateFtpUrl(Username, RemotePath);
-	FString Command = FString::Printf(TEXT("\"%s\" --user %s:%s -o \"%s\" --ftp-pasv"), 
-		*FtpUrl, *User->Username, *User->Password, *LocalPath);
+	const FString ContentDir = FPaths::ProjectContentDir();
+	RunInBackground([WeakSelf = TWeakPtr<FFileUpLoadModule*, ESPMode::ThreadSafe>(Lifetime), ContentDir]()
+	{
+		TSharedPtr<FFtpTransferPlan> Plan = MakeShared<FFtpTransferPlan>();
+		const bool bBuilt = FtpPlanner::BuildPlan(ContentDir, TEXT("upload/content"), GServerAddress, TEXT("test"), TEXT("test"), false, *Plan);
+		if (bBuilt)
+		{
+			// CI와 같은 형식으로 남겨 두어 검토/비교할 수 있게 한다
+			FtpPlanner::SavePlan(*Plan, FPaths::ProjectSavedDir() / TEXT("FileUpLoad") / TEXT("ContentPlan.json"));
+		}
 
-	FString Output, Error;
-	bool bSuccess = ExecuteCurlCommand(Command, Output, Error);
+		ReturnToGameThread(WeakSelf, [Plan, bBuilt](FFileUpLoadModule& Module)
+		{
+			Module.bPlanBusy = false;
+			Module.ShowPlan(bBuilt ? Plan : nullptr);
+		});
+	});
+}
 
-	if (bSuccess)
+void FFileUpLoadModule::ShowPlan(const TSharedPtr<FFtpTransferPlan>& Plan)
+{
+	ContentPlan = Plan;
+	if (!Plan.IsValid())
 	{
-		LogFtpMessage(FString::Printf(TEXT("Download successful: %s -> %s"), *RemotePath, *LocalPath), false);
+		PlanSummary = LOCTEXT("PlanFailed", "Planning failed - see the output log");
+		return;
 	}
-	else
+
+	PlanSummary = FText::FromString(FtpPlanner::DescribePlan(*Plan));
+
+	// 계획마다 새 모델로 바꿔 이전 계획의 행이 남지 않게 한다
+	PlanModel = MakeShared<FFtpFileListModel>();
+	for (const FFtpPlanEntry& Entry : Plan->Entries)
 	{
-		LogFtpMessage(FString::Printf(TEXT("Download failed: %s"), *Error), true);
+		EFtpListEntryStatus Status = EFtpListEntryStatus::PlanSkip;
+		switch (Entry.Action)
+		{
+		case EFtpPlanAction::Create: Status = EFtpListEntryStatus::PlanCreate; break;
+		case EFtpPlanAction::Update: Status = EFtpListEntryStatus::PlanUpdate; break;
+		case EFtpPlanAction::Delete: Status = EFtpListEntryStatus::PlanDelete; break;
+		default: break;
+		}
+		PlanModel->EnqueueAdd(Plan->Files.GetRelativePath(Entry.FileIndex), FMath::Max<int64>(Entry.LocalSize, Entry.RemoteSize), Plan->Files.GetFileModified(Entry.FileIndex), Status);
 	}
 
-	return bSuccess;
+	if (PlanListBox.IsValid())
+	{
+		PlanListBox->SetContent(
+			SNew(SFtpFileListView)
+			.Model(PlanModel)
+			.PathColumnLabel(LOCTEXT("PlanPathColumn", "Planned Path")));
+	}
 }
 
-// FTP 파일 목록 조회
-bool GetFileList(const FString& Username, const FString& RemotePath, TArray<FString>& FileList)
+void FFileUpLoadModule::ExecuteContentPlan()
 {
-	if (!HasPermission(Username, TEXT("Read")))
+	if (bPlanBusy || !ContentPlan.IsValid())
 	{
-		LogFtpMessage(FString::Printf(TEXT("GetFileList failed: User %s lacks read permission"), *Username), true);
-		return false;
+		return;
 	}
 
-	FFtpUserConfig* User = GetUser(Username);
-	if (!User)
-		return false;
+	bPlanBusy = true;
+	PlanSummary = FText::Format(LOCTEXT("PlanExecuting", "Executing: {0}"), FText::FromString(FtpPlanner::DescribePlan(*ContentPlan)));
 
-	// 루트 디렉토리부터 시작
-	FString FtpUrl = FString::Printf(TEXT("ftp://%s:%d/"), *GServerAddress, GServerPort);
-	FString Command = FString::Printf(TEXT("\"%s\" --user %s:%s --silent --show-error --ftp-pasv"), 
-		*FtpUrl, *User->Username, *User->Password);
-
-	FString Output, Error;
-	bool bSuccess = ExecuteCurlCommand(Command, Output, Error);
-
-	if (bSuccess)
-	{
-		// 출력을 줄 단위로 분리
-		TArray<FString> Lines;
-		Output.ParseIntoArray(Lines, TEXT("\n"), true);
-		
-		for (const FString& Line : Lines)
+	// 실행이 끝날 때마다 계획 목록의 해당 행을 Succeeded/Failed로 바꾼다
+	TSharedPtr<FFtpTransferPlan> Plan = ContentPlan;
+	TWeakPtr<FFtpFileListModel> WeakModel = PlanModel;
+	FDelegateHandle HistoryHandle = FFtpTransferHistory::Get().AddListener(FFtpTransferHistory::FOnTransferRecorded::FDelegate::CreateLambda(
+		[WeakModel, LocalRoot = Plan->LocalRoot](const FFtpTransferRecord& Record)
 		{
-			if (!Line.IsEmpty())
+			TSharedPtr<FFtpFileListModel> PinnedModel = WeakModel.Pin();
+			if (PinnedModel.IsValid() && Record.Direction == EFtpTransferDirection::Upload)
 			{
-				FileList.Add(Line);
+				FString RelativePath = Record.LocalPath;
+				FPaths::MakePathRelativeTo(RelativePath, *(LocalRoot / TEXT("")));
+				PinnedModel->EnqueueStatus(RelativePath, Record.bSuccess ? EFtpListEntryStatus::Succeeded : EFtpListEntryStatus::Failed);
 			}
-		}
+		}));
 
-		LogFtpMessage(FString::Printf(TEXT("GetFileList successful: %d files found"), FileList.Num()), false);
-	}
-	else
+	RunInBackground([WeakSelf = TWeakPtr<FFileUpLoadModule*, ESPMode::ThreadSafe>(Lifetime), Plan, HistoryHandle]()
 	{
-		LogFtpMessage(FString::Printf(TEXT("GetFileList failed: %s"), *Error), true);
-	}
+		const FFtpSyncStats Stats = FtpPlanner::ExecutePlan(*Plan, TEXT("test"));
+		FFtpTransferHistory::Get().RemoveListener(HistoryHandle);
 
-	return bSuccess;
+		ReturnToGameThread(WeakSelf, [Stats](FFileUpLoadModule& Module)
+		{
+			Module.bPlanBusy = false;
+			Module.PlanSummary = FText::Format(LOCTEXT("PlanExecuted", "Plan executed: {0} succeeded, {1} failed"), Stats.SuccessCount, Stats.FailCount);
+		});
+	});
 }
 
-// 연결 테스트
-bool TestConnection(const FString& Username)
+void FFileUpLoadModule::UploadContentChanges()
 {
-	FFtpUserConfig* User = GetUser(Username);
-	if (!User)
+	if (bPlanBusy)
 	{
-		LogFtpMessage(FString::Printf(TEXT("TestConnection failed: Invalid user %s"), *Username), true);
-		return false;
+		return;
 	}
 
-	// 더 간단한 연결 테스트 - 루트 디렉토리만 확인
-	FString FtpUrl = FString::Printf(TEXT("ftp://%s:%d/"), *GServerAddress, GServerPort);
-	FString Command = FString::Printf(TEXT("\"%s\" --user %s:%s --connect-timeout 10 --max-time 30 --silent --show-error --ftp-pasv --ftp-create-dirs"), 
-		*FtpUrl, *User->Username, *User->Password);
+	// 발견은 게임 스레드에서 더티 패키지만 보고 나머지는 비동기로, 끝나면 전송을 백그라운드로
+	bPlanBusy = true;
+	PlanSummary = LOCTEXT("DiscoveryRunning", "Discovering changes...");
 
-	FString Output, Error;
-	bool bSuccess = ExecuteCurlCommand(Command, Output, Error);
-
-	if (bSuccess)
-	{
-		LogFtpMessage(FString::Printf(TEXT("Connection test successful for user: %s"), *Username), false);
-	}
-	else
+	const FString RemotePath = TEXT("upload/content");
+	FtpChangeDiscovery::DiscoverChangesAsync(FPaths::ProjectContentDir(), RemotePath, EFtpDiscoverySource::All,
+		[WeakSelf = TWeakPtr<FFileUpLoadModule*, ESPMode::ThreadSafe>(Lifetime), RemotePath](TSharedPtr<FFtpDiscoveryResult> Discovery)
 	{
-		LogFtpMessage(FString::Printf(TEXT("Connection test failed for user %s: %s"), *Username, *Error), true);
-	}
+		const TSharedPtr<FFileUpLoadModule*, ESPMode::ThreadSafe> Self = WeakSelf.Pin();
+		if (!Self.IsValid())
+		{
+			return;
+		}
 
-	return bSuccess;
-}
+		FFileUpLoadModule& Module = **Self;
+		if (!Discovery.IsValid())
+		{
+			Module.bPlanBusy = false;
+			Module.PlanSummary = LOCTEXT("DiscoveryFailed", "Change discovery failed - see the output log");
+			return;
+		}
 
-void UploadSpecificFolder(const FString& LocalFolder, const FString& RemoteBaseDir, const FString& Server, const FString& User, const FString& Pass)
-{
-    UE_LOG(LogTemp, Log, TEXT("특정 폴더 업로드 시작: %s"), *LocalFolder);
-    
-    // 사용자 인증
-    if (!AuthenticateUser(User, Pass))
-    {
-        UE_LOG(LogTemp, Error, TEXT("사용자 인증 실패: %s"), *User);
-        return;
-    }
-    
-    TArray<FString> AllFiles;
-    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
-    
-    // 특정 폴더의 모든 파일 찾기
-    PlatformFile.FindFilesRecursively(AllFiles, *LocalFolder, TEXT("*"));
-    
-    UE_LOG(LogTemp, Log, TEXT("총 %d개 파일 발견"), AllFiles.Num());
-    
-    int32 SuccessCount = 0;
-    int32 FailCount = 0;
-    
-    for (const FString& LocalFile : AllFiles)
-    {
-        // 상대 경로 계산
-        FString RelativePath = LocalFile;
-        FPaths::MakePathRelativeTo(RelativePath, *LocalFolder);
-        
-        // 원격 경로 생성
-        FString RemoteFile = RemoteBaseDir / RelativePath;
-        
-        UE_LOG(LogTemp, Log, TEXT("업로드 중: %s -> %s"), *LocalFile, *RemoteFile);
-        
-        if (UploadFile(User, LocalFile, RemoteFile)) {
-            SuccessCount++;
-            UE_LOG(LogTemp, Log, TEXT("업로드 성공: %s"), *RelativePath);
-        } else {
-            FailCount++;
-            UE_LOG(LogTemp, Error, TEXT("업로드 실패: %s"), *RelativePath);
-        }
-    }
-    
-    UE_LOG(LogTemp, Log, TEXT("특정 폴더 업로드 완료: 성공 %d개, 실패 %d개"), SuccessCount, FailCount);
-}
+		Module.PlanSummary = FText::FromString(FtpChangeDiscovery::DescribeResult(*Discovery));
 
-void UploadFolderStructure(const FString& LocalFolder, const FString& RemoteBaseDir, const FString& Server, const FString& User, const FString& Pass)
-{
-    UE_LOG(LogTemp, Log, TEXT("폴더 구조 업로드 시작: %s"), *LocalFolder);
-    
-    // 사용자 인증
-    if (!AuthenticateUser(User, Pass))
-    {
-        UE_LOG(LogTemp, Error, TEXT("사용자 인증 실패: %s"), *User);
-        return;
-    }
-    
-    TArray<FString> AllFiles;
-    TSet<FString> AllDirectories; // 중복 제거를 위해 TSet 사용
-    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
-    
-    // 모든 파일 찾기 (여러 패턴으로 시도)
-    PlatformFile.FindFilesRecursively(AllFiles, *LocalFolder, TEXT("*.*"));
-    
-    // 만약 파일이 없으면 다른 패턴 시도
-    if (AllFiles.Num() == 0)
-    {
-        UE_LOG(LogTemp, Log, TEXT("*. 패턴으로 재시도"));
-        PlatformFile.FindFilesRecursively(AllFiles, *LocalFolder, TEXT("*"));
-    }
-    
-    // 여전히 파일이 없으면 모든 확장자 시도
-    if (AllFiles.Num() == 0)
-    {
-        UE_LOG(LogTemp, Log, TEXT("모든 확장자로 재시도"));
-        PlatformFile.FindFilesRecursively(AllFiles, *LocalFolder, TEXT("*.txt"));
-        PlatformFile.FindFilesRecursively(AllFiles, *LocalFolder, TEXT("*.uasset"));
-        PlatformFile.FindFilesRecursively(AllFiles, *LocalFolder, TEXT("*.umap"));
-        PlatformFile.FindFilesRecursively(AllFiles, *LocalFolder, TEXT("*.ini"));
-    }
-    
-    UE_LOG(LogTemp, Log, TEXT("파일 검색 결과: %d개 파일 발견"), AllFiles.Num());
-    
-    // 발견된 파일들 로그 출력
-    for (int32 i = 0; i < AllFiles.Num(); i++)
-    {
-        UE_LOG(LogTemp, Log, TEXT("파일 %d: %s"), i, *AllFiles[i]);
-    }
-    
-    // 파일 경로에서 폴더 경로 추출
-    for (const FString& FilePath : AllFiles)
-    {
-        FString DirectoryPath = FPaths::GetPath(FilePath);
-        AllDirectories.Add(DirectoryPath);
-    }
-    
-    UE_LOG(LogTemp, Log, TEXT("총 %d개 파일, %d개 폴더 발견"), AllFiles.Num(), AllDirectories.Num());
-    
-    int32 SuccessCount = 0;
-    int32 FailCount = 0;
-    
-    // 1단계: 모든 폴더 경로 준비
-    for (const FString& LocalDir : AllDirectories)
-    {
-        FString RelativePath = LocalDir;
-        FPaths::MakePathRelativeTo(RelativePath, *LocalFolder);
-        FString RemoteDir = RemoteBaseDir / RelativePath;
-        
-        UE_LOG(LogTemp, Log, TEXT("폴더 경로 준비: %s -> %s"), *LocalDir, *RemoteDir);
-    }
-    
-    // 2단계: 모든 파일 업로드
-    for (const FString& LocalFile : AllFiles)
-    {
-        // 상대 경로 계산
-        FString RelativePath = LocalFile;
-        FPaths::MakePathRelativeTo(RelativePath, *LocalFolder);
-        
-        // 원격 경로 생성
-        FString RemoteFile = RemoteBaseDir / RelativePath;
-        
-        UE_LOG(LogTemp, Log, TEXT("업로드 중: %s -> %s"), *LocalFile, *RemoteFile);
-        
-        if (UploadFile(User, LocalFile, RemoteFile)) {
-            SuccessCount++;
-            UE_LOG(LogTemp, Log, TEXT("업로드 성공: %s"), *RelativePath);
-        } else {
-            FailCount++;
-            UE_LOG(LogTemp, Error, TEXT("업로드 실패: %s"), *RelativePath);
-        }
-    }
-    
-    UE_LOG(LogTemp, Log, TEXT("폴더 구조 업로드 완료: 성공 %d개, 실패 %d개"), SuccessCount, FailCount);
-}
+		TArray<FName> PriorityPackages;
+		const FName EditorLevel = FtpUploadOrder::GetEditorLevelPackage();
+		if (!EditorLevel.IsNone())
+		{
+			PriorityPackages.Add(EditorLevel);
+		}
 
-void UploadFromFtpServer(const FString& RemotePath, const FString& LocalPath, const FString& Server, const FString& User, const FString& Pass)
-{
-    UE_LOG(LogTemp, Log, TEXT("=== FTP 서버에서 파일 다운로드 시작 ==="));
-    UE_LOG(LogTemp, Log, TEXT("FTP 서버 경로: %s"), *RemotePath);
-    UE_LOG(LogTemp, Log, TEXT("로컬 저장 경로: %s"), *LocalPath);
-    
-    // 사용자 인증
-    if (!AuthenticateUser(User, Pass))
-    {
-        UE_LOG(LogTemp, Error, TEXT("사용자 인증 실패: %s"), *User);
-        return;
-    }
-    
-    // 1단계: FTP 서버에서 파일 목록 가져오기
-    TArray<FString> FileList;
-    if (!GetFileList(User, RemotePath, FileList)) {
-        UE_LOG(LogTemp, Error, TEXT("FTP 파일 목록 가져오기 실패"));
-        return;
-    }
-    
-    UE_LOG(LogTemp, Log, TEXT("FTP 서버에서 %d개 파일 발견"), FileList.Num());
-    
-    // 발견된 파일들 로그 출력
-    for (int32 i = 0; i < FileList.Num(); i++) {
-        UE_LOG(LogTemp, Log, TEXT("파일 %d: %s"), i, *FileList[i]);
-    }
-    
-    // 2단계: 각 파일 다운로드
-    int32 SuccessCount = 0;
-    int32 FailCount = 0;
-    
-    for (const FString& RemoteFile : FileList) {
-        FString FullRemotePath = RemotePath / RemoteFile;
-        FString FullLocalPath = LocalPath / RemoteFile;
-        
-        UE_LOG(LogTemp, Log, TEXT("다운로드 중: %s -> %s"), *FullRemotePath, *FullLocalPath);
-        
-        if (DownloadFile(User, FullRemotePath, FullLocalPath)) {
-            SuccessCount++;
-            UE_LOG(LogTemp, Log, TEXT("다운로드 성공: %s"), *RemoteFile);
-        } else {
-            FailCount++;
-            UE_LOG(LogTemp, Error, TEXT("다운로드 실패: %s"), *RemoteFile);
-        }
-    }
-    
-    UE_LOG(LogTemp, Log, TEXT("=== FTP 다운로드 완료: 성공 %d개, 실패 %d개 ==="), SuccessCount, FailCount);
+		Module.RunInBackground([WeakSelf, Discovery, RemotePath, PriorityPackages]()
+		{
+			const FFtpSyncStats Stats = FtpChangeDiscovery::UploadChanges(*Discovery, RemotePath, GServerAddress, TEXT("test"), TEXT("test"), PriorityPackages);
+
+			ReturnToGameThread(WeakSelf, [Stats, NumUnsaved = Discovery->UnsavedPackages.Num()](FFileUpLoadModule& Module)
+			{
+				Module.bPlanBusy = false;
+				Module.PlanSummary = FText::Format(LOCTEXT("ChangesUploaded", "Changed assets uploaded: {0} succeeded, {1} failed, {2} unsaved package(s) skipped"), Stats.SuccessCount, Stats.FailCount, NumUnsaved);
+			});
+		});
+	});
 }
 
-void UploadToFtpServer(const FString& LocalPath, const FString& RemotePath, const FString& Server, const FString& User, const FString& Pass)
+void FFileUpLoadModule::FinishCookStreaming()
 {
-    UE_LOG(LogTemp, Log, TEXT("=== FTP 서버로 파일 업로드 시작 ==="));
-    UE_LOG(LogTemp, Log, TEXT("로컬 경로: %s"), *LocalPath);
-    UE_LOG(LogTemp, Log, TEXT("FTP 서버 경로: %s"), *RemotePath);
-    
-    // 사용자 인증
-    if (!AuthenticateUser(User, Pass))
-    {
-        UE_LOG(LogTemp, Error, TEXT("사용자 인증 실패: %s"), *User);
-        return;
-    }
-    
-    // 1단계: 로컬 파일 목록 가져오기 (개선된 방법)
-    TArray<FString> AllFiles;
-    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
-    
-    // 디렉토리 존재 확인
-    if (!FPaths::DirectoryExists(LocalPath)) {
-        UE_LOG(LogTemp, Error, TEXT("로컬 경로가 존재하지 않습니다: %s"), *LocalPath);
-        return;
-    }
-    
-    UE_LOG(LogTemp, Log, TEXT("로컬 경로 존재 확인됨: %s"), *LocalPath);
-    
-    // 모든 파일을 찾기 위해 여러 방법 시도
-    TArray<FString> Patterns = {TEXT("*"), TEXT("*.*"), TEXT("*.txt"), TEXT("*.uasset"), TEXT("*.umap"), TEXT("*.ini"), TEXT("*.bat"), TEXT("*.md")};
-    
-    for (const FString& Pattern : Patterns) {
-        TArray<FString> PatternFiles;
-        PlatformFile.FindFilesRecursively(PatternFiles, *LocalPath, *Pattern);
-        UE_LOG(LogTemp, Log, TEXT("패턴 %s: %d개 파일 발견"), *Pattern, PatternFiles.Num());
-        
-        // 각 파일의 전체 경로 출력
-        for (const FString& File : PatternFiles) {
-            UE_LOG(LogTemp, Log, TEXT("  발견된 파일: %s"), *File);
-        }
-        
-        AllFiles.Append(PatternFiles);
-    }
-    
-    // 중복 제거
-    TSet<FString> UniqueFiles(AllFiles);
-    AllFiles = UniqueFiles.Array();
-    
-    UE_LOG(LogTemp, Log, TEXT("총 %d개 고유 파일 발견"), AllFiles.Num());
-    
-    // 발견된 파일들 로그 출력
-    for (int32 i = 0; i < AllFiles.Num(); i++) {
-        UE_LOG(LogTemp, Log, TEXT("파일 %d: %s"), i, *AllFiles[i]);
-    }
-    
-    // 파일이 없으면 대안 방법 시도
-    if (AllFiles.Num() == 0) {
-        UE_LOG(LogTemp, Warning, TEXT("기본 패턴으로 파일을 찾지 못했습니다. 대안 방법 시도..."));
-        
-        // 대안 1: 디렉토리 내 모든 항목 나열
-        TArray<FString> AllItems;
-        PlatformFile.FindFiles(AllItems, *LocalPath, TEXT("*"));
-        UE_LOG(LogTemp, Log, TEXT("대안 1 - 모든 항목: %d개 발견"), AllItems.Num());
-        
-        for (const FString& Item : AllItems) {
-            UE_LOG(LogTemp, Log, TEXT("  항목: %s"), *Item);
-        }
-        
-        // 대안 2: 하위 디렉토리 검색 (수동으로 구현)
-        TArray<FString> SubDirs;
-        PlatformFile.FindFiles(SubDirs, *LocalPath, TEXT("*"));
-        
-        // 디렉토리만 필터링
-        TArray<FString> Directories;
-        for (const FString& Item : SubDirs) {
-            if (PlatformFile.DirectoryExists(*Item)) {
-                Directories.Add(Item);
-            }
-        }
-        
-        UE_LOG(LogTemp, Log, TEXT("대안 2 - 하위 디렉토리: %d개 발견"), Directories.Num());
-        
-        for (const FString& SubDir : Directories) {
-            UE_LOG(LogTemp, Log, TEXT("  하위 디렉토리: %s"), *SubDir);
-            
-            // 각 하위 디렉토리에서 파일 검색
-            TArray<FString> SubDirFiles;
-            PlatformFile.FindFilesRecursively(SubDirFiles, *SubDir, TEXT("*"));
-            UE_LOG(LogTemp, Log, TEXT("    %s에서 %d개 파일 발견"), *SubDir, SubDirFiles.Num());
-            
-            for (const FString& File : SubDirFiles) {
-                UE_LOG(LogTemp, Log, TEXT("      파일: %s"), *File);
-                AllFiles.Add(File);
-            }
-        }
-        
-        UE_LOG(LogTemp, Log, TEXT("대안 방법 후 총 %d개 파일 발견"), AllFiles.Num());
-    }
-    
-    // 2단계: 각 파일을 FTP 서버로 업로드
-    int32 SuccessCount = 0;
-    int32 FailCount = 0;
-    
-    for (const FString& LocalFile : AllFiles) {
-        // 상대 경로 계산
-        FString RelativePath = LocalFile;
-        FPaths::MakePathRelativeTo(RelativePath, *LocalPath);
-        
-        // 원격 경로 생성
-        FString RemoteFile = RemotePath / RelativePath;
-        
-        UE_LOG(LogTemp, Log, TEXT("업로드 중: %s -> %s"), *LocalFile, *RemoteFile);
-        
-        if (UploadFile(User, LocalFile, RemoteFile)) {
-            SuccessCount++;
-            UE_LOG(LogTemp, Log, TEXT("업로드 성공: %s"), *RelativePath);
-        } else {
-            FailCount++;
-            UE_LOG(LogTemp, Error, TEXT("업로드 실패: %s"), *RelativePath);
-        }
-    }
-    
-    UE_LOG(LogTemp, Log, TEXT("=== FTP 업로드 완료: 성공 %d개, 실패 %d개 ==="), SuccessCount, FailCount);
+	FCoreDelegates::OnEnginePreExit.Remove(EnginePreExitHandle);
+	EnginePreExitHandle.Reset();
+
+	if (CookStreamer.IsValid())
+	{
+		// 쿡 커맨드렛은 이미 끝났으므로 실패는 프로세스 종료 코드로만 알릴 수 있다
+		if (!CookStreamer->Finish())
+		{
+			UE_LOG(LogTemp, Error, TEXT("FtpStreamCook: cooked output was not fully uploaded"));
+			GIsCriticalError = true;
+		}
+		CookStreamer.Reset();
+	}
 }
 
 void FFileUpLoadModule::PluginButtonClicked()
@@ -855,6 +542,8 @@ void FFileUpLoadModule::RegisterMenus()
 // FileUpLoad 버튼 별 기능
 TSharedRef<SDockTab> FFileUpLoadModule::SpawnFileUploadTab(const FSpawnTabArgs& SpawnTabArgs)
 {
+	EnsureStyleInitialized();
+
 	return SNew(SDockTab)
 		.TabRole(ETabRole::NomadTab)
 		[
@@ -915,7 +604,14 @@ TSharedRef<SDockTab> FFileUpLoadModule::SpawnFileUploadTab(const FSpawnTabArgs&
 					// 3. 로컬 콘텐츠를 FTP 서버로 업로드
 					UE_LOG(LogTemp, Log, TEXT("=== 3단계: FTP 업로드 테스트 ==="));
 					FString RemoteBaseDir = TEXT("upload/content");
-					UploadToFtpServer(ContentDir, RemoteBaseDir, Server, User, Pass);
+					// 열려 있는 레벨과 그 의존성을 먼저 보낸다
+					TArray<FName> PriorityPackages;
+					const FName EditorLevel = FtpUploadOrder::GetEditorLevelPackage();
+					if (!EditorLevel.IsNone())
+					{
+						PriorityPackages.Add(EditorLevel);
+					}
+					UploadToFtpServer(ContentDir, RemoteBaseDir, Server, User, Pass, PriorityPackages);
 					
 					// 4. FTP 서버에서 파일 다운로드 (테스트)
 					UE_LOG(LogTemp, Log, TEXT("=== 4단계: FTP 다운로드 테스트 ==="));
@@ -927,11 +623,115 @@ TSharedRef<SDockTab> FFileUpLoadModule::SpawnFileUploadTab(const FSpawnTabArgs&
 					return FReply::Handled();
 				})
 			]
+			+ SVerticalBox::Slot()
+			.AutoHeight()
+			.Padding(10)
+			[
+				SNew(SButton)
+				.Text_Lambda([this]()
+				{
+					return ContentWatcher.IsValid() && ContentWatcher->IsWatching()
+						? LOCTEXT("StopWatchButton", "Stop Content Watch")
+						: LOCTEXT("StartWatchButton", "Start Content Watch");
+				})
+				.OnClicked_Lambda([this]()
+				{
+					ToggleContentWatch();
+					return FReply::Handled();
+				})
+			]
+			+ SVerticalBox::Slot()
+			.AutoHeight()
+			.Padding(10)
+			[
+				SNew(SButton)
+				.Text(LOCTEXT("FanOutButton", "Fan-out Upload to Mirrors"))
+				.ToolTipText(LOCTEXT("FanOutButtonToolTip", "Upload Content to every server in Saved/FileUpLoad/ServerProfiles.json, reading each file once"))
+				.OnClicked_Lambda([this]()
+				{
+					TArray<FFtpServerProfile> Targets;
+					if (!LoadFtpServerProfiles(GetDefaultServerProfilesPath(), Targets))
+					{
+						UE_LOG(LogTemp, Error, TEXT("서버 프로필이 없습니다: %s"), *GetDefaultServerProfilesPath());
+						return FReply::Handled();
+					}
+
+					const FString ContentDir = FPaths::ProjectContentDir();
+					RunInBackground([ContentDir, Targets]()
+					{
+						TArray<FFtpFanOutTargetResult> Results;
+						FtpFanOut::UploadToFtpServers(ContentDir, TEXT("upload/content"), Targets, Results);
+					});
+					return FReply::Handled();
+				})
+			]
+			+ SVerticalBox::Slot()
+			.AutoHeight()
+			.Padding(10)
+			[
+				SNew(SButton)
+				.Text(LOCTEXT("UploadChangesButton", "Upload Changed Assets"))
+				.ToolTipText(LOCTEXT("UploadChangesButtonToolTip", "Upload only packages saved in this session, changed in the Asset Registry since the last upload, or opened in source control. Content is not rescanned."))
+				.IsEnabled_Lambda([this]() { return !bPlanBusy; })
+				.OnClicked_Lambda([this]()
+				{
+					UploadContentChanges();
+					return FReply::Handled();
+				})
+			]
+			+ SVerticalBox::Slot()
+			.AutoHeight()
+			.Padding(10)
+			[
+				SNew(SHorizontalBox)
+				+ SHorizontalBox::Slot()
+				.AutoWidth()
+				.Padding(0, 0, 5, 0)
+				[
+					SNew(SButton)
+					.Text(LOCTEXT("PlanButton", "Plan Content Upload (Dry Run)"))
+					.ToolTipText(LOCTEXT("PlanButtonToolTip", "Compare Content with the server and list what an upload would create, update, skip or delete, with an ETA. Nothing is transferred."))
+					.IsEnabled_Lambda([this]() { return !bPlanBusy; })
+					.OnClicked_Lambda([this]()
+					{
+						BuildContentPlan();
+						return FReply::Handled();
+					})
+				]
+				+ SHorizontalBox::Slot()
+				.AutoWidth()
+				[
+					SNew(SButton)
+					.Text(LOCTEXT("ExecutePlanButton", "Execute Plan"))
+					.ToolTipText(LOCTEXT("ExecutePlanButtonToolTip", "Upload exactly the files in the plan above without rescanning"))
+					.IsEnabled_Lambda([this]() { return !bPlanBusy && ContentPlan.IsValid() && ContentPlan->GetNumTransfers() > 0; })
+					.OnClicked_Lambda([this]()
+					{
+						ExecuteContentPlan();
+						return FReply::Handled();
+					})
+				]
+			]
+			+ SVerticalBox::Slot()
+			.AutoHeight()
+			.Padding(10, 0)
+			[
+				SNew(STextBlock)
+				.Text_Lambda([this]() { return PlanSummary; })
+			]
+			+ SVerticalBox::Slot()
+			.FillHeight(1.0f)
+			.Padding(10)
+			[
+				SAssignNew(PlanListBox, SBox)
+			]
 		];
 }
 
 TSharedRef<SDockTab> FFileUpLoadModule::SpawnFtpClientTab(const FSpawnTabArgs& SpawnTabArgs)
 {
+	EnsureStyleInitialized();
+
 	return SNew(SDockTab)
 		.TabRole(ETabRole::NomadTab)
 		[
@@ -1009,8 +809,56 @@ TSharedRef<SDockTab> FFileUpLoadModule::SpawnFtpClientTab(const FSpawnTabArgs& S
 
 TSharedRef<SDockTab> FFileUpLoadModule::SpawnFileManagerTab(const FSpawnTabArgs& SpawnTabArgs)
 {
+	EnsureStyleInitialized();
+
+	TSharedRef<FFtpFileListModel> Model = MakeShared<FFtpFileListModel>();
+	const FString ContentDir = FPaths::ProjectContentDir();
+
+	// Content 트리는 스레드 풀에서 훑어 모델 큐에 넣는다 - 위젯은 보이는 행만 만든다
+	TWeakPtr<FFtpFileListModel> WeakModel = Model;
+	Async(EAsyncExecution::ThreadPool, [WeakModel, ContentDir]()
+	{
+		IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+		PlatformFile.IterateDirectoryStatRecursively(*ContentDir, [&WeakModel, &ContentDir](const TCHAR* FilenameOrDirectory, const FFileStatData& StatData)
+		{
+			TSharedPtr<FFtpFileListModel> PinnedModel = WeakModel.Pin();
+			if (!PinnedModel.IsValid())
+			{
+				// 탭이 닫히면 검색 중단
+				return false;
+			}
+
+			if (!StatData.bIsDirectory)
+			{
+				FString RelativePath = FilenameOrDirectory;
+				FPaths::MakePathRelativeTo(RelativePath, *ContentDir);
+				PinnedModel->EnqueueAdd(RelativePath, StatData.FileSize, StatData.ModificationTime, EFtpListEntryStatus::None);
+			}
+			return true;
+		});
+	});
+
+	// 전송이 끝날 때마다 해당 행의 상태만 갱신
+	FDelegateHandle HistoryHandle = FFtpTransferHistory::Get().AddListener(FFtpTransferHistory::FOnTransferRecorded::FDelegate::CreateLambda(
+		[WeakModel, ContentDir](const FFtpTransferRecord& Record)
+		{
+			TSharedPtr<FFtpFileListModel> PinnedModel = WeakModel.Pin();
+			// 검증은 실패했을 때만 업로드 성공 표시를 덮어쓴다
+			const bool bVerifyFailure = Record.Direction == EFtpTransferDirection::Verify && !Record.bSuccess;
+			if (PinnedModel.IsValid() && (Record.Direction == EFtpTransferDirection::Upload || bVerifyFailure))
+			{
+				FString RelativePath = Record.LocalPath;
+				FPaths::MakePathRelativeTo(RelativePath, *ContentDir);
+				PinnedModel->EnqueueStatus(RelativePath, Record.bSuccess ? EFtpListEntryStatus::Succeeded : EFtpListEntryStatus::Failed);
+			}
+		}));
+
 	return SNew(SDockTab)
 		.TabRole(ETabRole::NomadTab)
+		.OnTabClosed_Lambda([HistoryHandle](TSharedRef<SDockTab>)
+		{
+			FFtpTransferHistory::Get().RemoveListener(HistoryHandle);
+		})
 		[
 			SNew(SVerticalBox)
 			+ SVerticalBox::Slot()
@@ -1025,16 +873,62 @@ TSharedRef<SDockTab> FFileUpLoadModule::SpawnFileManagerTab(const FSpawnTabArgs&
 			.FillHeight(1.0f)
 			.Padding(10)
 			[
-				SNew(STextBlock)
-				.Text(LOCTEXT("FileManagerContent", "File Manager content will be displayed here."))
+				SNew(SFtpFileListView)
+				.Model(Model)
+				.PathColumnLabel(LOCTEXT("FileManagerPathColumn", "Content Path"))
 			]
 		];
 }
 
 TSharedRef<SDockTab> FFileUpLoadModule::SpawnUploadHistoryTab(const FSpawnTabArgs& SpawnTabArgs)
 {
+	EnsureStyleInitialized();
+
+	// 이력은 같은 경로가 여러 번 나올 수 있으므로 중복을 허용한다
+	TSharedRef<FFtpFileListModel> Model = MakeShared<FFtpFileListModel>(false);
+
+	auto AddRecord = [](FFtpFileListModel& InModel, const FFtpTransferRecord& Record)
+	{
+		FString Path;
+		switch (Record.Direction)
+		{
+		case EFtpTransferDirection::Upload:
+			Path = Record.LocalPath + TEXT(" -> ") + Record.RemotePath;
+			break;
+		case EFtpTransferDirection::Download:
+			Path = Record.RemotePath + TEXT(" -> ") + Record.LocalPath;
+			break;
+		default:
+			Path = Record.LocalPath + TEXT(" == ") + Record.RemotePath;
+			break;
+		}
+		InModel.EnqueueAdd(Path, Record.Bytes, Record.Timestamp, Record.bSuccess ? EFtpListEntryStatus::Succeeded : EFtpListEntryStatus::Failed);
+	};
+
+	TArray<FFtpTransferRecord> Records;
+	FFtpTransferHistory::Get().GetRecords(Records);
+	for (const FFtpTransferRecord& Record : Records)
+	{
+		AddRecord(*Model, Record);
+	}
+
+	// 새 전송은 큐를 통해 점진적으로 추가
+	TWeakPtr<FFtpFileListModel> WeakModel = Model;
+	FDelegateHandle HistoryHandle = FFtpTransferHistory::Get().AddListener(FFtpTransferHistory::FOnTransferRecorded::FDelegate::CreateLambda(
+		[WeakModel, AddRecord](const FFtpTransferRecord& Record)
+		{
+			if (TSharedPtr<FFtpFileListModel> PinnedModel = WeakModel.Pin())
+			{
+				AddRecord(*PinnedModel, Record);
+			}
+		}));
+
 	return SNew(SDockTab)
 		.TabRole(ETabRole::NomadTab)
+		.OnTabClosed_Lambda([HistoryHandle](TSharedRef<SDockTab>)
+		{
+			FFtpTransferHistory::Get().RemoveListener(HistoryHandle);
+		})
 		[
 			SNew(SVerticalBox)
 			+ SVerticalBox::Slot()
@@ -1049,8 +943,9 @@ TSharedRef<SDockTab> FFileUpLoadModule::SpawnUploadHistoryTab(const FSpawnTabArg
 			.FillHeight(1.0f)
 			.Padding(10)
 			[
-				SNew(STextBlock)
-				.Text(LOCTEXT("UploadHistoryContent", "Upload history will be displayed here."))
+				SNew(SFtpFileListView)
+				.Model(Model)
+				.PathColumnLabel(LOCTEXT("UploadHistoryPathColumn", "Transfer"))
 			]
 		];
 }
@@ -0,0 +1,80 @@
+#include "FileUpLoadTrace.h"
+#include "FtpTransferHistory.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/CString.h"
+#include "ProfilingDebugging/MiscTrace.h"
+
+UE_TRACE_CHANNEL_DEFINE(FileUpLoadChannel);
+
+TRACE_DECLARE_INT_COUNTER(FtpInFlightTransfers, TEXT("FileUpLoad/InFlightTransfers"));
+TRACE_DECLARE_MEMORY_COUNTER(FtpBytesUploaded, TEXT("FileUpLoad/BytesUploaded"));
+TRACE_DECLARE_MEMORY_COUNTER(FtpBytesDownloaded, TEXT("FileUpLoad/BytesDownloaded"));
+TRACE_DECLARE_INT_COUNTER(FtpServerSessions, TEXT("FileUpLoad/ServerSessions"));
+TRACE_DECLARE_MEMORY_COUNTER(FtpServerBytesSent, TEXT("FileUpLoad/ServerBytesSent"));
+TRACE_DECLARE_MEMORY_COUNTER(FtpServerBytesReceived, TEXT("FileUpLoad/ServerBytesReceived"));
+TRACE_DECLARE_MEMORY_COUNTER(FtpBufferPoolInUse, TEXT("FileUpLoad/BufferPoolInUse"));
+
+UE_TRACE_EVENT_BEGIN(FileUpLoad, Transfer)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(int64, Bytes)
+	UE_TRACE_EVENT_FIELD(double, DurationSeconds)
+	UE_TRACE_EVENT_FIELD(uint8, Direction)
+	UE_TRACE_EVENT_FIELD(bool, bSuccess)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, LocalPath)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, RemotePath)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(FileUpLoad, CurlTimings)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(double, ConnectSeconds)
+	UE_TRACE_EVENT_FIELD(double, PreTransferSeconds)
+	UE_TRACE_EVENT_FIELD(double, StartTransferSeconds)
+	UE_TRACE_EVENT_FIELD(double, TotalSeconds)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, RemotePath)
+UE_TRACE_EVENT_END()
+
+namespace FtpTrace
+{
+	void TransferRecorded(const FFtpTransferRecord& Record)
+	{
+		if (Record.bSuccess)
+		{
+			if (Record.Direction == EFtpTransferDirection::Upload)
+			{
+				TRACE_COUNTER_ADD(FtpBytesUploaded, Record.Bytes);
+			}
+			else if (Record.Direction == EFtpTransferDirection::Download)
+			{
+				TRACE_COUNTER_ADD(FtpBytesDownloaded, Record.Bytes);
+			}
+		}
+
+		UE_TRACE_LOG(FileUpLoad, Transfer, FileUpLoadChannel)
+			<< Transfer.Cycle(FPlatformTime::Cycles64())
+			<< Transfer.Bytes(Record.Bytes)
+			<< Transfer.DurationSeconds(Record.DurationSeconds)
+			<< Transfer.Direction((uint8)Record.Direction)
+			<< Transfer.bSuccess(Record.bSuccess)
+			<< Transfer.LocalPath(*Record.LocalPath, Record.LocalPath.Len())
+			<< Transfer.RemotePath(*Record.RemotePath, Record.RemotePath.Len());
+	}
+
+	void CurlTimings(const FString& RemotePath, double ConnectSeconds, double PreTransferSeconds, double StartTransferSeconds, double TotalSeconds)
+	{
+		UE_TRACE_LOG(FileUpLoad, CurlTimings, FileUpLoadChannel)
+			<< CurlTimings.Cycle(FPlatformTime::Cycles64())
+			<< CurlTimings.ConnectSeconds(ConnectSeconds)
+			<< CurlTimings.PreTransferSeconds(PreTransferSeconds)
+			<< CurlTimings.StartTransferSeconds(StartTransferSeconds)
+			<< CurlTimings.TotalSeconds(TotalSeconds)
+			<< CurlTimings.RemotePath(*RemotePath, RemotePath.Len());
+	}
+
+	void Bookmark(const FString& Text)
+	{
+		if (UE_TRACE_CHANNELEXPR_IS_ENABLED(FileUpLoadChannel))
+		{
+			TRACE_BOOKMARK(TEXT("%s"), *Text);
+		}
+	}
+}
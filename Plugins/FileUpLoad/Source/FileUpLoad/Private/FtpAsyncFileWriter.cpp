@@ -0,0 +1,381 @@
+#include "FtpAsyncFileWriter.h"
+#include "FtpSystem.h"
+#include "FileUpLoadTrace.h"
+#include "Async/Async.h"
+#include "HAL/Event.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/Paths.h"
+
+#if PLATFORM_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <limits.h>
+#include <sys/uio.h>
+#endif
+
+namespace FtpAsyncFileWriterInternal
+{
+	// 열린 쓰기 수 - 풀 예산을 나눠 가진다
+	static TAtomic<int32> GOpenWriters(0);
+}
+
+FFtpAsyncFileWriter::FBuffer* FFtpAsyncFileWriter::AcquireBuffer(int32 Size)
+{
+	FBuffer* Buffer = new FBuffer();
+	Buffer->Slab = FFtpBufferPool::Acquire(Size);
+	Buffer->Data = Buffer->Slab.GetData();
+	return Buffer;
+}
+
+int32 FFtpAsyncFileWriter::ChooseNextBufferSize() const
+{
+	const int64 Remaining = ExpectedSize - Offset;
+	if (ExpectedSize >= 0 && Remaining > 0)
+	{
+		return (int32)FMath::Clamp<int64>(Remaining, MinBufferSize, MaxBufferSize);
+	}
+
+	// 크기를 모르거나 예상보다 커졌으면 64KB부터 네 배씩 키운다
+	return LastBufferSize == 0 ? MinBufferSize : FMath::Min(LastBufferSize * 4, MaxBufferSize);
+}
+
+int64 FFtpAsyncFileWriter::GetMaxInFlightBytes(int32 NextBufferSize) const
+{
+	const int64 Share = FFtpBufferPool::GetBudgetBytes() / FMath::Max(FtpAsyncFileWriterInternal::GOpenWriters.Load(), 1);
+
+	// 몫이 작아도 하나는 쓰는 동안 하나는 채울 수 있어야 한다
+	return FMath::Max<int64>(Share, 2LL * NextBufferSize);
+}
+
+void FFtpAsyncFileWriter::ReleaseBuffer(FBuffer* Buffer)
+{
+	// 슬랩은 소멸자가 풀로 돌려준다
+	delete Buffer;
+}
+
+FFtpAsyncFileWriter::FFtpAsyncFileWriter()
+	: InFlightBytes(0)
+	, ActiveDrains(0)
+	, bDraining(false)
+	, bWriteFailed(false)
+	, ProgressEvent(FPlatformProcess::GetSynchEventFromPool(false))
+{
+}
+
+FFtpAsyncFileWriter::~FFtpAsyncFileWriter()
+{
+	if (bOpen)
+	{
+		Close();
+	}
+
+	FPlatformProcess::ReturnSynchEventToPool(ProgressEvent);
+	ProgressEvent = nullptr;
+}
+
+bool FFtpAsyncFileWriter::Open(const FString& InPath, int64 InExpectedSize)
+{
+	Path = InPath;
+	Offset = 0;
+	ExpectedSize = InExpectedSize;
+	LastBufferSize = 0;
+	CacheDroppedUpTo = 0;
+	bWriteFailed = false;
+
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(Path), true);
+
+#if PLATFORM_LINUX
+	const FString FullPath = FPaths::ConvertRelativePathToFull(Path);
+	bDirectIo = ExpectedSize >= DirectIoThreshold;
+
+	int Flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+	FileDescriptor = open(TCHAR_TO_UTF8(*FullPath), Flags | (bDirectIo ? O_DIRECT : 0), 0644);
+	if (FileDescriptor < 0 && bDirectIo)
+	{
+		// tmpfs 등 O_DIRECT를 지원하지 않는 파일 시스템
+		bDirectIo = false;
+		FileDescriptor = open(TCHAR_TO_UTF8(*FullPath), Flags, 0644);
+	}
+	if (FileDescriptor < 0)
+	{
+		LogFtpMessage(FString::Printf(TEXT("Async writer: cannot open %s (errno %d)"), *Path, errno), true);
+		return false;
+	}
+
+	// 미리 공간을 잡아 조각화와 쓰는 도중의 공간 부족을 피한다
+	if (ExpectedSize > 0)
+	{
+		const int Result = posix_fallocate(FileDescriptor, 0, ExpectedSize);
+		if (Result != 0)
+		{
+			LogFtpMessage(FString::Printf(TEXT("Async writer: fallocate failed for %s (%d), continuing without preallocation"), *Path, Result));
+		}
+		posix_fadvise(FileDescriptor, 0, 0, POSIX_FADV_SEQUENTIAL);
+	}
+#else
+	FileHandle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*Path));
+	if (!FileHandle.IsValid())
+	{
+		LogFtpMessage(FString::Printf(TEXT("Async writer: cannot open %s"), *Path), true);
+		return false;
+	}
+#endif
+
+	bOpen = true;
+	++FtpAsyncFileWriterInternal::GOpenWriters;
+	return true;
+}
+
+void FFtpAsyncFileWriter::Append(const uint8* Data, int64 Size)
+{
+	while (Size > 0)
+	{
+		if (Current == nullptr)
+		{
+			// 디스크가 한참 뒤처졌을 때만 멈춘다 - 메모리를 무한히 쓰지 않기 위한 상한
+			const int32 NextBufferSize = ChooseNextBufferSize();
+			WaitForInFlight(GetMaxInFlightBytes(NextBufferSize) - NextBufferSize);
+
+			Current = AcquireBuffer(NextBufferSize);
+			Current->FileOffset = Offset;
+			Current->Length = 0;
+			LastBufferSize = Current->Slab.GetSize();
+		}
+
+		const int32 Capacity = Current->Slab.GetSize();
+		const int32 CopySize = (int32)FMath::Min<int64>(Size, Capacity - Current->Length);
+		FMemory::Memcpy(Current->Data + Current->Length, Data, CopySize);
+		Current->Length += CopySize;
+		Offset += CopySize;
+		Data += CopySize;
+		Size -= CopySize;
+
+		if (Current->Length == Capacity)
+		{
+			Submit(Current);
+			Current = nullptr;
+		}
+	}
+}
+
+void FFtpAsyncFileWriter::Submit(FBuffer* Buffer)
+{
+	InFlightBytes += Buffer->Slab.GetSize();
+	Submitted.Enqueue(Buffer);
+
+	// 쓰기 작업이 없을 때만 새로 띄운다 - 동시에 하나만 돌아 순서대로 쓴다
+	if (!bDraining.Exchange(true))
+	{
+		++ActiveDrains;
+		Async(EAsyncExecution::ThreadPool, [this]()
+		{
+			Drain();
+
+			// Close가 이 값이 0이 되기를 기다리므로 this를 건드리는 마지막 동작이어야 한다
+			--ActiveDrains;
+		});
+	}
+}
+
+void FFtpAsyncFileWriter::Drain()
+{
+	constexpr int32 MaxBatchBuffers = 16;
+
+	while (true)
+	{
+		TArray<FBuffer*> Batch;
+		Batch.Reserve(MaxBatchBuffers);
+		FBuffer* Buffer = nullptr;
+		while (Batch.Num() < MaxBatchBuffers && Submitted.Dequeue(Buffer))
+		{
+			Batch.Add(Buffer);
+		}
+
+		if (Batch.Num() == 0)
+		{
+			bDraining = false;
+
+			// 내려놓는 사이에 들어온 버퍼가 있으면 다시 맡는다
+			if (Submitted.IsEmpty() || bDraining.Exchange(true))
+			{
+				break;
+			}
+			continue;
+		}
+
+		WriteBatch(Batch);
+
+		int64 BatchBytes = 0;
+		for (FBuffer* Written : Batch)
+		{
+			BatchBytes += Written->Slab.GetSize();
+			ReleaseBuffer(Written);
+		}
+		InFlightBytes -= BatchBytes;
+		ProgressEvent->Trigger();
+	}
+}
+
+void FFtpAsyncFileWriter::WriteBatch(const TArray<FBuffer*>& Batch)
+{
+	FTP_TRACE_SCOPE(DiskWrite);
+
+	if (bWriteFailed)
+	{
+		return;
+	}
+
+#if PLATFORM_LINUX
+	// 파일 위치가 이어지는 버퍼들을 pwritev 한 번으로 보낸다
+	int32 First = 0;
+	while (First < Batch.Num())
+	{
+		int32 Last = First + 1;
+		while (Last < Batch.Num() && Last - First < IOV_MAX
+			&& Batch[Last]->FileOffset == Batch[Last - 1]->FileOffset + Batch[Last - 1]->Length)
+		{
+			++Last;
+		}
+
+		TArray<iovec, TInlineAllocator<16>> Vectors;
+		int64 RunLength = 0;
+		for (int32 Index = First; Index < Last; ++Index)
+		{
+			// O_DIRECT는 길이도 정렬되어야 하므로 마지막 짧은 버퍼는 0으로 채우고 Close에서 잘라낸다
+			int32 Length = Batch[Index]->Length;
+			if (bDirectIo && (Length % BufferAlignment) != 0)
+			{
+				const int32 Padded = Align(Length, BufferAlignment);
+				FMemory::Memzero(Batch[Index]->Data + Length, Padded - Length);
+				Length = Padded;
+			}
+
+			iovec& Vector = Vectors.AddDefaulted_GetRef();
+			Vector.iov_base = Batch[Index]->Data;
+			Vector.iov_len = Length;
+			RunLength += Length;
+		}
+
+		const int64 RunOffset = Batch[First]->FileOffset;
+		int64 Done = 0;
+		int32 VectorIndex = 0;
+		while (Done < RunLength)
+		{
+			const ssize_t Result = pwritev(FileDescriptor, Vectors.GetData() + VectorIndex, Vectors.Num() - VectorIndex, RunOffset + Done);
+			if (Result < 0 && errno == EINTR)
+			{
+				continue;
+			}
+			if (Result <= 0)
+			{
+				LogFtpMessage(FString::Printf(TEXT("Async writer: write failed for %s (errno %d)"), *Path, errno), true);
+				bWriteFailed = true;
+				return;
+			}
+
+			// 부분 쓰기 - 남은 벡터만 다시 보낸다
+			Done += Result;
+			int64 Consumed = Result;
+			while (VectorIndex < Vectors.Num() && Consumed >= (int64)Vectors[VectorIndex].iov_len)
+			{
+				Consumed -= Vectors[VectorIndex].iov_len;
+				++VectorIndex;
+			}
+			if (VectorIndex < Vectors.Num() && Consumed > 0)
+			{
+				Vectors[VectorIndex].iov_base = (uint8*)Vectors[VectorIndex].iov_base + Consumed;
+				Vectors[VectorIndex].iov_len -= Consumed;
+			}
+		}
+
+		// 버퍼드 쓰기: 이번 구간은 바로 쓰기 시작하고, 앞 구간은 다 써진 뒤 캐시에서 내린다
+		if (!bDirectIo && RunOffset + RunLength >= DropCacheThreshold)
+		{
+			if (RunOffset > CacheDroppedUpTo)
+			{
+				sync_file_range(FileDescriptor, CacheDroppedUpTo, RunOffset - CacheDroppedUpTo, SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+				posix_fadvise(FileDescriptor, CacheDroppedUpTo, RunOffset - CacheDroppedUpTo, POSIX_FADV_DONTNEED);
+				CacheDroppedUpTo = RunOffset;
+			}
+			sync_file_range(FileDescriptor, RunOffset, RunLength, SYNC_FILE_RANGE_WRITE);
+		}
+
+		First = Last;
+	}
+#else
+	for (const FBuffer* Buffer : Batch)
+	{
+		if (FileHandle->Tell() != Buffer->FileOffset)
+		{
+			FileHandle->Seek(Buffer->FileOffset);
+		}
+		if (!FileHandle->Write(Buffer->Data, Buffer->Length))
+		{
+			LogFtpMessage(FString::Printf(TEXT("Async writer: write failed for %s"), *Path), true);
+			bWriteFailed = true;
+			return;
+		}
+	}
+#endif
+}
+
+void FFtpAsyncFileWriter::WaitForInFlight(int64 MaxBytes)
+{
+	while (InFlightBytes > MaxBytes || (MaxBytes == 0 && ActiveDrains > 0))
+	{
+		ProgressEvent->Wait(10);
+	}
+}
+
+bool FFtpAsyncFileWriter::Close()
+{
+	if (!bOpen)
+	{
+		return false;
+	}
+
+	if (Current != nullptr)
+	{
+		if (Current->Length > 0)
+		{
+			Submit(Current);
+		}
+		else
+		{
+			ReleaseBuffer(Current);
+		}
+		Current = nullptr;
+	}
+
+	WaitForInFlight(0);
+	bOpen = false;
+	--FtpAsyncFileWriterInternal::GOpenWriters;
+
+	bool bSuccess = !bWriteFailed;
+
+#if PLATFORM_LINUX
+	// O_DIRECT 패딩과 과하게 잡은 선할당을 실제 크기로 자른다
+	if (ftruncate(FileDescriptor, Offset) != 0)
+	{
+		bSuccess = false;
+	}
+	if (!bDirectIo && Offset >= DropCacheThreshold)
+	{
+		fdatasync(FileDescriptor);
+		posix_fadvise(FileDescriptor, 0, 0, POSIX_FADV_DONTNEED);
+	}
+	bSuccess &= close(FileDescriptor) == 0;
+	FileDescriptor = -1;
+#else
+	if (FileHandle.IsValid())
+	{
+		bSuccess &= FileHandle->Flush();
+		FileHandle.Reset();
+	}
+#endif
+
+	return bSuccess;
+}
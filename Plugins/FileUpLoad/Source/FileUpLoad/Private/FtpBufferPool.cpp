@@ -0,0 +1,517 @@
+#include "FtpBufferPool.h"
+#include "FtpSystem.h"
+#include "FileUpLoadStats.h"
+#include "FileUpLoadTrace.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+#include "Misc/ScopeLock.h"
+
+DECLARE_MEMORY_STAT(TEXT("Buffer Pool Committed"), STAT_FileUpLoad_BufferPoolCommitted, STATGROUP_FileUpLoad);
+DECLARE_MEMORY_STAT(TEXT("Buffer Pool In Use"), STAT_FileUpLoad_BufferPoolInUse, STATGROUP_FileUpLoad);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Buffer Pool Buffers In Use"), STAT_FileUpLoad_BufferPoolBuffers, STATGROUP_FileUpLoad);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Buffer Pool Waits"), STAT_FileUpLoad_BufferPoolWaits, STATGROUP_FileUpLoad);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Buffer Pool Overcommits"), STAT_FileUpLoad_BufferPoolOvercommits, STATGROUP_FileUpLoad);
+
+namespace FtpBufferPoolInternal
+{
+	static constexpr int32 NumSizeClasses = 4;
+	static constexpr int32 SlabSizes[NumSizeClasses] = { 64 * 1024, 256 * 1024, 1024 * 1024, 4 * 1024 * 1024 };
+	static_assert(SlabSizes[0] == FFtpBufferPool::MinSlabSize && SlabSizes[NumSizeClasses - 1] == FFtpBufferPool::MaxSlabSize, "slab size table");
+
+	// 이 크기 이하의 슬랩만 스레드 캐시에 둔다
+	static constexpr int32 MaxThreadCachedSlabSize = 1024 * 1024;
+
+	// 스레드 하나가 캐시에 쥘 수 있는 최대 바이트 - 예산이 차기 전에는 다른 스레드가 거둬 가지 않으므로 작게 둔다
+	static constexpr int64 ThreadCacheBytes = 1024 * 1024;
+
+	// 전역 빈 목록은 예산의 1/4까지만 남기고 넘는 반납은 바로 해제한다 (쉬는 동안의 사용량을 낮게)
+	static constexpr int64 IdleBudgetDivisor = 4;
+
+	// 예산을 기다리는 스레드가 반납 신호를 놓쳤을 때 다시 확인하는 간격
+	static constexpr uint32 WaitIntervalMs = 10;
+
+	static int32 GetSizeClass(int32 MinSize)
+	{
+		for (int32 SizeClass = 0; SizeClass < NumSizeClasses; ++SizeClass)
+		{
+			if (MinSize <= SlabSizes[SizeClass])
+			{
+				return SizeClass;
+			}
+		}
+		return NumSizeClasses - 1;
+	}
+
+	// -FtpBufferBudgetMB=<N>: 풀을 처음 쓸 때 한 번 읽는다 (모듈 시작 비용에 넣지 않는다)
+	static int64 GetInitialBudgetBytes()
+	{
+		int32 BudgetMB = 0;
+		if (FParse::Value(FCommandLine::Get(), TEXT("FtpBufferBudgetMB="), BudgetMB) && BudgetMB > 0)
+		{
+			return FMath::Max<int64>((int64)BudgetMB * 1024 * 1024, FFtpBufferPool::MaxSlabSize);
+		}
+		return FFtpBufferPool::DefaultBudgetBytes;
+	}
+
+	struct FThreadCache;
+
+	struct FGlobalState
+	{
+		FCriticalSection Lock;
+
+		// Lock 안에서만
+		TArray<uint8*> FreeSlabs[NumSizeClasses];
+		// 살아 있는 스레드 캐시 - 예산이 차면 여기서 거둬 간다. 잠금 순서는 Lock 다음에 캐시의 Lock
+		TArray<FThreadCache*> ThreadCaches;
+		int64 FreeBytes = 0;
+		int64 CommittedBytes = 0;
+		int64 BudgetBytes = GetInitialBudgetBytes();
+
+		TAtomic<int64> InUseBytes{ 0 };
+		TAtomic<int32> InUseBuffers{ 0 };
+		// 예산을 기다리는 스레드 수 - 0이 아니면 반납을 스레드 캐시에 두지 않는다
+		TAtomic<int32> NumWaiting{ 0 };
+		TAtomic<uint64> Acquires{ 0 };
+		TAtomic<uint64> Waits{ 0 };
+		TAtomic<uint64> Overcommits{ 0 };
+		TAtomic<bool> bOvercommitLogged{ false };
+
+		FEvent* ReleasedEvent = FPlatformProcess::GetSynchEventFromPool(false);
+	};
+
+	// 스레드 캐시는 종료 순서와 상관없이 반납할 수 있어야 하므로 해제하지 않는다
+	static FGlobalState& GetState()
+	{
+		static FGlobalState* State = new FGlobalState();
+		return *State;
+	}
+
+	// 빈 슬랩을 전역 목록에 두거나, 예산을 넘었거나 쉬는 슬랩이 많으면 해제한다
+	static void ReturnToGlobal(uint8* Data, int32 SizeClass)
+	{
+		FGlobalState& State = GetState();
+		const int32 SlabSize = SlabSizes[SizeClass];
+
+		bool bFree = false;
+		int64 Committed = 0;
+		{
+			FScopeLock ScopeLock(&State.Lock);
+			bFree = State.CommittedBytes > State.BudgetBytes || State.FreeBytes + SlabSize > State.BudgetBytes / IdleBudgetDivisor;
+			if (bFree)
+			{
+				State.CommittedBytes -= SlabSize;
+			}
+			else
+			{
+				State.FreeSlabs[SizeClass].Push(Data);
+				State.FreeBytes += SlabSize;
+			}
+			Committed = State.CommittedBytes;
+		}
+
+		if (bFree)
+		{
+			FMemory::Free(Data);
+		}
+		SET_MEMORY_STAT(STAT_FileUpLoad_BufferPoolCommitted, Committed);
+		State.ReleasedEvent->Trigger();
+	}
+
+	struct FThreadCache
+	{
+		// 주인 스레드와 거둬 가는 스레드 사이 - 주인은 이 잠금을 쥔 채 전역 Lock을 잡지 않는다
+		FCriticalSection Lock;
+		TArray<uint8*, TInlineAllocator<16>> Slabs[NumSizeClasses];
+		int64 Bytes = 0;
+
+		// 주인 스레드만 쓴다 - 이 시각까지는 예산이 차도 기다리지 않고 넘겨 받는다
+		double OvercommitGraceUntil = 0.0;
+
+		FThreadCache()
+		{
+			FGlobalState& State = GetState();
+			FScopeLock ScopeLock(&State.Lock);
+			State.ThreadCaches.Add(this);
+		}
+
+		~FThreadCache()
+		{
+			FGlobalState& State = GetState();
+			{
+				FScopeLock ScopeLock(&State.Lock);
+				State.ThreadCaches.RemoveSingleSwap(this);
+			}
+
+			for (int32 SizeClass = 0; SizeClass < NumSizeClasses; ++SizeClass)
+			{
+				for (uint8* Data : Slabs[SizeClass])
+				{
+					ReturnToGlobal(Data, SizeClass);
+				}
+			}
+		}
+	};
+
+	static thread_local FThreadCache GThreadCache;
+
+	// 모든 스레드 캐시를 전역 빈 목록으로 옮긴다. State.Lock 안에서 부른다
+	static void ReclaimThreadCachesLocked(FGlobalState& State)
+	{
+		for (FThreadCache* Cache : State.ThreadCaches)
+		{
+			FScopeLock CacheLock(&Cache->Lock);
+			for (int32 SizeClass = 0; SizeClass < NumSizeClasses; ++SizeClass)
+			{
+				State.FreeSlabs[SizeClass].Append(Cache->Slabs[SizeClass].GetData(), Cache->Slabs[SizeClass].Num());
+				State.FreeBytes += (int64)Cache->Slabs[SizeClass].Num() * SlabSizes[SizeClass];
+				Cache->Slabs[SizeClass].Reset();
+			}
+			Cache->Bytes = 0;
+		}
+	}
+}
+
+FFtpPooledBuffer::~FFtpPooledBuffer()
+{
+	Release();
+}
+
+FFtpPooledBuffer::FFtpPooledBuffer(FFtpPooledBuffer&& Other)
+	: Data(Other.Data)
+	, Size(Other.Size)
+	, SizeClass(Other.SizeClass)
+{
+	Other.Data = nullptr;
+	Other.Size = 0;
+}
+
+FFtpPooledBuffer& FFtpPooledBuffer::operator=(FFtpPooledBuffer&& Other)
+{
+	if (this != &Other)
+	{
+		Release();
+		Data = Other.Data;
+		Size = Other.Size;
+		SizeClass = Other.SizeClass;
+		Other.Data = nullptr;
+		Other.Size = 0;
+	}
+	return *this;
+}
+
+void FFtpPooledBuffer::Release()
+{
+	if (Data != nullptr)
+	{
+		FFtpBufferPool::Release(Data, SizeClass);
+		Data = nullptr;
+		Size = 0;
+	}
+}
+
+FFtpPooledBuffer FFtpBufferPool::Acquire(int32 MinSize)
+{
+	return AcquireInternal(MinSize, true);
+}
+
+FFtpPooledBuffer FFtpBufferPool::TryAcquire(int32 MinSize)
+{
+	return AcquireInternal(MinSize, false);
+}
+
+FFtpPooledBuffer FFtpBufferPool::AcquireInternal(int32 MinSize, bool bWait)
+{
+	using namespace FtpBufferPoolInternal;
+
+	FFtpPooledBuffer Buffer;
+	if (MinSize > MaxSlabSize)
+	{
+		LogFtpMessage(FString::Printf(TEXT("Buffer pool: %d bytes requested, slabs are at most %d bytes"), MinSize, MaxSlabSize), true);
+		return Buffer;
+	}
+
+	FGlobalState& State = GetState();
+	const int32 SizeClass = GetSizeClass(MinSize);
+	const int32 SlabSize = SlabSizes[SizeClass];
+
+	// 1. 이 스레드의 캐시 - 거둬 가는 스레드와만 다투는 잠금
+	uint8* Data = nullptr;
+	FThreadCache& Cache = GThreadCache;
+	{
+		FScopeLock CacheLock(&Cache.Lock);
+		if (Cache.Slabs[SizeClass].Num() > 0)
+		{
+			Data = Cache.Slabs[SizeClass].Pop();
+			Cache.Bytes -= SlabSize;
+		}
+	}
+
+	// 최근에 예산을 넘겨 받은 스레드는 다시 기다리지 않는다
+	const bool bInOvercommitGrace = bWait && FPlatformTime::Seconds() < Cache.OvercommitGraceUntil;
+
+	// 2. 전역 빈 목록 (모자라면 스레드 캐시를 거둬 온다), 3. 예산 안에서 새 슬랩, 4. 반납을 기다림
+	bool bAllocate = false;
+	bool bOvercommit = false;
+	bool bWaiting = false;
+	double Deadline = 0.0;
+	while (Data == nullptr && !bAllocate)
+	{
+		TArray<uint8*, TInlineAllocator<16>> Reclaimed;
+		int64 Committed = 0;
+		{
+			FScopeLock ScopeLock(&State.Lock);
+			if (State.FreeSlabs[SizeClass].Num() == 0 && State.CommittedBytes + SlabSize > State.BudgetBytes)
+			{
+				ReclaimThreadCachesLocked(State);
+			}
+
+			if (State.FreeSlabs[SizeClass].Num() > 0)
+			{
+				Data = State.FreeSlabs[SizeClass].Pop();
+				State.FreeBytes -= SlabSize;
+			}
+			else
+			{
+				// 예산이 모자라면 다른 크기의 빈 슬랩부터 해제한다 (큰 것부터)
+				for (int32 Other = NumSizeClasses - 1; Other >= 0 && State.CommittedBytes + SlabSize > State.BudgetBytes; --Other)
+				{
+					while (State.FreeSlabs[Other].Num() > 0 && State.CommittedBytes + SlabSize > State.BudgetBytes)
+					{
+						Reclaimed.Add(State.FreeSlabs[Other].Pop());
+						State.FreeBytes -= SlabSizes[Other];
+						State.CommittedBytes -= SlabSizes[Other];
+					}
+				}
+
+				bOvercommit = State.CommittedBytes + SlabSize > State.BudgetBytes
+					&& (bInOvercommitGrace || (bWaiting && FPlatformTime::Seconds() >= Deadline));
+				if (State.CommittedBytes + SlabSize <= State.BudgetBytes || bOvercommit)
+				{
+					State.CommittedBytes += SlabSize;
+					bAllocate = true;
+				}
+			}
+			Committed = State.CommittedBytes;
+		}
+
+		for (uint8* ReclaimedData : Reclaimed)
+		{
+			FMemory::Free(ReclaimedData);
+		}
+		SET_MEMORY_STAT(STAT_FileUpLoad_BufferPoolCommitted, Committed);
+
+		if (Data != nullptr || bAllocate)
+		{
+			break;
+		}
+		if (!bWait)
+		{
+			return Buffer;
+		}
+
+		if (!bWaiting)
+		{
+			bWaiting = true;
+			Deadline = FPlatformTime::Seconds() + MaxWaitSeconds;
+			++State.NumWaiting;
+			++State.Waits;
+			INC_DWORD_STAT(STAT_FileUpLoad_BufferPoolWaits);
+		}
+		State.ReleasedEvent->Wait(WaitIntervalMs);
+	}
+
+	if (bWaiting)
+	{
+		--State.NumWaiting;
+	}
+
+	Cache.OvercommitGraceUntil = bOvercommit ? FPlatformTime::Seconds() + MaxWaitSeconds : 0.0;
+
+	if (bOvercommit)
+	{
+		++State.Overcommits;
+		INC_DWORD_STAT(STAT_FileUpLoad_BufferPoolOvercommits);
+		if (!State.bOvercommitLogged.Exchange(true))
+		{
+			LogFtpMessage(FString::Printf(TEXT("Buffer pool: budget of %lld MB exhausted for %.0f s, allocating over budget"),
+				GetBudgetBytes() / (1024 * 1024), MaxWaitSeconds));
+		}
+	}
+
+	if (bAllocate)
+	{
+		Data = (uint8*)FMemory::Malloc(SlabSize, Alignment);
+	}
+
+	Buffer.Data = Data;
+	Buffer.Size = SlabSize;
+	Buffer.SizeClass = SizeClass;
+
+	const int64 InUse = (State.InUseBytes += SlabSize);
+	++State.InUseBuffers;
+	++State.Acquires;
+	INC_MEMORY_STAT_BY(STAT_FileUpLoad_BufferPoolInUse, SlabSize);
+	INC_DWORD_STAT(STAT_FileUpLoad_BufferPoolBuffers);
+	TRACE_COUNTER_SET(FtpBufferPoolInUse, InUse);
+	return Buffer;
+}
+
+void FFtpBufferPool::Release(uint8* Data, int32 SizeClass)
+{
+	using namespace FtpBufferPoolInternal;
+
+	FGlobalState& State = GetState();
+	const int32 SlabSize = SlabSizes[SizeClass];
+
+	const int64 InUse = (State.InUseBytes -= SlabSize);
+	--State.InUseBuffers;
+	DEC_MEMORY_STAT_BY(STAT_FileUpLoad_BufferPoolInUse, SlabSize);
+	DEC_DWORD_STAT(STAT_FileUpLoad_BufferPoolBuffers);
+	TRACE_COUNTER_SET(FtpBufferPoolInUse, InUse);
+
+	// 기다리는 스레드가 없으면 이 스레드가 곧 다시 쓸 것으로 보고 캐시에 둔다
+	if (SlabSize <= MaxThreadCachedSlabSize && State.NumWaiting == 0)
+	{
+		FThreadCache& Cache = GThreadCache;
+		FScopeLock CacheLock(&Cache.Lock);
+		if (Cache.Bytes + SlabSize <= ThreadCacheBytes)
+		{
+			Cache.Slabs[SizeClass].Push(Data);
+			Cache.Bytes += SlabSize;
+			return;
+		}
+	}
+
+	ReturnToGlobal(Data, SizeClass);
+}
+
+bool FFtpBufferPool::HasCapacity(int64 Bytes)
+{
+	using namespace FtpBufferPoolInternal;
+
+	FGlobalState& State = GetState();
+	FScopeLock ScopeLock(&State.Lock);
+
+	// 빈 슬랩은 다른 크기로 바꿔 쓸 수 있으므로 쓰는 중인 것만 센다
+	return State.CommittedBytes - State.FreeBytes + Bytes <= State.BudgetBytes;
+}
+
+bool FFtpBufferPool::WaitForCapacity(int64 Bytes, double TimeoutSeconds)
+{
+	using namespace FtpBufferPoolInternal;
+
+	if (HasCapacity(Bytes))
+	{
+		return true;
+	}
+
+	FGlobalState& State = GetState();
+	++State.NumWaiting;
+	++State.Waits;
+	INC_DWORD_STAT(STAT_FileUpLoad_BufferPoolWaits);
+
+	const double Deadline = FPlatformTime::Seconds() + TimeoutSeconds;
+	bool bHasCapacity = false;
+	while (!(bHasCapacity = HasCapacity(Bytes)) && FPlatformTime::Seconds() < Deadline)
+	{
+		State.ReleasedEvent->Wait(WaitIntervalMs);
+	}
+
+	--State.NumWaiting;
+	return bHasCapacity;
+}
+
+void FFtpBufferPool::SetBudgetBytes(int64 Bytes)
+{
+	using namespace FtpBufferPoolInternal;
+
+	FGlobalState& State = GetState();
+	TArray<uint8*> Reclaimed;
+	int64 Committed = 0;
+	{
+		FScopeLock ScopeLock(&State.Lock);
+
+		// 가장 큰 슬랩 하나는 언제나 빌릴 수 있어야 한다
+		State.BudgetBytes = FMath::Max<int64>(Bytes, MaxSlabSize);
+		for (int32 SizeClass = 0; SizeClass < NumSizeClasses; ++SizeClass)
+		{
+			while (State.FreeSlabs[SizeClass].Num() > 0 && State.CommittedBytes > State.BudgetBytes)
+			{
+				Reclaimed.Add(State.FreeSlabs[SizeClass].Pop());
+				State.FreeBytes -= SlabSizes[SizeClass];
+				State.CommittedBytes -= SlabSizes[SizeClass];
+			}
+		}
+		Committed = State.CommittedBytes;
+	}
+
+	for (uint8* Data : Reclaimed)
+	{
+		FMemory::Free(Data);
+	}
+	SET_MEMORY_STAT(STAT_FileUpLoad_BufferPoolCommitted, Committed);
+
+	// 예산을 늘렸으면 기다리던 스레드가 바로 할당할 수 있다
+	State.ReleasedEvent->Trigger();
+}
+
+int64 FFtpBufferPool::GetBudgetBytes()
+{
+	using namespace FtpBufferPoolInternal;
+
+	FGlobalState& State = GetState();
+	FScopeLock ScopeLock(&State.Lock);
+	return State.BudgetBytes;
+}
+
+void FFtpBufferPool::Trim()
+{
+	using namespace FtpBufferPoolInternal;
+
+	FGlobalState& State = GetState();
+	TArray<uint8*> Reclaimed;
+	int64 Committed = 0;
+	{
+		FScopeLock ScopeLock(&State.Lock);
+		for (int32 SizeClass = 0; SizeClass < NumSizeClasses; ++SizeClass)
+		{
+			Reclaimed.Append(State.FreeSlabs[SizeClass]);
+			State.CommittedBytes -= (int64)State.FreeSlabs[SizeClass].Num() * SlabSizes[SizeClass];
+			State.FreeSlabs[SizeClass].Empty();
+		}
+		State.FreeBytes = 0;
+		Committed = State.CommittedBytes;
+	}
+
+	for (uint8* Data : Reclaimed)
+	{
+		FMemory::Free(Data);
+	}
+	SET_MEMORY_STAT(STAT_FileUpLoad_BufferPoolCommitted, Committed);
+}
+
+FFtpBufferPoolStats FFtpBufferPool::GetStats()
+{
+	using namespace FtpBufferPoolInternal;
+
+	FGlobalState& State = GetState();
+	FFtpBufferPoolStats Stats;
+	{
+		FScopeLock ScopeLock(&State.Lock);
+		Stats.BudgetBytes = State.BudgetBytes;
+		Stats.CommittedBytes = State.CommittedBytes;
+		for (int32 SizeClass = 0; SizeClass < NumSizeClasses; ++SizeClass)
+		{
+			Stats.FreeBuffers += State.FreeSlabs[SizeClass].Num();
+		}
+	}
+	Stats.InUseBytes = State.InUseBytes;
+	Stats.InUseBuffers = State.InUseBuffers;
+	Stats.Acquires = State.Acquires;
+	Stats.Waits = State.Waits;
+	Stats.Overcommits = State.Overcommits;
+	return Stats;
+}
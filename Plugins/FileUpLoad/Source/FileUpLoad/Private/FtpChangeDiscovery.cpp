@@ -0,0 +1,609 @@
+#include "FtpChangeDiscovery.h"
+#include "FtpPathTable.h"
+#include "FtpUploadOrder.h"
+#include "FileUpLoadStats.h"
+#include "FileUpLoadTrace.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "AssetRegistry/AssetData.h"
+#include "AssetRegistry/ARFilter.h"
+#include "Async/Async.h"
+#include "FileHelpers.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "ISourceControlModule.h"
+#include "ISourceControlProvider.h"
+#include "SourceControlOperations.h"
+#include "Misc/Crc.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "UObject/ObjectSaveContext.h"
+#include "UObject/Package.h"
+
+DECLARE_CYCLE_STAT(TEXT("Discover Changes"), STAT_FileUpLoad_DiscoverChanges, STATGROUP_FileUpLoad);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Discovered Files"), STAT_FileUpLoad_DiscoveredFiles, STATGROUP_FileUpLoad);
+
+namespace FtpChangeDiscovery
+{
+	// 헤더(.uasset/.umap)와 함께 저장되는 파일들
+	static const TCHAR* CompanionExtensions[] = { TEXT(".uexp"), TEXT(".ubulk"), TEXT(".uptnl") };
+
+	// 저장 이벤트로 모은 파일 (전체 경로 -> 마지막 저장 시각)
+	struct FSavedFiles
+	{
+		FCriticalSection Lock;
+		TMap<FString, double> Files;
+		// 대상(로컬 루트|원격 경로)마다 이 시각까지 저장된 파일은 이미 올렸다 - 기록 자체는 다른 대상을 위해 남긴다
+		TMap<FString, double> UploadedUpTo;
+		FDelegateHandle SavedHandle;
+	};
+
+	static FSavedFiles& GetSavedFiles()
+	{
+		static FSavedFiles SavedFiles;
+		return SavedFiles;
+	}
+
+	// 원격 경로별 레지스트리 기준 - 파일은 처음 쓸 때 한 번만 읽는다
+	static FCriticalSection BaselineLock;
+	static TMap<FString, TSharedPtr<TMap<FName, FString>>> BaselineCache;
+
+	static void OnPackageSaved(const FString& PackageFilename, UPackage* Package, FObjectPostSaveContext SaveContext)
+	{
+		// 쿡/자동 저장 같은 절차적 저장은 사용자의 변경이 아니다
+		if (SaveContext.IsProceduralSave())
+		{
+			return;
+		}
+
+		FSavedFiles& SavedFiles = GetSavedFiles();
+		FScopeLock ScopeLock(&SavedFiles.Lock);
+		SavedFiles.Files.Add(FPaths::ConvertRelativePathToFull(PackageFilename), FPlatformTime::Seconds());
+	}
+
+	void StartTracking()
+	{
+		FSavedFiles& SavedFiles = GetSavedFiles();
+		if (!SavedFiles.SavedHandle.IsValid())
+		{
+			SavedFiles.SavedHandle = UPackage::PackageSavedWithContextEvent.AddStatic(&OnPackageSaved);
+		}
+	}
+
+	void StopTracking()
+	{
+		FSavedFiles& SavedFiles = GetSavedFiles();
+		if (SavedFiles.SavedHandle.IsValid())
+		{
+			UPackage::PackageSavedWithContextEvent.Remove(SavedFiles.SavedHandle);
+			SavedFiles.SavedHandle.Reset();
+		}
+	}
+
+	static FString GetTargetKey(const FString& LocalRoot, const FString& RemotePath)
+	{
+		return LocalRoot + TEXT("|") + RemotePath;
+	}
+
+	static FString GetBaselinePath(const FString& TargetKey)
+	{
+		return FPaths::ProjectSavedDir() / TEXT("FileUpLoad") / TEXT("Discovery") / FString::Printf(TEXT("%08x.txt"), FCrc::StrCrc32(*TargetKey));
+	}
+
+	// 한 줄에 "패키지\t크기:저장 해시" - 20만 패키지에서도 JSON보다 빨리 읽고 쓴다
+	static TSharedPtr<TMap<FName, FString>> LoadBaseline(const FString& BaselinePath)
+	{
+		FScopeLock ScopeLock(&BaselineLock);
+		if (TSharedPtr<TMap<FName, FString>>* Cached = BaselineCache.Find(BaselinePath))
+		{
+			return *Cached;
+		}
+
+		FString Text;
+		if (!FFileHelper::LoadFileToString(Text, *BaselinePath))
+		{
+			return nullptr;
+		}
+
+		TSharedPtr<TMap<FName, FString>> Baseline = MakeShared<TMap<FName, FString>>();
+		TArray<FString> Lines;
+		Text.ParseIntoArrayLines(Lines);
+		Baseline->Reserve(Lines.Num());
+		for (const FString& Line : Lines)
+		{
+			FString PackageName;
+			FString State;
+			if (Line.Split(TEXT("\t"), &PackageName, &State))
+			{
+				Baseline->Add(FName(*PackageName), MoveTemp(State));
+			}
+		}
+		BaselineCache.Add(BaselinePath, Baseline);
+		return Baseline;
+	}
+
+	static void SaveBaseline(const FString& BaselinePath, const TMap<FName, FString>& Snapshot)
+	{
+		TStringBuilder<256> Line;
+		FString Text;
+		Text.Reserve(Snapshot.Num() * 96);
+		for (const TPair<FName, FString>& Entry : Snapshot)
+		{
+			Line.Reset();
+			Line << Entry.Key << TEXT('\t') << Entry.Value << TEXT('\n');
+			Text.Append(Line.ToView());
+		}
+
+		if (!FFileHelper::SaveStringToFile(Text, *BaselinePath))
+		{
+			LogFtpMessage(FString::Printf(TEXT("Cannot write discovery baseline %s"), *BaselinePath), true);
+			return;
+		}
+
+		FScopeLock ScopeLock(&BaselineLock);
+		BaselineCache.Add(BaselinePath, MakeShared<TMap<FName, FString>>(Snapshot));
+	}
+
+	// 루트 디렉토리에 대응하는 패키지 경로 ("/Game") - 콘텐츠 루트가 아니면 빈 문자열
+	static FString GetRootPackagePath(const FString& FullRoot)
+	{
+		FString PackagePath;
+		if (!FPackageName::TryConvertFilenameToLongPackageName(FullRoot / TEXT(""), PackagePath))
+		{
+			return FString();
+		}
+		while (PackagePath.Len() > 1 && PackagePath.EndsWith(TEXT("/")))
+		{
+			PackagePath.LeftChopInline(1);
+		}
+		return PackagePath;
+	}
+
+	static bool IsUnderPackagePath(const FString& PackageName, const FString& RootPackagePath)
+	{
+		return PackageName.StartsWith(RootPackagePath) && (PackageName.Len() == RootPackagePath.Len() || PackageName[RootPackagePath.Len()] == TEXT('/'));
+	}
+
+	// 크기와 저장 해시 - 내용이 바뀌면 둘 중 하나는 바뀐다
+	static FString MakeRegistryState(const FAssetPackageData& PackageData)
+	{
+		return FString::Printf(TEXT("%lld:%s"), PackageData.DiskSize, *LexToString(PackageData.GetPackageSavedHash()));
+	}
+
+	static void CollectSavedPackages(const FString& FullRoot, TSet<FString>& OutFiles, FFtpDiscoveryResult& OutResult)
+	{
+		FSavedFiles& SavedFiles = GetSavedFiles();
+		FScopeLock ScopeLock(&SavedFiles.Lock);
+		const double UploadedUpTo = SavedFiles.UploadedUpTo.FindRef(OutResult.TargetKey);
+		for (const TPair<FString, double>& Saved : SavedFiles.Files)
+		{
+			if (Saved.Value > UploadedUpTo && FPaths::IsUnderDirectory(Saved.Key, FullRoot))
+			{
+				bool bAlreadyFound = false;
+				OutFiles.Add(Saved.Key, &bAlreadyFound);
+				OutResult.NumFromSaved += bAlreadyFound ? 0 : 1;
+			}
+		}
+	}
+
+	static void CollectRegistryChanges(const FString& RootPackagePath, TSet<FString>& OutFiles, FFtpDiscoveryResult& OutResult)
+	{
+		IAssetRegistry* AssetRegistry = IAssetRegistry::Get();
+		if (AssetRegistry == nullptr || RootPackagePath.IsEmpty())
+		{
+			return;
+		}
+
+		if (AssetRegistry->IsLoadingAssets())
+		{
+			// 스캔 중인 상태를 기준으로 남기면 다음 번에 나머지가 모두 바뀐 것으로 보인다
+			LogFtpMessage(TEXT("Asset registry is still scanning; skipping registry change discovery"));
+			return;
+		}
+
+		// 레지스트리 메모리만 본다 - 디스크를 훑지 않음
+		FARFilter Filter;
+		Filter.PackagePaths.Add(FName(*RootPackagePath));
+		Filter.bRecursivePaths = true;
+		Filter.bIncludeOnlyOnDiskAssets = true;
+		TArray<FAssetData> Assets;
+		AssetRegistry->GetAssets(Filter, Assets);
+
+		OutResult.RegistrySnapshot.Reserve(Assets.Num());
+		for (const FAssetData& Asset : Assets)
+		{
+			if (OutResult.RegistrySnapshot.Contains(Asset.PackageName))
+			{
+				continue;
+			}
+			const TOptional<FAssetPackageData> PackageData = AssetRegistry->GetAssetPackageDataCopy(Asset.PackageName);
+			if (PackageData.IsSet())
+			{
+				OutResult.RegistrySnapshot.Add(Asset.PackageName, MakeRegistryState(PackageData.GetValue()));
+			}
+		}
+
+		const TSharedPtr<TMap<FName, FString>> Baseline = LoadBaseline(OutResult.BaselinePath);
+		if (!Baseline.IsValid())
+		{
+			LogFtpMessage(FString::Printf(TEXT("No discovery baseline for %s yet; the current registry state (%d packages) becomes the baseline after this upload"), *RootPackagePath, OutResult.RegistrySnapshot.Num()));
+			return;
+		}
+
+		FString Filename;
+		for (const TPair<FName, FString>& Entry : OutResult.RegistrySnapshot)
+		{
+			const FString* Previous = Baseline->Find(Entry.Key);
+			if (Previous != nullptr && *Previous == Entry.Value)
+			{
+				continue;
+			}
+
+			// 바뀐 패키지만 실제 파일 이름을 찾는다 (.umap/.uasset stat)
+			if (FPackageName::DoesPackageExist(Entry.Key.ToString(), &Filename))
+			{
+				bool bAlreadyFound = false;
+				OutFiles.Add(FPaths::ConvertRelativePathToFull(Filename), &bAlreadyFound);
+				OutResult.NumFromAssetRegistry += bAlreadyFound ? 0 : 1;
+			}
+		}
+
+		for (const TPair<FName, FString>& Entry : *Baseline)
+		{
+			if (!OutResult.RegistrySnapshot.Contains(Entry.Key))
+			{
+				OutResult.MissingFiles.Add(Entry.Key.ToString());
+			}
+		}
+	}
+
+	// 발견 하나의 진행 상태 - 레지스트리 비교(워커)와 소스 컨트롤 갱신(비동기 명령)이 둘 다 끝나면 마무리한다
+	struct FDiscoveryJob
+	{
+		FString FullRoot;
+		FString RootPackagePath;
+		EFtpDiscoverySource Sources = EFtpDiscoverySource::None;
+		double StartTime = 0.0;
+		TSharedRef<FFtpDiscoveryResult> Result = MakeShared<FFtpDiscoveryResult>();
+
+		// 저장 기록과 레지스트리에서 나온 파일 - 저장 기록은 게임 스레드가 먼저 넣고, 그 뒤로는 레지스트리 단계만 쓴다
+		TSet<FString> Candidates;
+		// 소스 컨트롤에서 나온 파일 - 게임 스레드에서 채우고 마무리에서 합친다
+		TArray<FString> SourceControlFiles;
+		TArray<FString> SourceControlDeleted;
+
+		TAtomic<int32> PendingParts{ 2 };
+		TAtomic<bool> bSourceControlDone{ false };
+		TFunction<void(TSharedPtr<FFtpDiscoveryResult>)> OnComplete;
+	};
+
+	static bool IsSourceControlAvailable()
+	{
+		ISourceControlModule& SourceControlModule = ISourceControlModule::Get();
+		return SourceControlModule.IsEnabled() && SourceControlModule.GetProvider().IsAvailable();
+	}
+
+	// 열린(체크아웃/추가/삭제) 파일만 물어본다 - 작업 공간 전체 상태를 받지 않음
+	static TSharedRef<FUpdateStatus, ESPMode::ThreadSafe> MakeOpenedStatusUpdate()
+	{
+		TSharedRef<FUpdateStatus, ESPMode::ThreadSafe> UpdateStatus = ISourceControlOperation::Create<FUpdateStatus>();
+		UpdateStatus->SetGetOpenedOnly(true);
+		return UpdateStatus;
+	}
+
+	// 상태 갱신이 끝난 뒤 캐시에서 열린 파일을 꺼낸다 (게임 스레드)
+	static void GatherSourceControlStates(FDiscoveryJob& Job)
+	{
+		check(IsInGameThread());
+		const FString& FullRoot = Job.FullRoot;
+		const TArray<FSourceControlStateRef> States = ISourceControlModule::Get().GetProvider().GetCachedStateByPredicate([&FullRoot](const FSourceControlStateRef& State)
+		{
+			return (State->IsCheckedOut() || State->IsAdded() || State->IsModified() || State->IsDeleted())
+				&& FPaths::IsUnderDirectory(State->GetFilename(), FullRoot);
+		});
+
+		for (const FSourceControlStateRef& State : States)
+		{
+			if (State->IsDeleted())
+			{
+				Job.SourceControlDeleted.Add(State->GetFilename());
+			}
+			else
+			{
+				Job.SourceControlFiles.Add(State->GetFilename());
+			}
+		}
+	}
+
+	static void CollectDirtyPackages(const FString& RootPackagePath, FFtpDiscoveryResult& OutResult)
+	{
+		check(IsInGameThread());
+		if (RootPackagePath.IsEmpty())
+		{
+			return;
+		}
+
+		TArray<UPackage*> DirtyPackages;
+		FEditorFileUtils::GetDirtyWorldPackages(DirtyPackages);
+		FEditorFileUtils::GetDirtyContentPackages(DirtyPackages);
+		for (const UPackage* Package : DirtyPackages)
+		{
+			const FString PackageName = Package->GetName();
+			if (IsUnderPackagePath(PackageName, RootPackagePath))
+			{
+				OutResult.UnsavedPackages.AddUnique(PackageName);
+			}
+		}
+	}
+
+	// 발견된 파일을 stat해서 경로 표에 넣는다 - 헤더는 같은 이름의 .uexp 등도 함께
+	static void AddDiscoveredFile(const FString& FullPath, const FString& FullRoot, TSet<FString>& Added, FFtpDiscoveryResult& OutResult)
+	{
+		if (Added.Contains(FullPath))
+		{
+			return;
+		}
+		Added.Add(FullPath);
+
+		const FFileStatData StatData = IFileManager::Get().GetStatData(*FullPath);
+		if (!StatData.bIsValid || StatData.bIsDirectory)
+		{
+			return;
+		}
+
+		FStringView RelativePath(FullPath);
+		RelativePath.RightChopInline(FullRoot.Len());
+		while (RelativePath.Len() > 0 && (RelativePath[0] == TEXT('/') || RelativePath[0] == TEXT('\\')))
+		{
+			RelativePath.RightChopInline(1);
+		}
+		OutResult.Files->AddFile(RelativePath, StatData.FileSize, StatData.ModificationTime);
+	}
+
+	// 발견된 파일을 모아 stat하고 결과를 마무리한다 (아무 스레드 - 다른 단계가 모두 끝난 뒤)
+	static void FinishDiscovery(FDiscoveryJob& Job)
+	{
+		FFtpDiscoveryResult& Result = *Job.Result;
+
+		Result.MissingFiles.Append(Job.SourceControlDeleted);
+		for (const FString& Filename : Job.SourceControlFiles)
+		{
+			bool bAlreadyFound = false;
+			Job.Candidates.Add(Filename, &bAlreadyFound);
+			Result.NumFromSourceControl += bAlreadyFound ? 0 : 1;
+		}
+
+		TSet<FString> Added;
+		for (const FString& Candidate : Job.Candidates)
+		{
+			AddDiscoveredFile(Candidate, Job.FullRoot, Added, Result);
+
+			const FString Extension = FPaths::GetExtension(Candidate, true);
+			if (Extension == TEXT(".uasset") || Extension == TEXT(".umap"))
+			{
+				const FString BasePath = Candidate.LeftChop(Extension.Len());
+				for (const TCHAR* CompanionExtension : CompanionExtensions)
+				{
+					AddDiscoveredFile(BasePath + CompanionExtension, Job.FullRoot, Added, Result);
+				}
+			}
+		}
+
+		Result.Seconds = FPlatformTime::Seconds() - Job.StartTime;
+		SET_DWORD_STAT(STAT_FileUpLoad_DiscoveredFiles, Result.Files->Num());
+		LogFtpMessage(DescribeResult(Result));
+		for (const FString& PackageName : Result.UnsavedPackages)
+		{
+			LogFtpMessage(FString::Printf(TEXT("Unsaved package not uploaded: %s"), *PackageName));
+		}
+	}
+
+	// 게임 스레드에서만 알 수 있는 것(더티 패키지)과 저장 기록을 먼저 모은다
+	static bool BeginDiscovery(const FString& LocalRoot, const FString& RemotePath, EFtpDiscoverySource Sources, FDiscoveryJob& Job)
+	{
+		check(IsInGameThread());
+		Job.StartTime = FPlatformTime::Seconds();
+		Job.Sources = Sources;
+		Job.FullRoot = FPaths::ConvertRelativePathToFull(LocalRoot);
+		FPaths::NormalizeDirectoryName(Job.FullRoot);
+
+		FFtpDiscoveryResult& Result = *Job.Result;
+		Result.Files = MakeShared<FFtpPathTable>(Job.FullRoot);
+		Result.DiscoveryTime = Job.StartTime;
+		Result.TargetKey = GetTargetKey(Job.FullRoot, RemotePath);
+		Result.BaselinePath = GetBaselinePath(Result.TargetKey);
+
+		if (!FPaths::DirectoryExists(Job.FullRoot))
+		{
+			LogFtpMessage(FString::Printf(TEXT("Discovery root does not exist: %s"), *Job.FullRoot), true);
+			return false;
+		}
+
+		Job.RootPackagePath = GetRootPackagePath(Job.FullRoot);
+		if (EnumHasAnyFlags(Sources, EFtpDiscoverySource::SavedPackages))
+		{
+			CollectSavedPackages(Job.FullRoot, Job.Candidates, Result);
+		}
+		if (EnumHasAnyFlags(Sources, EFtpDiscoverySource::DirtyPackages))
+		{
+			CollectDirtyPackages(Job.RootPackagePath, Result);
+		}
+		return true;
+	}
+
+	bool DiscoverChanges(const FString& LocalRoot, const FString& RemotePath, EFtpDiscoverySource Sources, FFtpDiscoveryResult& OutResult)
+	{
+		check(IsInGameThread());
+		SCOPE_CYCLE_COUNTER(STAT_FileUpLoad_DiscoverChanges);
+		FTP_TRACE_SCOPE(Discover);
+
+		FDiscoveryJob Job;
+		const bool bStarted = BeginDiscovery(LocalRoot, RemotePath, Sources, Job);
+		if (bStarted)
+		{
+			if (EnumHasAnyFlags(Sources, EFtpDiscoverySource::AssetRegistry))
+			{
+				CollectRegistryChanges(Job.RootPackagePath, Job.Candidates, *Job.Result);
+			}
+			if (EnumHasAnyFlags(Sources, EFtpDiscoverySource::SourceControl) && IsSourceControlAvailable())
+			{
+				if (ISourceControlModule::Get().GetProvider().Execute(MakeOpenedStatusUpdate(), TArray<FString>{ Job.FullRoot }, EConcurrency::Synchronous) == ECommandResult::Succeeded)
+				{
+					GatherSourceControlStates(Job);
+				}
+				else
+				{
+					LogFtpMessage(FString::Printf(TEXT("Source control status update failed for %s"), *Job.FullRoot), true);
+				}
+			}
+			FinishDiscovery(Job);
+		}
+
+		OutResult = MoveTemp(*Job.Result);
+		return bStarted;
+	}
+
+	// 레지스트리 단계와 소스 컨트롤 단계가 끝날 때마다 부른다 - 마지막 단계가 워커에서 마무리하고 게임 스레드로 알린다
+	static void CompleteDiscoveryPart(const TSharedRef<FDiscoveryJob>& Job)
+	{
+		if (--Job->PendingParts > 0)
+		{
+			return;
+		}
+
+		auto FinishAndNotify = [Job]()
+		{
+			SCOPE_CYCLE_COUNTER(STAT_FileUpLoad_DiscoverChanges);
+			FinishDiscovery(*Job);
+			AsyncTask(ENamedThreads::GameThread, [Job]()
+			{
+				Job->OnComplete(Job->Result);
+			});
+		};
+
+		if (IsInGameThread())
+		{
+			Async(EAsyncExecution::ThreadPool, MoveTemp(FinishAndNotify));
+		}
+		else
+		{
+			FinishAndNotify();
+		}
+	}
+
+	// 완료 콜백과 명령 실패가 겹쳐도 한 번만 센다. 이번 호출이 센 것이면 true
+	static bool CompleteSourceControlPart(const TSharedRef<FDiscoveryJob>& Job)
+	{
+		if (Job->bSourceControlDone.Exchange(true))
+		{
+			return false;
+		}
+		CompleteDiscoveryPart(Job);
+		return true;
+	}
+
+	void DiscoverChangesAsync(const FString& LocalRoot, const FString& RemotePath, EFtpDiscoverySource Sources, TFunction<void(TSharedPtr<FFtpDiscoveryResult>)> OnComplete)
+	{
+		check(IsInGameThread());
+
+		TSharedRef<FDiscoveryJob> Job = MakeShared<FDiscoveryJob>();
+		Job->OnComplete = MoveTemp(OnComplete);
+		if (!BeginDiscovery(LocalRoot, RemotePath, Sources, *Job))
+		{
+			Job->OnComplete(nullptr);
+			return;
+		}
+
+		// 레지스트리 메모리 비교와 바뀐 패키지의 파일 찾기는 워커에서
+		Async(EAsyncExecution::ThreadPool, [Job]()
+		{
+			FTP_TRACE_SCOPE(Discover);
+			if (EnumHasAnyFlags(Job->Sources, EFtpDiscoverySource::AssetRegistry))
+			{
+				CollectRegistryChanges(Job->RootPackagePath, Job->Candidates, *Job->Result);
+			}
+			CompleteDiscoveryPart(Job);
+		});
+
+		// 소스 컨트롤은 비동기 명령으로 - 완료 콜백은 게임 스레드에서 온다
+		if (!EnumHasAnyFlags(Sources, EFtpDiscoverySource::SourceControl) || !IsSourceControlAvailable())
+		{
+			CompleteSourceControlPart(Job);
+			return;
+		}
+
+		const ECommandResult::Type Issued = ISourceControlModule::Get().GetProvider().Execute(MakeOpenedStatusUpdate(), TArray<FString>{ Job->FullRoot }, EConcurrency::Asynchronous,
+			FSourceControlOperationComplete::CreateLambda([Job](const FSourceControlOperationRef& Operation, ECommandResult::Type Result)
+			{
+				if (Job->bSourceControlDone)
+				{
+					return;
+				}
+				if (Result == ECommandResult::Succeeded)
+				{
+					GatherSourceControlStates(*Job);
+				}
+				else
+				{
+					LogFtpMessage(FString::Printf(TEXT("Source control status update failed for %s"), *Job->FullRoot), true);
+				}
+				CompleteSourceControlPart(Job);
+			}));
+
+		if (Issued == ECommandResult::Failed && CompleteSourceControlPart(Job))
+		{
+			LogFtpMessage(FString::Printf(TEXT("Source control status update could not start for %s"), *Job->FullRoot), true);
+		}
+	}
+
+	FFtpSyncStats UploadChanges(const FFtpDiscoveryResult& Discovery, const FString& RemotePath, const FString& Server, const FString& User, const FString& Pass, const TArray<FName>& PriorityPackages)
+	{
+		if (!AuthenticateUser(User, Pass))
+		{
+			LogFtpMessage(FString::Printf(TEXT("Authentication failed for %s"), *User), true);
+			return FFtpSyncStats::Aborted();
+		}
+
+		if (!Discovery.Files.IsValid())
+		{
+			return FFtpSyncStats::Aborted();
+		}
+
+		FFtpSyncStats Stats;
+		if (Discovery.Files->Num() > 0)
+		{
+			TArray<int32> UploadOrder;
+			FtpUploadOrder::OrderByDependencies(*Discovery.Files, nullptr, PriorityPackages, UploadOrder);
+			Stats = UploadPathTable(*Discovery.Files, &UploadOrder, RemotePath, Server, User);
+		}
+
+		// 일부라도 실패하면 다음 발견에서 다시 나오도록 기록을 그대로 둔다
+		if (Stats.bAborted || Stats.FailCount > 0)
+		{
+			return Stats;
+		}
+
+		{
+			// 이 대상에만 올린 것으로 기록한다 - 발견 뒤에 다시 저장된 파일과 다른 대상은 다음 발견에서 그대로 나온다
+			FSavedFiles& SavedFiles = GetSavedFiles();
+			FScopeLock ScopeLock(&SavedFiles.Lock);
+			double& UploadedUpTo = SavedFiles.UploadedUpTo.FindOrAdd(Discovery.TargetKey, 0.0);
+			UploadedUpTo = FMath::Max(UploadedUpTo, Discovery.DiscoveryTime);
+		}
+
+		if (Discovery.RegistrySnapshot.Num() > 0)
+		{
+			SaveBaseline(Discovery.BaselinePath, Discovery.RegistrySnapshot);
+		}
+		return Stats;
+	}
+
+	FString DescribeResult(const FFtpDiscoveryResult& Discovery)
+	{
+		return FString::Printf(TEXT("Discovered %d file(s) in %.1f ms (%d saved, %d registry, %d source control), %d unsaved, %d missing"),
+			Discovery.Files.IsValid() ? Discovery.Files->Num() : 0, Discovery.Seconds * 1000.0,
+			Discovery.NumFromSaved, Discovery.NumFromAssetRegistry, Discovery.NumFromSourceControl,
+			Discovery.UnsavedPackages.Num(), Discovery.MissingFiles.Num());
+	}
+}
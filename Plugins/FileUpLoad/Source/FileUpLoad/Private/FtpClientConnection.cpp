@@ -0,0 +1,477 @@
+#include "FtpClientConnection.h"
+#include "FtpBufferPool.h"
+#include "FtpSystem.h"
+#include "FileUpLoadTrace.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+#include "IPAddress.h"
+#include "String/Find.h"
+
+namespace FtpClientConnectionInternal
+{
+	// 응답/데이터를 기다리는 최대 시간
+	static const FTimespan ReplyTimeout = FTimespan::FromSeconds(30);
+
+	// 응답 한 줄의 최대 길이
+	static constexpr int32 MaxReplyLineLength = 1024;
+
+	// 데이터 연결 수신 단위
+	static constexpr int32 ReceiveChunkSize = 64 * 1024;
+
+	static ISocketSubsystem* GetSocketSubsystem()
+	{
+		return ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	}
+
+	static void DestroySocket(FSocket*& Socket)
+	{
+		if (Socket != nullptr)
+		{
+			Socket->Close();
+			GetSocketSubsystem()->DestroySocket(Socket);
+			Socket = nullptr;
+		}
+	}
+
+	static FSocket* ConnectSocket(const FInternetAddr& Addr, int32 Port, const TCHAR* Description)
+	{
+		TSharedRef<FInternetAddr> Target = Addr.Clone();
+		if (Port > 0)
+		{
+			Target->SetPort(Port);
+		}
+
+		FSocket* Socket = GetSocketSubsystem()->CreateSocket(NAME_Stream, Description, Target->GetProtocolType());
+		if (Socket == nullptr)
+		{
+			return nullptr;
+		}
+		Socket->SetNoDelay(true);
+		if (!Socket->Connect(*Target))
+		{
+			DestroySocket(Socket);
+		}
+		return Socket;
+	}
+
+	static bool SendAll(FSocket* Socket, const uint8* Data, int64 Length)
+	{
+		while (Length > 0)
+		{
+			int32 BytesSent = 0;
+			if (!Socket->Send(Data, (int32)FMath::Min<int64>(Length, MAX_int32), BytesSent) || BytesSent <= 0)
+			{
+				return false;
+			}
+			Data += BytesSent;
+			Length -= BytesSent;
+		}
+		return true;
+	}
+
+	// "(|||port|)"
+	static int32 ParseExtendedPassivePort(FAnsiStringView Text)
+	{
+		const int32 Start = UE::String::FindFirst(Text, "(|||");
+		if (Start == INDEX_NONE)
+		{
+			return 0;
+		}
+		FAnsiStringView PortText = Text.RightChop(Start + 4);
+		int32 End = INDEX_NONE;
+		if (PortText.FindChar('|', End))
+		{
+			PortText = PortText.Left(End);
+		}
+		int64 Port = 0;
+		return FtpProtocol::ParseInt64(PortText, Port) && Port > 0 && Port <= 65535 ? (int32)Port : 0;
+	}
+
+	// 150 응답의 "(1234 bytes)" - 없으면 -1
+	static int64 ParseTransferSize(FAnsiStringView Text)
+	{
+		int32 Open = INDEX_NONE;
+		if (!Text.FindLastChar('(', Open))
+		{
+			return -1;
+		}
+		FAnsiStringView SizeText = Text.RightChop(Open + 1);
+		int32 Space = INDEX_NONE;
+		if (SizeText.FindChar(' ', Space))
+		{
+			SizeText = SizeText.Left(Space);
+		}
+		int64 Size = -1;
+		return FtpProtocol::ParseInt64(SizeText, Size) ? Size : -1;
+	}
+}
+
+FFtpClientConnection::FFtpClientConnection()
+	: Reader(FtpClientConnectionInternal::MaxReplyLineLength)
+{
+}
+
+FFtpClientConnection::~FFtpClientConnection()
+{
+	Disconnect();
+}
+
+TSharedPtr<FInternetAddr> FFtpClientConnection::ResolveAddress(const FString& Host, int32 Port)
+{
+	ISocketSubsystem* SocketSubsystem = FtpClientConnectionInternal::GetSocketSubsystem();
+	const FAddressInfoResult Result = SocketSubsystem->GetAddressInfo(*Host, nullptr, EAddressInfoFlags::Default, NAME_None, ESocketType::SOCKTYPE_Streaming);
+	if (Result.ReturnCode != SE_NO_ERROR || Result.Results.Num() == 0)
+	{
+		LogFtpMessage(FString::Printf(TEXT("Cannot resolve FTP server address %s"), *Host), true);
+		return nullptr;
+	}
+
+	TSharedPtr<FInternetAddr> Addr = Result.Results[0].Address->Clone();
+	Addr->SetPort(Port);
+	return Addr;
+}
+
+bool FFtpClientConnection::Connect(const FInternetAddr& InServerAddr, const FString& User, const FString& Password)
+{
+	FTP_TRACE_SCOPE(ClientConnect);
+
+	Disconnect();
+	ServerAddr = InServerAddr.Clone();
+
+	Control = FtpClientConnectionInternal::ConnectSocket(*ServerAddr, 0, TEXT("FtpClientControl"));
+	if (Control == nullptr || !ExpectReply(220))
+	{
+		Disconnect();
+		return false;
+	}
+
+	// 서버에 따라 USER에 바로 230을 줄 수도 있다
+	int32 Code = 0;
+	Writer.Reset().BeginCommand(EFtpCommand::User).Append(' ').AppendUtf8(User).EndLine();
+	if (!SendCommand() || !ReadReply(Code))
+	{
+		Disconnect();
+		return false;
+	}
+	if (Code == 331)
+	{
+		Writer.Reset().BeginCommand(EFtpCommand::Pass).Append(' ').AppendUtf8(Password).EndLine();
+		if (!SendCommand() || !ReadReply(Code))
+		{
+			Disconnect();
+			return false;
+		}
+	}
+	if (Code != 230)
+	{
+		LogFtpMessage(FString::Printf(TEXT("FTP login failed for %s (%d)"), *User, Code), true);
+		Disconnect();
+		return false;
+	}
+
+	Writer.Reset().BeginCommand(EFtpCommand::Type).AppendArgument("I").EndLine();
+	if (!SendCommand() || !ExpectReply(200))
+	{
+		Disconnect();
+		return false;
+	}
+	return true;
+}
+
+void FFtpClientConnection::Disconnect()
+{
+	FtpClientConnectionInternal::DestroySocket(Control);
+	Reader.Reset();
+	Parser.Reset();
+	LastReplyText.Reset();
+}
+
+bool FFtpClientConnection::SendCommand()
+{
+	if (Control == nullptr || !FtpClientConnectionInternal::SendAll(Control, Writer.GetData(), Writer.Num()))
+	{
+		Disconnect();
+		return false;
+	}
+	return true;
+}
+
+bool FFtpClientConnection::SendPathCommand(EFtpCommand Command, const FString& Path)
+{
+	Writer.Reset().BeginCommand(Command).Append(' ').AppendUtf8(Path).EndLine();
+	return SendCommand();
+}
+
+bool FFtpClientConnection::ReadReply(int32& OutCode)
+{
+	while (Control != nullptr)
+	{
+		FAnsiStringView Line;
+		const EFtpLineResult LineResult = Reader.NextLine(Line);
+		if (LineResult == EFtpLineResult::Line)
+		{
+			const EFtpReplyResult ReplyResult = Parser.Feed(Line);
+			if (ReplyResult == EFtpReplyResult::Complete)
+			{
+				OutCode = Parser.GetCode();
+				LastReplyText = Parser.GetText();
+				return true;
+			}
+			if (ReplyResult == EFtpReplyResult::Malformed)
+			{
+				break;
+			}
+			continue;
+		}
+		if (LineResult == EFtpLineResult::Overflow || !Control->Wait(ESocketWaitConditions::WaitForRead, FtpClientConnectionInternal::ReplyTimeout))
+		{
+			break;
+		}
+
+		int32 Capacity = 0;
+		uint8* Dest = Reader.GetWriteBuffer(Capacity);
+		int32 BytesRead = 0;
+		if (!Control->Recv(Dest, Capacity, BytesRead) || BytesRead <= 0)
+		{
+			break;
+		}
+		Reader.CommitWrite(BytesRead);
+	}
+
+	Disconnect();
+	return false;
+}
+
+bool FFtpClientConnection::ExpectReply(int32 ExpectedCode)
+{
+	int32 Code = 0;
+	if (!ReadReply(Code))
+	{
+		return false;
+	}
+	if (Code != ExpectedCode)
+	{
+		Disconnect();
+		return false;
+	}
+	return true;
+}
+
+FSocket* FFtpClientConnection::OpenDataConnection()
+{
+	Writer.Reset().BeginCommand(EFtpCommand::Epsv).EndLine();
+	if (!SendCommand() || !ExpectReply(229))
+	{
+		return nullptr;
+	}
+
+	const int32 Port = FtpClientConnectionInternal::ParseExtendedPassivePort(LastReplyText);
+	FSocket* DataSocket = Port > 0 ? FtpClientConnectionInternal::ConnectSocket(*ServerAddr, Port, TEXT("FtpClientData")) : nullptr;
+	if (DataSocket == nullptr)
+	{
+		Disconnect();
+	}
+	return DataSocket;
+}
+
+EFtpClientResult FFtpClientConnection::Retrieve(const FString& RemotePath, TArray<uint8>& OutData, int64 MaxBytes)
+{
+	FTP_TRACE_SCOPE(ClientRetrieve);
+
+	using namespace FtpClientConnectionInternal;
+
+	OutData.Reset();
+
+	FSocket* DataSocket = OpenDataConnection();
+	if (DataSocket == nullptr)
+	{
+		return EFtpClientResult::Failed;
+	}
+
+	int32 Code = 0;
+	if (!SendPathCommand(EFtpCommand::Retr, RemotePath) || !ReadReply(Code))
+	{
+		DestroySocket(DataSocket);
+		return EFtpClientResult::Failed;
+	}
+	if (Code == 550)
+	{
+		DestroySocket(DataSocket);
+		return EFtpClientResult::NotFound;
+	}
+	if (Code != 150 && Code != 125)
+	{
+		DestroySocket(DataSocket);
+		Disconnect();
+		return EFtpClientResult::Failed;
+	}
+
+	// 크기를 알려 주면 한 번에 잡는다
+	const int64 ExpectedSize = ParseTransferSize(LastReplyText);
+	if (ExpectedSize > MaxBytes)
+	{
+		DestroySocket(DataSocket);
+		Disconnect();
+		return EFtpClientResult::Failed;
+	}
+	if (ExpectedSize > 0)
+	{
+		OutData.Reserve(ExpectedSize);
+	}
+
+	// 상대가 데이터 연결을 닫을 때까지 받는다 - 수신 버퍼는 스레드 캐시에서 나오므로 잠금 없이 빌린다
+	FFtpPooledBuffer ReceiveBuffer = FFtpBufferPool::Acquire(ReceiveChunkSize);
+	bool bReceived = true;
+	while (true)
+	{
+		if (!DataSocket->Wait(ESocketWaitConditions::WaitForRead, ReplyTimeout))
+		{
+			bReceived = false;
+			break;
+		}
+
+		int32 BytesRead = 0;
+		if (!DataSocket->Recv(ReceiveBuffer.GetData(), ReceiveBuffer.GetSize(), BytesRead) || BytesRead <= 0)
+		{
+			break;
+		}
+		OutData.Append(ReceiveBuffer.GetData(), BytesRead);
+		if (OutData.Num() > MaxBytes)
+		{
+			bReceived = false;
+			break;
+		}
+	}
+	DestroySocket(DataSocket);
+
+	if (!bReceived || !ExpectReply(226) || (ExpectedSize >= 0 && OutData.Num() != ExpectedSize))
+	{
+		Disconnect();
+		OutData.Reset();
+		return EFtpClientResult::Failed;
+	}
+	return EFtpClientResult::Ok;
+}
+
+EFtpClientResult FFtpClientConnection::Store(const FString& RemotePath, const uint8* Data, int64 Size)
+{
+	FTP_TRACE_SCOPE(ClientStore);
+
+	using namespace FtpClientConnectionInternal;
+
+	FSocket* DataSocket = OpenDataConnection();
+	if (DataSocket == nullptr)
+	{
+		return EFtpClientResult::Failed;
+	}
+
+	int32 Code = 0;
+	if (!SendPathCommand(EFtpCommand::Stor, RemotePath) || !ReadReply(Code))
+	{
+		DestroySocket(DataSocket);
+		return EFtpClientResult::Failed;
+	}
+	if (Code == 550 || Code == 553)
+	{
+		DestroySocket(DataSocket);
+		return EFtpClientResult::NotFound;
+	}
+	if (Code != 150 && Code != 125)
+	{
+		DestroySocket(DataSocket);
+		Disconnect();
+		return EFtpClientResult::Failed;
+	}
+
+	const bool bSent = SendAll(DataSocket, Data, Size);
+	// 닫아야 서버가 끝을 안다
+	DestroySocket(DataSocket);
+
+	if (!bSent || !ExpectReply(226))
+	{
+		Disconnect();
+		return EFtpClientResult::Failed;
+	}
+	return EFtpClientResult::Ok;
+}
+
+EFtpClientResult FFtpClientConnection::GetSize(const FString& RemotePath, int64& OutSize)
+{
+	int32 Code = 0;
+	if (!SendPathCommand(EFtpCommand::Size, RemotePath) || !ReadReply(Code))
+	{
+		return EFtpClientResult::Failed;
+	}
+	if (Code == 550)
+	{
+		return EFtpClientResult::NotFound;
+	}
+	if (Code != 213 || !FtpProtocol::ParseInt64(LastReplyText, OutSize))
+	{
+		Disconnect();
+		return EFtpClientResult::Failed;
+	}
+	return EFtpClientResult::Ok;
+}
+
+EFtpClientResult FFtpClientConnection::Rename(const FString& FromPath, const FString& ToPath)
+{
+	int32 Code = 0;
+	if (!SendPathCommand(EFtpCommand::Rnfr, FromPath) || !ReadReply(Code))
+	{
+		return EFtpClientResult::Failed;
+	}
+	if (Code == 550)
+	{
+		return EFtpClientResult::NotFound;
+	}
+	if (Code != 350)
+	{
+		Disconnect();
+		return EFtpClientResult::Failed;
+	}
+
+	if (!SendPathCommand(EFtpCommand::Rnto, ToPath) || !ReadReply(Code))
+	{
+		return EFtpClientResult::Failed;
+	}
+	if (Code == 550 || Code == 553)
+	{
+		return EFtpClientResult::NotFound;
+	}
+	if (Code != 250)
+	{
+		Disconnect();
+		return EFtpClientResult::Failed;
+	}
+	return EFtpClientResult::Ok;
+}
+
+EFtpClientResult FFtpClientConnection::Delete(const FString& RemotePath)
+{
+	int32 Code = 0;
+	if (!SendPathCommand(EFtpCommand::Dele, RemotePath) || !ReadReply(Code))
+	{
+		return EFtpClientResult::Failed;
+	}
+	if (Code == 550)
+	{
+		return EFtpClientResult::NotFound;
+	}
+	if (Code != 250)
+	{
+		Disconnect();
+		return EFtpClientResult::Failed;
+	}
+	return EFtpClientResult::Ok;
+}
+
+bool FFtpClientConnection::MakeDirectory(const FString& RemotePath)
+{
+	int32 Code = 0;
+	if (!SendPathCommand(EFtpCommand::Mkd, RemotePath) || !ReadReply(Code))
+	{
+		return false;
+	}
+	return Code == 257 || Code == 550 || Code == 521;
+}
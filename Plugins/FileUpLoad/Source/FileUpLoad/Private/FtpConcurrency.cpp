@@ -0,0 +1,279 @@
+#include "FtpConcurrency.h"
+#include "FtpBufferPool.h"
+#include "FileUpLoadStats.h"
+#include "Async/Async.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/ScopeLock.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Concurrency Limit"), STAT_FileUpLoad_ConcurrencyLimit, STATGROUP_FileUpLoad);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Active Transfers"), STAT_FileUpLoad_ActiveTransfers, STATGROUP_FileUpLoad);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Concurrency Increases"), STAT_FileUpLoad_ConcurrencyIncreases, STATGROUP_FileUpLoad);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Concurrency Decreases"), STAT_FileUpLoad_ConcurrencyDecreases, STATGROUP_FileUpLoad);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Server Busy Replies"), STAT_FileUpLoad_ServerBusyReplies, STATGROUP_FileUpLoad);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Transfer Throughput (MB/s)"), STAT_FileUpLoad_TransferThroughput, STATGROUP_FileUpLoad);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Transfer Latency (ms)"), STAT_FileUpLoad_TransferLatency, STATGROUP_FileUpLoad);
+
+FFtpConcurrencyController::FFtpConcurrencyController(const FString& InServerKey, int32 InMaxLimit)
+	: ServerKey(InServerKey)
+	, SlotEvent(FPlatformProcess::GetSynchEventFromPool(false))
+	, MaxLimit(FMath::Max(InMaxLimit, MinLimit))
+{
+	Limit = FMath::Min(InitialLimit, MaxLimit);
+	SET_DWORD_STAT(STAT_FileUpLoad_ConcurrencyLimit, Limit);
+	WindowStart = FPlatformTime::Seconds();
+}
+
+FFtpConcurrencyController::~FFtpConcurrencyController()
+{
+	FPlatformProcess::ReturnSynchEventToPool(SlotEvent);
+}
+
+void FFtpConcurrencyController::Acquire()
+{
+	while (true)
+	{
+		{
+			FScopeLock ScopeLock(&Lock);
+			if (Active < Limit)
+			{
+				++Active;
+				INC_DWORD_STAT(STAT_FileUpLoad_ActiveTransfers);
+				return;
+			}
+		}
+		// 한도가 늘어나는 경우도 있으므로 시간 제한을 두고 다시 본다
+		SlotEvent->Wait(50);
+	}
+}
+
+void FFtpConcurrencyController::Release(const FFtpTransferSample& Sample)
+{
+	{
+		FScopeLock ScopeLock(&Lock);
+		const double Now = FPlatformTime::Seconds();
+		--Active;
+		DEC_DWORD_STAT(STAT_FileUpLoad_ActiveTransfers);
+
+		WindowBytes += Sample.Bytes;
+		WindowFiles += Sample.Files;
+		WindowFailed += Sample.FailedFiles;
+		if (Sample.LatencySeconds > 0.0)
+		{
+			WindowLatencySum += Sample.LatencySeconds;
+			++WindowLatencyCount;
+			MinLatency = MinLatency > 0.0 ? FMath::Min(MinLatency, Sample.LatencySeconds) : Sample.LatencySeconds;
+		}
+
+		if (Sample.bServerBusy)
+		{
+			INC_DWORD_STAT(STAT_FileUpLoad_ServerBusyReplies);
+
+			// 421은 바로 반영한다 - 창이 끝날 때까지 기다리면 거절이 더 쌓인다
+			if (!bWindowBusy)
+			{
+				bWindowBusy = true;
+				LearnedCeiling = FMath::Max(MinLimit, FMath::Min(Active + 1, Limit) - 1);
+				LastBusyTime = Now;
+				SetLimit(FMath::Min(LearnedCeiling, FMath::FloorToInt(Limit * BusyDecrease)), TEXT("server busy (421)"));
+				bLastWasIncrease = false;
+				HoldWindows = 0;
+			}
+		}
+
+		if (Now - WindowStart >= WindowSeconds)
+		{
+			EvaluateWindow(Now);
+		}
+	}
+
+	SlotEvent->Trigger();
+}
+
+void FFtpConcurrencyController::SetMaxLimit(int32 InMaxLimit)
+{
+	if (InMaxLimit <= 0)
+	{
+		return;
+	}
+
+	FScopeLock ScopeLock(&Lock);
+	MaxLimit = FMath::Max(InMaxLimit, MinLimit);
+	if (Limit > MaxLimit)
+	{
+		SetLimit(MaxLimit, TEXT("server connection limit"));
+	}
+}
+
+int32 FFtpConcurrencyController::GetLimit() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return Limit;
+}
+
+int32 FFtpConcurrencyController::GetMaxLimit() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return MaxLimit;
+}
+
+int32 FFtpConcurrencyController::GetEffectiveMax() const
+{
+	return LearnedCeiling > 0 ? FMath::Min(MaxLimit, LearnedCeiling) : MaxLimit;
+}
+
+void FFtpConcurrencyController::SetLimit(int32 NewLimit, const TCHAR* Reason)
+{
+	NewLimit = FMath::Clamp(NewLimit, MinLimit, MaxLimit);
+	if (NewLimit == Limit)
+	{
+		return;
+	}
+
+	if (NewLimit > Limit)
+	{
+		INC_DWORD_STAT(STAT_FileUpLoad_ConcurrencyIncreases);
+	}
+	else
+	{
+		INC_DWORD_STAT(STAT_FileUpLoad_ConcurrencyDecreases);
+	}
+
+	LogFtpMessage(FString::Printf(TEXT("Concurrency %s: %d -> %d (%s)"), *ServerKey, Limit, NewLimit, Reason));
+	Limit = NewLimit;
+	SET_DWORD_STAT(STAT_FileUpLoad_ConcurrencyLimit, Limit);
+}
+
+void FFtpConcurrencyController::EvaluateWindow(double Now)
+{
+	const double Elapsed = Now - WindowStart;
+	const double Throughput = Elapsed > 0.0 ? WindowBytes / Elapsed : 0.0;
+	const double ErrorRate = WindowFiles > 0 ? (double)WindowFailed / WindowFiles : 0.0;
+	const double Latency = WindowLatencyCount > 0 ? WindowLatencySum / WindowLatencyCount : 0.0;
+
+	SET_FLOAT_STAT(STAT_FileUpLoad_TransferThroughput, Throughput / (1024.0 * 1024.0));
+	SET_FLOAT_STAT(STAT_FileUpLoad_TransferLatency, Latency * 1000.0);
+
+	// 421이 한동안 없으면 배운 상한을 조금씩 풀어 준다 (서버 쪽 다른 클라이언트가 빠졌을 수 있음)
+	if (LearnedCeiling > 0 && Now - LastBusyTime >= CeilingRelaxSeconds)
+	{
+		LastBusyTime = Now;
+		LearnedCeiling = LearnedCeiling + 1 >= MaxLimit ? 0 : LearnedCeiling + 1;
+	}
+
+	if (bWindowBusy)
+	{
+		// 이미 Release에서 줄였다
+	}
+	else if (WindowFiles == 0)
+	{
+		// 이 창에서 끝난 전송이 없다 (큰 파일 진행 중) - 판단하지 않는다
+		WindowStart = Now;
+		return;
+	}
+	else if (ErrorRate > MaxErrorRate)
+	{
+		SetLimit(FMath::FloorToInt(Limit * CongestionDecrease), TEXT("error rate"));
+		bLastWasIncrease = false;
+		HoldWindows = 0;
+	}
+	else if (MinLatency > 0.0 && Latency > MinLatency * MaxLatencyInflation)
+	{
+		SetLimit(FMath::FloorToInt(Limit * CongestionDecrease), TEXT("latency inflation"));
+		bLastWasIncrease = false;
+		HoldWindows = 0;
+	}
+	else if (bLastWasIncrease && Throughput < LastThroughput * (1.0 + MinThroughputGain))
+	{
+		// 늘려도 처리량이 그대로면 링크가 찼다 - 늘린 것을 되돌리고 머문다
+		SetLimit(Limit - 1, TEXT("throughput plateau"));
+		bLastWasIncrease = false;
+		HoldWindows = 1;
+	}
+	else if (!bLastWasIncrease && HoldWindows > 0 && HoldWindows < ProbeIntervalWindows)
+	{
+		++HoldWindows;
+	}
+	else if (Active + 1 >= Limit && Limit < GetEffectiveMax())
+	{
+		// 자리가 모두 차 있을 때만 늘린다 (방금 끝난 전송 하나는 빠져 있다) - 일이 부족해서 남는 자리는 늘려도 소용없다
+		SetLimit(Limit + 1, TEXT("additive increase"));
+		bLastWasIncrease = true;
+		HoldWindows = 0;
+	}
+	else
+	{
+		bLastWasIncrease = false;
+		HoldWindows = 1;
+	}
+
+	LastThroughput = Throughput;
+
+	WindowStart = Now;
+	WindowBytes = 0;
+	WindowFiles = 0;
+	WindowFailed = 0;
+	WindowLatencySum = 0.0;
+	WindowLatencyCount = 0;
+	bWindowBusy = false;
+}
+
+namespace FtpConcurrency
+{
+	TSharedRef<FFtpConcurrencyController> GetController(const FString& ServerKey, int32 MaxConnections)
+	{
+		static FCriticalSection RegistryLock;
+		static TMap<FString, TSharedRef<FFtpConcurrencyController>> Controllers;
+
+		FScopeLock ScopeLock(&RegistryLock);
+		if (TSharedRef<FFtpConcurrencyController>* Existing = Controllers.Find(ServerKey))
+		{
+			(*Existing)->SetMaxLimit(MaxConnections);
+			return *Existing;
+		}
+
+		return Controllers.Add(ServerKey, MakeShared<FFtpConcurrencyController>(ServerKey, MaxConnections));
+	}
+
+	void RunTransfers(FFtpConcurrencyController& Controller, int32 NumItems, TFunctionRef<FFtpTransferSample(int32)> Transfer)
+	{
+		if (NumItems <= 0)
+		{
+			return;
+		}
+
+		// 전송은 curl 프로세스를 기다리는 일이므로 스레드 풀이 아닌 전용 스레드를 쓴다
+		// 스레드는 최대 한도만큼 띄우고, 실제로 몇 개가 동시에 도는지는 조절기가 정한다
+		TAtomic<int32> NextIndex(0);
+		TArray<TFuture<void>> Workers;
+		const int32 NumWorkers = FMath::Min(Controller.GetMaxLimit(), NumItems);
+		for (int32 WorkerIndex = 0; WorkerIndex < NumWorkers; ++WorkerIndex)
+		{
+			Workers.Add(Async(EAsyncExecution::Thread, [&Controller, &NextIndex, NumItems, Transfer]()
+			{
+				while (true)
+				{
+					const int32 Index = NextIndex++;
+					if (Index >= NumItems)
+					{
+						break;
+					}
+
+					// 버퍼 풀 예산이 차 있으면 진행 중인 전송이 버퍼를 돌려줄 때까지 새 전송을 늦춘다
+					// 시간 안에 비지 않아도 시작한다 - 멈추지 않는 것이 우선이고, 초과분은 풀이 Overcommits로 센다
+					FFtpBufferPool::WaitForCapacity(FFtpBufferPool::MaxSlabSize);
+
+					Controller.Acquire();
+					const FFtpTransferSample Sample = Transfer(Index);
+					Controller.Release(Sample);
+				}
+			}));
+		}
+
+		for (TFuture<void>& Worker : Workers)
+		{
+			Worker.Wait();
+		}
+	}
+}
@@ -0,0 +1,453 @@
+#include "FtpContentStore.h"
+#include "FtpIngestCommitter.h"
+#include "FtpIntegrity.h"
+#include "Async/ParallelFor.h"
+#include "Dom/JsonObject.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Guid.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+namespace FtpContentStore
+{
+	// 한 번에 올리는 객체 수 (UploadFilesBatch 한 번 = curl 한 번)
+	constexpr int32 ObjectBatchSize = 32;
+
+	static FString GetShardPath(const FString& RemoteRoot, const FString& Hash)
+	{
+		return RemoteRoot / TEXT("cas") / Hash.Left(2);
+	}
+
+	static FString GetManifestPath(const FString& RemoteRoot, const FString& ManifestName)
+	{
+		return RemoteRoot / TEXT("manifests") / (ManifestName + TEXT(".json"));
+	}
+
+	// 로컬 작업 디렉토리 (Saved/FileUpLoad/Manifests)
+	static FString GetLocalManifestDir()
+	{
+		return FPaths::ProjectSavedDir() / TEXT("FileUpLoad") / TEXT("Manifests");
+	}
+
+	FString GetObjectPath(const FString& RemoteRoot, const FString& Hash)
+	{
+		return GetShardPath(RemoteRoot, Hash) / Hash;
+	}
+
+	// 업로드 중인 객체 이름 - 40자가 아니므로 ListPresentObjects가 객체로 세지 않는다
+	static FString GetTempObjectPath(const FString& RemoteRoot, const FString& Hash, const FString& PushId)
+	{
+		return GetShardPath(RemoteRoot, Hash) / (Hash + TEXT(".") + PushId + TEXT(".part"));
+	}
+
+	static bool IsObjectHash(const FString& Hash)
+	{
+		if (Hash.Len() != 40)
+		{
+			return false;
+		}
+		for (const TCHAR Char : Hash)
+		{
+			if (!FChar::IsHexDigit(Char))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// 매니페스트 경로를 LocalPath 아래의 절대 경로로 바꾼다. 절대 경로나 LocalPath 밖을 가리키면 false
+	static bool ResolveEntryPath(const FString& LocalPath, const FString& EntryPath, FString& OutTargetPath)
+	{
+		FString Relative = EntryPath;
+		FPaths::NormalizeFilename(Relative);
+		if (Relative.IsEmpty() || Relative.StartsWith(TEXT("/")) || Relative.Contains(TEXT(":")))
+		{
+			return false;
+		}
+
+		const FString Root = FPaths::ConvertRelativePathToFull(LocalPath);
+		OutTargetPath = Root / Relative;
+		if (!FPaths::CollapseRelativeDirectories(OutTargetPath))
+		{
+			return false;
+		}
+		return OutTargetPath != Root && FPaths::IsUnderDirectory(OutTargetPath, Root);
+	}
+
+	// 필요한 샤드 디렉토리들을 curl 한 번으로 나열해 서버에 이미 있는 객체 이름을 모은다
+	// 객체 이름이 곧 해시이므로 어느 샤드에서 나왔는지는 구분할 필요가 없다
+	static bool ListPresentObjects(const FString& User, const FString& RemoteRoot, const TSet<FString>& Shards, TSet<FString>& OutPresent)
+	{
+		FFtpUserConfig* UserConfig = GetUser(User);
+		if (!UserConfig || Shards.Num() == 0)
+		{
+			return UserConfig != nullptr;
+		}
+
+		FString ListConfig;
+		for (const FString& Shard : Shards)
+		{
+			ListConfig += FString::Printf(TEXT("url = \"%s/\"\n"), *EscapeCurlConfigValue(CreateFtpUrl(User, RemoteRoot / TEXT("cas") / Shard)));
+		}
+
+		const FString ListPath = FPaths::ConvertRelativePathToFull(FPaths::CreateTempFilename(*GetCurlPrivateDir(), TEXT("cas"), TEXT(".cfg")));
+		if (!FFileHelper::SaveStringToFile(ListConfig, *ListPath))
+		{
+			LogFtpMessage(FString::Printf(TEXT("Content store: cannot write %s"), *ListPath), true);
+			return false;
+		}
+
+		FFtpCurlSessionScope CurlSession;
+		// 아직 없는 샤드는 550으로 실패하지만 curl은 다음 URL로 계속 진행한다
+		const FString Command = FString::Printf(TEXT("%s -K \"%s\" --list-only --ftp-pasv --silent"),
+			*BuildCurlSessionArgs(UserConfig->Username, UserConfig->Password, GFtpSecurityConfig.bUseFtps), *ListPath);
+
+		FString Output, Error;
+		ExecuteCurlCommand(Command, Output, Error);
+		IFileManager::Get().Delete(*ListPath);
+
+		TArray<FString> Lines;
+		Output.ParseIntoArrayLines(Lines);
+		for (const FString& Line : Lines)
+		{
+			// 서버에 따라 NLST가 경로를 붙여 돌려준다
+			const FString Name = FPaths::GetCleanFilename(Line.TrimStartAndEnd());
+			if (Name.Len() == 40)
+			{
+				OutPresent.Add(Name.ToLower());
+			}
+		}
+		return true;
+	}
+
+	// FTP 명령들을 curl 한 번으로 보낸다. 각 명령은 실패해도 다음 명령으로 넘어간다 ('*' 접두어)
+	static void RunQuoteCommands(const FString& User, const TArray<FString>& Commands)
+	{
+		FFtpUserConfig* UserConfig = GetUser(User);
+		if (!UserConfig || Commands.Num() == 0)
+		{
+			return;
+		}
+
+		FString QuoteConfig;
+		for (const FString& QuoteCommand : Commands)
+		{
+			QuoteConfig += FString::Printf(TEXT("quote = \"*%s\"\n"), *EscapeCurlConfigValue(QuoteCommand));
+		}
+
+		const FString QuotePath = FPaths::ConvertRelativePathToFull(FPaths::CreateTempFilename(*GetCurlPrivateDir(), TEXT("cas"), TEXT(".cfg")));
+		if (FFileHelper::SaveStringToFile(QuoteConfig, *QuotePath))
+		{
+			FFtpCurlSessionScope CurlSession;
+			const FString Command = FString::Printf(TEXT("%s -K \"%s\" \"%s\" --list-only --ftp-pasv --silent"),
+				*BuildCurlSessionArgs(UserConfig->Username, UserConfig->Password, GFtpSecurityConfig.bUseFtps), *QuotePath, *CreateFtpUrl(User, TEXT("/")));
+
+			FString Output, Error;
+			ExecuteCurlCommand(Command, Output, Error);
+			IFileManager::Get().Delete(*QuotePath);
+		}
+	}
+
+	static FString ToCommandPath(const FString& RemotePath)
+	{
+		FString CommandPath = RemotePath;
+		CommandPath.RemoveFromStart(TEXT("/"));
+		return CommandPath;
+	}
+
+	FString SerializeManifest(const FString& ManifestName, const TArray<FFtpManifestEntry>& Entries)
+	{
+		TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+		Root->SetStringField(TEXT("Name"), ManifestName);
+		Root->SetStringField(TEXT("Created"), FDateTime::UtcNow().ToIso8601());
+
+		TArray<TSharedPtr<FJsonValue>> Files;
+		Files.Reserve(Entries.Num());
+		for (const FFtpManifestEntry& Entry : Entries)
+		{
+			TSharedRef<FJsonObject> File = MakeShared<FJsonObject>();
+			File->SetStringField(TEXT("Path"), Entry.Path);
+			File->SetStringField(TEXT("Hash"), Entry.Hash);
+			File->SetNumberField(TEXT("Size"), (double)Entry.Size);
+			Files.Add(MakeShared<FJsonValueObject>(File));
+		}
+		Root->SetArrayField(TEXT("Files"), Files);
+
+		FString JsonText;
+		TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonText);
+		FJsonSerializer::Serialize(Root, Writer);
+		return JsonText;
+	}
+
+	bool ParseManifest(const FString& JsonText, TArray<FFtpManifestEntry>& OutEntries)
+	{
+		TSharedPtr<FJsonObject> Root;
+		TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(JsonText);
+		const TArray<TSharedPtr<FJsonValue>>* Files = nullptr;
+		if (!FJsonSerializer::Deserialize(Reader, Root) || !Root.IsValid() || !Root->TryGetArrayField(TEXT("Files"), Files))
+		{
+			return false;
+		}
+
+		for (const TSharedPtr<FJsonValue>& Value : *Files)
+		{
+			const TSharedPtr<FJsonObject>* File = nullptr;
+			if (!Value.IsValid() || !Value->TryGetObject(File))
+			{
+				continue;
+			}
+
+			FFtpManifestEntry Entry;
+			double Size = 0.0;
+			(*File)->TryGetStringField(TEXT("Path"), Entry.Path);
+			(*File)->TryGetStringField(TEXT("Hash"), Entry.Hash);
+			(*File)->TryGetNumberField(TEXT("Size"), Size);
+			Entry.Size = (int64)Size;
+
+			if (!Entry.Path.IsEmpty() && Entry.Hash.Len() == 40)
+			{
+				OutEntries.Add(MoveTemp(Entry));
+			}
+		}
+		return true;
+	}
+
+	FFtpContentStoreStats PushSnapshot(const FString& LocalPath, const FString& RemoteRoot, const FString& ManifestName, const FString& User, const FString& Pass)
+	{
+		FFtpContentStoreStats Stats;
+
+		if (!AuthenticateUser(User, Pass))
+		{
+			LogFtpMessage(FString::Printf(TEXT("Content store: authentication failed for %s"), *User), true);
+			Stats.bAborted = true;
+			return Stats;
+		}
+
+		if (!FPaths::DirectoryExists(LocalPath))
+		{
+			LogFtpMessage(FString::Printf(TEXT("Content store: Local path does not exist: %s"), *LocalPath), true);
+			Stats.bAborted = true;
+			return Stats;
+		}
+
+		TArray<FString> AllFiles;
+		FPlatformFileManager::Get().GetPlatformFile().FindFilesRecursively(AllFiles, *LocalPath, TEXT(""));
+
+		// 1단계: 모든 파일 해시 (병렬)
+		TArray<FFtpLocalDigest> Digests;
+		Digests.SetNum(AllFiles.Num());
+		ParallelFor(AllFiles.Num(), [&AllFiles, &Digests](int32 Index)
+		{
+			FtpIntegrity::ComputeLocalDigest(AllFiles[Index], Digests[Index]);
+		});
+
+		// 2단계: 매니페스트와 고유 객체 목록 (같은 내용은 첫 파일 하나만 대표로 올린다)
+		TArray<FFtpManifestEntry> Entries;
+		TMap<FString, int32> ObjectSources;
+		TSet<FString> Shards;
+		for (int32 Index = 0; Index < AllFiles.Num(); ++Index)
+		{
+			if (!Digests[Index].bValid)
+			{
+				LogFtpMessage(FString::Printf(TEXT("Content store: cannot read %s"), *AllFiles[Index]), true);
+				Stats.FailCount++;
+				continue;
+			}
+
+			FFtpManifestEntry& Entry = Entries.AddDefaulted_GetRef();
+			Entry.Path = AllFiles[Index];
+			FPaths::MakePathRelativeTo(Entry.Path, *(LocalPath / TEXT("")));
+			Entry.Hash = Digests[Index].Sha1.ToLower();
+			Entry.Size = Digests[Index].Size;
+
+			if (!ObjectSources.Contains(Entry.Hash))
+			{
+				ObjectSources.Add(Entry.Hash, Index);
+				Shards.Add(Entry.Hash.Left(2));
+			}
+			else
+			{
+				Stats.SkippedBytes += Entry.Size;
+			}
+		}
+		Stats.UniqueObjects = ObjectSources.Num();
+
+		// 3단계: 서버에 이미 있는 객체 확인
+		TSet<FString> Present;
+		if (!ListPresentObjects(User, RemoteRoot, Shards, Present))
+		{
+			Stats.bAborted = true;
+			return Stats;
+		}
+
+		// 이번 푸시의 임시 이름 - 다른 푸시나 다른 매니페스트가 쓰는 객체와 겹치지 않는다
+		const FString PushId = FGuid::NewGuid().ToString(EGuidFormats::Digits);
+
+		TArray<FFtpUploadRequest> Missing;
+		TArray<FString> MissingHashes;
+		for (const TPair<FString, int32>& Object : ObjectSources)
+		{
+			if (Present.Contains(Object.Key))
+			{
+				Stats.SkippedBytes += Digests[Object.Value].Size;
+				continue;
+			}
+
+			FFtpUploadRequest& Request = Missing.AddDefaulted_GetRef();
+			Request.LocalPath = AllFiles[Object.Value];
+			Request.RemotePath = GetTempObjectPath(RemoteRoot, Object.Key, PushId);
+			MissingHashes.Add(Object.Key);
+		}
+
+		LogFtpMessage(FString::Printf(TEXT("Content store: %d files, %d unique objects, %d already on server, %d to upload"),
+			AllFiles.Num(), ObjectSources.Num(), ObjectSources.Num() - Missing.Num(), Missing.Num()));
+
+		// 4단계: 새 객체를 임시 이름으로 올리고, 끝까지 올라간 것만 RNFR/RNTO로 최종 이름에 게시한다
+		// 잘린 업로드는 최종 이름에 나타나지 않으므로 다른 푸시가 반쯤 쓴 객체를 있는 것으로 오인하지 않는다
+		int32 FailedObjects = 0;
+		for (int32 BatchStart = 0; BatchStart < Missing.Num(); BatchStart += ObjectBatchSize)
+		{
+			const int32 BatchCount = FMath::Min(ObjectBatchSize, Missing.Num() - BatchStart);
+			TArray<FFtpUploadRequest> Batch(Missing.GetData() + BatchStart, BatchCount);
+
+			TArray<bool> BatchSuccess;
+			UploadFilesBatch(User, Batch, BatchSuccess);
+
+			TArray<FString> RenameCommands;
+			TArray<FString> CleanupCommands;
+			TSet<FString> BatchShards;
+			for (int32 Index = 0; Index < BatchCount; ++Index)
+			{
+				const FString& Hash = MissingHashes[BatchStart + Index];
+				if (BatchSuccess[Index])
+				{
+					RenameCommands.Add(TEXT("RNFR ") + ToCommandPath(Batch[Index].RemotePath));
+					RenameCommands.Add(TEXT("RNTO ") + ToCommandPath(GetObjectPath(RemoteRoot, Hash)));
+					BatchShards.Add(Hash.Left(2));
+				}
+				// 이번 푸시가 만든 임시 이름만 지운다 - 최종 이름은 다른 매니페스트가 가리킬 수 있다
+				CleanupCommands.Add(TEXT("DELE ") + ToCommandPath(Batch[Index].RemotePath));
+			}
+			RunQuoteCommands(User, RenameCommands);
+
+			// 게시 결과는 다시 나열해 확인한다 (curl은 '*' 명령의 실패를 알려 주지 않는다)
+			TSet<FString> Published;
+			ListPresentObjects(User, RemoteRoot, BatchShards, Published);
+
+			for (int32 Index = 0; Index < BatchCount; ++Index)
+			{
+				if (BatchSuccess[Index] && Published.Contains(MissingHashes[BatchStart + Index]))
+				{
+					Stats.UploadedObjects++;
+					Stats.UploadedBytes += IFileManager::Get().FileSize(*Batch[Index].LocalPath);
+				}
+				else
+				{
+					FailedObjects++;
+				}
+			}
+
+			// 이름을 바꾼 임시 파일은 이미 없으므로 DELE가 실패하고 넘어간다
+			RunQuoteCommands(User, CleanupCommands);
+		}
+
+		// 5단계: 객체가 모두 있을 때만 매니페스트 게시
+		if (FailedObjects == 0 && Stats.FailCount == 0)
+		{
+			const FString LocalManifest = GetLocalManifestDir() / (ManifestName + TEXT(".json"));
+			if (FFileHelper::SaveStringToFile(SerializeManifest(ManifestName, Entries), *LocalManifest)
+				&& UploadFile(User, LocalManifest, GetManifestPath(RemoteRoot, ManifestName)))
+			{
+				Stats.SuccessCount = Entries.Num();
+			}
+			else
+			{
+				LogFtpMessage(FString::Printf(TEXT("Content store: failed to publish manifest %s"), *ManifestName), true);
+				Stats.FailCount += Entries.Num();
+			}
+		}
+		else
+		{
+			LogFtpMessage(FString::Printf(TEXT("Content store: %d object(s) failed, manifest %s not published"), FailedObjects, *ManifestName), true);
+			Stats.FailCount += FailedObjects;
+		}
+
+		LogFtpMessage(FString::Printf(TEXT("Content store: uploaded %d object(s), %lld bytes; skipped %lld duplicate/existing bytes"),
+			Stats.UploadedObjects, Stats.UploadedBytes, Stats.SkippedBytes));
+		return Stats;
+	}
+
+	FFtpSyncStats PullSnapshot(const FString& RemoteRoot, const FString& ManifestName, const FString& LocalPath, const FString& User, const FString& Pass)
+	{
+		if (!AuthenticateUser(User, Pass))
+		{
+			LogFtpMessage(FString::Printf(TEXT("Content store: authentication failed for %s"), *User), true);
+			return FFtpSyncStats::Aborted();
+		}
+
+		const FString LocalManifest = GetLocalManifestDir() / (ManifestName + TEXT(".json"));
+		FString JsonText;
+		TArray<FFtpManifestEntry> Entries;
+		IFileManager::Get().MakeDirectory(*GetLocalManifestDir(), true);
+		if (!DownloadFile(User, GetManifestPath(RemoteRoot, ManifestName), LocalManifest)
+			|| !FFileHelper::LoadFileToString(JsonText, *LocalManifest)
+			|| !ParseManifest(JsonText, Entries))
+		{
+			LogFtpMessage(FString::Printf(TEXT("Content store: cannot load manifest %s"), *ManifestName), true);
+			return FFtpSyncStats::Aborted();
+		}
+
+		int32 SuccessCount = 0;
+		int32 FailCount = 0;
+		TMap<FString, FString> Restored;
+		for (const FFtpManifestEntry& Entry : Entries)
+		{
+			// 매니페스트는 서버에서 온 것이므로 경로와 해시를 믿지 않는다
+			FString TargetPath;
+			if (!IsObjectHash(Entry.Hash) || !ResolveEntryPath(LocalPath, Entry.Path, TargetPath))
+			{
+				LogFtpMessage(FString::Printf(TEXT("Content store: rejected manifest entry %s"), *Entry.Path), true);
+				FailCount++;
+				continue;
+			}
+			IFileManager::Get().MakeDirectory(*FPaths::GetPath(TargetPath), true);
+
+			// 임시 파일로 받아 해시가 맞을 때만 제자리로 옮긴다 - 실패해도 기존 파일은 그대로다
+			const FString TempPath = FFtpIngestCommitter::MakeTempPath(TargetPath);
+			bool bSuccess = false;
+			if (const FString* Existing = Restored.Find(Entry.Hash))
+			{
+				bSuccess = IFileManager::Get().Copy(*TempPath, **Existing) == COPY_OK;
+			}
+			else if (DownloadFile(User, GetObjectPath(RemoteRoot, Entry.Hash), TempPath, Entry.Size))
+			{
+				FFtpLocalDigest Digest;
+				bSuccess = FtpIntegrity::ComputeLocalDigest(TempPath, Digest) && Digest.Sha1.Equals(Entry.Hash, ESearchCase::IgnoreCase);
+				if (!bSuccess)
+				{
+					LogFtpMessage(FString::Printf(TEXT("Content store: object %s does not match its hash"), *Entry.Hash), true);
+				}
+			}
+
+			if (bSuccess && FFtpIngestCommitter::ReplaceFile(TempPath, TargetPath))
+			{
+				Restored.FindOrAdd(Entry.Hash, TargetPath);
+				SuccessCount++;
+			}
+			else
+			{
+				IFileManager::Get().Delete(*TempPath, false, true, true);
+				FailCount++;
+			}
+		}
+
+		LogFtpMessage(FString::Printf(TEXT("Content store: restored %s (%d files, %d objects downloaded, %d failed)"),
+			*ManifestName, SuccessCount, Restored.Num(), FailCount), FailCount > 0);
+		return FFtpSyncStats(SuccessCount, FailCount);
+	}
+}
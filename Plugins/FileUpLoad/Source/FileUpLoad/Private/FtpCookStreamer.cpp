@@ -0,0 +1,396 @@
+#include "FtpCookStreamer.h"
+#include "FtpSystem.h"
+#include "FtpTransferPlan.h"
+#include "FtpUploadQueue.h"
+#include "FileUpLoadStats.h"
+#include "FileUpLoadTrace.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "HAL/Event.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/App.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "UObject/ObjectSaveContext.h"
+#include "UObject/Package.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Cook Packages Waiting"), STAT_FileUpLoad_CookPackagesWaiting, STATGROUP_FileUpLoad);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Cook Packages Streamed"), STAT_FileUpLoad_CookPackagesStreamed, STATGROUP_FileUpLoad);
+
+namespace FtpCookStreamerInternal
+{
+	// 쿡된 헤더(.uasset/.umap)와 함께 쓰이는 파일들
+	static const TCHAR* CompanionExtensions[] = { TEXT(".uexp"), TEXT(".ubulk"), TEXT(".uptnl"), TEXT(".m.ubulk") };
+
+	// 감시 스레드가 대기 중인 패키지를 다시 보는 간격
+	static constexpr uint32 PollIntervalMs = 100;
+
+	// 업로드 큐가 빌 때까지 기다리는 최대 시간
+	static constexpr double DrainTimeoutSeconds = 3600.0;
+
+	static FString NormalizeDirectory(const FString& Directory)
+	{
+		FString Result = FPaths::ConvertRelativePathToFull(Directory);
+		FPaths::NormalizeDirectoryName(Result);
+		return Result;
+	}
+}
+
+FFtpCookStreamer::FFtpCookStreamer(const FFtpCookStreamSettings& InSettings)
+	: Settings(InSettings)
+	, NumWaiting(0)
+	, NumStreamedPackages(0)
+	, NumMissingPackages(0)
+	, bStopping(false)
+{
+	if (Settings.CookedRoot.IsEmpty())
+	{
+		Settings.CookedRoot = FPaths::ProjectSavedDir() / TEXT("Cooked");
+	}
+	Settings.CookedRoot = FtpCookStreamerInternal::NormalizeDirectory(Settings.CookedRoot);
+}
+
+FFtpCookStreamer::~FFtpCookStreamer()
+{
+	if (SavedHandle.IsValid())
+	{
+		UPackage::PackageSavedWithContextEvent.Remove(SavedHandle);
+		SavedHandle.Reset();
+	}
+
+	if (Thread != nullptr)
+	{
+		Thread->Kill(true);
+		delete Thread;
+		Thread = nullptr;
+	}
+
+	if (WorkEvent != nullptr)
+	{
+		FPlatformProcess::ReturnSynchEventToPool(WorkEvent);
+		WorkEvent = nullptr;
+	}
+
+	UploadQueue.Reset();
+}
+
+bool FFtpCookStreamer::LoadSettings(const FString& JobSpecPath, FFtpCookStreamSettings& OutSettings)
+{
+	FString JsonText;
+	if (!FFileHelper::LoadFileToString(JsonText, *JobSpecPath))
+	{
+		LogFtpMessage(FString::Printf(TEXT("Cook streaming: cannot read job spec %s"), *JobSpecPath), true);
+		return false;
+	}
+
+	TSharedPtr<FJsonObject> Spec;
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(JsonText);
+	if (!FJsonSerializer::Deserialize(Reader, Spec) || !Spec.IsValid())
+	{
+		LogFtpMessage(FString::Printf(TEXT("Cook streaming: invalid JSON in %s"), *JobSpecPath), true);
+		return false;
+	}
+
+	if (!Spec->TryGetStringField(TEXT("User"), OutSettings.User) || !Spec->TryGetStringField(TEXT("Password"), OutSettings.Password))
+	{
+		LogFtpMessage(TEXT("Cook streaming: job spec needs \"User\" and \"Password\""), true);
+		return false;
+	}
+
+	const TSharedPtr<FJsonObject>* ServerObject = nullptr;
+	if (Spec->TryGetObjectField(TEXT("Server"), ServerObject))
+	{
+		(*ServerObject)->TryGetStringField(TEXT("Address"), GServerAddress);
+		(*ServerObject)->TryGetNumberField(TEXT("Port"), GServerPort);
+		(*ServerObject)->TryGetNumberField(TEXT("MaxConnections"), GServerMaxConnections);
+	}
+
+	const TSharedPtr<FJsonObject>* StreamObject = nullptr;
+	if (Spec->TryGetObjectField(TEXT("StreamCook"), StreamObject))
+	{
+		const FJsonObject& Stream = **StreamObject;
+		Stream.TryGetStringField(TEXT("Remote"), OutSettings.RemoteRoot);
+		if (Stream.TryGetStringField(TEXT("CookedRoot"), OutSettings.CookedRoot) && FPaths::IsRelative(OutSettings.CookedRoot))
+		{
+			OutSettings.CookedRoot = FPaths::ProjectDir() / OutSettings.CookedRoot;
+		}
+		Stream.TryGetBoolField(TEXT("MirrorDeletes"), OutSettings.bMirrorDeletes);
+		Stream.TryGetNumberField(TEXT("BatchFiles"), OutSettings.BatchFiles);
+		Stream.TryGetNumberField(TEXT("StableSeconds"), OutSettings.StableSeconds);
+	}
+
+	return true;
+}
+
+bool FFtpCookStreamer::Start()
+{
+	if (IsStreaming())
+	{
+		return true;
+	}
+
+	if (!AuthenticateUser(Settings.User, Settings.Password))
+	{
+		LogFtpMessage(FString::Printf(TEXT("Cook streaming disabled: authentication failed for %s"), *Settings.User), true);
+		return false;
+	}
+
+	StartUtc = FDateTime::UtcNow();
+	bStopping = false;
+	UploadQueue = MakeUnique<FFtpUploadQueue>(Settings.User, Settings.BatchFiles);
+	WorkEvent = FPlatformProcess::GetSynchEventFromPool(false);
+	Thread = FRunnableThread::Create(this, TEXT("FtpCookStreamer"));
+
+	SavedHandle = UPackage::PackageSavedWithContextEvent.AddRaw(this, &FFtpCookStreamer::OnPackageSaved);
+
+	LogFtpMessage(FString::Printf(TEXT("Cook streaming: %s -> %s"), *Settings.CookedRoot, *Settings.RemoteRoot));
+	FtpTrace::Bookmark(TEXT("FTP 쿡 스트리밍 시작"));
+	return true;
+}
+
+void FFtpCookStreamer::OnPackageSaved(const FString& PackageFilename, UPackage* Package, FObjectPostSaveContext SaveContext)
+{
+	// 에디터 저장 등은 ChangeDiscovery가 다룬다
+	if (!SaveContext.IsCooking())
+	{
+		return;
+	}
+
+	const FString HeaderPath = FPaths::ConvertRelativePathToFull(PackageFilename);
+	FString RelativePath = HeaderPath;
+	if (!RelativePath.RemoveFromStart(Settings.CookedRoot + TEXT("/")))
+	{
+		// -OutputDir로 다른 곳에 쿡하는 경우 - CookedRoot를 맞춰야 한다
+		UE_LOG(LogTemp, Verbose, TEXT("Cook streaming: %s is outside %s"), *HeaderPath, *Settings.CookedRoot);
+		return;
+	}
+
+	int32 SlashIndex = INDEX_NONE;
+	if (!RelativePath.FindChar(TEXT('/'), SlashIndex))
+	{
+		return;
+	}
+
+	{
+		FScopeLock ScopeLock(&InboxLock);
+		Inbox.Add(HeaderPath);
+		Platforms.Add(RelativePath.Left(SlashIndex));
+	}
+	WorkEvent->Trigger();
+}
+
+uint32 FFtpCookStreamer::Run()
+{
+	while (!bStopping)
+	{
+		// 기다리는 패키지가 있으면 주기적으로 다시 본다
+		WorkEvent->Wait(Waiting.Num() > 0 ? FtpCookStreamerInternal::PollIntervalMs : MAX_uint32);
+
+		// 꺼내는 순간에도 Finish가 빈 상태로 보지 않도록 대기 수를 함께 올린다
+		TArray<FString> NewPackages;
+		{
+			FScopeLock ScopeLock(&InboxLock);
+			NewPackages = MoveTemp(Inbox);
+			Inbox.Reset();
+			NumWaiting = Waiting.Num() + NewPackages.Num();
+		}
+
+		const double Now = FPlatformTime::Seconds();
+		for (const FString& HeaderPath : NewPackages)
+		{
+			// 같은 패키지를 다시 저장하면 안정 시간을 처음부터 잰다
+			FWaitingPackage& Package = Waiting.FindOrAdd(HeaderPath);
+			if (Package.FirstSeenTime == 0.0)
+			{
+				Package.FirstSeenTime = Now;
+			}
+			Package.LastChangeTime = Now;
+			Package.LastSignature = MIN_int64;
+		}
+
+		PollWaiting(Now);
+	}
+
+	return 0;
+}
+
+void FFtpCookStreamer::Stop()
+{
+	bStopping = true;
+	if (WorkEvent != nullptr)
+	{
+		WorkEvent->Trigger();
+	}
+}
+
+void FFtpCookStreamer::PollWaiting(double Now)
+{
+	FTP_TRACE_SCOPE(CookPoll);
+
+	for (auto It = Waiting.CreateIterator(); It; ++It)
+	{
+		FWaitingPackage& Package = It.Value();
+		const int64 Signature = GetPackageSignature(It.Key());
+		if (Signature < 0)
+		{
+			// 헤더가 아직 없음 - 오래 안 나타나면 정리 단계에 맡긴다
+			if (Now - Package.FirstSeenTime > Settings.MissingTimeoutSeconds)
+			{
+				++NumMissingPackages;
+				It.RemoveCurrent();
+			}
+			continue;
+		}
+
+		if (Signature != Package.LastSignature)
+		{
+			Package.LastSignature = Signature;
+			Package.LastChangeTime = Now;
+			continue;
+		}
+
+		if (Now - Package.LastChangeTime >= Settings.StableSeconds)
+		{
+			EnqueuePackage(It.Key());
+			++NumStreamedPackages;
+			INC_DWORD_STAT(STAT_FileUpLoad_CookPackagesStreamed);
+			It.RemoveCurrent();
+		}
+	}
+
+	NumWaiting = Waiting.Num();
+	SET_DWORD_STAT(STAT_FileUpLoad_CookPackagesWaiting, Waiting.Num());
+}
+
+int64 FFtpCookStreamer::GetPackageSignature(const FString& HeaderPath) const
+{
+	IFileManager& FileManager = IFileManager::Get();
+	const int64 HeaderSize = FileManager.FileSize(*HeaderPath);
+	if (HeaderSize < 0)
+	{
+		return -1;
+	}
+
+	// 없는 동반 파일은 -1로 섞는다
+	int64 Signature = HeaderSize;
+	for (const TCHAR* Extension : FtpCookStreamerInternal::CompanionExtensions)
+	{
+		Signature = Signature * 31 + FileManager.FileSize(*FPaths::ChangeExtension(HeaderPath, Extension));
+	}
+	return Signature & MAX_int64;
+}
+
+void FFtpCookStreamer::EnqueuePackage(const FString& HeaderPath)
+{
+	// 동반 파일을 먼저 넣는다 - 서버에서 헤더가 보이면 그 헤더가 가리키는 .uexp/.ubulk도 이미 있어야 한다
+	for (const TCHAR* Extension : FtpCookStreamerInternal::CompanionExtensions)
+	{
+		const FString CompanionPath = FPaths::ChangeExtension(HeaderPath, Extension);
+		if (IFileManager::Get().FileSize(*CompanionPath) >= 0)
+		{
+			UploadQueue->Enqueue(CompanionPath, MakeRemotePath(CompanionPath));
+		}
+	}
+	UploadQueue->Enqueue(HeaderPath, MakeRemotePath(HeaderPath));
+}
+
+FString FFtpCookStreamer::MakeRemotePath(const FString& LocalPath) const
+{
+	FString RelativePath = LocalPath;
+	RelativePath.RemoveFromStart(Settings.CookedRoot + TEXT("/"));
+	return Settings.RemoteRoot / RelativePath;
+}
+
+bool FFtpCookStreamer::IsPlatformCookComplete(const FString& Platform) const
+{
+	// 쿡은 플랫폼마다 마지막에 개발용 에셋 레지스트리를 쓴다
+	const FString RegistryPath = Settings.CookedRoot / Platform / FApp::GetProjectName() / TEXT("Metadata") / TEXT("DevelopmentAssetRegistry.bin");
+	const FDateTime Written = IFileManager::Get().GetTimeStamp(*RegistryPath);
+	return Written != FDateTime::MinValue() && Written >= StartUtc;
+}
+
+bool FFtpCookStreamer::Finish()
+{
+	using namespace FtpCookStreamerInternal;
+
+	if (!IsStreaming())
+	{
+		return false;
+	}
+
+	FTP_TRACE_SCOPE(CookFinish);
+
+	UPackage::PackageSavedWithContextEvent.Remove(SavedHandle);
+	SavedHandle.Reset();
+
+	// 아직 쓰이는 중인 패키지를 마저 넘긴다 - 안 나타나는 것은 MissingTimeoutSeconds 뒤 감시 스레드가 버린다
+	const double WaitEnd = FPlatformTime::Seconds() + Settings.MissingTimeoutSeconds + Settings.StableSeconds + 1.0;
+	while (FPlatformTime::Seconds() < WaitEnd)
+	{
+		bool bDrained = false;
+		{
+			FScopeLock ScopeLock(&InboxLock);
+			bDrained = Inbox.Num() == 0 && NumWaiting.Load() == 0;
+		}
+		if (bDrained)
+		{
+			break;
+		}
+		WorkEvent->Trigger();
+		FPlatformProcess::Sleep(0.05f);
+	}
+
+	Stop();
+	Thread->WaitForCompletion();
+	delete Thread;
+	Thread = nullptr;
+
+	if (!UploadQueue->WaitUntilIdle(DrainTimeoutSeconds))
+	{
+		LogFtpMessage(TEXT("Cook streaming: upload queue did not drain, leaving the rest to reconciliation"), true);
+	}
+	const int32 NumStreamedFiles = UploadQueue->GetNumUploaded();
+	const int32 NumStreamFailures = UploadQueue->GetNumFailed();
+	UploadQueue.Reset();
+
+	LogFtpMessage(FString::Printf(TEXT("Cook streaming: %d package(s), %d file(s) uploaded during the cook, %d failed, %d never appeared"),
+		NumStreamedPackages.Load(), NumStreamedFiles, NumStreamFailures, NumMissingPackages.Load()), NumStreamFailures > 0);
+
+	TArray<FString> PlatformNames;
+	{
+		FScopeLock ScopeLock(&InboxLock);
+		PlatformNames = Platforms.Array();
+	}
+
+	// 정리 단계 - 스트리밍이 놓친 파일(실패, 쿡 끝에 쓰인 메타데이터)을 올리고 쿡이 끝난 플랫폼은 삭제까지 맞춘다
+	FFtpSyncStats Total;
+	for (const FString& Platform : PlatformNames)
+	{
+		const bool bComplete = IsPlatformCookComplete(Platform);
+		if (!bComplete && Settings.bMirrorDeletes)
+		{
+			LogFtpMessage(FString::Printf(TEXT("Cook streaming: %s cook did not finish, remote deletions skipped"), *Platform), true);
+		}
+
+		FFtpTransferPlan Plan;
+		if (!FtpPlanner::BuildPlan(Settings.CookedRoot / Platform, Settings.RemoteRoot / Platform, GServerAddress, Settings.User, Settings.Password, Settings.bMirrorDeletes && bComplete, Plan))
+		{
+			++Total.FailCount;
+			continue;
+		}
+
+		LogFtpMessage(FString::Printf(TEXT("Cook streaming: reconciling %s: %s"), *Platform, *FtpPlanner::DescribePlan(Plan)));
+		const FFtpSyncStats Stats = FtpPlanner::ExecutePlan(Plan, Settings.Password);
+		Total.SuccessCount += Stats.SuccessCount;
+		Total.FailCount += Stats.FailCount + (Stats.bAborted ? 1 : 0);
+	}
+
+	LogFtpMessage(FString::Printf(TEXT("Cook streaming finished: reconciliation %d succeeded, %d failed"), Total.SuccessCount, Total.FailCount), Total.FailCount > 0);
+	FtpTrace::Bookmark(TEXT("FTP 쿡 스트리밍 완료"));
+	return Total.FailCount == 0;
+}
@@ -0,0 +1,149 @@
+#include "FtpCurlProcess.h"
+#include "FtpSystem.h"
+
+#if PLATFORM_LINUX
+#include <poll.h>
+#elif PLATFORM_WINDOWS
+#include "Windows/WindowsHWrapper.h"
+#endif
+
+FFtpCurlProcess::~FFtpCurlProcess()
+{
+	if (ProcHandle.IsValid())
+	{
+		if (FPlatformProcess::IsProcRunning(ProcHandle))
+		{
+			FPlatformProcess::TerminateProc(ProcHandle);
+		}
+		FPlatformProcess::CloseProc(ProcHandle);
+	}
+
+	CloseStdIn();
+	FPlatformProcess::ClosePipe(StdOutRead, StdOutWrite);
+}
+
+bool FFtpCurlProcess::Launch(const FString& Params, bool bWithStdIn)
+{
+	if (!FPlatformProcess::CreatePipe(StdOutRead, StdOutWrite))
+	{
+		return false;
+	}
+
+	// 쓰기 쪽은 이 프로세스에만 남기고 읽기 쪽을 curl의 표준 입력으로 넘긴다
+	if (bWithStdIn && !FPlatformProcess::CreatePipe(StdInRead, StdInWrite, true))
+	{
+		return false;
+	}
+
+	FString Executable, LaunchParams;
+	GetCurlLaunchCommand(Params, Executable, LaunchParams);
+	ProcHandle = FPlatformProcess::CreateProc(*Executable, *LaunchParams, false, true, true, nullptr, 0, nullptr, StdOutWrite, StdInRead);
+	return ProcHandle.IsValid();
+}
+
+bool FFtpCurlProcess::Write(const uint8* Data, int64 Size)
+{
+	// WritePipe는 int32 길이만 받으므로 나눠서 쓴다
+	constexpr int64 MaxWriteSize = 1024 * 1024;
+
+	int64 Offset = 0;
+	while (Offset < Size)
+	{
+		const int32 ChunkSize = (int32)FMath::Min(Size - Offset, MaxWriteSize);
+		int32 Written = 0;
+		if (!FPlatformProcess::WritePipe(StdInWrite, Data + Offset, ChunkSize, &Written) || Written <= 0)
+		{
+			// 파이프가 가득 찬 경우와 curl이 이미 끝난 경우를 구분
+			if (!FPlatformProcess::IsProcRunning(ProcHandle))
+			{
+				return false;
+			}
+			DrainOutput();
+			FPlatformProcess::Sleep(0.001f);
+			continue;
+		}
+		Offset += Written;
+	}
+
+	return true;
+}
+
+void FFtpCurlProcess::CloseStdIn()
+{
+	if (StdInRead != nullptr || StdInWrite != nullptr)
+	{
+		FPlatformProcess::ClosePipe(StdInRead, StdInWrite);
+		StdInRead = nullptr;
+		StdInWrite = nullptr;
+	}
+}
+
+int32 FFtpCurlProcess::Wait(FString& OutOutput)
+{
+	if (!ProcHandle.IsValid())
+	{
+		return -1;
+	}
+
+	CloseStdIn();
+
+	while (FPlatformProcess::IsProcRunning(ProcHandle))
+	{
+		DrainOutput();
+		FPlatformProcess::Sleep(0.005f);
+	}
+	DrainOutput();
+
+	int32 ReturnCode = -1;
+	FPlatformProcess::GetProcReturnCode(ProcHandle, &ReturnCode);
+	FPlatformProcess::CloseProc(ProcHandle);
+
+	OutOutput = MoveTemp(Output);
+	return ReturnCode;
+}
+
+void FFtpCurlProcess::DrainOutput()
+{
+	Output += FPlatformProcess::ReadPipe(StdOutRead);
+}
+
+bool FFtpCurlProcess::ReadBinaryOutput(TArray<uint8>& OutData)
+{
+	OutData.Reset();
+	return FPlatformProcess::ReadPipeToArray(StdOutRead, OutData) && OutData.Num() > 0;
+}
+
+void FFtpCurlProcess::WaitForOutput(uint32 TimeoutMs)
+{
+#if PLATFORM_LINUX
+	// 데이터가 오면 바로 깨어난다
+	if (StdOutRead != nullptr)
+	{
+		pollfd PollDescriptor;
+		PollDescriptor.fd = static_cast<FPipeHandle*>(StdOutRead)->GetHandle();
+		PollDescriptor.events = POLLIN;
+		PollDescriptor.revents = 0;
+		poll(&PollDescriptor, 1, (int)TimeoutMs);
+		return;
+	}
+#elif PLATFORM_WINDOWS
+	// 익명 파이프는 기다릴 수 있는 핸들이 아니므로 비어 있을 때만 프로세스 핸들에서 1ms씩 잠든다
+	// (curl이 끝나면 바로 깨어나고, 자식들이 파이프 쓰기 핸들을 서로 물려받을 수 있어 막히는 ReadFile은 쓰지 않는다)
+	DWORD Available = 0;
+	if (StdOutRead != nullptr && ::PeekNamedPipe(StdOutRead, nullptr, 0, nullptr, &Available, nullptr) && Available > 0)
+	{
+		return;
+	}
+	if (ProcHandle.IsValid())
+	{
+		::WaitForSingleObject(ProcHandle.Get(), FMath::Min<uint32>(TimeoutMs, 1));
+		return;
+	}
+#endif
+	FPlatformProcess::Sleep(FMath::Min<uint32>(TimeoutMs, 1) / 1000.0f);
+}
+
+bool FFtpCurlProcess::IsRunning()
+{
+	return ProcHandle.IsValid() && FPlatformProcess::IsProcRunning(ProcHandle);
+}
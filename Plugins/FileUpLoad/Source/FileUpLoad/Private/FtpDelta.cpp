@@ -0,0 +1,777 @@
+#include "FtpDelta.h"
+#include "FileUpLoadTrace.h"
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeExit.h"
+#include "Serialization/Archive.h"
+
+namespace FtpDelta
+{
+	const TCHAR* SignatureExtension = TEXT(".ftpsig");
+	const TCHAR* DeltaExtension = TEXT(".ftpdelta");
+
+	static constexpr uint32 SignatureMagic = 0x47495346; // "FSIG"
+	static constexpr uint32 PatchMagic = 0x544C4446;     // "FDLT"
+	static constexpr uint32 FormatVersion = 1;
+
+	// 패치 명령
+	enum class EPatchOp : uint8
+	{
+		Copy = 0,
+		Data = 1,
+		End = 2
+	};
+
+	// 스캔 창 크기 및 리터럴 묶음 크기
+	static constexpr int32 ScanWindowSize = 8 * 1024 * 1024;
+	static constexpr int32 MaxLiteralRun = 1024 * 1024;
+
+	// rsync 약한 체크섬의 두 합 (mod 2^16은 비교할 때 적용)
+	// 단순 누적 루프라 컴파일러가 벡터화한다
+	static void ComputeWeakParts(const uint8* Data, int32 Length, uint32& OutA, uint32& OutB)
+	{
+		uint32 A = 0;
+		uint32 B = 0;
+		for (int32 Index = 0; Index < Length; ++Index)
+		{
+			A += Data[Index];
+			B += (uint32)(Length - Index) * Data[Index];
+		}
+		OutA = A;
+		OutB = B;
+	}
+
+	static uint32 PackWeak(uint32 A, uint32 B)
+	{
+		return (A & 0xffff) | (B << 16);
+	}
+
+	// BLAKE3는 내부적으로 SSE4.1/AVX2/AVX-512/NEON 구현을 골라 쓴다
+	static FFtpStrongSum ComputeStrong(const uint8* Data, int32 Length)
+	{
+		const FBlake3Hash Hash = FBlake3::HashBuffer(Data, Length);
+		FFtpStrongSum Strong;
+		FMemory::Memcpy(Strong.Bytes, Hash.GetBytes(), sizeof(Strong.Bytes));
+		return Strong;
+	}
+
+	static void SerializeHash(FArchive& Ar, FBlake3Hash& Hash)
+	{
+		Ar.Serialize(Hash.GetBytes(), sizeof(FBlake3Hash::ByteArray));
+	}
+
+	static bool ReadAll(IFileHandle& Handle, uint8* Data, int64 Size)
+	{
+		return Handle.Read(Data, Size);
+	}
+
+	int32 ChooseBlockSize(int64 FileSize)
+	{
+		const int64 Root = (int64)FMath::Sqrt((double)FMath::Max<int64>(FileSize, 1));
+		return (int32)FMath::Clamp<int64>(Align(Root, 1024), 4 * 1024, 256 * 1024);
+	}
+
+	bool ComputeSignature(const FString& FilePath, FFtpFileSignature& OutSignature)
+	{
+		FTP_TRACE_SCOPE(Signature);
+
+		TUniquePtr<IFileHandle> Handle(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*FilePath));
+		if (!Handle.IsValid())
+		{
+			return false;
+		}
+
+		OutSignature.FileSize = Handle->Size();
+		OutSignature.BlockSize = ChooseBlockSize(OutSignature.FileSize);
+
+		const int32 BlockSize = OutSignature.BlockSize;
+		const int64 NumBlocks = (OutSignature.FileSize + BlockSize - 1) / BlockSize;
+		OutSignature.WeakSums.SetNumUninitialized((int32)NumBlocks);
+		OutSignature.StrongSums.SetNumUninitialized((int32)NumBlocks);
+
+		// 창 단위로 읽어 블록 체크섬을 병렬로 계산
+		const int32 BlocksPerWindow = FMath::Max(1, ScanWindowSize / BlockSize);
+		TArray<uint8> Window;
+		Window.SetNumUninitialized(BlocksPerWindow * BlockSize);
+
+		FBlake3 FileHasher;
+		for (int64 FirstBlock = 0; FirstBlock < NumBlocks; FirstBlock += BlocksPerWindow)
+		{
+			const int64 WindowOffset = FirstBlock * BlockSize;
+			const int64 WindowBytes = FMath::Min<int64>(Window.Num(), OutSignature.FileSize - WindowOffset);
+			if (!ReadAll(*Handle, Window.GetData(), WindowBytes))
+			{
+				return false;
+			}
+			FileHasher.Update(Window.GetData(), WindowBytes);
+
+			const int32 WindowBlocks = (int32)((WindowBytes + BlockSize - 1) / BlockSize);
+			ParallelFor(WindowBlocks, [&](int32 LocalIndex)
+			{
+				const int64 Offset = (int64)LocalIndex * BlockSize;
+				const int32 Length = (int32)FMath::Min<int64>(BlockSize, WindowBytes - Offset);
+				uint32 A, B;
+				ComputeWeakParts(Window.GetData() + Offset, Length, A, B);
+				OutSignature.WeakSums[FirstBlock + LocalIndex] = PackWeak(A, B);
+				OutSignature.StrongSums[FirstBlock + LocalIndex] = ComputeStrong(Window.GetData() + Offset, Length);
+			});
+		}
+
+		OutSignature.FileHash = FileHasher.Finalize();
+		return true;
+	}
+
+	bool SaveSignature(const FFtpFileSignature& Signature, const FString& SignaturePath)
+	{
+		TUniquePtr<FArchive> Ar(IFileManager::Get().CreateFileWriter(*SignaturePath));
+		if (!Ar.IsValid())
+		{
+			return false;
+		}
+
+		uint32 Magic = SignatureMagic;
+		uint32 Version = FormatVersion;
+		int32 BlockSize = Signature.BlockSize;
+		int64 FileSize = Signature.FileSize;
+		FBlake3Hash FileHash = Signature.FileHash;
+		int32 NumBlocks = Signature.WeakSums.Num();
+
+		*Ar << Magic << Version << BlockSize << FileSize;
+		SerializeHash(*Ar, FileHash);
+		*Ar << NumBlocks;
+		Ar->Serialize(const_cast<uint32*>(Signature.WeakSums.GetData()), (int64)NumBlocks * sizeof(uint32));
+		Ar->Serialize(const_cast<FFtpStrongSum*>(Signature.StrongSums.GetData()), (int64)NumBlocks * sizeof(FFtpStrongSum));
+		return Ar->Close();
+	}
+
+	bool LoadSignature(const FString& SignaturePath, FFtpFileSignature& OutSignature)
+	{
+		TUniquePtr<FArchive> Ar(IFileManager::Get().CreateFileReader(*SignaturePath));
+		if (!Ar.IsValid())
+		{
+			return false;
+		}
+
+		uint32 Magic = 0;
+		uint32 Version = 0;
+		int32 NumBlocks = 0;
+		*Ar << Magic << Version;
+		if (Magic != SignatureMagic || Version != FormatVersion)
+		{
+			return false;
+		}
+
+		*Ar << OutSignature.BlockSize << OutSignature.FileSize;
+		SerializeHash(*Ar, OutSignature.FileHash);
+		*Ar << NumBlocks;
+
+		const int64 ExpectedBlocks = OutSignature.BlockSize > 0 ? (OutSignature.FileSize + OutSignature.BlockSize - 1) / OutSignature.BlockSize : -1;
+		if (Ar->IsError() || NumBlocks != ExpectedBlocks)
+		{
+			return false;
+		}
+
+		OutSignature.WeakSums.SetNumUninitialized(NumBlocks);
+		OutSignature.StrongSums.SetNumUninitialized(NumBlocks);
+		Ar->Serialize(OutSignature.WeakSums.GetData(), (int64)NumBlocks * sizeof(uint32));
+		Ar->Serialize(OutSignature.StrongSums.GetData(), (int64)NumBlocks * sizeof(FFtpStrongSum));
+		return !Ar->IsError();
+	}
+
+	// 패치 출력 - 연속 블록 복사는 하나로 합치고 리터럴은 모아서 쓴다
+	class FPatchWriter
+	{
+	public:
+		explicit FPatchWriter(FArchive& InAr)
+			: Ar(InAr)
+		{
+		}
+
+		void AddCopy(int32 BlockIndex)
+		{
+			FlushLiteral();
+			if (CopyCount > 0 && CopyStart + CopyCount == BlockIndex)
+			{
+				++CopyCount;
+				return;
+			}
+			FlushCopy();
+			CopyStart = BlockIndex;
+			CopyCount = 1;
+		}
+
+		void AddLiteral(const uint8* Data, int32 Length)
+		{
+			FlushCopy();
+			Literal.Append(Data, Length);
+			LiteralBytes += Length;
+			if (Literal.Num() >= MaxLiteralRun)
+			{
+				FlushLiteral();
+			}
+		}
+
+		void Finish()
+		{
+			FlushLiteral();
+			FlushCopy();
+			uint8 Op = (uint8)EPatchOp::End;
+			Ar << Op;
+		}
+
+		int64 LiteralBytes = 0;
+
+	private:
+		void FlushCopy()
+		{
+			if (CopyCount > 0)
+			{
+				uint8 Op = (uint8)EPatchOp::Copy;
+				Ar << Op << CopyStart << CopyCount;
+				CopyCount = 0;
+			}
+		}
+
+		void FlushLiteral()
+		{
+			if (Literal.Num() > 0)
+			{
+				uint8 Op = (uint8)EPatchOp::Data;
+				int32 Length = Literal.Num();
+				Ar << Op << Length;
+				Ar.Serialize(Literal.GetData(), Length);
+				Literal.Reset();
+			}
+		}
+
+		FArchive& Ar;
+		TArray<uint8> Literal;
+		int32 CopyStart = 0;
+		int32 CopyCount = 0;
+	};
+
+	bool CreateDeltaPatch(const FFtpFileSignature& BaseSignature, const FString& NewFilePath, const FString& PatchPath, int64& OutLiteralBytes)
+	{
+		OutLiteralBytes = 0;
+
+		TUniquePtr<IFileHandle> Input(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*NewFilePath));
+		TUniquePtr<FArchive> Ar(IFileManager::Get().CreateFileWriter(*PatchPath));
+		if (!Input.IsValid() || !Ar.IsValid() || BaseSignature.BlockSize <= 0)
+		{
+			return false;
+		}
+
+		const int32 BlockSize = BaseSignature.BlockSize;
+		const int64 NewSize = Input->Size();
+
+		// 꽉 찬 블록만 일치 후보 (마지막 짧은 블록은 리터럴로 보낸다)
+		const int32 NumFullBlocks = (int32)(BaseSignature.FileSize / BlockSize);
+		TMultiMap<uint32, int32> WeakLookup;
+		WeakLookup.Reserve(NumFullBlocks);
+		for (int32 BlockIndex = 0; BlockIndex < NumFullBlocks; ++BlockIndex)
+		{
+			WeakLookup.Add(BaseSignature.WeakSums[BlockIndex], BlockIndex);
+		}
+
+		// 헤더 - 대상 해시는 끝까지 읽은 뒤 채운다
+		uint32 Magic = PatchMagic;
+		uint32 Version = FormatVersion;
+		int32 HeaderBlockSize = BlockSize;
+		int64 BaseSize = BaseSignature.FileSize;
+		FBlake3Hash BaseHash = BaseSignature.FileHash;
+		int64 TargetSize = NewSize;
+		FBlake3Hash TargetHash;
+
+		*Ar << Magic << Version << HeaderBlockSize << BaseSize;
+		SerializeHash(*Ar, BaseHash);
+		*Ar << TargetSize;
+		const int64 TargetHashOffset = Ar->Tell();
+		SerializeHash(*Ar, TargetHash);
+
+		FPatchWriter Writer(*Ar);
+		FBlake3 TargetHasher;
+
+		TArray<uint8> Window;
+		Window.SetNumUninitialized(ScanWindowSize + BlockSize);
+		int32 WindowLength = 0;
+		int64 ReadOffset = 0;
+
+		int32 Position = 0;
+		bool bHaveWeak = false;
+		uint32 WeakA = 0;
+		uint32 WeakB = 0;
+
+		while (true)
+		{
+			if (Position + BlockSize > WindowLength)
+			{
+				if (ReadOffset >= NewSize)
+				{
+					break;
+				}
+
+				// 남은 바이트를 앞으로 당기고 이어서 읽는다 (약한 합은 내용 기준이라 그대로 유효)
+				WindowLength -= Position;
+				FMemory::Memmove(Window.GetData(), Window.GetData() + Position, WindowLength);
+				Position = 0;
+
+				const int64 ReadSize = FMath::Min<int64>(Window.Num() - WindowLength, NewSize - ReadOffset);
+				if (!ReadAll(*Input, Window.GetData() + WindowLength, ReadSize))
+				{
+					return false;
+				}
+				TargetHasher.Update(Window.GetData() + WindowLength, ReadSize);
+				WindowLength += (int32)ReadSize;
+				ReadOffset += ReadSize;
+				continue;
+			}
+
+			const uint8* Block = Window.GetData() + Position;
+			if (!bHaveWeak)
+			{
+				ComputeWeakParts(Block, BlockSize, WeakA, WeakB);
+				bHaveWeak = true;
+			}
+
+			int32 MatchedBlock = INDEX_NONE;
+			bool bStrongComputed = false;
+			FFtpStrongSum Strong;
+			for (auto It = WeakLookup.CreateConstKeyIterator(PackWeak(WeakA, WeakB)); It; ++It)
+			{
+				if (!bStrongComputed)
+				{
+					Strong = ComputeStrong(Block, BlockSize);
+					bStrongComputed = true;
+				}
+				if (BaseSignature.StrongSums[It.Value()] == Strong)
+				{
+					MatchedBlock = It.Value();
+					break;
+				}
+			}
+
+			if (MatchedBlock != INDEX_NONE)
+			{
+				Writer.AddCopy(MatchedBlock);
+				Position += BlockSize;
+				bHaveWeak = false;
+				continue;
+			}
+
+			// 한 바이트 밀고 체크섬을 굴린다
+			Writer.AddLiteral(Block, 1);
+			if (Position + BlockSize < WindowLength)
+			{
+				const uint32 Out = Block[0];
+				const uint32 In = Block[BlockSize];
+				WeakA = WeakA - Out + In;
+				WeakB = WeakB - (uint32)BlockSize * Out + WeakA;
+			}
+			else
+			{
+				bHaveWeak = false;
+			}
+			++Position;
+		}
+
+		// 남은 꼬리는 리터럴
+		if (Position < WindowLength)
+		{
+			Writer.AddLiteral(Window.GetData() + Position, WindowLength - Position);
+		}
+		Writer.Finish();
+
+		TargetHash = TargetHasher.Finalize();
+		Ar->Seek(TargetHashOffset);
+		SerializeHash(*Ar, TargetHash);
+
+		OutLiteralBytes = Writer.LiteralBytes;
+		return Ar->Close();
+	}
+
+	bool ApplyDeltaPatch(const FString& BasePath, const FString& PatchPath, const FString& OutPath, const FBlake3Hash* KnownBaseHash)
+	{
+		IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+		TUniquePtr<FArchive> Patch(IFileManager::Get().CreateFileReader(*PatchPath));
+		TUniquePtr<IFileHandle> Base(PlatformFile.OpenRead(*BasePath));
+		if (!Patch.IsValid() || !Base.IsValid())
+		{
+			return false;
+		}
+
+		uint32 Magic = 0;
+		uint32 Version = 0;
+		int32 BlockSize = 0;
+		int64 BaseSize = 0;
+		FBlake3Hash BaseHash;
+		int64 TargetSize = 0;
+		FBlake3Hash TargetHash;
+
+		*Patch << Magic << Version << BlockSize << BaseSize;
+		SerializeHash(*Patch, BaseHash);
+		*Patch << TargetSize;
+		SerializeHash(*Patch, TargetHash);
+
+		if (Patch->IsError() || Magic != PatchMagic || Version != FormatVersion || BlockSize <= 0 || Base->Size() != BaseSize)
+		{
+			LogFtpMessage(FString::Printf(TEXT("Delta patch does not match base: %s"), *BasePath), true);
+			return false;
+		}
+
+		// 다른 버전에 대해 만든 패치를 적용하지 않도록 기존 파일 해시 확인
+		FFtpFileSignature BaseSignature;
+		const bool bBaseHashKnown = KnownBaseHash != nullptr || ComputeSignature(BasePath, BaseSignature);
+		if (!bBaseHashKnown || (KnownBaseHash != nullptr ? *KnownBaseHash : BaseSignature.FileHash) != BaseHash)
+		{
+			LogFtpMessage(FString::Printf(TEXT("Delta patch base hash mismatch: %s"), *BasePath), true);
+			return false;
+		}
+
+		TUniquePtr<FArchive> Output(IFileManager::Get().CreateFileWriter(*OutPath));
+		if (!Output.IsValid())
+		{
+			return false;
+		}
+
+		FBlake3 OutputHasher;
+		int64 Written = 0;
+		TArray<uint8> Buffer;
+
+		while (!Patch->IsError())
+		{
+			uint8 Op = 0;
+			*Patch << Op;
+
+			if (Op == (uint8)EPatchOp::Copy)
+			{
+				int32 FirstBlock = 0;
+				int32 Count = 0;
+				*Patch << FirstBlock << Count;
+
+				const int64 Offset = (int64)FirstBlock * BlockSize;
+				const int64 Length = (int64)Count * BlockSize;
+				if (FirstBlock < 0 || Count <= 0 || Offset + Length > BaseSize || !Base->Seek(Offset))
+				{
+					break;
+				}
+
+				for (int64 Done = 0; Done < Length;)
+				{
+					const int64 Chunk = FMath::Min<int64>(Length - Done, ScanWindowSize);
+					Buffer.SetNumUninitialized((int32)Chunk);
+					if (!ReadAll(*Base, Buffer.GetData(), Chunk))
+					{
+						return false;
+					}
+					OutputHasher.Update(Buffer.GetData(), Chunk);
+					Output->Serialize(Buffer.GetData(), Chunk);
+					Done += Chunk;
+				}
+				Written += Length;
+			}
+			else if (Op == (uint8)EPatchOp::Data)
+			{
+				int32 Length = 0;
+				*Patch << Length;
+				if (Length <= 0 || Length > MaxLiteralRun * 2)
+				{
+					break;
+				}
+
+				Buffer.SetNumUninitialized(Length);
+				Patch->Serialize(Buffer.GetData(), Length);
+				OutputHasher.Update(Buffer.GetData(), Length);
+				Output->Serialize(Buffer.GetData(), Length);
+				Written += Length;
+			}
+			else
+			{
+				break;
+			}
+
+			if (Written > TargetSize)
+			{
+				break;
+			}
+		}
+
+		const bool bClosed = Output->Close();
+		Output.Reset();
+
+		if (!bClosed || Patch->IsError() || Written != TargetSize || OutputHasher.Finalize() != TargetHash)
+		{
+			LogFtpMessage(FString::Printf(TEXT("Delta patch produced wrong output for %s"), *BasePath), true);
+			IFileManager::Get().Delete(*OutPath);
+			return false;
+		}
+		return true;
+	}
+
+	// 서버 파일을 조용히 받아 온다 (서명이 아직 없는 것은 정상이므로 이력/오류로 남기지 않는다)
+	static bool FetchRemoteFile(const FFtpUserConfig& User, const FString& RemotePath, const FString& LocalPath)
+	{
+		FFtpCurlSessionScope CurlSession;
+		const FString Command = FString::Printf(TEXT("%s \"%s\" -o \"%s\" --ftp-pasv --silent --fail"),
+			*BuildCurlSessionArgs(User.Username, User.Password, GFtpSecurityConfig.bUseFtps), *CreateFtpUrl(User.Username, RemotePath), *LocalPath);
+
+		FString Output, Error;
+		return ExecuteCurlCommand(Command, Output, Error);
+	}
+
+	// 서버의 서명을 지운다 - 파일을 통째로 바꾸면 옛 서명은 더 이상 그 파일을 설명하지 않는다
+	// 서명이 없는 것은 정상이므로 실패해도 넘어간다
+	static void DeleteRemoteSignatures(const FString& Username, const TArray<FString>& RemotePaths)
+	{
+		FFtpUserConfig* User = GetUser(Username);
+		if (!User || RemotePaths.Num() == 0)
+		{
+			return;
+		}
+
+		FString DeleteConfig;
+		for (const FString& RemotePath : RemotePaths)
+		{
+			FString CommandPath = RemotePath + SignatureExtension;
+			CommandPath.RemoveFromStart(TEXT("/"));
+			DeleteConfig += FString::Printf(TEXT("quote = \"*DELE %s\"\n"), *EscapeCurlConfigValue(CommandPath));
+		}
+
+		const FString DeletePath = FPaths::ConvertRelativePathToFull(FPaths::CreateTempFilename(*GetCurlPrivateDir(), TEXT("delta"), TEXT(".cfg")));
+		if (FFileHelper::SaveStringToFile(DeleteConfig, *DeletePath))
+		{
+			FFtpCurlSessionScope CurlSession;
+			const FString Command = FString::Printf(TEXT("%s -K \"%s\" \"%s\" --list-only --ftp-pasv --silent"),
+				*BuildCurlSessionArgs(User->Username, User->Password, GFtpSecurityConfig.bUseFtps), *DeletePath, *CreateFtpUrl(Username, TEXT("/")));
+
+			FString Output, Error;
+			ExecuteCurlCommand(Command, Output, Error);
+			IFileManager::Get().Delete(*DeletePath);
+		}
+	}
+
+	// 통째로 올리고 서버가 다음 델타의 기준으로 쓸 서명도 함께 올린다
+	// 서명을 먼저 지우므로 새 서명을 올리지 못해도 옛 서명이 새 파일을 가리키는 일은 없다
+	static bool UploadFullWithSignature(const FString& Username, const FString& LocalPath, const FString& RemotePath, const FString& WorkDir)
+	{
+		DeleteRemoteSignatures(Username, { RemotePath });
+		if (!UploadFile(Username, LocalPath, RemotePath))
+		{
+			return false;
+		}
+
+		FFtpFileSignature Signature;
+		const FString SignaturePath = WorkDir / TEXT("upload") + SignatureExtension;
+		if (ComputeSignature(LocalPath, Signature) && SaveSignature(Signature, SignaturePath))
+		{
+			UploadFile(Username, SignaturePath, RemotePath + SignatureExtension);
+		}
+		return true;
+	}
+
+	static EUploadResult ToUploadResult(bool bSuccess)
+	{
+		return bSuccess ? EUploadResult::Uploaded : EUploadResult::Failed;
+	}
+
+	EUploadResult UploadFileDelta(const FString& Username, const FString& LocalPath, const FString& RemotePath)
+	{
+		const int64 FileSize = IFileManager::Get().FileSize(*LocalPath);
+		if (FileSize < MinDeltaFileSize)
+		{
+			DeleteRemoteSignatures(Username, { RemotePath });
+			return ToUploadResult(UploadFile(Username, LocalPath, RemotePath));
+		}
+
+		FFtpUserConfig* User = GetUser(Username);
+		if (!User)
+		{
+			return EUploadResult::Failed;
+		}
+
+		const FString WorkDir = FPaths::ConvertRelativePathToFull(FPaths::CreateTempFilename(*GetCurlPrivateDir(), TEXT("delta")));
+		IFileManager::Get().MakeDirectory(*WorkDir, true);
+		ON_SCOPE_EXIT
+		{
+			IFileManager::Get().DeleteDirectory(*WorkDir, false, true);
+		};
+
+		const FString BaseSignaturePath = WorkDir / TEXT("base") + SignatureExtension;
+		FFtpFileSignature BaseSignature;
+		if (!FetchRemoteFile(*User, RemotePath + SignatureExtension, BaseSignaturePath) || !LoadSignature(BaseSignaturePath, BaseSignature))
+		{
+			LogFtpMessage(FString::Printf(TEXT("Delta: no remote signature for %s, sending full file"), *RemotePath));
+			return ToUploadResult(UploadFullWithSignature(Username, LocalPath, RemotePath, WorkDir));
+		}
+
+		if (BaseSignature.FileSize == FileSize)
+		{
+			// 같은 크기면 해시가 같은지부터 본다 - 바뀐 게 없으면 아무것도 보내지 않는다
+			FFtpFileSignature LocalSignature;
+			if (ComputeSignature(LocalPath, LocalSignature) && LocalSignature.FileHash == BaseSignature.FileHash)
+			{
+				LogFtpMessage(FString::Printf(TEXT("Delta: %s unchanged"), *RemotePath));
+				return EUploadResult::Unchanged;
+			}
+		}
+
+		const FString PatchPath = WorkDir / TEXT("patch") + DeltaExtension;
+		int64 LiteralBytes = 0;
+		if (!CreateDeltaPatch(BaseSignature, LocalPath, PatchPath, LiteralBytes))
+		{
+			LogFtpMessage(FString::Printf(TEXT("Delta: failed to build patch for %s, sending full file"), *LocalPath), true);
+			return ToUploadResult(UploadFullWithSignature(Username, LocalPath, RemotePath, WorkDir));
+		}
+
+		const int64 PatchSize = IFileManager::Get().FileSize(*PatchPath);
+		if (PatchSize > FileSize * MaxPatchRatio)
+		{
+			LogFtpMessage(FString::Printf(TEXT("Delta: patch for %s is %lld of %lld bytes, sending full file"), *RemotePath, PatchSize, FileSize));
+			return ToUploadResult(UploadFullWithSignature(Username, LocalPath, RemotePath, WorkDir));
+		}
+
+		LogFtpMessage(FString::Printf(TEXT("Delta: %s -> %lld byte patch (%lld literal) instead of %lld bytes, pending apply"), *RemotePath, PatchSize, LiteralBytes, FileSize));
+		return UploadFile(Username, PatchPath, RemotePath + DeltaExtension) ? EUploadResult::Pending : EUploadResult::Failed;
+	}
+
+	FFtpSyncStats UploadFolder(const FString& LocalPath, const FString& RemotePath, const FString& User, const FString& Pass)
+	{
+		if (!AuthenticateUser(User, Pass))
+		{
+			LogFtpMessage(FString::Printf(TEXT("Delta upload: authentication failed for %s"), *User), true);
+			return FFtpSyncStats::Aborted();
+		}
+
+		if (!FPaths::DirectoryExists(LocalPath))
+		{
+			LogFtpMessage(FString::Printf(TEXT("Delta upload: Local path does not exist: %s"), *LocalPath), true);
+			return FFtpSyncStats::Aborted();
+		}
+
+		TArray<FString> AllFiles;
+		FPlatformFileManager::Get().GetPlatformFile().FindFilesRecursively(AllFiles, *LocalPath, TEXT(""));
+
+		constexpr int32 SmallFileBatchSize = 32;
+
+		int32 SuccessCount = 0;
+		int32 FailCount = 0;
+		int32 PendingCount = 0;
+		TArray<FFtpUploadRequest> SmallFiles;
+
+		auto FlushSmallFiles = [&]()
+		{
+			TArray<FString> RemoteFiles;
+			for (const FFtpUploadRequest& Request : SmallFiles)
+			{
+				RemoteFiles.Add(Request.RemotePath);
+			}
+			DeleteRemoteSignatures(User, RemoteFiles);
+
+			TArray<bool> BatchSuccess;
+			UploadFilesBatch(User, SmallFiles, BatchSuccess);
+			for (bool bSuccess : BatchSuccess)
+			{
+				if (bSuccess)
+				{
+					++SuccessCount;
+				}
+				else
+				{
+					++FailCount;
+				}
+			}
+			SmallFiles.Reset();
+		};
+
+		for (const FString& LocalFile : AllFiles)
+		{
+			FString RelativePath = LocalFile;
+			FPaths::MakePathRelativeTo(RelativePath, *LocalPath);
+			const FString RemoteFile = RemotePath / RelativePath;
+
+			if (IFileManager::Get().FileSize(*LocalFile) >= MinDeltaFileSize)
+			{
+				switch (UploadFileDelta(User, LocalFile, RemoteFile))
+				{
+				case EUploadResult::Failed:
+					++FailCount;
+					break;
+				case EUploadResult::Pending:
+					++PendingCount;
+					break;
+				default:
+					++SuccessCount;
+					break;
+				}
+				continue;
+			}
+
+			SmallFiles.Add({ LocalFile, RemoteFile });
+			if (SmallFiles.Num() >= SmallFileBatchSize)
+			{
+				FlushSmallFiles();
+			}
+		}
+		if (SmallFiles.Num() > 0)
+		{
+			FlushSmallFiles();
+		}
+
+		LogFtpMessage(FString::Printf(TEXT("Delta upload complete: %d succeeded, %d pending apply, %d failed"), SuccessCount, PendingCount, FailCount));
+		FFtpSyncStats Stats(SuccessCount, FailCount);
+		Stats.PendingCount = PendingCount;
+		return Stats;
+	}
+
+	FFtpSyncStats ApplyPendingDeltas(const FString& LocalRoot)
+	{
+		TArray<FString> Patches;
+		IFileManager::Get().FindFilesRecursive(Patches, *LocalRoot, *(FString(TEXT("*")) + DeltaExtension), true, false);
+
+		int32 AppliedCount = 0;
+		int32 FailedCount = 0;
+		for (const FString& PatchPath : Patches)
+		{
+			const FString BasePath = PatchPath.LeftChop(FCString::Strlen(DeltaExtension));
+			const FString SignaturePath = BasePath + SignatureExtension;
+			const FString NewPath = BasePath + TEXT(".ftpnew");
+
+			// 서명은 클라이언트가 올린 것일 수도 있고 기존 파일이 서명 뒤에 다른 경로로 바뀌었을 수도 있다
+			// 기존 파일보다 새것이고 크기가 맞을 때만 그 해시로 기존 파일 읽기를 건너뛴다 (틀려도 적용 결과 해시 검사에서 걸린다)
+			FFtpFileSignature BaseSignature;
+			const bool bHaveSignature = IFileManager::Get().GetTimeStamp(*SignaturePath) >= IFileManager::Get().GetTimeStamp(*BasePath)
+				&& LoadSignature(SignaturePath, BaseSignature) && BaseSignature.FileSize == IFileManager::Get().FileSize(*BasePath);
+
+			bool bApplied = ApplyDeltaPatch(BasePath, PatchPath, NewPath, bHaveSignature ? &BaseSignature.FileHash : nullptr);
+			if (bApplied && !IFileManager::Get().Move(*BasePath, *NewPath, true))
+			{
+				LogFtpMessage(FString::Printf(TEXT("Delta: cannot replace %s"), *BasePath), true);
+				IFileManager::Get().Delete(*NewPath);
+				bApplied = false;
+			}
+
+			if (!bApplied)
+			{
+				// 이 패치는 지금 파일에 맞지 않는다 - 서명까지 지워 다음 푸시가 전체 파일을 보내게 한다
+				LogFtpMessage(FString::Printf(TEXT("Delta: failed to apply %s, removing patch and signature"), *PatchPath), true);
+				IFileManager::Get().Delete(*PatchPath);
+				IFileManager::Get().Delete(*SignaturePath);
+				++FailedCount;
+				continue;
+			}
+
+			FFtpFileSignature NewSignature;
+			if (ComputeSignature(BasePath, NewSignature))
+			{
+				SaveSignature(NewSignature, SignaturePath);
+			}
+			IFileManager::Get().Delete(*PatchPath);
+
+			LogFtpMessage(FString::Printf(TEXT("Delta applied: %s"), *BasePath));
+			++AppliedCount;
+		}
+		return FFtpSyncStats(AppliedCount, FailedCount);
+	}
+}
@@ -0,0 +1,899 @@
+#include "FtpDerivedDataStore.h"
+#include "FtpClientConnection.h"
+#include "FtpSystem.h"
+#include "FileUpLoadStats.h"
+#include "FileUpLoadTrace.h"
+#include "Async/Async.h"
+#include "Dom/JsonObject.h"
+#include "Hash/Blake3.h"
+#include "HAL/Event.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "IPAddress.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Guid.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("DDC Local Hits"), STAT_FileUpLoad_DdcLocalHits, STATGROUP_FileUpLoad);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("DDC Remote Hits"), STAT_FileUpLoad_DdcRemoteHits, STATGROUP_FileUpLoad);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("DDC Misses"), STAT_FileUpLoad_DdcMisses, STATGROUP_FileUpLoad);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("DDC Negative Hits"), STAT_FileUpLoad_DdcNegativeHits, STATGROUP_FileUpLoad);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("DDC Queued Requests"), STAT_FileUpLoad_DdcQueued, STATGROUP_FileUpLoad);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("DDC MB Downloaded"), STAT_FileUpLoad_DdcMegabytesDownloaded, STATGROUP_FileUpLoad);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("DDC MB Uploaded"), STAT_FileUpLoad_DdcMegabytesUploaded, STATGROUP_FileUpLoad);
+
+namespace FtpDerivedDataStoreInternal
+{
+	// 레코드 헤더: 매직, 버전, 값 크기, 값의 BLAKE3
+	static constexpr uint32 RecordMagic = 0x43444446; // "FDDC"
+	static constexpr uint32 RecordVersion = 1;
+	static constexpr int32 HashSize = sizeof(FBlake3Hash::ByteArray);
+	static constexpr int32 HeaderSize = 4 + 4 + 8 + HashSize;
+
+	// 연결 스레드가 일이 없을 때 종료 여부를 다시 보는 간격
+	static constexpr uint32 PollIntervalMs = 100;
+
+	// 서버에 닿지 않을 때 다시 시도하기까지의 시간
+	static constexpr double RemoteRetrySeconds = 10.0;
+
+	// 부정 캐시 항목 상한 - 넘으면 만료된 것부터 비운다
+	static constexpr int32 MaxNegativeEntries = 64 * 1024;
+
+	// 정리할 때 예산의 이 비율까지 줄인다 - 예산 근처에서 매번 정리하지 않게
+	static constexpr double TrimTargetRatio = 0.9;
+
+	// 이보다 오래된 임시 파일은 죽은 쓰기로 보고 지운다
+	static constexpr double StaleTempFileSeconds = 3600.0;
+
+	static const TCHAR* TempExtension = TEXT(".tmp");
+
+	static FString GetShard(const FString& Name)
+	{
+		return Name.Left(2);
+	}
+}
+
+class FFtpDerivedDataStore::FConnectionWorker : public FRunnable
+{
+public:
+	FConnectionWorker(FFtpDerivedDataStore& InStore, int32 Index)
+		: Store(InStore)
+	{
+		Thread = FRunnableThread::Create(this, *FString::Printf(TEXT("FtpDerivedData%d"), Index));
+	}
+
+	virtual ~FConnectionWorker()
+	{
+		if (Thread != nullptr)
+		{
+			Thread->Kill(true);
+			delete Thread;
+			Thread = nullptr;
+		}
+	}
+
+	virtual uint32 Run() override
+	{
+		while (!Store.bStopping)
+		{
+			FOperation Operation;
+			bool bIsPut = false;
+			if (!Store.Dequeue(Operation, bIsPut))
+			{
+				Store.WorkEvent->Wait(FtpDerivedDataStoreInternal::PollIntervalMs);
+				continue;
+			}
+
+			if (bIsPut)
+			{
+				Store.ProcessPut(Connection, Operation);
+			}
+			else
+			{
+				Store.ProcessGet(Connection, Operation);
+			}
+		}
+
+		Connection.Disconnect();
+		return 0;
+	}
+
+private:
+	FFtpDerivedDataStore& Store;
+	// 이 스레드만 쓰는 로그인한 연결
+	FFtpClientConnection Connection;
+	FRunnableThread* Thread = nullptr;
+};
+
+FFtpDerivedDataStore::FFtpDerivedDataStore(const FFtpDerivedDataSettings& InSettings)
+	: Settings(InSettings)
+	, bStopping(true)
+	, NumQueued(0)
+	, NumOutstanding(0)
+	, RemoteRetryCycles(0)
+	, LocalBytes(0)
+	, bTrimming(false)
+	, LocalHits(0)
+	, RemoteHits(0)
+	, Misses(0)
+	, NegativeHits(0)
+	, Errors(0)
+	, Puts(0)
+	, RemotePuts(0)
+	, RemotePutsSkipped(0)
+	, BytesDownloaded(0)
+	, BytesUploaded(0)
+{
+	if (Settings.LocalRoot.IsEmpty())
+	{
+		Settings.LocalRoot = FPaths::ProjectSavedDir() / TEXT("FtpDerivedData");
+	}
+	Settings.LocalRoot = FPaths::ConvertRelativePathToFull(Settings.LocalRoot);
+	FPaths::NormalizeDirectoryName(Settings.LocalRoot);
+	FPaths::NormalizeDirectoryName(Settings.RemoteRoot);
+}
+
+FFtpDerivedDataStore::~FFtpDerivedDataStore()
+{
+	bStopping = true;
+	Workers.Empty();
+
+	// 큐에 남은 요청과 아직 로컬 단계를 도는 요청도 완료 함수를 불러 준다
+	FOperation Operation;
+	bool bIsPut = false;
+	while (NumOutstanding.Load() > 0 || bTrimming.Load())
+	{
+		while (Dequeue(Operation, bIsPut))
+		{
+			if (bIsPut)
+			{
+				CompletePut(Operation, EFtpCacheStatus::Error);
+			}
+			else
+			{
+				CompleteGet(Operation, EFtpCacheStatus::Error, EFtpCacheSource::None, TArray<uint8>());
+			}
+		}
+		FPlatformProcess::Sleep(0.01f);
+	}
+
+	if (WorkEvent != nullptr)
+	{
+		FPlatformProcess::ReturnSynchEventToPool(WorkEvent);
+		WorkEvent = nullptr;
+	}
+
+	if (ServerAddr.IsValid())
+	{
+		const FFtpDerivedDataStats Stats = GetStats();
+		LogFtpMessage(FString::Printf(TEXT("Derived data store: %llu local hit(s), %llu remote hit(s), %llu miss(es) (%llu answered by the negative cache), %llu error(s), %llu put(s) (%llu uploaded, %llu already on server)"),
+			Stats.LocalHits, Stats.RemoteHits, Stats.Misses, Stats.NegativeHits, Stats.Errors, Stats.Puts, Stats.RemotePuts, Stats.RemotePutsSkipped));
+	}
+}
+
+bool FFtpDerivedDataStore::LoadSettings(const FString& JobSpecPath, FFtpDerivedDataSettings& OutSettings)
+{
+	FString JsonText;
+	if (!FFileHelper::LoadFileToString(JsonText, *JobSpecPath))
+	{
+		LogFtpMessage(FString::Printf(TEXT("Derived data store: cannot read job spec %s"), *JobSpecPath), true);
+		return false;
+	}
+
+	TSharedPtr<FJsonObject> Spec;
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(JsonText);
+	if (!FJsonSerializer::Deserialize(Reader, Spec) || !Spec.IsValid())
+	{
+		LogFtpMessage(FString::Printf(TEXT("Derived data store: invalid JSON in %s"), *JobSpecPath), true);
+		return false;
+	}
+
+	if (!Spec->TryGetStringField(TEXT("User"), OutSettings.User) || !Spec->TryGetStringField(TEXT("Password"), OutSettings.Password))
+	{
+		LogFtpMessage(TEXT("Derived data store: job spec needs \"User\" and \"Password\""), true);
+		return false;
+	}
+
+	const TSharedPtr<FJsonObject>* ServerObject = nullptr;
+	if (Spec->TryGetObjectField(TEXT("Server"), ServerObject))
+	{
+		(*ServerObject)->TryGetStringField(TEXT("Address"), GServerAddress);
+		(*ServerObject)->TryGetNumberField(TEXT("Port"), GServerPort);
+		(*ServerObject)->TryGetNumberField(TEXT("MaxConnections"), GServerMaxConnections);
+	}
+
+	const TSharedPtr<FJsonObject>* StoreObject = nullptr;
+	if (Spec->TryGetObjectField(TEXT("DerivedData"), StoreObject))
+	{
+		const FJsonObject& Store = **StoreObject;
+		Store.TryGetStringField(TEXT("Remote"), OutSettings.RemoteRoot);
+		if (Store.TryGetStringField(TEXT("LocalRoot"), OutSettings.LocalRoot) && FPaths::IsRelative(OutSettings.LocalRoot))
+		{
+			OutSettings.LocalRoot = FPaths::ProjectDir() / OutSettings.LocalRoot;
+		}
+		int64 LocalBudgetMB = 0;
+		if (Store.TryGetNumberField(TEXT("LocalBudgetMB"), LocalBudgetMB))
+		{
+			OutSettings.LocalBudgetBytes = FMath::Max<int64>(LocalBudgetMB, 0) * 1024 * 1024;
+		}
+		Store.TryGetNumberField(TEXT("Connections"), OutSettings.Connections);
+		Store.TryGetNumberField(TEXT("NegativeCacheSeconds"), OutSettings.NegativeCacheSeconds);
+		Store.TryGetBoolField(TEXT("RemoteWrites"), OutSettings.bRemoteWrites);
+	}
+
+	return true;
+}
+
+bool FFtpDerivedDataStore::Start()
+{
+	if (IsRunning())
+	{
+		return true;
+	}
+
+	// 프로세스 안 전송은 평문 FTP만 한다
+	if (GFtpSecurityConfig.bUseFtps)
+	{
+		LogFtpMessage(TEXT("Derived data store disabled: the in-process FTP transport does not support FTPS"), true);
+		return false;
+	}
+
+	if (!AuthenticateUser(Settings.User, Settings.Password))
+	{
+		LogFtpMessage(FString::Printf(TEXT("Derived data store disabled: authentication failed for %s"), *Settings.User), true);
+		return false;
+	}
+
+	ServerAddr = FFtpClientConnection::ResolveAddress(GServerAddress, GServerPort);
+	if (!ServerAddr.IsValid())
+	{
+		return false;
+	}
+
+	IFileManager::Get().MakeDirectory(*Settings.LocalRoot, true);
+
+	bStopping = false;
+	WorkEvent = FPlatformProcess::GetSynchEventFromPool(false);
+
+	// 서버 연결 수 제한을 넘지 않는다
+	const int32 MaxConnections = GServerMaxConnections > 0 ? GServerMaxConnections : Settings.Connections;
+	const int32 NumWorkers = FMath::Clamp(Settings.Connections, 1, FMath::Max(MaxConnections, 1));
+	for (int32 Index = 0; Index < NumWorkers; ++Index)
+	{
+		Workers.Add(MakeUnique<FConnectionWorker>(*this, Index));
+	}
+
+	// 로컬 계층 크기를 세고 넘친 것은 정리한다
+	RequestTrim();
+
+	LogFtpMessage(FString::Printf(TEXT("Derived data store: %s -> %s:%d/%s, %d connection(s), local budget %lld MB"),
+		*Settings.LocalRoot, *GServerAddress, GServerPort, *Settings.RemoteRoot, NumWorkers, Settings.LocalBudgetBytes / (1024 * 1024)));
+	return true;
+}
+
+FString FFtpDerivedDataStore::MakeRecordName(const FString& Key)
+{
+	const FTCHARToUTF8 Utf8(*Key);
+	const FBlake3Hash Hash = FBlake3::HashBuffer(Utf8.Get(), Utf8.Length());
+	return BytesToHex(Hash.GetBytes(), FtpDerivedDataStoreInternal::HashSize).ToLower();
+}
+
+FString FFtpDerivedDataStore::GetLocalPath(const FString& Name) const
+{
+	return Settings.LocalRoot / FtpDerivedDataStoreInternal::GetShard(Name) / Name;
+}
+
+FString FFtpDerivedDataStore::GetRemotePath(const FString& Name) const
+{
+	return Settings.RemoteRoot / FtpDerivedDataStoreInternal::GetShard(Name) / Name;
+}
+
+void FFtpDerivedDataStore::Get(TArray<FFtpCacheGetRequest> Requests, FOnFtpCacheGetComplete OnComplete)
+{
+	if (Requests.Num() == 0)
+	{
+		return;
+	}
+
+	NumOutstanding += Requests.Num();
+	TSharedPtr<FOnFtpCacheGetComplete, ESPMode::ThreadSafe> SharedOnComplete = MakeShared<FOnFtpCacheGetComplete, ESPMode::ThreadSafe>(MoveTemp(OnComplete));
+
+	// 로컬 파일 읽기도 호출한 스레드(보통 게임 스레드)를 막지 않는다
+	Async(EAsyncExecution::ThreadPool, [this, Requests = MoveTemp(Requests), SharedOnComplete]() mutable
+	{
+		ResolveLocally(Requests, SharedOnComplete);
+	});
+}
+
+void FFtpDerivedDataStore::ResolveLocally(TArray<FFtpCacheGetRequest>& Requests, const TSharedPtr<FOnFtpCacheGetComplete, ESPMode::ThreadSafe>& OnComplete)
+{
+	FTP_TRACE_SCOPE(DdcLookup);
+
+	TArray<uint8> Record;
+	for (FFtpCacheGetRequest& Request : Requests)
+	{
+		FOperation Operation;
+		Operation.Key = MoveTemp(Request.Key);
+		Operation.Name = MakeRecordName(Operation.Key);
+		Operation.UserData = Request.UserData;
+		Operation.OnGet = OnComplete;
+
+		// 아직 로컬에 쓰지 않은 Put
+		FSharedBytes PendingValue;
+		{
+			FScopeLock ScopeLock(&PendingPutLock);
+			if (const FSharedBytes* Found = PendingPuts.Find(Operation.Name))
+			{
+				PendingValue = *Found;
+			}
+		}
+		if (PendingValue.IsValid())
+		{
+			LocalHits++;
+			INC_DWORD_STAT(STAT_FileUpLoad_DdcLocalHits);
+			CompleteGet(Operation, EFtpCacheStatus::Ok, EFtpCacheSource::Local, TArray<uint8>(*PendingValue));
+			continue;
+		}
+
+		if (ReadLocal(Operation.Name, Record))
+		{
+			TArray<uint8> Value;
+			if (DecodeRecord(Record, Value))
+			{
+				// 정리(LRU)에서 최근에 쓴 것으로 보이게 한다
+				IFileManager::Get().SetTimeStamp(*GetLocalPath(Operation.Name), FDateTime::UtcNow());
+				LocalHits++;
+				INC_DWORD_STAT(STAT_FileUpLoad_DdcLocalHits);
+				CompleteGet(Operation, EFtpCacheStatus::Ok, EFtpCacheSource::Local, MoveTemp(Value));
+				continue;
+			}
+			IFileManager::Get().Delete(*GetLocalPath(Operation.Name), false, true, true);
+		}
+
+		if (IsNegative(Operation.Name))
+		{
+			NegativeHits++;
+			Misses++;
+			INC_DWORD_STAT(STAT_FileUpLoad_DdcNegativeHits);
+			INC_DWORD_STAT(STAT_FileUpLoad_DdcMisses);
+			CompleteGet(Operation, EFtpCacheStatus::Miss, EFtpCacheSource::None, TArray<uint8>());
+			continue;
+		}
+
+		Enqueue(GetQueue, MoveTemp(Operation));
+	}
+}
+
+void FFtpDerivedDataStore::Put(TArray<FFtpCachePutRequest> Requests, FOnFtpCachePutComplete OnComplete)
+{
+	if (Requests.Num() == 0)
+	{
+		return;
+	}
+
+	NumOutstanding += Requests.Num();
+	TSharedPtr<FOnFtpCachePutComplete, ESPMode::ThreadSafe> SharedOnComplete = MakeShared<FOnFtpCachePutComplete, ESPMode::ThreadSafe>(MoveTemp(OnComplete));
+
+	for (FFtpCachePutRequest& Request : Requests)
+	{
+		FOperation Operation;
+		Operation.Key = MoveTemp(Request.Key);
+		Operation.Name = MakeRecordName(Operation.Key);
+		Operation.UserData = Request.UserData;
+		Operation.Value = MakeShared<TArray<uint8>, ESPMode::ThreadSafe>(MoveTemp(Request.Data));
+		Operation.OnPut = SharedOnComplete;
+
+		// 방금 없다고 기록한 키라도 이제는 있다
+		RemoveNegative(Operation.Name);
+		{
+			FScopeLock ScopeLock(&PendingPutLock);
+			PendingPuts.Add(Operation.Name, Operation.Value);
+		}
+		Puts++;
+		Enqueue(PutQueue, MoveTemp(Operation));
+	}
+}
+
+void FFtpDerivedDataStore::Enqueue(TQueue<FOperation, EQueueMode::Mpsc>& Queue, FOperation&& Operation)
+{
+	// 시작하기 전이나 멈춘 뒤에는 원격으로 보내지 않는다
+	if (bStopping)
+	{
+		if (Operation.OnGet.IsValid())
+		{
+			CompleteGet(Operation, EFtpCacheStatus::Error, EFtpCacheSource::None, TArray<uint8>());
+		}
+		else
+		{
+			CompletePut(Operation, EFtpCacheStatus::Error);
+		}
+		return;
+	}
+
+	NumQueued++;
+	INC_DWORD_STAT(STAT_FileUpLoad_DdcQueued);
+	Queue.Enqueue(MoveTemp(Operation));
+	WorkEvent->Trigger();
+}
+
+bool FFtpDerivedDataStore::Dequeue(FOperation& OutOperation, bool& bOutIsPut)
+{
+	FScopeLock ScopeLock(&DequeueLock);
+
+	// Get은 누군가 기다리고 있고 Put은 뒤에 써도 된다
+	if (GetQueue.Dequeue(OutOperation))
+	{
+		bOutIsPut = false;
+	}
+	else if (PutQueue.Dequeue(OutOperation))
+	{
+		bOutIsPut = true;
+	}
+	else
+	{
+		return false;
+	}
+
+	NumQueued--;
+	DEC_DWORD_STAT(STAT_FileUpLoad_DdcQueued);
+
+	// 남은 일이 있으면 다른 연결 스레드도 깨운다
+	if (WorkEvent != nullptr && (!GetQueue.IsEmpty() || !PutQueue.IsEmpty()))
+	{
+		WorkEvent->Trigger();
+	}
+	return true;
+}
+
+bool FFtpDerivedDataStore::EnsureConnected(FFtpClientConnection& Connection)
+{
+	if (Connection.IsConnected())
+	{
+		return true;
+	}
+
+	// 서버가 내려가 있으면 요청마다 접속을 시도하지 않고 바로 실패시킨다
+	if (FPlatformTime::Cycles64() < RemoteRetryCycles.Load())
+	{
+		return false;
+	}
+
+	if (Connection.Connect(*ServerAddr, Settings.User, Settings.Password))
+	{
+		return true;
+	}
+
+	RemoteRetryCycles = FPlatformTime::Cycles64() + (uint64)(FtpDerivedDataStoreInternal::RemoteRetrySeconds / FPlatformTime::GetSecondsPerCycle64());
+	LogFtpMessage(FString::Printf(TEXT("Derived data store: cannot reach %s:%d, retrying in %.0f s"), *GServerAddress, GServerPort, FtpDerivedDataStoreInternal::RemoteRetrySeconds), true);
+	return false;
+}
+
+bool FFtpDerivedDataStore::EnsureRemoteDirectory(FFtpClientConnection& Connection, const FString& Name)
+{
+	// MKD는 한 단계씩만 만든다
+	FString Directory;
+	TArray<FString> Parts;
+	Settings.RemoteRoot.ParseIntoArray(Parts, TEXT("/"));
+	Parts.Add(FtpDerivedDataStoreInternal::GetShard(Name));
+	for (const FString& Part : Parts)
+	{
+		Directory = Directory.IsEmpty() ? Part : Directory / Part;
+		if (!Connection.MakeDirectory(Directory))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void FFtpDerivedDataStore::ProcessGet(FFtpClientConnection& Connection, FOperation& Operation)
+{
+	FTP_TRACE_SCOPE(DdcGet);
+
+	using namespace FtpDerivedDataStoreInternal;
+
+	if (!EnsureConnected(Connection))
+	{
+		Errors++;
+		CompleteGet(Operation, EFtpCacheStatus::Error, EFtpCacheSource::None, TArray<uint8>());
+		return;
+	}
+
+	const FString RemotePath = GetRemotePath(Operation.Name);
+	TArray<uint8> Record;
+	EFtpClientResult Result = Connection.Retrieve(RemotePath, Record, Settings.MaxRecordBytes + HeaderSize);
+	// 서버가 유휴 연결을 끊었을 수 있다 - 한 번만 다시 붙어 본다
+	if (Result == EFtpClientResult::Failed && EnsureConnected(Connection))
+	{
+		Result = Connection.Retrieve(RemotePath, Record, Settings.MaxRecordBytes + HeaderSize);
+	}
+
+	if (Result == EFtpClientResult::Ok)
+	{
+		BytesDownloaded += Record.Num();
+		INC_FLOAT_STAT_BY(STAT_FileUpLoad_DdcMegabytesDownloaded, Record.Num() / (1024.0 * 1024.0));
+
+		TArray<uint8> Value;
+		if (DecodeRecord(Record, Value))
+		{
+			WriteLocal(Operation.Name, Record);
+			RemoteHits++;
+			INC_DWORD_STAT(STAT_FileUpLoad_DdcRemoteHits);
+			CompleteGet(Operation, EFtpCacheStatus::Ok, EFtpCacheSource::Remote, MoveTemp(Value));
+			return;
+		}
+
+		// 깨진 레코드는 부정 캐시에 넣지 않는다 - 누가 다시 올리면 다음 Get에서 바로 보여야 한다
+		LogFtpMessage(FString::Printf(TEXT("Derived data store: corrupt record %s for %s"), *RemotePath, *Operation.Key), true);
+		Misses++;
+		INC_DWORD_STAT(STAT_FileUpLoad_DdcMisses);
+		CompleteGet(Operation, EFtpCacheStatus::Miss, EFtpCacheSource::None, TArray<uint8>());
+		return;
+	}
+
+	if (Result == EFtpClientResult::Failed)
+	{
+		Errors++;
+		CompleteGet(Operation, EFtpCacheStatus::Error, EFtpCacheSource::None, TArray<uint8>());
+		return;
+	}
+
+	// 없는 레코드 - 잠시 다시 묻지 않는다
+	AddNegative(Operation.Name);
+	Misses++;
+	INC_DWORD_STAT(STAT_FileUpLoad_DdcMisses);
+	CompleteGet(Operation, EFtpCacheStatus::Miss, EFtpCacheSource::None, TArray<uint8>());
+}
+
+void FFtpDerivedDataStore::ProcessPut(FFtpClientConnection& Connection, FOperation& Operation)
+{
+	FTP_TRACE_SCOPE(DdcPut);
+
+	TArray<uint8> Record;
+	EncodeRecord(*Operation.Value, Record);
+	WriteLocal(Operation.Name, Record);
+
+	// 이제 로컬 계층에서 읽힌다. 그 사이 같은 키로 새 Put이 들어왔으면 그것은 남겨 둔다
+	{
+		FScopeLock ScopeLock(&PendingPutLock);
+		const FSharedBytes* Found = PendingPuts.Find(Operation.Name);
+		if (Found != nullptr && *Found == Operation.Value)
+		{
+			PendingPuts.Remove(Operation.Name);
+		}
+	}
+	Operation.Value.Reset();
+
+	if (!Settings.bRemoteWrites)
+	{
+		CompletePut(Operation, EFtpCacheStatus::Ok);
+		return;
+	}
+	if (!EnsureConnected(Connection))
+	{
+		Errors++;
+		CompletePut(Operation, EFtpCacheStatus::Error);
+		return;
+	}
+
+	// 같은 결과를 다른 사람이 이미 올렸으면 보내지 않는다
+	const FString RemotePath = GetRemotePath(Operation.Name);
+	int64 RemoteSize = 0;
+	EFtpClientResult Result = Connection.GetSize(RemotePath, RemoteSize);
+	if (Result == EFtpClientResult::Failed && EnsureConnected(Connection))
+	{
+		Result = Connection.GetSize(RemotePath, RemoteSize);
+	}
+	if (Result == EFtpClientResult::Ok && RemoteSize == Record.Num())
+	{
+		RemotePutsSkipped++;
+		CompletePut(Operation, EFtpCacheStatus::Ok);
+		return;
+	}
+	if (Result == EFtpClientResult::Failed)
+	{
+		Errors++;
+		CompletePut(Operation, EFtpCacheStatus::Error);
+		return;
+	}
+
+	// 임시 이름으로 올린 뒤 바꾼다 - 같은 키를 받는 쪽이 반쯤 쓰인 레코드를 보지 않는다
+	const FString TempPath = RemotePath + TEXT(".") + FGuid::NewGuid().ToString() + FtpDerivedDataStoreInternal::TempExtension;
+	Result = Connection.Store(TempPath, Record.GetData(), Record.Num());
+	if (Result == EFtpClientResult::NotFound && EnsureRemoteDirectory(Connection, Operation.Name))
+	{
+		Result = Connection.Store(TempPath, Record.GetData(), Record.Num());
+	}
+	if (Result == EFtpClientResult::Ok)
+	{
+		Result = Connection.Rename(TempPath, RemotePath);
+
+		// 이름을 바꾸지 못했으면(거절이든 연결이 끊겼든) 서버에서 임시 파일을 치울 사람이 없다 - 다시 접속해서라도 지운다
+		if (Result != EFtpClientResult::Ok && EnsureConnected(Connection))
+		{
+			Connection.Delete(TempPath);
+		}
+	}
+
+	if (Result == EFtpClientResult::Ok)
+	{
+		RemotePuts++;
+		BytesUploaded += Record.Num();
+		INC_FLOAT_STAT_BY(STAT_FileUpLoad_DdcMegabytesUploaded, Record.Num() / (1024.0 * 1024.0));
+		CompletePut(Operation, EFtpCacheStatus::Ok);
+	}
+	else
+	{
+		Errors++;
+		CompletePut(Operation, EFtpCacheStatus::Error);
+	}
+}
+
+void FFtpDerivedDataStore::CompleteGet(FOperation& Operation, EFtpCacheStatus Status, EFtpCacheSource Source, TArray<uint8>&& Data)
+{
+	FFtpCacheGetResponse Response;
+	Response.Key = MoveTemp(Operation.Key);
+	Response.UserData = Operation.UserData;
+	Response.Status = Status;
+	Response.Source = Source;
+	Response.Data = MoveTemp(Data);
+
+	if (Operation.OnGet.IsValid() && *Operation.OnGet)
+	{
+		(*Operation.OnGet)(MoveTemp(Response));
+	}
+	Operation.OnGet.Reset();
+	NumOutstanding--;
+}
+
+void FFtpDerivedDataStore::CompletePut(FOperation& Operation, EFtpCacheStatus Status)
+{
+	FFtpCachePutResponse Response;
+	Response.Key = MoveTemp(Operation.Key);
+	Response.UserData = Operation.UserData;
+	Response.Status = Status;
+
+	if (Operation.OnPut.IsValid() && *Operation.OnPut)
+	{
+		(*Operation.OnPut)(MoveTemp(Response));
+	}
+	Operation.OnPut.Reset();
+	NumOutstanding--;
+}
+
+bool FFtpDerivedDataStore::WaitForPending(double TimeoutSeconds) const
+{
+	const double EndTime = FPlatformTime::Seconds() + TimeoutSeconds;
+	while (NumOutstanding.Load() > 0)
+	{
+		if (FPlatformTime::Seconds() >= EndTime)
+		{
+			return false;
+		}
+		FPlatformProcess::Sleep(0.05f);
+	}
+	return true;
+}
+
+FFtpDerivedDataStats FFtpDerivedDataStore::GetStats() const
+{
+	FFtpDerivedDataStats Stats;
+	Stats.LocalHits = LocalHits.Load();
+	Stats.RemoteHits = RemoteHits.Load();
+	Stats.Misses = Misses.Load();
+	Stats.NegativeHits = NegativeHits.Load();
+	Stats.Errors = Errors.Load();
+	Stats.Puts = Puts.Load();
+	Stats.RemotePuts = RemotePuts.Load();
+	Stats.RemotePutsSkipped = RemotePutsSkipped.Load();
+	Stats.BytesDownloaded = BytesDownloaded.Load();
+	Stats.BytesUploaded = BytesUploaded.Load();
+	return Stats;
+}
+
+void FFtpDerivedDataStore::EncodeRecord(const TArray<uint8>& Value, TArray<uint8>& OutRecord)
+{
+	using namespace FtpDerivedDataStoreInternal;
+
+	const FBlake3Hash Hash = FBlake3::HashBuffer(Value.GetData(), Value.Num());
+	const uint64 ValueSize = (uint64)Value.Num();
+
+	OutRecord.SetNumUninitialized(HeaderSize + Value.Num());
+	uint8* Out = OutRecord.GetData();
+	FMemory::Memcpy(Out, &RecordMagic, 4);
+	FMemory::Memcpy(Out + 4, &RecordVersion, 4);
+	FMemory::Memcpy(Out + 8, &ValueSize, 8);
+	FMemory::Memcpy(Out + 16, Hash.GetBytes(), HashSize);
+	if (Value.Num() > 0)
+	{
+		FMemory::Memcpy(Out + HeaderSize, Value.GetData(), Value.Num());
+	}
+}
+
+bool FFtpDerivedDataStore::DecodeRecord(const TArray<uint8>& Record, TArray<uint8>& OutValue)
+{
+	using namespace FtpDerivedDataStoreInternal;
+
+	if (Record.Num() < HeaderSize)
+	{
+		return false;
+	}
+
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	uint64 ValueSize = 0;
+	const uint8* In = Record.GetData();
+	FMemory::Memcpy(&Magic, In, 4);
+	FMemory::Memcpy(&Version, In + 4, 4);
+	FMemory::Memcpy(&ValueSize, In + 8, 8);
+	if (Magic != RecordMagic || Version != RecordVersion || ValueSize != (uint64)(Record.Num() - HeaderSize))
+	{
+		return false;
+	}
+
+	const FBlake3Hash Hash = FBlake3::HashBuffer(In + HeaderSize, ValueSize);
+	if (FMemory::Memcmp(Hash.GetBytes(), In + 16, HashSize) != 0)
+	{
+		return false;
+	}
+
+	OutValue = TArray<uint8>(In + HeaderSize, (int32)ValueSize);
+	return true;
+}
+
+bool FFtpDerivedDataStore::ReadLocal(const FString& Name, TArray<uint8>& OutRecord) const
+{
+	return FFileHelper::LoadFileToArray(OutRecord, *GetLocalPath(Name), FILEREAD_Silent);
+}
+
+void FFtpDerivedDataStore::WriteLocal(const FString& Name, const TArray<uint8>& Record)
+{
+	// 임시 파일에 다 쓴 뒤 옮긴다 - 다른 스레드/프로세스가 반쯤 쓴 레코드를 읽지 않게
+	const FString FinalPath = GetLocalPath(Name);
+	const FString TempPath = FinalPath + TEXT(".") + FGuid::NewGuid().ToString() + FtpDerivedDataStoreInternal::TempExtension;
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(FinalPath), true);
+	if (!FFileHelper::SaveArrayToFile(Record, *TempPath) || !IFileManager::Get().Move(*FinalPath, *TempPath, true, true))
+	{
+		IFileManager::Get().Delete(*TempPath, false, true, true);
+		return;
+	}
+
+	LocalBytes += Record.Num();
+	if (Settings.LocalBudgetBytes > 0 && LocalBytes.Load() > Settings.LocalBudgetBytes)
+	{
+		RequestTrim();
+	}
+}
+
+void FFtpDerivedDataStore::RequestTrim()
+{
+	if (bTrimming.Exchange(true))
+	{
+		return;
+	}
+
+	Async(EAsyncExecution::ThreadPool, [this]()
+	{
+		TrimLocal();
+		bTrimming = false;
+	});
+}
+
+void FFtpDerivedDataStore::TrimLocal()
+{
+	FTP_TRACE_SCOPE(DdcTrim);
+
+	using namespace FtpDerivedDataStoreInternal;
+
+	struct FLocalRecord
+	{
+		FString Path;
+		int64 Size = 0;
+		FDateTime Modified;
+	};
+
+	TArray<FLocalRecord> Records;
+	int64 TotalBytes = 0;
+	const FDateTime StaleTempTime = FDateTime::UtcNow() - FTimespan::FromSeconds(StaleTempFileSeconds);
+	IFileManager::Get().IterateDirectoryStatRecursively(*Settings.LocalRoot, [&Records, &TotalBytes, &StaleTempTime](const TCHAR* Path, const FFileStatData& Stat)
+	{
+		if (Stat.bIsDirectory)
+		{
+			return true;
+		}
+		if (FCString::Strstr(Path, TempExtension) != nullptr)
+		{
+			if (Stat.ModificationTime < StaleTempTime)
+			{
+				IFileManager::Get().Delete(Path, false, true, true);
+			}
+			return true;
+		}
+		Records.Add({ Path, Stat.FileSize, Stat.ModificationTime });
+		TotalBytes += Stat.FileSize;
+		return true;
+	});
+
+	const int64 Budget = Settings.LocalBudgetBytes;
+	if (Budget > 0 && TotalBytes > Budget)
+	{
+		// 오래 쓰지 않은 것부터 (읽을 때 수정 시각을 갱신한다)
+		Records.Sort([](const FLocalRecord& A, const FLocalRecord& B)
+		{
+			return A.Modified < B.Modified;
+		});
+
+		const int64 Target = (int64)(Budget * TrimTargetRatio);
+		int32 NumDeleted = 0;
+		for (const FLocalRecord& Record : Records)
+		{
+			if (TotalBytes <= Target || bStopping)
+			{
+				break;
+			}
+			if (IFileManager::Get().Delete(*Record.Path, false, true, true))
+			{
+				TotalBytes -= Record.Size;
+				++NumDeleted;
+			}
+		}
+		UE_LOG(LogTemp, Verbose, TEXT("Derived data store: trimmed %d local record(s), %lld MB left"), NumDeleted, TotalBytes / (1024 * 1024));
+	}
+
+	LocalBytes = TotalBytes;
+}
+
+bool FFtpDerivedDataStore::IsNegative(const FString& Name)
+{
+	FScopeLock ScopeLock(&NegativeLock);
+	const double* Expiry = NegativeExpiry.Find(Name);
+	if (Expiry == nullptr)
+	{
+		return false;
+	}
+	if (*Expiry > FPlatformTime::Seconds())
+	{
+		return true;
+	}
+	NegativeExpiry.Remove(Name);
+	return false;
+}
+
+void FFtpDerivedDataStore::AddNegative(const FString& Name)
+{
+	if (Settings.NegativeCacheSeconds <= 0.0)
+	{
+		return;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	FScopeLock ScopeLock(&NegativeLock);
+	if (NegativeExpiry.Num() >= FtpDerivedDataStoreInternal::MaxNegativeEntries)
+	{
+		for (auto It = NegativeExpiry.CreateIterator(); It; ++It)
+		{
+			if (It.Value() <= Now)
+			{
+				It.RemoveCurrent();
+			}
+		}
+		// 모두 살아 있으면 통째로 비운다 - 최악이어도 한 번씩 다시 묻는 것뿐이다
+		if (NegativeExpiry.Num() >= FtpDerivedDataStoreInternal::MaxNegativeEntries)
+		{
+			NegativeExpiry.Reset();
+		}
+	}
+	NegativeExpiry.Add(Name, Now + Settings.NegativeCacheSeconds);
+}
+
+void FFtpDerivedDataStore::RemoveNegative(const FString& Name)
+{
+	FScopeLock ScopeLock(&NegativeLock);
+	NegativeExpiry.Remove(Name);
+}
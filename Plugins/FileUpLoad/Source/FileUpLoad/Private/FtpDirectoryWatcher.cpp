@@ -0,0 +1,177 @@
+#include "FtpDirectoryWatcher.h"
+#include "DirectoryWatcherModule.h"
+#include "IDirectoryWatcher.h"
+#include "Modules/ModuleManager.h"
+#include "Misc/Paths.h"
+#include "HAL/PlatformTime.h"
+#include "FtpSystem.h"
+#include "FtpUploadQueue.h"
+
+FFtpDirectoryWatcher::FFtpDirectoryWatcher(const FString& InUsername, const TArray<FFtpWatchRoot>& InRoots)
+	: Username(InUsername)
+	, Roots(InRoots)
+{
+	// IDirectoryWatcher는 절대 경로 기준으로 알려주므로 루트도 맞춰 둔다
+	for (FFtpWatchRoot& Root : Roots)
+	{
+		Root.LocalDirectory = FPaths::ConvertRelativePathToFull(Root.LocalDirectory);
+		FPaths::NormalizeDirectoryName(Root.LocalDirectory);
+	}
+}
+
+FFtpDirectoryWatcher::~FFtpDirectoryWatcher()
+{
+	Stop();
+}
+
+bool FFtpDirectoryWatcher::Start()
+{
+	if (IsWatching())
+	{
+		return true;
+	}
+
+	FDirectoryWatcherModule& DirectoryWatcherModule = FModuleManager::LoadModuleChecked<FDirectoryWatcherModule>(TEXT("DirectoryWatcher"));
+	IDirectoryWatcher* DirectoryWatcher = DirectoryWatcherModule.Get();
+	if (DirectoryWatcher == nullptr)
+	{
+		LogFtpMessage(TEXT("Watch mode unavailable: no directory watcher on this platform"), true);
+		return false;
+	}
+
+	UploadQueue = MakeUnique<FFtpUploadQueue>(Username);
+
+	for (int32 RootIndex = 0; RootIndex < Roots.Num(); ++RootIndex)
+	{
+		const FFtpWatchRoot& Root = Roots[RootIndex];
+
+		FDelegateHandle Handle;
+		const bool bRegistered = DirectoryWatcher->RegisterDirectoryChangedCallback_Handle(
+			Root.LocalDirectory,
+			IDirectoryWatcher::FDirectoryChanged::CreateRaw(this, &FFtpDirectoryWatcher::OnDirectoryChanged, RootIndex),
+			Handle);
+
+		if (bRegistered)
+		{
+			WatchHandles.Add(Handle);
+			LogFtpMessage(FString::Printf(TEXT("Watching %s -> %s"), *Root.LocalDirectory, *Root.RemoteDirectory));
+		}
+		else
+		{
+			// 인덱스를 루트와 맞추기 위해 빈 핸들도 넣어 둔다
+			WatchHandles.Add(FDelegateHandle());
+			LogFtpMessage(FString::Printf(TEXT("Failed to watch %s"), *Root.LocalDirectory), true);
+		}
+	}
+
+	TickHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FFtpDirectoryWatcher::Tick), 0.25f);
+	return true;
+}
+
+void FFtpDirectoryWatcher::Stop()
+{
+	if (TickHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(TickHandle);
+		TickHandle.Reset();
+	}
+
+	if (WatchHandles.Num() > 0)
+	{
+		if (FDirectoryWatcherModule* DirectoryWatcherModule = FModuleManager::GetModulePtr<FDirectoryWatcherModule>(TEXT("DirectoryWatcher")))
+		{
+			if (IDirectoryWatcher* DirectoryWatcher = DirectoryWatcherModule->Get())
+			{
+				for (int32 RootIndex = 0; RootIndex < WatchHandles.Num(); ++RootIndex)
+				{
+					if (WatchHandles[RootIndex].IsValid())
+					{
+						DirectoryWatcher->UnregisterDirectoryChangedCallback_Handle(Roots[RootIndex].LocalDirectory, WatchHandles[RootIndex]);
+					}
+				}
+			}
+		}
+		WatchHandles.Reset();
+	}
+
+	PendingChanges.Reset();
+
+	// 진행 중인 전송이 끝날 때까지 기다린 뒤 큐 정리
+	UploadQueue.Reset();
+}
+
+void FFtpDirectoryWatcher::OnDirectoryChanged(const TArray<FFileChangeData>& Changes, int32 RootIndex)
+{
+	const double Now = FPlatformTime::Seconds();
+
+	for (const FFileChangeData& Change : Changes)
+	{
+		FString Path = FPaths::ConvertRelativePathToFull(Change.Filename);
+		FPaths::NormalizeFilename(Path);
+
+		if (ShouldIgnore(Path))
+		{
+			continue;
+		}
+
+		// 같은 경로의 연속된 변경은 마지막 시각만 남긴다
+		FPendingChange& Pending = PendingChanges.FindOrAdd(Path);
+		Pending.LastChangeTime = Now;
+		Pending.RootIndex = RootIndex;
+	}
+}
+
+bool FFtpDirectoryWatcher::Tick(float DeltaTime)
+{
+	if (PendingChanges.Num() == 0 || !UploadQueue.IsValid())
+	{
+		return true;
+	}
+
+	const double Now = FPlatformTime::Seconds();
+	int32 NumQueued = 0;
+
+	for (auto It = PendingChanges.CreateIterator(); It; ++It)
+	{
+		if (Now - It->Value.LastChangeTime < DebounceSeconds)
+		{
+			continue;
+		}
+
+		const FString& LocalPath = It->Key;
+		const FFtpWatchRoot& Root = Roots[It->Value.RootIndex];
+
+		// 삭제됐거나 디렉토리 변경이면 올릴 것이 없다 (임시 파일 -> 이름 변경의 원본 쪽 포함)
+		if (FPaths::FileExists(LocalPath))
+		{
+			FString RelativePath = LocalPath;
+			FPaths::MakePathRelativeTo(RelativePath, *(Root.LocalDirectory / TEXT("")));
+			UploadQueue->Enqueue(LocalPath, Root.RemoteDirectory / RelativePath);
+			++NumQueued;
+		}
+
+		It.RemoveCurrent();
+	}
+
+	if (NumQueued > 0)
+	{
+		LogFtpMessage(FString::Printf(TEXT("Watch mode queued %d changed file(s), %d pending upload(s)"), NumQueued, UploadQueue->GetNumPending()));
+	}
+
+	return true;
+}
+
+bool FFtpDirectoryWatcher::ShouldIgnore(const FString& Path) const
+{
+	const FString Filename = FPaths::GetCleanFilename(Path);
+	if (Filename.StartsWith(TEXT("~")) || Filename.StartsWith(TEXT(".")))
+	{
+		return true;
+	}
+
+	const FString Extension = FPaths::GetExtension(Filename);
+	return Extension.Equals(TEXT("tmp"), ESearchCase::IgnoreCase)
+		|| Extension.Equals(TEXT("temp"), ESearchCase::IgnoreCase)
+		|| Extension.Equals(TEXT("swp"), ESearchCase::IgnoreCase)
+		|| Extension.Equals(TEXT("bak"), ESearchCase::IgnoreCase);
+}
@@ -0,0 +1,606 @@
+#include "FtpFanOutUpload.h"
+#include "FtpBufferPool.h"
+#include "FtpCurlProcess.h"
+#include "FtpIntegrity.h"
+#include "FtpPathTable.h"
+#include "FtpTransferHistory.h"
+#include "FileUpLoadTrace.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "HAL/Event.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+namespace FtpFanOut
+{
+	// 청크 스트리밍 단위 - 버퍼 풀의 가장 큰 슬랩
+	constexpr int64 StreamChunkSize = FFtpBufferPool::MaxSlabSize;
+
+	static FString MakeStdInUploadParams(const FFtpServerProfile& Target, const FString& RemotePath)
+	{
+		return FString::Printf(TEXT("%s -T - \"%s\" --ftp-pasv --ftp-create-dirs --silent --show-error"),
+			*BuildCurlSessionArgs(Target.Username, Target.Password, Target.bUseFtps), *CreateFtpUrl(Target, RemotePath));
+	}
+
+	// 스트리밍할 때 대상마다 쌓아 둘 수 있는 청크 수 - 이보다 뒤처진 대상은 공유 읽기에서 떨어져 나가 스스로 읽는다
+	constexpr int32 StreamWindowChunks = 4;
+
+	// 파일 전체를 풀 슬랩 여러 개에 한 번 읽어 둔다 - 모든 대상과 재시도가 같은 메모리를 쓴다
+	static bool ReadIntoSlabs(const FString& LocalPath, int64 FileSize, TArray<FFtpPooledBuffer>& OutSlabs)
+	{
+		TUniquePtr<IFileHandle> FileHandle(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*LocalPath));
+		if (!FileHandle.IsValid())
+		{
+			return false;
+		}
+
+		for (int64 Offset = 0; Offset < FileSize; Offset += StreamChunkSize)
+		{
+			const int64 SlabBytes = FMath::Min(FileSize - Offset, StreamChunkSize);
+			FFtpPooledBuffer& Slab = OutSlabs.Add_GetRef(FFtpBufferPool::Acquire((int32)SlabBytes));
+			if (!FileHandle->Read(Slab.GetData(), SlabBytes))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// 메모리에 읽어 둔 파일을 대상 하나로 전송
+	static bool SendSlabs(const FFtpServerProfile& Target, const FString& RemotePath, const TArray<FFtpPooledBuffer>& Slabs, int64 FileSize, FString& OutError)
+	{
+		FFtpCurlSessionScope CurlSession;
+		FFtpCurlProcess Process;
+		if (!Process.Launch(MakeStdInUploadParams(Target, RemotePath), true))
+		{
+			OutError = TEXT("failed to launch curl");
+			return false;
+		}
+
+		bool bWritten = true;
+		for (int32 SlabIndex = 0; SlabIndex < Slabs.Num() && bWritten; ++SlabIndex)
+		{
+			const int64 Offset = SlabIndex * StreamChunkSize;
+			bWritten = Process.Write(Slabs[SlabIndex].GetData(), FMath::Min(FileSize - Offset, StreamChunkSize));
+		}
+		const int32 ReturnCode = Process.Wait(OutError);
+		return bWritten && ReturnCode == 0;
+	}
+
+	// 리더가 한 번 읽어 여러 대상이 나눠 쓰는 청크 - 마지막 대상이 놓으면 풀로 돌아간다
+	struct FStreamChunk
+	{
+		TSharedPtr<FFtpPooledBuffer, ESPMode::ThreadSafe> Buffer;
+		int64 Size = 0;
+	};
+
+	// 스트리밍 대상 하나 - 자기 스레드가 큐를 비우며 curl에 쓰므로 느린 미러가 리더와 다른 미러를 막지 않는다
+	struct FStreamTarget
+	{
+		FFtpCurlProcess Process;
+		TAtomic<bool> bAlive{ false };
+
+		FCriticalSection Lock;
+		// Lock 안에서만
+		TArray<FStreamChunk> Queue;
+		// 0 이상이면 리더가 이 위치부터 더 넣지 않는다 - 큐를 비운 뒤 스스로 읽는다
+		int64 DetachedOffset = -1;
+		bool bReaderDone = false;
+
+		FEvent* QueueEvent = FPlatformProcess::GetSynchEventFromPool(false);
+
+		~FStreamTarget()
+		{
+			FPlatformProcess::ReturnSynchEventToPool(QueueEvent);
+		}
+	};
+
+	// 공유 읽기에서 떨어져 나간 대상 - 자기 핸들과 버퍼로 나머지를 읽어 보낸다
+	static bool StreamRemainder(FFtpCurlProcess& Process, const FString& LocalPath, int64 Offset, int64 FileSize)
+	{
+		TUniquePtr<IFileHandle> FileHandle(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*LocalPath));
+		if (!FileHandle.IsValid() || !FileHandle->Seek(Offset))
+		{
+			return false;
+		}
+
+		FFtpPooledBuffer Chunk = FFtpBufferPool::Acquire(StreamChunkSize);
+		while (Offset < FileSize)
+		{
+			const int64 ReadSize = FMath::Min(FileSize - Offset, StreamChunkSize);
+			if (!FileHandle->Read(Chunk.GetData(), ReadSize) || !Process.Write(Chunk.GetData(), ReadSize))
+			{
+				return false;
+			}
+			Offset += ReadSize;
+		}
+		return true;
+	}
+
+	static void RunStreamTarget(FStreamTarget& Target, const FString& LocalPath, int64 FileSize)
+	{
+		while (true)
+		{
+			FStreamChunk Chunk;
+			int64 DetachedOffset = -1;
+			bool bReaderDone = false;
+			{
+				FScopeLock ScopeLock(&Target.Lock);
+				if (Target.Queue.Num() > 0)
+				{
+					Chunk = MoveTemp(Target.Queue[0]);
+					Target.Queue.RemoveAt(0);
+				}
+				else
+				{
+					DetachedOffset = Target.DetachedOffset;
+					bReaderDone = Target.bReaderDone;
+				}
+			}
+
+			// 실패한 대상도 큐는 비워야 청크가 풀로 돌아간다
+			if (Chunk.Buffer.IsValid())
+			{
+				if (Target.bAlive && !Target.Process.Write(Chunk.Buffer->GetData(), Chunk.Size))
+				{
+					Target.bAlive = false;
+				}
+				continue;
+			}
+			if (DetachedOffset >= 0)
+			{
+				if (Target.bAlive && !StreamRemainder(Target.Process, LocalPath, DetachedOffset, FileSize))
+				{
+					Target.bAlive = false;
+				}
+				return;
+			}
+			if (bReaderDone)
+			{
+				return;
+			}
+			Target.QueueEvent->Wait();
+		}
+	}
+
+	// 큰 파일 - 청크를 한 번 읽어 대상마다의 큐(창)에 넣는다. 창이 찬 대상은 떨어져 나가 스스로 읽으므로
+	// 리더와 다른 대상은 가장 느린 미러를 기다리지 않는다. DigestBuilder가 있으면 같은 청크로 해시도 누적한다
+	static void StreamFileToTargets(const FString& LocalPath, const FString& RemotePath, const TArray<FFtpServerProfile>& Targets, const TArray<int32>& TargetIndices, TArray<bool>& OutTargetSuccess, FFtpDigestBuilder* DigestBuilder)
+	{
+		FFtpCurlSessionScope CurlSession;
+		TArray<TUniquePtr<FStreamTarget>> StreamTargets;
+		TArray<bool> Attached;
+		for (int32 TargetIndex : TargetIndices)
+		{
+			FStreamTarget& StreamTarget = *StreamTargets.Add_GetRef(MakeUnique<FStreamTarget>());
+			StreamTarget.bAlive = StreamTarget.Process.Launch(MakeStdInUploadParams(Targets[TargetIndex], RemotePath), true);
+			Attached.Add(StreamTarget.bAlive);
+		}
+
+		TUniquePtr<IFileHandle> FileHandle(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*LocalPath));
+		bool bReadFailed = !FileHandle.IsValid();
+		if (bReadFailed)
+		{
+			LogFtpMessage(FString::Printf(TEXT("Fan-out failed: cannot open %s"), *LocalPath), true);
+		}
+		const int64 FileSize = bReadFailed ? 0 : FileHandle->Size();
+
+		TArray<TFuture<void>> Writers;
+		for (const TUniquePtr<FStreamTarget>& StreamTarget : StreamTargets)
+		{
+			Writers.Add(Async(EAsyncExecution::Thread, [Target = StreamTarget.Get(), &LocalPath, FileSize]()
+			{
+				RunStreamTarget(*Target, LocalPath, FileSize);
+			}));
+		}
+
+		for (int64 Offset = 0; !bReadFailed && Offset < FileSize; )
+		{
+			// 모두 떨어져 나갔으면 해시를 만들 때만 계속 읽는다
+			if (!Attached.Contains(true) && DigestBuilder == nullptr)
+			{
+				break;
+			}
+
+			const int64 ReadSize = FMath::Min(FileSize - Offset, StreamChunkSize);
+			FStreamChunk Chunk;
+			Chunk.Buffer = MakeShared<FFtpPooledBuffer, ESPMode::ThreadSafe>(FFtpBufferPool::Acquire(StreamChunkSize));
+			Chunk.Size = ReadSize;
+			if (!FileHandle->Read(Chunk.Buffer->GetData(), ReadSize))
+			{
+				LogFtpMessage(FString::Printf(TEXT("Fan-out failed: read error on %s"), *LocalPath), true);
+				bReadFailed = true;
+				break;
+			}
+
+			if (DigestBuilder != nullptr)
+			{
+				DigestBuilder->Update(Chunk.Buffer->GetData(), ReadSize);
+			}
+
+			for (int32 Index = 0; Index < StreamTargets.Num(); ++Index)
+			{
+				FStreamTarget& StreamTarget = *StreamTargets[Index];
+				if (!Attached[Index] || !StreamTarget.bAlive)
+				{
+					continue;
+				}
+				{
+					FScopeLock ScopeLock(&StreamTarget.Lock);
+					if (StreamTarget.Queue.Num() < StreamWindowChunks)
+					{
+						StreamTarget.Queue.Add(Chunk);
+					}
+					else
+					{
+						StreamTarget.DetachedOffset = Offset;
+						Attached[Index] = false;
+					}
+				}
+				StreamTarget.QueueEvent->Trigger();
+			}
+			Offset += ReadSize;
+		}
+
+		for (const TUniquePtr<FStreamTarget>& StreamTarget : StreamTargets)
+		{
+			if (bReadFailed)
+			{
+				StreamTarget->bAlive = false;
+			}
+			{
+				FScopeLock ScopeLock(&StreamTarget->Lock);
+				StreamTarget->bReaderDone = true;
+			}
+			StreamTarget->QueueEvent->Trigger();
+		}
+		for (TFuture<void>& Writer : Writers)
+		{
+			Writer.Wait();
+		}
+
+		for (int32 Index = 0; Index < StreamTargets.Num(); ++Index)
+		{
+			FString Error;
+			const int32 ReturnCode = StreamTargets[Index]->Process.Wait(Error);
+			const int32 TargetIndex = TargetIndices[Index];
+			OutTargetSuccess[TargetIndex] = !bReadFailed && StreamTargets[Index]->bAlive && ReturnCode == 0;
+			if (!OutTargetSuccess[TargetIndex])
+			{
+				LogFtpMessage(FString::Printf(TEXT("Fan-out upload to %s failed: %s"), *Targets[TargetIndex].Name, *Error), true);
+			}
+		}
+	}
+
+	bool UploadFileToServers(const FString& LocalPath, const FString& RemotePath, const TArray<FFtpServerProfile>& Targets, TArray<bool>& OutTargetSuccess, int32 MaxRetries, TArray<int32>* OutTargetAttempts, FFtpLocalDigest* OutDigest)
+	{
+		FTP_TRACE_SCOPE(FanOutUpload);
+		FFtpTraceInFlightScope InFlight(Targets.Num());
+
+		OutTargetSuccess.Init(false, Targets.Num());
+		if (OutTargetAttempts != nullptr)
+		{
+			OutTargetAttempts->Init(0, Targets.Num());
+		}
+
+		const int64 FileSize = IFileManager::Get().FileSize(*LocalPath);
+		if (FileSize < 0)
+		{
+			LogFtpMessage(FString::Printf(TEXT("Fan-out failed: Local file does not exist: %s"), *LocalPath), true);
+			return false;
+		}
+
+		// 디스크에서는 한 번만 읽는다 - 풀 예산 안에 들어가면 슬랩 여러 개에 통째로 두고 재시도도 그 메모리로 한다
+		TArray<FFtpPooledBuffer> SharedSlabs;
+		const bool bUseSharedBuffer = FileSize <= MaxSharedBufferBytes && (FileSize <= StreamChunkSize || FFtpBufferPool::HasCapacity(FileSize));
+		if (bUseSharedBuffer && !ReadIntoSlabs(LocalPath, FileSize, SharedSlabs))
+		{
+			LogFtpMessage(FString::Printf(TEXT("Fan-out failed: cannot read %s"), *LocalPath), true);
+			return false;
+		}
+
+		// 공유 버퍼는 이미 메모리에 있으므로 그대로 해시한다
+		if (OutDigest != nullptr && bUseSharedBuffer)
+		{
+			FFtpDigestBuilder DigestBuilder;
+			for (int32 SlabIndex = 0; SlabIndex < SharedSlabs.Num(); ++SlabIndex)
+			{
+				DigestBuilder.Update(SharedSlabs[SlabIndex].GetData(), FMath::Min(FileSize - SlabIndex * StreamChunkSize, StreamChunkSize));
+			}
+			*OutDigest = DigestBuilder.Finalize();
+		}
+
+		TArray<int32> PendingTargets;
+		for (int32 TargetIndex = 0; TargetIndex < Targets.Num(); ++TargetIndex)
+		{
+			PendingTargets.Add(TargetIndex);
+		}
+
+		for (int32 Attempt = 0; Attempt <= MaxRetries && PendingTargets.Num() > 0; ++Attempt)
+		{
+			const double StartTime = FPlatformTime::Seconds();
+
+			if (bUseSharedBuffer)
+			{
+				// 대상마다 전용 스레드와 curl로 병렬 전송 - 느린 미러가 다른 미러를 막지 않고,
+				// 막히는 curl 쓰기/대기가 태스크 그래프 작업 스레드를 잡지 않는다
+				TArray<TFuture<void>> Senders;
+				for (int32 TargetIndex : PendingTargets)
+				{
+					Senders.Add(Async(EAsyncExecution::Thread, [&, TargetIndex]()
+					{
+						FString Error;
+						OutTargetSuccess[TargetIndex] = SendSlabs(Targets[TargetIndex], RemotePath, SharedSlabs, FileSize, Error);
+						if (!OutTargetSuccess[TargetIndex])
+						{
+							LogFtpMessage(FString::Printf(TEXT("Fan-out upload to %s failed: %s"), *Targets[TargetIndex].Name, *Error), true);
+						}
+					}));
+				}
+				for (TFuture<void>& Sender : Senders)
+				{
+					Sender.Wait();
+				}
+			}
+			else
+			{
+				if (Attempt > 0)
+				{
+					LogFtpMessage(FString::Printf(TEXT("Fan-out retry re-reads %s (larger than the shared buffer limit or the buffer pool budget)"), *LocalPath));
+				}
+				// 해시는 첫 시도에서 한 번만 계산
+				FFtpDigestBuilder DigestBuilder;
+				const bool bHashThisPass = OutDigest != nullptr && Attempt == 0;
+				StreamFileToTargets(LocalPath, RemotePath, Targets, PendingTargets, OutTargetSuccess, bHashThisPass ? &DigestBuilder : nullptr);
+				if (bHashThisPass)
+				{
+					*OutDigest = DigestBuilder.Finalize();
+					OutDigest->bValid = OutDigest->Size == FileSize;
+				}
+			}
+
+			const double Duration = FPlatformTime::Seconds() - StartTime;
+
+			TArray<int32> FailedTargets;
+			for (int32 TargetIndex : PendingTargets)
+			{
+				if (OutTargetAttempts != nullptr)
+				{
+					++(*OutTargetAttempts)[TargetIndex];
+				}
+
+				FFtpTransferRecord Record;
+				Record.LocalPath = LocalPath;
+				Record.RemotePath = Targets[TargetIndex].Name + TEXT(":") + RemotePath;
+				Record.Bytes = FileSize;
+				Record.DurationSeconds = Duration;
+				Record.Timestamp = FDateTime::Now();
+				Record.Direction = EFtpTransferDirection::Upload;
+				Record.bSuccess = OutTargetSuccess[TargetIndex];
+				FFtpTransferHistory::Get().Record(Record);
+
+				if (!OutTargetSuccess[TargetIndex])
+				{
+					FailedTargets.Add(TargetIndex);
+				}
+			}
+			PendingTargets = MoveTemp(FailedTargets);
+		}
+
+		return PendingTargets.Num() == 0;
+	}
+
+	// 대상 하나로 파일 묶음을 curl 한 번에 올린다 - 제어 연결, 로그인, TLS 세션을 묶음 전체가 나눠 쓴다
+	// OutSuccess는 FileIndices와 같은 순서
+	static void UploadBatchToTarget(const FFtpServerProfile& Target, const FFtpPathTable& Files, const FString& RemotePath, const TArray<int32>& FileIndices, TArray<bool>& OutSuccess)
+	{
+		OutSuccess.Init(false, FileIndices.Num());
+
+		// 요청 목록은 설정 파일로 넘긴다 - 명령줄 길이 제한을 피하고 경로가 프로세스 목록에 남지 않는다
+		FString BatchConfig;
+		for (int32 FileIndex : FileIndices)
+		{
+			BatchConfig += FString::Printf(TEXT("upload-file = \"%s\"\nurl = \"%s\"\n"),
+				*EscapeCurlConfigValue(FPaths::ConvertRelativePathToFull(Files.GetFullPath(FileIndex))),
+				*EscapeCurlConfigValue(CreateFtpUrl(Target, Files.GetRemotePath(FileIndex, RemotePath))));
+		}
+		// 전송마다 한 줄씩 종료 코드와 마지막 응답 코드
+		BatchConfig += TEXT("write-out = \"%{exitcode} %{response_code}\\n\"\n");
+
+		const FString BatchPath = FPaths::ConvertRelativePathToFull(FPaths::CreateTempFilename(*GetCurlPrivateDir(), TEXT("fanout"), TEXT(".cfg")));
+		if (!FFileHelper::SaveStringToFile(BatchConfig, *BatchPath))
+		{
+			LogFtpMessage(FString::Printf(TEXT("Fan-out failed: cannot write batch file %s"), *BatchPath), true);
+			return;
+		}
+
+		FFtpCurlSessionScope CurlSession;
+		const FString Command = FString::Printf(TEXT("%s -K \"%s\" --ftp-pasv --ftp-create-dirs --silent --show-error"),
+			*BuildCurlSessionArgs(Target.Username, Target.Password, Target.bUseFtps), *BatchPath);
+
+		FString Output, Error;
+		const bool bAllSucceeded = ExecuteCurlCommand(Command, Output, Error);
+		IFileManager::Get().Delete(*BatchPath);
+
+		TArray<FString> Lines;
+		Output.ParseIntoArrayLines(Lines);
+		for (int32 BatchIndex = 0; BatchIndex < FileIndices.Num(); ++BatchIndex)
+		{
+			if (!Lines.IsValidIndex(BatchIndex))
+			{
+				// 중간에 멈춘 묶음 - 줄이 없는 전송은 끝나지 않았다
+				OutSuccess[BatchIndex] = bAllSucceeded;
+				continue;
+			}
+
+			TArray<FString> Fields;
+			Lines[BatchIndex].ParseIntoArray(Fields, TEXT(" "));
+			int32 ExitCode = -1;
+			if (Fields.Num() > 0)
+			{
+				LexFromString(ExitCode, *Fields[0]);
+			}
+			OutSuccess[BatchIndex] = ExitCode == 0;
+		}
+
+		if (!bAllSucceeded)
+		{
+			LogFtpMessage(FString::Printf(TEXT("Fan-out upload to %s failed: %s"), *Target.Name, *Error), true);
+		}
+	}
+
+	// 대상 하나의 폴더 업로드 - 전용 스레드에서 돈다. 실패한 파일만 다시 묶어 보낸다
+	static void UploadFolderToTarget(const FFtpServerProfile& Target, const FFtpPathTable& Files, const FString& RemotePath, int32 MaxRetries, TArray<bool>& OutUploaded, int32& OutRetryCount)
+	{
+		FTP_TRACE_SCOPE(FanOutUpload);
+
+		OutUploaded.Init(false, Files.Num());
+		OutRetryCount = 0;
+
+		TArray<int32> PendingFiles;
+		PendingFiles.Reserve(Files.Num());
+		for (int32 FileIndex = 0; FileIndex < Files.Num(); ++FileIndex)
+		{
+			PendingFiles.Add(FileIndex);
+		}
+
+		for (int32 Attempt = 0; Attempt <= MaxRetries && PendingFiles.Num() > 0; ++Attempt)
+		{
+			if (Attempt > 0)
+			{
+				OutRetryCount += PendingFiles.Num();
+				LogFtpMessage(FString::Printf(TEXT("Fan-out retrying %d files to %s"), PendingFiles.Num(), *Target.Name));
+			}
+
+			FFtpTraceInFlightScope InFlight(PendingFiles.Num());
+			const double StartTime = FPlatformTime::Seconds();
+			TArray<bool> BatchSuccess;
+			UploadBatchToTarget(Target, Files, RemotePath, PendingFiles, BatchSuccess);
+			const double Duration = FPlatformTime::Seconds() - StartTime;
+
+			TArray<int32> FailedFiles;
+			for (int32 BatchIndex = 0; BatchIndex < PendingFiles.Num(); ++BatchIndex)
+			{
+				const int32 FileIndex = PendingFiles[BatchIndex];
+				const FString RemoteFile = Files.GetRemotePath(FileIndex, RemotePath);
+
+				FFtpTransferRecord Record;
+				Record.LocalPath = Files.GetFullPath(FileIndex);
+				Record.RemotePath = Target.Name + TEXT(":") + RemoteFile;
+				Record.Bytes = IFileManager::Get().FileSize(*Record.LocalPath);
+				Record.DurationSeconds = Duration / PendingFiles.Num();
+				Record.Timestamp = FDateTime::Now();
+				Record.Direction = EFtpTransferDirection::Upload;
+				Record.bSuccess = BatchSuccess[BatchIndex];
+				FFtpTransferHistory::Get().Record(Record);
+
+				if (BatchSuccess[BatchIndex])
+				{
+					OutUploaded[FileIndex] = true;
+				}
+				else
+				{
+					FailedFiles.Add(FileIndex);
+				}
+			}
+			PendingFiles = MoveTemp(FailedFiles);
+		}
+	}
+
+	void UploadToFtpServers(const FString& LocalPath, const FString& RemotePath, const TArray<FFtpServerProfile>& Targets, TArray<FFtpFanOutTargetResult>& OutResults, int32 MaxRetries, bool bVerify)
+	{
+		UE_LOG(LogTemp, Log, TEXT("=== FTP 팬아웃 업로드 시작: %d개 서버 ==="), Targets.Num());
+
+		OutResults.SetNum(Targets.Num());
+		for (int32 TargetIndex = 0; TargetIndex < Targets.Num(); ++TargetIndex)
+		{
+			OutResults[TargetIndex].TargetName = Targets[TargetIndex].Name;
+		}
+
+		if (!FPaths::DirectoryExists(LocalPath))
+		{
+			UE_LOG(LogTemp, Error, TEXT("로컬 경로가 존재하지 않습니다: %s"), *LocalPath);
+			return;
+		}
+
+		FFtpPathTable AllFiles(LocalPath);
+		AllFiles.Scan();
+		UE_LOG(LogTemp, Log, TEXT("총 %d개 파일 발견"), AllFiles.Num());
+
+		// 대상마다 전용 스레드에서 curl 한 번으로 묶어 올린다 - 파일마다 프로세스, 로그인, TLS 핸드셰이크를 하지 않고,
+		// 막히는 curl 대기가 태스크 그래프 작업 스레드를 잡지 않는다
+		const FDateTime UploadStart = FDateTime::UtcNow();
+		TArray<TArray<bool>> Uploaded;
+		Uploaded.SetNum(Targets.Num());
+		TArray<TFuture<void>> TargetTasks;
+		for (int32 TargetIndex = 0; TargetIndex < Targets.Num(); ++TargetIndex)
+		{
+			TargetTasks.Add(Async(EAsyncExecution::Thread, [&, TargetIndex]()
+			{
+				UploadFolderToTarget(Targets[TargetIndex], AllFiles, RemotePath, MaxRetries, Uploaded[TargetIndex], OutResults[TargetIndex].RetryCount);
+			}));
+		}
+		for (TFuture<void>& TargetTask : TargetTasks)
+		{
+			TargetTask.Wait();
+		}
+
+		// 검증용 해시는 대상 수와 상관없이 파일마다 한 번만 계산한다
+		TArray<FFtpLocalDigest> Digests;
+		if (bVerify)
+		{
+			Digests.SetNum(AllFiles.Num());
+			ParallelFor(AllFiles.Num(), [&](int32 FileIndex)
+			{
+				FtpIntegrity::ComputeLocalDigest(AllFiles.GetFullPath(FileIndex), Digests[FileIndex]);
+			});
+		}
+
+		TArray<TArray<FFtpVerifyRequest>> VerifyRequests;
+		VerifyRequests.SetNum(Targets.Num());
+		for (int32 TargetIndex = 0; TargetIndex < Targets.Num(); ++TargetIndex)
+		{
+			FFtpFanOutTargetResult& Result = OutResults[TargetIndex];
+			for (int32 FileIndex = 0; FileIndex < AllFiles.Num(); ++FileIndex)
+			{
+				if (!Uploaded[TargetIndex][FileIndex])
+				{
+					Result.FailCount++;
+					continue;
+				}
+
+				Result.SuccessCount++;
+				if (bVerify)
+				{
+					FFtpVerifyRequest& Request = VerifyRequests[TargetIndex].AddDefaulted_GetRef();
+					Request.LocalPath = AllFiles.GetFullPath(FileIndex);
+					Request.RemotePath = AllFiles.GetRemotePath(FileIndex, RemotePath);
+					Request.Digest = Digests[FileIndex];
+					Request.UploadedAfter = UploadStart;
+				}
+			}
+		}
+
+		// 대상별로 디렉토리 단위 일괄 검증 - 불일치는 실패로 옮긴다
+		for (int32 TargetIndex = 0; bVerify && TargetIndex < Targets.Num(); ++TargetIndex)
+		{
+			TArray<FFtpVerifyOutcome> Outcomes;
+			const int32 VerifyFailCount = FtpIntegrity::VerifyFiles(Targets[TargetIndex], VerifyRequests[TargetIndex], Outcomes);
+
+			FFtpFanOutTargetResult& Result = OutResults[TargetIndex];
+			Result.VerifyFailCount = VerifyFailCount;
+			Result.SuccessCount -= VerifyFailCount;
+			Result.FailCount += VerifyFailCount;
+		}
+
+		for (const FFtpFanOutTargetResult& Result : OutResults)
+		{
+			UE_LOG(LogTemp, Log, TEXT("=== %s: 성공 %d개, 실패 %d개 (검증 실패 %d개), 재시도 %d회 ==="), *Result.TargetName, Result.SuccessCount, Result.FailCount, Result.VerifyFailCount, Result.RetryCount);
+		}
+	}
+}
@@ -0,0 +1,284 @@
+#include "FtpFileListModel.h"
+#include "Async/Async.h"
+#include "Misc/ScopeRWLock.h"
+
+const FName FFtpListColumns::Path(TEXT("Path"));
+const FName FFtpListColumns::Size(TEXT("Size"));
+const FName FFtpListColumns::Time(TEXT("Time"));
+const FName FFtpListColumns::Status(TEXT("Status"));
+
+FFtpFileListModel::FFtpFileListModel(bool bInUniquePaths)
+	: bUniquePaths(bInUniquePaths)
+	, SortColumn(FFtpListColumns::Path)
+	, SortMode(EColumnSortMode::None)
+	, ViewGeneration(0)
+	, bRebuildInFlight(false)
+{
+}
+
+void FFtpFileListModel::EnqueueAdd(const FString& Path, int64 Size, const FDateTime& Time, EFtpListEntryStatus Status)
+{
+	FPendingOp Op;
+	Op.Path = Path;
+	Op.Size = Size;
+	Op.Time = Time;
+	Op.Status = Status;
+	Op.bIsAdd = true;
+	PendingOps.Enqueue(MoveTemp(Op));
+}
+
+void FFtpFileListModel::EnqueueStatus(const FString& Path, EFtpListEntryStatus Status)
+{
+	FPendingOp Op;
+	Op.Path = Path;
+	Op.Status = Status;
+	PendingOps.Enqueue(MoveTemp(Op));
+}
+
+bool FFtpFileListModel::FlushPending()
+{
+	check(IsInGameThread());
+
+	if (PendingOps.IsEmpty())
+	{
+		return false;
+	}
+
+	// 백그라운드 정렬이 읽는 중이면 게임 스레드를 막지 않고 다음 프레임에 다시 시도한다
+	if (!DataLock.TryWriteLock())
+	{
+		return false;
+	}
+
+	const int32 FirstNewIndex = Paths.Num();
+	bool bKeysChanged = false;
+
+	FPendingOp Op;
+	int32 NumOps = 0;
+	while (NumOps < MaxOpsPerFlush && PendingOps.Dequeue(Op))
+	{
+		++NumOps;
+
+		int32* ExistingIndex = PathToIndex.Find(Op.Path);
+		if (Op.bIsAdd && (!bUniquePaths || ExistingIndex == nullptr))
+		{
+			const int32 Index = Paths.Add(Op.Path);
+			Sizes.Add(Op.Size);
+			Times.Add(Op.Time);
+			Statuses.Add(Op.Status);
+			PathToIndex.Add(Op.Path, Index);
+		}
+		else if (ExistingIndex != nullptr)
+		{
+			const int32 Index = *ExistingIndex;
+			if (Op.bIsAdd)
+			{
+				Sizes[Index] = Op.Size;
+				Times[Index] = Op.Time;
+			}
+			Statuses[Index] = Op.Status;
+			bKeysChanged = true;
+		}
+	}
+
+	DataLock.WriteUnlock();
+
+	const int32 NumAdded = Paths.Num() - FirstNewIndex;
+	for (int32 Index = FirstNewIndex; Index < Paths.Num(); ++Index)
+	{
+		Handles.Add(MakeShared<FFtpListItem>(Index));
+	}
+
+	// 정렬 키가 바뀌었거나 한 번에 많이 들어왔으면 백그라운드에서 다시 계산
+	const bool bSortDependsOnKeys = SortMode != EColumnSortMode::None && SortColumn != FFtpListColumns::Path;
+	if ((bKeysChanged && bSortDependsOnKeys) || NumAdded > IncrementalInsertLimit)
+	{
+		RequestRebuildView();
+		return false;
+	}
+
+	// 진행 중인 재계산은 스냅샷 이후 행을 ApplyView에서 끼워 넣는다
+	if (NumAdded > 0 && !bRebuildInFlight)
+	{
+		for (int32 Index = FirstNewIndex; Index < Paths.Num(); ++Index)
+		{
+			InsertVisible(Index);
+		}
+		ViewChangedEvent.Broadcast();
+		return true;
+	}
+
+	return false;
+}
+
+void FFtpFileListModel::SetSort(FName Column, EColumnSortMode::Type Mode)
+{
+	SortColumn = Column;
+	SortMode = Mode;
+	RequestRebuildView();
+}
+
+void FFtpFileListModel::SetFilter(const FString& InFilter)
+{
+	if (FilterText != InFilter)
+	{
+		FilterText = InFilter;
+		RequestRebuildView();
+	}
+}
+
+bool FFtpFileListModel::PassesFilter(int32 Index, const FString& Filter) const
+{
+	return Filter.IsEmpty() || Paths[Index].Contains(Filter);
+}
+
+bool FFtpFileListModel::CompareRows(const FFtpFileListModel& Model, FName Column, EColumnSortMode::Type Mode, int32 A, int32 B)
+{
+	if (Mode == EColumnSortMode::Descending)
+	{
+		Swap(A, B);
+	}
+
+	if (Column == FFtpListColumns::Size && Model.Sizes[A] != Model.Sizes[B])
+	{
+		return Model.Sizes[A] < Model.Sizes[B];
+	}
+	if (Column == FFtpListColumns::Time && Model.Times[A] != Model.Times[B])
+	{
+		return Model.Times[A] < Model.Times[B];
+	}
+	if (Column == FFtpListColumns::Status && Model.Statuses[A] != Model.Statuses[B])
+	{
+		return Model.Statuses[A] < Model.Statuses[B];
+	}
+	if (Column == FFtpListColumns::Path)
+	{
+		const int32 Result = Model.Paths[A].Compare(Model.Paths[B], ESearchCase::IgnoreCase);
+		if (Result != 0)
+		{
+			return Result < 0;
+		}
+	}
+
+	// 같은 키는 추가 순서 유지
+	return A < B;
+}
+
+void FFtpFileListModel::RequestRebuildView()
+{
+	check(IsInGameThread());
+
+	const uint32 Generation = ++ViewGeneration;
+	bRebuildInFlight = true;
+
+	TWeakPtr<FFtpFileListModel> WeakModel = AsShared();
+	const FName Column = SortColumn;
+	const EColumnSortMode::Type Mode = SortMode;
+	const FString Filter = FilterText;
+
+	Async(EAsyncExecution::ThreadPool, [WeakModel, Generation, Column, Mode, Filter]()
+	{
+		TSharedPtr<FFtpFileListModel> Model = WeakModel.Pin();
+		if (!Model.IsValid())
+		{
+			return;
+		}
+
+		TArray<int32> Indices;
+		int32 SnapshotNum = 0;
+		{
+			FReadScopeLock ReadLock(Model->DataLock);
+
+			SnapshotNum = Model->Paths.Num();
+			Indices.Reserve(SnapshotNum);
+			for (int32 Index = 0; Index < SnapshotNum; ++Index)
+			{
+				if (Model->PassesFilter(Index, Filter))
+				{
+					Indices.Add(Index);
+				}
+			}
+
+			if (Mode != EColumnSortMode::None)
+			{
+				const FFtpFileListModel& ModelRef = *Model;
+				Indices.Sort([&ModelRef, Column, Mode](int32 A, int32 B)
+				{
+					return CompareRows(ModelRef, Column, Mode, A, B);
+				});
+			}
+		}
+
+		AsyncTask(ENamedThreads::GameThread, [WeakModel, Generation, SnapshotNum, Indices = MoveTemp(Indices)]() mutable
+		{
+			if (TSharedPtr<FFtpFileListModel> PinnedModel = WeakModel.Pin())
+			{
+				PinnedModel->ApplyView(Generation, SnapshotNum, MoveTemp(Indices));
+			}
+		});
+	});
+}
+
+void FFtpFileListModel::ApplyView(uint32 Generation, int32 SnapshotNum, TArray<int32>&& Indices)
+{
+	// 그 사이 정렬/필터가 다시 바뀌었으면 오래된 결과는 버린다
+	if (Generation != ViewGeneration)
+	{
+		return;
+	}
+
+	bRebuildInFlight = false;
+
+	VisibleItems.Reset(Indices.Num());
+	for (int32 Index : Indices)
+	{
+		VisibleItems.Add(Handles[Index]);
+	}
+
+	// 스냅샷 이후 추가된 행
+	const int32 NumLate = Paths.Num() - SnapshotNum;
+	if (NumLate > IncrementalInsertLimit)
+	{
+		ViewChangedEvent.Broadcast();
+		RequestRebuildView();
+		return;
+	}
+
+	for (int32 Index = SnapshotNum; Index < Paths.Num(); ++Index)
+	{
+		InsertVisible(Index);
+	}
+
+	ViewChangedEvent.Broadcast();
+}
+
+void FFtpFileListModel::InsertVisible(int32 Index)
+{
+	if (!PassesFilter(Index, FilterText))
+	{
+		return;
+	}
+
+	if (SortMode == EColumnSortMode::None)
+	{
+		VisibleItems.Add(Handles[Index]);
+		return;
+	}
+
+	// 정렬 위치를 이진 탐색으로 찾아 끼워 넣는다
+	int32 Low = 0;
+	int32 High = VisibleItems.Num();
+	while (Low < High)
+	{
+		const int32 Mid = Low + (High - Low) / 2;
+		if (CompareRows(*this, SortColumn, SortMode, VisibleItems[Mid]->Index, Index))
+		{
+			Low = Mid + 1;
+		}
+		else
+		{
+			High = Mid;
+		}
+	}
+	VisibleItems.Insert(Handles[Index], Low);
+}
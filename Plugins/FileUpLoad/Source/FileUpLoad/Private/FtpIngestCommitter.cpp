@@ -0,0 +1,287 @@
+#include "FtpIngestCommitter.h"
+#include "FtpSystem.h"
+#include "FileUpLoadStats.h"
+#include "FileUpLoadTrace.h"
+#include "Async/Async.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformFilemanager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+#if PLATFORM_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#elif PLATFORM_MAC
+#include <stdio.h>
+#elif PLATFORM_WINDOWS
+#include "Windows/WindowsHWrapper.h"
+#endif
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Ingest Files Committed"), STAT_FileUpLoad_IngestFilesCommitted, STATGROUP_FileUpLoad);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Ingest Commit Batches"), STAT_FileUpLoad_IngestCommitBatches, STATGROUP_FileUpLoad);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Ingest Last Batch (ms)"), STAT_FileUpLoad_IngestLastBatchMs, STATGROUP_FileUpLoad);
+
+namespace FtpIngest
+{
+	static const TCHAR* TempMarker = TEXT(".ftppart.");
+	static TAtomic<uint32> TempCounter(0);
+}
+
+FFtpIngestCommitter::FFtpIngestCommitter()
+	: WakeEvent(FPlatformProcess::GetSynchEventFromPool(false))
+	, bStopping(false)
+{
+}
+
+FFtpIngestCommitter::~FFtpIngestCommitter()
+{
+	Stop();
+	FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+	WakeEvent = nullptr;
+}
+
+void FFtpIngestCommitter::Start()
+{
+	if (bStarted)
+	{
+		return;
+	}
+
+	bStarted = true;
+	bStopping = false;
+	CommitFuture = Async(EAsyncExecution::Thread, [this]()
+	{
+		CommitLoop();
+	});
+}
+
+void FFtpIngestCommitter::Stop()
+{
+	if (!bStarted)
+	{
+		return;
+	}
+
+	bStopping = true;
+	WakeEvent->Trigger();
+	CommitFuture.Wait();
+	bStarted = false;
+}
+
+FString FFtpIngestCommitter::MakeTempPath(const FString& FinalPath)
+{
+	// 숨김 이름 + 프로세스 안에서 겹치지 않는 번호
+	return FPaths::GetPath(FinalPath) / FString::Printf(TEXT(".%s%s%u"), *FPaths::GetCleanFilename(FinalPath), FtpIngest::TempMarker, ++FtpIngest::TempCounter);
+}
+
+bool FFtpIngestCommitter::IsTempFileName(const FString& FileName)
+{
+	return FileName.StartsWith(TEXT(".")) && FileName.Contains(FtpIngest::TempMarker, ESearchCase::CaseSensitive);
+}
+
+bool FFtpIngestCommitter::ReplaceFile(const FString& TempPath, const FString& FinalPath)
+{
+	FString FullTempPath = FPaths::ConvertRelativePathToFull(TempPath);
+	FString FullFinalPath = FPaths::ConvertRelativePathToFull(FinalPath);
+
+#if PLATFORM_WINDOWS
+	// 대상이 있어도 한 번에 바꾸고, 이름 바꾸기가 디스크에 내려간 뒤 돌아온다
+	FPaths::MakePlatformFilename(FullTempPath);
+	FPaths::MakePlatformFilename(FullFinalPath);
+	return ::MoveFileExW(*FullTempPath, *FullFinalPath, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#elif PLATFORM_UNIX || PLATFORM_MAC
+	return rename(TCHAR_TO_UTF8(*FullTempPath), TCHAR_TO_UTF8(*FullFinalPath)) == 0;
+#else
+	// 원자적으로 바꿀 방법이 없는 플랫폼 - 지운 뒤 옮긴다
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	if (PlatformFile.FileExists(*FullFinalPath))
+	{
+		PlatformFile.DeleteFile(*FullFinalPath);
+	}
+	return PlatformFile.MoveFile(*FullFinalPath, *FullTempPath);
+#endif
+}
+
+bool FFtpIngestCommitter::Commit(const FString& TempPath, const FString& FinalPath)
+{
+	if (!bStarted)
+	{
+		return false;
+	}
+
+	FRequest Request;
+	Request.TempPath = TempPath;
+	Request.FinalPath = FinalPath;
+	Request.DoneEvent = FPlatformProcess::GetSynchEventFromPool(true);
+
+	{
+		FScopeLock ScopeLock(&Lock);
+		Pending.Add(&Request);
+	}
+	WakeEvent->Trigger();
+
+	Request.DoneEvent->Wait();
+	FPlatformProcess::ReturnSynchEventToPool(Request.DoneEvent);
+	return Request.bSuccess;
+}
+
+void FFtpIngestCommitter::CommitLoop()
+{
+	while (true)
+	{
+		bool bHasPending = false;
+		{
+			FScopeLock ScopeLock(&Lock);
+			bHasPending = Pending.Num() > 0;
+		}
+
+		if (!bHasPending)
+		{
+			if (bStopping)
+			{
+				break;
+			}
+			WakeEvent->Wait(100);
+			continue;
+		}
+
+		// 첫 요청 뒤 잠깐 더 모은다 - 동시에 끝나는 다른 세션의 파일이 같은 sync를 타게
+		const double BatchDeadline = FPlatformTime::Seconds() + MaxBatchDelaySeconds;
+		while (FPlatformTime::Seconds() < BatchDeadline && !bStopping)
+		{
+			{
+				FScopeLock ScopeLock(&Lock);
+				if (Pending.Num() >= MaxBatchFiles)
+				{
+					break;
+				}
+			}
+			FPlatformProcess::SleepNoStats(0.0005f);
+		}
+
+		TArray<FRequest*> Batch;
+		{
+			FScopeLock ScopeLock(&Lock);
+			const int32 Count = FMath::Min(Pending.Num(), MaxBatchFiles);
+			Batch.Append(Pending.GetData(), Count);
+			Pending.RemoveAt(0, Count);
+		}
+
+		CommitBatch(Batch);
+	}
+}
+
+void FFtpIngestCommitter::CommitBatch(TArray<FRequest*>& Batch)
+{
+	FTP_TRACE_SCOPE(IngestCommit);
+
+	const double StartTime = FPlatformTime::Seconds();
+	TSet<FString> Directories;
+
+#if PLATFORM_LINUX
+	// 1) 내용을 디스크에 내린다
+	TArray<int> Descriptors;
+	Descriptors.Init(-1, Batch.Num());
+	TMap<uint64, int> DeviceDescriptors;
+	for (int32 Index = 0; Index < Batch.Num(); ++Index)
+	{
+		Descriptors[Index] = open(TCHAR_TO_UTF8(*Batch[Index]->TempPath), O_RDONLY | O_CLOEXEC);
+		struct stat StatBuffer;
+		if (Descriptors[Index] >= 0 && fstat(Descriptors[Index], &StatBuffer) == 0)
+		{
+			DeviceDescriptors.FindOrAdd((uint64)StatBuffer.st_dev, Descriptors[Index]);
+		}
+	}
+
+	TArray<bool> Synced;
+	Synced.Init(false, Batch.Num());
+	if (Batch.Num() >= SyncFileSystemMinFiles)
+	{
+		// 파일 시스템 전체를 한 번에 - 파일 수와 관계없이 장치마다 한 번의 저널 커밋
+		TSet<uint64> SyncedDevices;
+		for (const TPair<uint64, int>& Device : DeviceDescriptors)
+		{
+			if (syncfs(Device.Value) == 0)
+			{
+				SyncedDevices.Add(Device.Key);
+			}
+		}
+		for (int32 Index = 0; Index < Batch.Num(); ++Index)
+		{
+			struct stat StatBuffer;
+			Synced[Index] = Descriptors[Index] >= 0 && fstat(Descriptors[Index], &StatBuffer) == 0 && SyncedDevices.Contains((uint64)StatBuffer.st_dev);
+		}
+	}
+	for (int32 Index = 0; Index < Batch.Num(); ++Index)
+	{
+		if (!Synced[Index] && Descriptors[Index] >= 0)
+		{
+			Synced[Index] = fdatasync(Descriptors[Index]) == 0;
+		}
+		if (Descriptors[Index] >= 0)
+		{
+			close(Descriptors[Index]);
+		}
+	}
+
+	// 2) 제자리로 원자적으로 옮긴다 (기존 파일은 한 번에 바뀐다)
+	for (int32 Index = 0; Index < Batch.Num(); ++Index)
+	{
+		FRequest& Request = *Batch[Index];
+		Request.bSuccess = Synced[Index] && rename(TCHAR_TO_UTF8(*Request.TempPath), TCHAR_TO_UTF8(*Request.FinalPath)) == 0;
+		if (Request.bSuccess)
+		{
+			Directories.Add(FPaths::GetPath(Request.FinalPath));
+		}
+		else
+		{
+			LogFtpMessage(FString::Printf(TEXT("Ingest commit failed for %s (errno %d)"), *Request.FinalPath, errno), true);
+			unlink(TCHAR_TO_UTF8(*Request.TempPath));
+		}
+	}
+
+	// 3) 이름 바꾸기를 내구성 있게 - 디렉토리마다 한 번
+	for (const FString& Directory : Directories)
+	{
+		const int DirectoryDescriptor = open(TCHAR_TO_UTF8(*Directory), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+		if (DirectoryDescriptor >= 0)
+		{
+			fsync(DirectoryDescriptor);
+			close(DirectoryDescriptor);
+		}
+	}
+#else
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	for (FRequest* Request : Batch)
+	{
+		bool bFlushed = false;
+		{
+			TUniquePtr<IFileHandle> Handle(PlatformFile.OpenWrite(*Request->TempPath, true));
+			bFlushed = Handle.IsValid() && Handle->Flush(true);
+		}
+
+		// 기존 파일은 지우지 않고 한 번에 바꾼다 - 읽는 쪽은 옛 파일이나 새 파일 중 하나만 본다
+		Request->bSuccess = bFlushed && ReplaceFile(Request->TempPath, Request->FinalPath);
+		if (!Request->bSuccess)
+		{
+			LogFtpMessage(FString::Printf(TEXT("Ingest commit failed for %s"), *Request->FinalPath), true);
+			PlatformFile.DeleteFile(*Request->TempPath);
+		}
+	}
+#endif
+
+	INC_DWORD_STAT_BY(STAT_FileUpLoad_IngestFilesCommitted, Batch.Num());
+	INC_DWORD_STAT(STAT_FileUpLoad_IngestCommitBatches);
+	SET_FLOAT_STAT(STAT_FileUpLoad_IngestLastBatchMs, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+	// 모두 내구성 있게 끝난 뒤에만 세션들을 깨운다
+	for (FRequest* Request : Batch)
+	{
+		Request->DoneEvent->Trigger();
+	}
+}
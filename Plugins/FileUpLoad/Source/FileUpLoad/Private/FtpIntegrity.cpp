@@ -0,0 +1,599 @@
+#include "FtpIntegrity.h"
+#include "FtpBufferPool.h"
+#include "FtpTransferHistory.h"
+#include "FileUpLoadTrace.h"
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFilemanager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Crc.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+FFtpDigestBuilder::FFtpDigestBuilder()
+{
+}
+
+void FFtpDigestBuilder::Update(const uint8* Data, int64 InSize)
+{
+	FTP_TRACE_SCOPE(Hash);
+
+	// FCrc::MemCrc32은 int32 길이만 받으므로 나눠서 누적
+	constexpr int64 MaxCrcChunk = 1 << 30;
+
+	Md5.Update(Data, InSize);
+	Sha1.Update(Data, InSize);
+	for (int64 Offset = 0; Offset < InSize; Offset += MaxCrcChunk)
+	{
+		Crc32 = FCrc::MemCrc32(Data + Offset, (int32)FMath::Min(InSize - Offset, MaxCrcChunk), Crc32);
+	}
+	Size += InSize;
+}
+
+FFtpLocalDigest FFtpDigestBuilder::Finalize()
+{
+	uint8 Md5Bytes[16];
+	Md5.Final(Md5Bytes);
+
+	uint8 Sha1Bytes[FSHA1::DigestSize];
+	Sha1.Final();
+	Sha1.GetHash(Sha1Bytes);
+
+	FFtpLocalDigest Digest;
+	Digest.Size = Size;
+	Digest.Md5 = BytesToHex(Md5Bytes, UE_ARRAY_COUNT(Md5Bytes));
+	Digest.Sha1 = BytesToHex(Sha1Bytes, UE_ARRAY_COUNT(Sha1Bytes));
+	Digest.Crc32 = Crc32;
+	Digest.bValid = true;
+	return Digest;
+}
+
+namespace FtpIntegrity
+{
+	// FEAT로 알아낸 서버 기능
+	struct FServerCapabilities
+	{
+		bool bHash = false;
+		bool bXSha1 = false;
+		bool bXMd5 = false;
+		bool bXCrc = false;
+		bool bSize = false;
+		bool bMdtm = false;
+		FString HashAlgorithms;
+	};
+
+	// 서버별 기능은 세션 동안 한 번만 묻는다
+	static FCriticalSection CapabilitiesLock;
+	static TMap<FString, FServerCapabilities> CapabilitiesCache;
+
+	// 응답의 첫 세 자리 코드
+	static int32 GetReplyCode(const FString& Reply)
+	{
+		int32 Code = 0;
+		if (Reply.Len() >= 3 && FChar::IsDigit(Reply[0]) && FChar::IsDigit(Reply[1]) && FChar::IsDigit(Reply[2]))
+		{
+			LexFromString(Code, *Reply.Left(3));
+		}
+		return Code;
+	}
+
+	// 응답에서 지정 길이의 16진수 토큰 찾기
+	static FString ExtractHexToken(const FString& Reply, int32 HexLength)
+	{
+		TArray<FString> Tokens;
+		Reply.ParseIntoArrayWS(Tokens);
+		for (int32 Index = 1; Index < Tokens.Num(); ++Index)
+		{
+			const FString& Token = Tokens[Index];
+			if (Token.Len() != HexLength)
+			{
+				continue;
+			}
+
+			bool bAllHex = true;
+			for (TCHAR Char : Token)
+			{
+				bAllHex &= FChar::IsHexDigit(Char);
+			}
+			if (bAllHex)
+			{
+				return Token.ToLower();
+			}
+		}
+		return FString();
+	}
+
+	// FTP 명령 인자로 쓰는 로그인 디렉토리 기준 경로
+	static FString ToCommandPath(const FString& RemotePath)
+	{
+		FString Path = RemotePath;
+		Path.RemoveFromStart(TEXT("/"));
+		return Path;
+	}
+
+	// quote 명령들을 curl 한 번으로 보내고 명령별 응답을 모은다
+	// '*'를 붙여 지원하지 않는 명령이 있어도 나머지를 계속 보낸다
+	static bool RunQuoteCommands(const FFtpServerProfile& Server, const FString& DirectoryPath, const TArray<FString>& Commands, TArray<FString>& OutReplies)
+	{
+		OutReplies.Reset();
+		OutReplies.SetNum(Commands.Num());
+
+		FString QuoteConfig;
+		for (const FString& Command : Commands)
+		{
+			QuoteConfig += FString::Printf(TEXT("quote = \"*%s\"\n"), *EscapeCurlConfigValue(Command));
+		}
+
+		const FString QuotePath = FPaths::ConvertRelativePathToFull(FPaths::CreateTempFilename(*GetCurlPrivateDir(), TEXT("verify"), TEXT(".cfg")));
+		if (!FFileHelper::SaveStringToFile(QuoteConfig, *QuotePath))
+		{
+			LogFtpMessage(FString::Printf(TEXT("Verify failed: cannot write %s"), *QuotePath), true);
+			return false;
+		}
+
+		FString DirectoryUrl = CreateFtpUrl(Server, DirectoryPath);
+		if (!DirectoryUrl.EndsWith(TEXT("/")))
+		{
+			DirectoryUrl += TEXT("/");
+		}
+
+		FFtpCurlSessionScope CurlSession;
+		// 응답은 -v 출력(표준 에러)의 "> 명령" / "< 응답" 줄에서 읽는다
+		const FString Command = FString::Printf(TEXT("%s -K \"%s\" \"%s\" --list-only --ftp-pasv --silent --verbose"),
+			*BuildCurlSessionArgs(Server.Username, Server.Password, Server.bUseFtps), *QuotePath, *DirectoryUrl);
+
+		FString Output, Error;
+		ExecuteCurlCommand(Command, Output, Error);
+		IFileManager::Get().Delete(*QuotePath);
+
+		TArray<FString> Lines;
+		Error.ParseIntoArrayLines(Lines);
+
+		int32 NextCommand = 0;
+		int32 CurrentCommand = INDEX_NONE;
+		for (const FString& Line : Lines)
+		{
+			if (Line.StartsWith(TEXT("> ")))
+			{
+				const FString Sent = Line.Mid(2).TrimEnd();
+				CurrentCommand = INDEX_NONE;
+				for (int32 Index = NextCommand; Index < Commands.Num(); ++Index)
+				{
+					if (Commands[Index] == Sent)
+					{
+						CurrentCommand = Index;
+						NextCommand = Index + 1;
+						break;
+					}
+				}
+			}
+			else if (Line.StartsWith(TEXT("< ")) && CurrentCommand != INDEX_NONE)
+			{
+				const FString Received = Line.Mid(2).TrimEnd();
+				FString& Reply = OutReplies[CurrentCommand];
+				Reply += Reply.IsEmpty() ? Received : TEXT("\n") + Received;
+
+				// "213-" 는 여러 줄 응답의 시작, "213 " 이 끝
+				if (Received.Len() >= 4 && GetReplyCode(Received) != 0 && Received[3] == TEXT(' '))
+				{
+					CurrentCommand = INDEX_NONE;
+				}
+			}
+		}
+
+		return NextCommand > 0;
+	}
+
+	static FServerCapabilities GetServerCapabilities(const FFtpServerProfile& Server)
+	{
+		const FString Key = FString::Printf(TEXT("%s:%d"), *Server.Address, Server.Port);
+		{
+			FScopeLock ScopeLock(&CapabilitiesLock);
+			if (const FServerCapabilities* Cached = CapabilitiesCache.Find(Key))
+			{
+				return *Cached;
+			}
+		}
+
+		FServerCapabilities Capabilities;
+		TArray<FString> Replies;
+		if (!RunQuoteCommands(Server, TEXT("/"), { TEXT("FEAT") }, Replies) || GetReplyCode(Replies[0]) == 0)
+		{
+			// 연결 실패는 캐시하지 않고 다음 검증에서 다시 묻는다
+			return Capabilities;
+		}
+
+		{
+			TArray<FString> Features;
+			Replies[0].ParseIntoArrayLines(Features);
+			for (FString Feature : Features)
+			{
+				Feature.TrimStartAndEndInline();
+				Feature.ToUpperInline();
+
+				FString Name;
+				FString Arguments;
+				if (!Feature.Split(TEXT(" "), &Name, &Arguments))
+				{
+					Name = Feature;
+				}
+
+				if (Name == TEXT("HASH"))
+				{
+					Capabilities.bHash = true;
+					Capabilities.HashAlgorithms = Arguments;
+				}
+				Capabilities.bXSha1 |= Name == TEXT("XSHA1");
+				Capabilities.bXMd5 |= Name == TEXT("XMD5");
+				Capabilities.bXCrc |= Name == TEXT("XCRC");
+				Capabilities.bSize |= Name == TEXT("SIZE");
+				Capabilities.bMdtm |= Name == TEXT("MDTM");
+			}
+		}
+
+		FScopeLock ScopeLock(&CapabilitiesLock);
+		CapabilitiesCache.Add(Key, Capabilities);
+		return Capabilities;
+	}
+
+	// 서버가 지원하는 가장 강한 방법 선택. HASH면 사용할 알고리즘도 돌려준다
+	static EFtpVerifyMethod SelectMethod(const FServerCapabilities& Capabilities, FString& OutHashAlgorithm)
+	{
+		if (Capabilities.bHash)
+		{
+			if (Capabilities.HashAlgorithms.Contains(TEXT("SHA-1")))
+			{
+				OutHashAlgorithm = TEXT("SHA-1");
+				return EFtpVerifyMethod::Hash;
+			}
+			if (Capabilities.HashAlgorithms.Contains(TEXT("MD5")))
+			{
+				OutHashAlgorithm = TEXT("MD5");
+				return EFtpVerifyMethod::Hash;
+			}
+		}
+		if (Capabilities.bXSha1)
+		{
+			return EFtpVerifyMethod::XSha1;
+		}
+		if (Capabilities.bXMd5)
+		{
+			return EFtpVerifyMethod::XMd5;
+		}
+		if (Capabilities.bXCrc)
+		{
+			return EFtpVerifyMethod::XCrc;
+		}
+		if (Capabilities.bSize)
+		{
+			return EFtpVerifyMethod::SizeAndTime;
+		}
+		return EFtpVerifyMethod::None;
+	}
+
+	static FString MakeVerifyCommand(EFtpVerifyMethod Method, const FString& CommandPath)
+	{
+		switch (Method)
+		{
+		case EFtpVerifyMethod::Hash:
+			return TEXT("HASH ") + CommandPath;
+		case EFtpVerifyMethod::XSha1:
+			return TEXT("XSHA1 ") + CommandPath;
+		case EFtpVerifyMethod::XMd5:
+			return TEXT("XMD5 ") + CommandPath;
+		case EFtpVerifyMethod::XCrc:
+			return TEXT("XCRC ") + CommandPath;
+		case EFtpVerifyMethod::SizeAndTime:
+			return TEXT("MDTM ") + CommandPath;
+		default:
+			return FString();
+		}
+	}
+
+	// 방법에 맞는 로컬 값과 16진수 길이
+	static FString GetLocalHashValue(EFtpVerifyMethod Method, const FString& HashAlgorithm, const FFtpLocalDigest& Digest, int32& OutHexLength)
+	{
+		const bool bSha1 = Method == EFtpVerifyMethod::XSha1 || (Method == EFtpVerifyMethod::Hash && HashAlgorithm == TEXT("SHA-1"));
+		if (bSha1)
+		{
+			OutHexLength = 40;
+			return Digest.Sha1.ToLower();
+		}
+		if (Method == EFtpVerifyMethod::XCrc)
+		{
+			OutHexLength = 8;
+			return FString::Printf(TEXT("%08x"), Digest.Crc32);
+		}
+		OutHexLength = 32;
+		return Digest.Md5.ToLower();
+	}
+
+	// MDTM 응답 "213 YYYYMMDDHHMMSS[.sss]" (UTC)
+	static bool ParseMdtm(const FString& Reply, FDateTime& OutTime)
+	{
+		TArray<FString> Tokens;
+		Reply.ParseIntoArrayWS(Tokens);
+		if (GetReplyCode(Reply) != 213 || Tokens.Num() < 2 || Tokens[1].Len() < 14)
+		{
+			return false;
+		}
+
+		const FString& Stamp = Tokens[1];
+		auto Field = [&Stamp](int32 Start, int32 Count)
+		{
+			int32 Value = 0;
+			LexFromString(Value, *Stamp.Mid(Start, Count));
+			return Value;
+		};
+
+		if (!FDateTime::Validate(Field(0, 4), Field(4, 2), Field(6, 2), Field(8, 2), Field(10, 2), Field(12, 2), 0))
+		{
+			return false;
+		}
+		OutTime = FDateTime(Field(0, 4), Field(4, 2), Field(6, 2), Field(8, 2), Field(10, 2), Field(12, 2));
+		return true;
+	}
+
+	bool ComputeLocalDigest(const FString& LocalPath, FFtpLocalDigest& OutDigest)
+	{
+		FTP_TRACE_SCOPE(HashFile);
+
+		TUniquePtr<IFileHandle> FileHandle(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*LocalPath));
+		if (!FileHandle.IsValid())
+		{
+			return false;
+		}
+
+		// 병렬 해시가 파일마다 청크를 새로 잡지 않도록 풀에서 빌린다
+		FFtpPooledBuffer Chunk = FFtpBufferPool::Acquire(1024 * 1024);
+		const int64 ChunkSize = Chunk.GetSize();
+
+		FFtpDigestBuilder Builder;
+		int64 Remaining = FileHandle->Size();
+		while (Remaining > 0)
+		{
+			const int64 ReadSize = FMath::Min(Remaining, ChunkSize);
+			if (!FileHandle->Read(Chunk.GetData(), ReadSize))
+			{
+				return false;
+			}
+			Builder.Update(Chunk.GetData(), ReadSize);
+			Remaining -= ReadSize;
+		}
+
+		OutDigest = Builder.Finalize();
+		return true;
+	}
+
+	int32 VerifyFiles(const FFtpServerProfile& Server, const TArray<FFtpVerifyRequest>& Requests, TArray<FFtpVerifyOutcome>& OutOutcomes)
+	{
+		OutOutcomes.Reset();
+		OutOutcomes.SetNum(Requests.Num());
+		for (int32 Index = 0; Index < Requests.Num(); ++Index)
+		{
+			OutOutcomes[Index].LocalPath = Requests[Index].LocalPath;
+			OutOutcomes[Index].RemotePath = Requests[Index].RemotePath;
+		}
+
+		FString HashAlgorithm;
+		const FServerCapabilities Capabilities = GetServerCapabilities(Server);
+		const EFtpVerifyMethod Method = SelectMethod(Capabilities, HashAlgorithm);
+		if (Method == EFtpVerifyMethod::None)
+		{
+			LogFtpMessage(FString::Printf(TEXT("Verify skipped: %s supports neither hash commands nor SIZE"), *Server.Name), true);
+			return 0;
+		}
+
+		// 스트리밍 중 계산된 값이 없는 파일만 로컬에서 읽는다
+		TArray<FFtpLocalDigest> Digests;
+		Digests.SetNum(Requests.Num());
+		ParallelFor(Requests.Num(), [&](int32 Index)
+		{
+			const FFtpVerifyRequest& Request = Requests[Index];
+			if (Request.Digest.bValid)
+			{
+				Digests[Index] = Request.Digest;
+			}
+			else if (Method == EFtpVerifyMethod::SizeAndTime)
+			{
+				Digests[Index].Size = IFileManager::Get().FileSize(*Request.LocalPath);
+				Digests[Index].bValid = Digests[Index].Size >= 0;
+			}
+			else
+			{
+				ComputeLocalDigest(Request.LocalPath, Digests[Index]);
+			}
+		});
+
+		// 원격 디렉토리별로 묶는다
+		TMap<FString, TArray<int32>> ByDirectory;
+		for (int32 Index = 0; Index < Requests.Num(); ++Index)
+		{
+			ByDirectory.FindOrAdd(FPaths::GetPath(Requests[Index].RemotePath)).Add(Index);
+		}
+
+		int32 FailedCount = 0;
+		for (const TPair<FString, TArray<int32>>& Directory : ByDirectory)
+		{
+			for (int32 GroupStart = 0; GroupStart < Directory.Value.Num(); GroupStart += MaxFilesPerQuery)
+			{
+				const int32 GroupEnd = FMath::Min(GroupStart + MaxFilesPerQuery, Directory.Value.Num());
+
+				TArray<FString> Commands;
+				Commands.Add(TEXT("TYPE I"));
+				if (Method == EFtpVerifyMethod::Hash)
+				{
+					Commands.Add(TEXT("OPTS HASH ") + HashAlgorithm);
+				}
+
+				// 파일마다 [SIZE, 검증 명령]
+				const int32 FirstFileCommand = Commands.Num();
+				for (int32 GroupIndex = GroupStart; GroupIndex < GroupEnd; ++GroupIndex)
+				{
+					const FString CommandPath = ToCommandPath(Requests[Directory.Value[GroupIndex]].RemotePath);
+					Commands.Add(Capabilities.bSize ? TEXT("SIZE ") + CommandPath : FString(TEXT("NOOP")));
+					Commands.Add(Method != EFtpVerifyMethod::SizeAndTime || Capabilities.bMdtm ? MakeVerifyCommand(Method, CommandPath) : FString(TEXT("NOOP")));
+				}
+
+				const double StartTime = FPlatformTime::Seconds();
+				TArray<FString> Replies;
+				const bool bQueried = RunQuoteCommands(Server, Directory.Key, Commands, Replies);
+				const double Duration = (FPlatformTime::Seconds() - StartTime) / (GroupEnd - GroupStart);
+
+				for (int32 GroupIndex = GroupStart; GroupIndex < GroupEnd; ++GroupIndex)
+				{
+					const int32 Index = Directory.Value[GroupIndex];
+					const FFtpVerifyRequest& Request = Requests[Index];
+					const FFtpLocalDigest& Digest = Digests[Index];
+					FFtpVerifyOutcome& Outcome = OutOutcomes[Index];
+					Outcome.Method = Method;
+
+					const int32 CommandIndex = FirstFileCommand + (GroupIndex - GroupStart) * 2;
+					const FString& SizeReply = Replies[CommandIndex];
+					const FString& VerifyReply = Replies[CommandIndex + 1];
+
+					if (!bQueried || !Digest.bValid)
+					{
+						Outcome.Result = EFtpVerifyResult::Unverifiable;
+					}
+					else if (GetReplyCode(SizeReply) == 550 || GetReplyCode(VerifyReply) == 550)
+					{
+						Outcome.Result = EFtpVerifyResult::Missing;
+					}
+					else if (Method == EFtpVerifyMethod::SizeAndTime)
+					{
+						int64 RemoteSize = -1;
+						TArray<FString> Tokens;
+						SizeReply.ParseIntoArrayWS(Tokens);
+						if (GetReplyCode(SizeReply) == 213 && Tokens.Num() >= 2)
+						{
+							LexFromString(RemoteSize, *Tokens[1]);
+						}
+
+						FDateTime RemoteTime = FDateTime::MinValue();
+						const bool bHasTime = ParseMdtm(VerifyReply, RemoteTime);
+						const bool bTimeOk = Request.UploadedAfter == FDateTime::MinValue()
+							|| !bHasTime
+							|| RemoteTime >= Request.UploadedAfter - FTimespan::FromSeconds(ClockSkewSeconds);
+
+						Outcome.LocalValue = FString::Printf(TEXT("%lld"), Digest.Size);
+						Outcome.RemoteValue = bHasTime ? FString::Printf(TEXT("%lld @ %s"), RemoteSize, *RemoteTime.ToString()) : FString::Printf(TEXT("%lld"), RemoteSize);
+						Outcome.Result = RemoteSize < 0 ? EFtpVerifyResult::Unverifiable
+							: (RemoteSize == Digest.Size && bTimeOk ? EFtpVerifyResult::Verified : EFtpVerifyResult::Mismatch);
+					}
+					else
+					{
+						int32 HexLength = 0;
+						Outcome.LocalValue = GetLocalHashValue(Method, HashAlgorithm, Digest, HexLength);
+						Outcome.RemoteValue = ExtractHexToken(VerifyReply, HexLength);
+
+						if (Outcome.RemoteValue.IsEmpty())
+						{
+							Outcome.Result = EFtpVerifyResult::Unverifiable;
+						}
+						else
+						{
+							Outcome.Result = Outcome.RemoteValue == Outcome.LocalValue ? EFtpVerifyResult::Verified : EFtpVerifyResult::Mismatch;
+						}
+					}
+
+					if (Outcome.Result == EFtpVerifyResult::Unverifiable)
+					{
+						LogFtpMessage(FString::Printf(TEXT("Verify inconclusive (%s): %s"), LexToString(Method), *Request.RemotePath));
+						continue;
+					}
+
+					const bool bVerified = Outcome.Result == EFtpVerifyResult::Verified;
+					if (!bVerified)
+					{
+						++FailedCount;
+						LogFtpMessage(FString::Printf(TEXT("Verify %s (%s): %s local=%s remote=%s"),
+							Outcome.Result == EFtpVerifyResult::Missing ? TEXT("missing") : TEXT("mismatch"),
+							LexToString(Method), *Request.RemotePath, *Outcome.LocalValue, *Outcome.RemoteValue), true);
+					}
+
+					FFtpTransferRecord Record;
+					Record.LocalPath = Request.LocalPath;
+					Record.RemotePath = Server.Name + TEXT(":") + Request.RemotePath;
+					Record.Bytes = Digest.Size;
+					Record.DurationSeconds = Duration;
+					Record.Timestamp = FDateTime::Now();
+					Record.Direction = EFtpTransferDirection::Verify;
+					Record.bSuccess = bVerified;
+					FFtpTransferHistory::Get().Record(Record);
+				}
+			}
+		}
+
+		return FailedCount;
+	}
+
+	FFtpSyncStats VerifyFolder(const FString& LocalPath, const FString& RemotePath, const FFtpServerProfile& Server)
+	{
+		if (!FPaths::DirectoryExists(LocalPath))
+		{
+			LogFtpMessage(FString::Printf(TEXT("Verify failed: Local path does not exist: %s"), *LocalPath), true);
+			return FFtpSyncStats::Aborted();
+		}
+
+		TArray<FString> AllFiles;
+		FPlatformFileManager::Get().GetPlatformFile().FindFilesRecursively(AllFiles, *LocalPath, TEXT(""));
+
+		TArray<FFtpVerifyRequest> Requests;
+		Requests.Reserve(AllFiles.Num());
+		for (const FString& LocalFile : AllFiles)
+		{
+			FString RelativePath = LocalFile;
+			FPaths::MakePathRelativeTo(RelativePath, *LocalPath);
+
+			FFtpVerifyRequest& Request = Requests.AddDefaulted_GetRef();
+			Request.LocalPath = LocalFile;
+			Request.RemotePath = RemotePath / RelativePath;
+		}
+
+		TArray<FFtpVerifyOutcome> Outcomes;
+		VerifyFiles(Server, Requests, Outcomes);
+
+		int32 VerifiedCount = 0;
+		int32 FailedCount = 0;
+		int32 InconclusiveCount = 0;
+		for (const FFtpVerifyOutcome& Outcome : Outcomes)
+		{
+			switch (Outcome.Result)
+			{
+			case EFtpVerifyResult::Verified:
+				++VerifiedCount;
+				break;
+			case EFtpVerifyResult::Unverifiable:
+				++InconclusiveCount;
+				break;
+			default:
+				++FailedCount;
+				break;
+			}
+		}
+
+		LogFtpMessage(FString::Printf(TEXT("Verify %s: %d verified, %d failed, %d inconclusive"), *RemotePath, VerifiedCount, FailedCount, InconclusiveCount), FailedCount > 0);
+		return FFtpSyncStats(VerifiedCount, FailedCount);
+	}
+
+	const TCHAR* LexToString(EFtpVerifyMethod Method)
+	{
+		switch (Method)
+		{
+		case EFtpVerifyMethod::Hash:
+			return TEXT("HASH");
+		case EFtpVerifyMethod::XSha1:
+			return TEXT("XSHA1");
+		case EFtpVerifyMethod::XMd5:
+			return TEXT("XMD5");
+		case EFtpVerifyMethod::XCrc:
+			return TEXT("XCRC");
+		case EFtpVerifyMethod::SizeAndTime:
+			return TEXT("SIZE+MDTM");
+		default:
+			return TEXT("None");
+		}
+	}
+}
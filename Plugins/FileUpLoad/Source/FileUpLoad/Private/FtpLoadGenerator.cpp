@@ -0,0 +1,871 @@
+#include "FtpLoadGenerator.h"
+#include "FtpServer.h"
+#include "FtpReadCache.h"
+#include "FtpSystem.h"
+#include "FtpProtocol.h"
+#include "FileUpLoadTrace.h"
+#include "Async/Async.h"
+#include "Dom/JsonObject.h"
+#include "HAL/PlatformMemory.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+#include "IPAddress.h"
+#include "String/Find.h"
+
+namespace FtpLoadGenerator
+{
+	static constexpr int32 NumCommands = (int32)EFtpLoadCommand::Count;
+
+	// 응답/데이터를 기다리는 최대 시간 - 넘으면 오류로 센다
+	static const FTimespan ReplyTimeout = FTimespan::FromSeconds(30);
+
+	// 데이터 연결 읽기 단위
+	static constexpr int32 DataChunkSize = 256 * 1024;
+
+	// 응답 한 줄의 최대 길이 - 클라이언트마다 이 두 배 남짓을 잡는다
+	static constexpr int32 MaxReplyLineLength = 512;
+
+	// 지연 비교에서 이보다 작은 차이는 잡음으로 본다
+	static constexpr double LatencyNoiseFloorMs = 1.0;
+
+	// 메모리 비교에서 이보다 작은 증가분 차이는 잡음으로 본다
+	static constexpr int64 MemoryNoiseFloorBytes = 64LL * 1024 * 1024;
+
+	/**
+	 * 로그-선형 지연 히스토그램 (마이크로초)
+	 * 64 미만은 1us 칸, 그 위는 2의 거듭제곱 구간마다 32칸이라 상대 오차가 약 3%다. 기록에 할당이 없다.
+	 */
+	struct FLatencyHistogram
+	{
+		static constexpr int32 SubBucketBits = 5;
+		static constexpr int32 SubBuckets = 1 << SubBucketBits;
+		static constexpr int32 LinearBuckets = SubBuckets * 2;
+		static constexpr int32 MaxExponent = 40;
+		static constexpr int32 NumBuckets = LinearBuckets + (MaxExponent - SubBucketBits) * SubBuckets;
+
+		uint32 Buckets[NumBuckets];
+		int64 Count = 0;
+		int64 Errors = 0;
+		uint64 MaxMicros = 0;
+
+		FLatencyHistogram()
+		{
+			FMemory::Memzero(Buckets);
+		}
+
+		static int32 GetBucket(uint64 Micros)
+		{
+			if (Micros < LinearBuckets)
+			{
+				return (int32)Micros;
+			}
+			const int32 Exponent = FMath::Min<int32>(FPlatformMath::FloorLog2_64(Micros), MaxExponent);
+			const int32 SubBucket = (int32)FMath::Min<uint64>(Micros >> (Exponent - SubBucketBits), LinearBuckets - 1) - SubBuckets;
+			return LinearBuckets + (Exponent - SubBucketBits - 1) * SubBuckets + SubBucket;
+		}
+
+		// 칸의 윗값
+		static uint64 GetBucketValue(int32 Bucket)
+		{
+			if (Bucket < LinearBuckets)
+			{
+				return Bucket;
+			}
+			const int32 Exponent = SubBucketBits + 1 + (Bucket - LinearBuckets) / SubBuckets;
+			const uint64 SubBucket = SubBuckets + (Bucket - LinearBuckets) % SubBuckets;
+			return ((SubBucket + 1) << (Exponent - SubBucketBits)) - 1;
+		}
+
+		void Record(uint64 Micros)
+		{
+			Buckets[GetBucket(Micros)]++;
+			Count++;
+			MaxMicros = FMath::Max(MaxMicros, Micros);
+		}
+
+		void Merge(const FLatencyHistogram& Other)
+		{
+			for (int32 Bucket = 0; Bucket < NumBuckets; ++Bucket)
+			{
+				Buckets[Bucket] += Other.Buckets[Bucket];
+			}
+			Count += Other.Count;
+			Errors += Other.Errors;
+			MaxMicros = FMath::Max(MaxMicros, Other.MaxMicros);
+		}
+
+		double GetPercentileMs(double Fraction) const
+		{
+			if (Count == 0)
+			{
+				return 0.0;
+			}
+			const int64 Target = FMath::Max<int64>(1, (int64)FMath::CeilToDouble(Fraction * Count));
+			int64 Seen = 0;
+			for (int32 Bucket = 0; Bucket < NumBuckets; ++Bucket)
+			{
+				Seen += Buckets[Bucket];
+				if (Seen >= Target)
+				{
+					return FMath::Min(GetBucketValue(Bucket), MaxMicros) / 1000.0;
+				}
+			}
+			return MaxMicros / 1000.0;
+		}
+	};
+
+	// 제어 연결 하나 - 한 워커 스레드만 쓴다
+	struct FLoadClient
+	{
+		FSocket* Control = nullptr;
+		FFtpLineReader Reader{ MaxReplyLineLength };
+		FFtpReplyParser Parser;
+		double NextDue = 0.0;
+		int32 Index = 0;
+		uint32 StorCounter = 0;
+	};
+
+	struct FWorker
+	{
+		FLatencyHistogram Histograms[NumCommands];
+		TArray<FLoadClient> Clients;
+		TArray<uint8> DataBuffer;
+		// 명령 줄 조립 버퍼 - 작업마다 재사용
+		FFtpMessageWriter Writer{ 256 };
+		FRandomStream Random;
+		int64 Operations = 0;
+		int64 BytesTransferred = 0;
+		int32 ConnectedClients = 0;
+		// 지금 작업이 예정 시각보다 늦게 시작한 만큼 - 그 작업의 첫 측정에 더한다
+		uint64 PendingLagMicros = 0;
+	};
+
+	// 모든 워커가 읽기만 하는 준비된 값들
+	struct FLoadShared
+	{
+		const FFtpLoadConfig* Config = nullptr;
+		TSharedPtr<FInternetAddr> ServerAddr;
+		FFtpMessageWriter UserLine;
+		FFtpMessageWriter PassLine;
+		TArray<uint8> Payload;
+		float Weights[NumCommands] = {};
+		float TotalWeight = 0.0f;
+		double EndTime = 0.0;
+	};
+
+	static ISocketSubsystem* GetSocketSubsystem()
+	{
+		return ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	}
+
+	static void DestroySocket(FSocket*& Socket)
+	{
+		if (Socket != nullptr)
+		{
+			Socket->Close();
+			GetSocketSubsystem()->DestroySocket(Socket);
+			Socket = nullptr;
+		}
+	}
+
+	static uint64 ElapsedMicros(uint64 StartCycles)
+	{
+		return (uint64)(FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles) * 1000000.0);
+	}
+
+	static FSocket* ConnectSocket(const FInternetAddr& Addr, int32 Port, const TCHAR* Description)
+	{
+		TSharedRef<FInternetAddr> Target = Addr.Clone();
+		Target->SetPort(Port);
+
+		FSocket* Socket = GetSocketSubsystem()->CreateSocket(NAME_Stream, Description, Target->GetProtocolType());
+		if (Socket == nullptr)
+		{
+			return nullptr;
+		}
+		Socket->SetNoDelay(true);
+		if (!Socket->Connect(*Target))
+		{
+			DestroySocket(Socket);
+		}
+		return Socket;
+	}
+
+	static bool SendAll(FSocket* Socket, const uint8* Data, int64 Length)
+	{
+		while (Length > 0)
+		{
+			int32 BytesSent = 0;
+			if (!Socket->Send(Data, (int32)FMath::Min<int64>(Length, MAX_int32), BytesSent) || BytesSent <= 0)
+			{
+				return false;
+			}
+			Data += BytesSent;
+			Length -= BytesSent;
+		}
+		return true;
+	}
+
+	static bool SendCommand(FLoadClient& Client, FAnsiStringView Line)
+	{
+		return SendAll(Client.Control, (const uint8*)Line.GetData(), Line.Len());
+	}
+
+	// 응답 하나를 끝까지 읽는다 - OutText는 다음 수신 전까지만 유효하다
+	static bool ReadReply(FLoadClient& Client, int32& OutCode, FAnsiStringView& OutText)
+	{
+		while (true)
+		{
+			FAnsiStringView Line;
+			const EFtpLineResult LineResult = Client.Reader.NextLine(Line);
+			if (LineResult == EFtpLineResult::Line)
+			{
+				const EFtpReplyResult ReplyResult = Client.Parser.Feed(Line);
+				if (ReplyResult == EFtpReplyResult::Complete)
+				{
+					OutCode = Client.Parser.GetCode();
+					OutText = Client.Parser.GetText();
+					return true;
+				}
+				if (ReplyResult == EFtpReplyResult::Malformed)
+				{
+					return false;
+				}
+				continue;
+			}
+			if (LineResult == EFtpLineResult::Overflow)
+			{
+				return false;
+			}
+
+			if (!Client.Control->Wait(ESocketWaitConditions::WaitForRead, ReplyTimeout))
+			{
+				return false;
+			}
+
+			int32 Capacity = 0;
+			uint8* Dest = Client.Reader.GetWriteBuffer(Capacity);
+			int32 BytesRead = 0;
+			if (!Client.Control->Recv(Dest, Capacity, BytesRead) || BytesRead <= 0)
+			{
+				return false;
+			}
+			Client.Reader.CommitWrite(BytesRead);
+		}
+	}
+
+	static bool ExpectReply(FLoadClient& Client, int32 ExpectedCode)
+	{
+		int32 Code = 0;
+		FAnsiStringView Text;
+		return ReadReply(Client, Code, Text) && Code == ExpectedCode;
+	}
+
+	static void Disconnect(FLoadClient& Client)
+	{
+		DestroySocket(Client.Control);
+		Client.Reader.Reset();
+		Client.Parser.Reset();
+	}
+
+	static void RecordResult(FWorker& Worker, EFtpLoadCommand Command, bool bSuccess, uint64 StartCycles)
+	{
+		FLatencyHistogram& Histogram = Worker.Histograms[(int32)Command];
+		if (bSuccess)
+		{
+			Histogram.Record(ElapsedMicros(StartCycles) + Worker.PendingLagMicros);
+		}
+		else
+		{
+			Histogram.Errors++;
+		}
+		Worker.PendingLagMicros = 0;
+	}
+
+	// 접속 + 220 인사, 이어서 USER/PASS
+	static bool ConnectAndLogin(FWorker& Worker, FLoadClient& Client, const FLoadShared& Shared)
+	{
+		FTP_TRACE_SCOPE(LoadConnectLogin);
+
+		Disconnect(Client);
+
+		uint64 StartCycles = FPlatformTime::Cycles64();
+		Client.Control = ConnectSocket(*Shared.ServerAddr, Shared.Config->Port, TEXT("FtpLoadControl"));
+		const bool bConnected = Client.Control != nullptr && ExpectReply(Client, 220);
+		RecordResult(Worker, EFtpLoadCommand::Connect, bConnected, StartCycles);
+		if (!bConnected)
+		{
+			Disconnect(Client);
+			return false;
+		}
+
+		StartCycles = FPlatformTime::Cycles64();
+		const bool bLoggedIn = SendCommand(Client, Shared.UserLine.GetView()) && ExpectReply(Client, 331)
+			&& SendCommand(Client, Shared.PassLine.GetView()) && ExpectReply(Client, 230);
+		RecordResult(Worker, EFtpLoadCommand::Login, bLoggedIn, StartCycles);
+		if (!bLoggedIn)
+		{
+			Disconnect(Client);
+		}
+		return bLoggedIn;
+	}
+
+	// "229 Entering Extended Passive Mode (|||port|)"
+	static bool OpenPassive(FWorker& Worker, FLoadClient& Client, int32& OutPort)
+	{
+		FTP_TRACE_SCOPE(LoadPasv);
+
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+
+		int32 Code = 0;
+		FAnsiStringView Text;
+		bool bSuccess = SendCommand(Client, "EPSV\r\n") && ReadReply(Client, Code, Text) && Code == 229;
+		if (bSuccess)
+		{
+			// "(|||" 뒤 숫자부터 다음 '|'까지
+			int64 Port = 0;
+			const int32 PortStart = UE::String::FindFirst(Text, "(|||");
+			if (PortStart != INDEX_NONE)
+			{
+				FAnsiStringView PortText = Text.RightChop(PortStart + 4);
+				int32 PortEnd = INDEX_NONE;
+				PortText.FindChar('|', PortEnd);
+				FtpProtocol::ParseInt64(PortEnd != INDEX_NONE ? PortText.Left(PortEnd) : PortText, Port);
+			}
+			OutPort = (int32)FMath::Clamp<int64>(Port, 0, 65535);
+			bSuccess = OutPort > 0;
+		}
+		RecordResult(Worker, EFtpLoadCommand::Epsv, bSuccess, StartCycles);
+		return bSuccess;
+	}
+
+	// 데이터 연결을 쓰는 명령 - 명령을 보낸 때부터 226까지를 잰다
+	static bool RunTransfer(FWorker& Worker, FLoadClient& Client, const FLoadShared& Shared, EFtpLoadCommand Command, FAnsiStringView Line, int64 UploadBytes)
+	{
+		int32 DataPort = 0;
+		if (!OpenPassive(Worker, Client, DataPort))
+		{
+			return false;
+		}
+
+		FSocket* DataSocket = ConnectSocket(*Shared.ServerAddr, DataPort, TEXT("FtpLoadData"));
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		bool bSuccess = DataSocket != nullptr && SendCommand(Client, Line) && ExpectReply(Client, 150);
+
+		if (bSuccess && UploadBytes > 0)
+		{
+			bSuccess = SendAll(DataSocket, Shared.Payload.GetData(), UploadBytes);
+			Worker.BytesTransferred += bSuccess ? UploadBytes : 0;
+		}
+		else if (bSuccess)
+		{
+			// 상대가 데이터 연결을 닫을 때까지 읽는다
+			while (true)
+			{
+				if (!DataSocket->Wait(ESocketWaitConditions::WaitForRead, ReplyTimeout))
+				{
+					bSuccess = false;
+					break;
+				}
+				int32 BytesRead = 0;
+				if (!DataSocket->Recv(Worker.DataBuffer.GetData(), Worker.DataBuffer.Num(), BytesRead) || BytesRead <= 0)
+				{
+					break;
+				}
+				Worker.BytesTransferred += BytesRead;
+			}
+		}
+		DestroySocket(DataSocket);
+
+		bSuccess = bSuccess && ExpectReply(Client, 226);
+		RecordResult(Worker, Command, bSuccess, StartCycles);
+		return bSuccess;
+	}
+
+	static bool RunSize(FWorker& Worker, FLoadClient& Client, FAnsiStringView Line)
+	{
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		const bool bSuccess = SendCommand(Client, Line) && ExpectReply(Client, 213);
+		RecordResult(Worker, EFtpLoadCommand::Size, bSuccess, StartCycles);
+		return bSuccess;
+	}
+
+	static EFtpLoadCommand PickCommand(FWorker& Worker, const FLoadShared& Shared)
+	{
+		float Roll = Worker.Random.FRand() * Shared.TotalWeight;
+		for (int32 Command = 0; Command < NumCommands; ++Command)
+		{
+			if (Shared.Weights[Command] <= 0.0f)
+			{
+				continue;
+			}
+			Roll -= Shared.Weights[Command];
+			if (Roll <= 0.0f)
+			{
+				return (EFtpLoadCommand)Command;
+			}
+		}
+		return EFtpLoadCommand::Size;
+	}
+
+	// 작업 하나 - 실패하면 연결 상태를 알 수 없으니 끊고 다음 작업에서 다시 붙는다
+	static void RunOperation(FWorker& Worker, FLoadClient& Client, const FLoadShared& Shared)
+	{
+		const FFtpLoadConfig& Config = *Shared.Config;
+		if (Client.Control == nullptr && !ConnectAndLogin(Worker, Client, Shared))
+		{
+			return;
+		}
+
+		FFtpMessageWriter& Line = Worker.Writer.Reset();
+		bool bSuccess = true;
+		const int32 FileIndex = Worker.Random.RandHelper(FMath::Max(Config.NumFiles, 1));
+
+		switch (PickCommand(Worker, Shared))
+		{
+		case EFtpLoadCommand::Login:
+		{
+			SendCommand(Client, "QUIT\r\n");
+			ExpectReply(Client, 221);
+			bSuccess = ConnectAndLogin(Worker, Client, Shared);
+			break;
+		}
+		case EFtpLoadCommand::List:
+			Line.BeginCommand(EFtpCommand::List).AppendArgument("load").EndLine();
+			bSuccess = RunTransfer(Worker, Client, Shared, EFtpLoadCommand::List, Line.GetView(), 0);
+			break;
+		case EFtpLoadCommand::Retr:
+			Line.BeginCommand(EFtpCommand::Retr).AppendArgument("load/file_").AppendInt(FileIndex, 4).Append(".bin").EndLine();
+			bSuccess = RunTransfer(Worker, Client, Shared, EFtpLoadCommand::Retr, Line.GetView(), 0);
+			break;
+		case EFtpLoadCommand::Stor:
+			// 클라이언트마다 몇 개 이름만 돌려 써서 디스크 사용량이 늘지 않게 한다
+			Line.BeginCommand(EFtpCommand::Stor).AppendArgument("load/stor_").AppendInt(Client.Index).Append('_').AppendInt(Client.StorCounter++ % 4).Append(".bin").EndLine();
+			bSuccess = RunTransfer(Worker, Client, Shared, EFtpLoadCommand::Stor, Line.GetView(), Config.StorBytes);
+			break;
+		default:
+			Line.BeginCommand(EFtpCommand::Size).AppendArgument("load/file_").AppendInt(FileIndex, 4).Append(".bin").EndLine();
+			bSuccess = RunSize(Worker, Client, Line.GetView());
+			break;
+		}
+
+		Worker.Operations++;
+		if (!bSuccess)
+		{
+			Disconnect(Client);
+		}
+	}
+
+	static void RunWorker(FWorker& Worker, const FLoadShared& Shared)
+	{
+		const FFtpLoadConfig& Config = *Shared.Config;
+
+		if (Worker.Clients.Num() == 0)
+		{
+			return;
+		}
+
+		// 먼저 모든 세션을 붙인다
+		for (FLoadClient& Client : Worker.Clients)
+		{
+			Worker.ConnectedClients += ConnectAndLogin(Worker, Client, Shared) ? 1 : 0;
+			Client.NextDue = FPlatformTime::Seconds() + Config.ThinkTimeSeconds * Worker.Random.FRand();
+		}
+
+		while (true)
+		{
+			// 예정 시각이 가장 이른 클라이언트 - 앞 클라이언트를 기다리느라 늦은 것을 먼저 처리한다
+			FLoadClient* Client = &Worker.Clients[0];
+			for (FLoadClient& Candidate : Worker.Clients)
+			{
+				if (Candidate.NextDue < Client->NextDue)
+				{
+					Client = &Candidate;
+				}
+			}
+
+			if (Client->NextDue >= Shared.EndTime)
+			{
+				break;
+			}
+
+			double Now = FPlatformTime::Seconds();
+			if (Now >= Shared.EndTime)
+			{
+				break;
+			}
+			if (Client->NextDue > Now)
+			{
+				FPlatformProcess::SleepNoStats((float)(Client->NextDue - Now));
+				Now = FPlatformTime::Seconds();
+			}
+
+			// 예정보다 늦게 보낸 만큼은 서버 지연에 포함한다 - 빼면 느려질수록 측정 수가 줄고 값은 좋아 보인다
+			Worker.PendingLagMicros = (uint64)(FMath::Max(Now - Client->NextDue, 0.0) * 1000000.0);
+			RunOperation(Worker, *Client, Shared);
+			Worker.PendingLagMicros = 0;
+
+			Client->NextDue += Config.ThinkTimeSeconds * (0.5 + Worker.Random.FRand());
+		}
+
+		for (FLoadClient& Client : Worker.Clients)
+		{
+			if (Client.Control != nullptr)
+			{
+				SendCommand(Client, "QUIT\r\n");
+			}
+			Disconnect(Client);
+		}
+	}
+
+	static void MakeLine(FFtpMessageWriter& Writer, EFtpCommand Command, const FString& Argument)
+	{
+		Writer.Reset().BeginCommand(Command).Append(' ').AppendUtf8(Argument).EndLine();
+	}
+
+	// 준비 - RETR/SIZE 대상 파일을 한 세션으로 올려 둔다
+	static bool PrepareFiles(const FLoadShared& Shared)
+	{
+		const FFtpLoadConfig& Config = *Shared.Config;
+		TUniquePtr<FWorker> Worker = MakeUnique<FWorker>();
+		Worker->DataBuffer.SetNumUninitialized(DataChunkSize);
+		FLoadClient Client;
+		if (!ConnectAndLogin(*Worker, Client, Shared))
+		{
+			LogFtpMessage(FString::Printf(TEXT("Load test cannot log in to %s:%d as %s"), *Config.Host, Config.Port, *Config.User), true);
+			return false;
+		}
+
+		// 이미 있으면 550이므로 응답 코드는 보지 않는다
+		SendCommand(Client, "MKD load\r\n");
+		int32 Code = 0;
+		FAnsiStringView Text;
+		ReadReply(Client, Code, Text);
+
+		bool bSuccess = true;
+		for (int32 FileIndex = 0; FileIndex < Config.NumFiles && bSuccess; ++FileIndex)
+		{
+			FFtpMessageWriter& Line = Worker->Writer.Reset();
+			Line.BeginCommand(EFtpCommand::Stor).AppendArgument("load/file_").AppendInt(FileIndex, 4).Append(".bin").EndLine();
+			bSuccess = RunTransfer(*Worker, Client, Shared, EFtpLoadCommand::Stor, Line.GetView(), Config.FileBytes);
+		}
+		Disconnect(Client);
+
+		if (!bSuccess)
+		{
+			LogFtpMessage(TEXT("Load test cannot upload its test files"), true);
+		}
+		return bSuccess;
+	}
+
+	bool Run(const FFtpLoadConfig& Config, const FFtpServer* Server, FFtpLoadResult& OutResult)
+	{
+		OutResult = FFtpLoadResult();
+		OutResult.Clients = Config.Clients;
+
+		FLoadShared Shared;
+		Shared.Config = &Config;
+		Shared.ServerAddr = GetSocketSubsystem()->CreateInternetAddr();
+		bool bValidAddress = false;
+		Shared.ServerAddr->SetIp(*Config.Host, bValidAddress);
+		if (!bValidAddress)
+		{
+			LogFtpMessage(FString::Printf(TEXT("Load test host is not an IP address: %s"), *Config.Host), true);
+			return false;
+		}
+
+		MakeLine(Shared.UserLine, EFtpCommand::User, Config.User);
+		MakeLine(Shared.PassLine, EFtpCommand::Pass, Config.Password);
+		Shared.Payload.SetNumUninitialized(FMath::Max(Config.FileBytes, Config.StorBytes));
+		for (int32 Index = 0; Index < Shared.Payload.Num(); ++Index)
+		{
+			Shared.Payload[Index] = (uint8)(Index * 31 + 7);
+		}
+		Shared.Weights[(int32)EFtpLoadCommand::Login] = FMath::Max(Config.LoginWeight, 0.0f);
+		Shared.Weights[(int32)EFtpLoadCommand::List] = FMath::Max(Config.ListWeight, 0.0f);
+		Shared.Weights[(int32)EFtpLoadCommand::Stor] = FMath::Max(Config.StorWeight, 0.0f);
+		Shared.Weights[(int32)EFtpLoadCommand::Retr] = FMath::Max(Config.RetrWeight, 0.0f);
+		Shared.Weights[(int32)EFtpLoadCommand::Size] = FMath::Max(Config.SizeWeight, 0.0f);
+		for (float Weight : Shared.Weights)
+		{
+			Shared.TotalWeight += Weight;
+		}
+		if (Shared.TotalWeight <= 0.0f)
+		{
+			LogFtpMessage(TEXT("Load test mix has no positive weights"), true);
+			return false;
+		}
+
+		if (!PrepareFiles(Shared))
+		{
+			return false;
+		}
+
+		// 워커마다 클라이언트를 고르게 나눈다
+		const int32 NumWorkers = FMath::Clamp(Config.Workers, 1, FMath::Max(Config.Clients, 1));
+		TArray<TUniquePtr<FWorker>> Workers;
+		for (int32 WorkerIndex = 0; WorkerIndex < NumWorkers; ++WorkerIndex)
+		{
+			TUniquePtr<FWorker>& Worker = Workers.Add_GetRef(MakeUnique<FWorker>());
+			Worker->Random.Initialize(WorkerIndex * 7919 + 1);
+			Worker->DataBuffer.SetNumUninitialized(DataChunkSize);
+		}
+		for (int32 ClientIndex = 0; ClientIndex < Config.Clients; ++ClientIndex)
+		{
+			FLoadClient& Client = Workers[ClientIndex % NumWorkers]->Clients.AddDefaulted_GetRef();
+			Client.Index = ClientIndex;
+		}
+
+		OutResult.BaseUsedPhysical = (int64)FPlatformMemory::GetStats().UsedPhysical;
+		OutResult.PeakUsedPhysical = OutResult.BaseUsedPhysical;
+		const double StartTime = FPlatformTime::Seconds();
+		Shared.EndTime = StartTime + Config.DurationSeconds;
+
+		LogFtpMessage(FString::Printf(TEXT("Load test: %d clients on %d workers against %s:%d for %.0f s"), Config.Clients, NumWorkers, *Config.Host, Config.Port, Config.DurationSeconds));
+
+		TArray<TFuture<void>> Futures;
+		for (TUniquePtr<FWorker>& Worker : Workers)
+		{
+			FWorker* WorkerPtr = Worker.Get();
+			Futures.Add(Async(EAsyncExecution::Thread, [WorkerPtr, &Shared]()
+			{
+				RunWorker(*WorkerPtr, Shared);
+			}));
+		}
+
+		// 끝날 때까지 서버 쪽 값을 표본으로 잰다
+		bool bAllDone = false;
+		while (!bAllDone)
+		{
+			OutResult.PeakUsedPhysical = FMath::Max<int64>(OutResult.PeakUsedPhysical, (int64)FPlatformMemory::GetStats().UsedPhysical);
+			if (Server != nullptr)
+			{
+				OutResult.PeakSessions = FMath::Max(OutResult.PeakSessions, Server->GetNumSessions());
+				OutResult.CacheBytes = FMath::Max(OutResult.CacheBytes, Server->GetReadCache().GetCachedBytes());
+			}
+
+			bAllDone = true;
+			for (const TFuture<void>& Future : Futures)
+			{
+				bAllDone &= Future.IsReady();
+			}
+			if (!bAllDone)
+			{
+				FPlatformProcess::Sleep(0.1f);
+			}
+		}
+		OutResult.Seconds = FPlatformTime::Seconds() - StartTime;
+
+		// 합치기
+		TUniquePtr<FLatencyHistogram[]> Totals = MakeUnique<FLatencyHistogram[]>(NumCommands);
+		int64 BytesTransferred = 0;
+		for (const TUniquePtr<FWorker>& Worker : Workers)
+		{
+			for (int32 Command = 0; Command < NumCommands; ++Command)
+			{
+				Totals[Command].Merge(Worker->Histograms[Command]);
+			}
+			OutResult.Operations += Worker->Operations;
+			OutResult.ConnectedClients += Worker->ConnectedClients;
+			BytesTransferred += Worker->BytesTransferred;
+		}
+
+		int64 TotalSamples = 0;
+		int64 TotalErrors = 0;
+		for (int32 Command = 0; Command < NumCommands; ++Command)
+		{
+			const FLatencyHistogram& Histogram = Totals[Command];
+			FFtpLoadCommandResult& CommandResult = OutResult.Commands.AddDefaulted_GetRef();
+			CommandResult.Command = LexToString((EFtpLoadCommand)Command);
+			CommandResult.Count = Histogram.Count;
+			CommandResult.Errors = Histogram.Errors;
+			CommandResult.P50Ms = Histogram.GetPercentileMs(0.50);
+			CommandResult.P99Ms = Histogram.GetPercentileMs(0.99);
+			CommandResult.P999Ms = Histogram.GetPercentileMs(0.999);
+			CommandResult.MaxMs = Histogram.MaxMicros / 1000.0;
+			TotalSamples += Histogram.Count + Histogram.Errors;
+			TotalErrors += Histogram.Errors;
+		}
+
+		OutResult.OperationsPerSecond = OutResult.Seconds > 0.0 ? OutResult.Operations / OutResult.Seconds : 0.0;
+		OutResult.MegabytesPerSecond = OutResult.Seconds > 0.0 ? BytesTransferred / (1024.0 * 1024.0) / OutResult.Seconds : 0.0;
+		OutResult.ErrorRate = TotalSamples > 0 ? (double)TotalErrors / TotalSamples : 0.0;
+		return true;
+	}
+
+	bool SaveResult(const FFtpLoadResult& Result, const FString& FilePath)
+	{
+		TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+		Root->SetNumberField(TEXT("Clients"), Result.Clients);
+		Root->SetNumberField(TEXT("ConnectedClients"), Result.ConnectedClients);
+		Root->SetNumberField(TEXT("Seconds"), Result.Seconds);
+		Root->SetNumberField(TEXT("Operations"), (double)Result.Operations);
+		Root->SetNumberField(TEXT("OperationsPerSecond"), Result.OperationsPerSecond);
+		Root->SetNumberField(TEXT("MegabytesPerSecond"), Result.MegabytesPerSecond);
+		Root->SetNumberField(TEXT("ErrorRate"), Result.ErrorRate);
+		Root->SetNumberField(TEXT("BaseUsedPhysical"), (double)Result.BaseUsedPhysical);
+		Root->SetNumberField(TEXT("PeakUsedPhysical"), (double)Result.PeakUsedPhysical);
+		Root->SetNumberField(TEXT("PeakSessions"), Result.PeakSessions);
+		Root->SetNumberField(TEXT("CacheBytes"), (double)Result.CacheBytes);
+
+		TArray<TSharedPtr<FJsonValue>> Commands;
+		for (const FFtpLoadCommandResult& Command : Result.Commands)
+		{
+			TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+			Object->SetStringField(TEXT("Command"), Command.Command);
+			Object->SetNumberField(TEXT("Count"), (double)Command.Count);
+			Object->SetNumberField(TEXT("Errors"), (double)Command.Errors);
+			Object->SetNumberField(TEXT("P50Ms"), Command.P50Ms);
+			Object->SetNumberField(TEXT("P99Ms"), Command.P99Ms);
+			Object->SetNumberField(TEXT("P999Ms"), Command.P999Ms);
+			Object->SetNumberField(TEXT("MaxMs"), Command.MaxMs);
+			Commands.Add(MakeShared<FJsonValueObject>(Object));
+		}
+		Root->SetArrayField(TEXT("Commands"), Commands);
+
+		FString JsonText;
+		TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JsonText);
+		if (!FJsonSerializer::Serialize(Root, Writer) || !FFileHelper::SaveStringToFile(JsonText, *FilePath))
+		{
+			LogFtpMessage(FString::Printf(TEXT("Cannot write load test result %s"), *FilePath), true);
+			return false;
+		}
+		return true;
+	}
+
+	bool LoadResult(const FString& FilePath, FFtpLoadResult& OutResult)
+	{
+		FString JsonText;
+		TSharedPtr<FJsonObject> Root;
+		if (!FFileHelper::LoadFileToString(JsonText, *FilePath) || !FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(JsonText), Root) || !Root.IsValid())
+		{
+			LogFtpMessage(FString::Printf(TEXT("Cannot read load test baseline %s"), *FilePath), true);
+			return false;
+		}
+
+		OutResult = FFtpLoadResult();
+		OutResult.Clients = (int32)Root->GetNumberField(TEXT("Clients"));
+		OutResult.ConnectedClients = (int32)Root->GetNumberField(TEXT("ConnectedClients"));
+		OutResult.Seconds = Root->GetNumberField(TEXT("Seconds"));
+		OutResult.Operations = (int64)Root->GetNumberField(TEXT("Operations"));
+		OutResult.OperationsPerSecond = Root->GetNumberField(TEXT("OperationsPerSecond"));
+		OutResult.MegabytesPerSecond = Root->GetNumberField(TEXT("MegabytesPerSecond"));
+		OutResult.ErrorRate = Root->GetNumberField(TEXT("ErrorRate"));
+		OutResult.BaseUsedPhysical = (int64)Root->GetNumberField(TEXT("BaseUsedPhysical"));
+		OutResult.PeakUsedPhysical = (int64)Root->GetNumberField(TEXT("PeakUsedPhysical"));
+		OutResult.PeakSessions = (int32)Root->GetNumberField(TEXT("PeakSessions"));
+		OutResult.CacheBytes = (int64)Root->GetNumberField(TEXT("CacheBytes"));
+
+		const TArray<TSharedPtr<FJsonValue>>* Commands = nullptr;
+		if (Root->TryGetArrayField(TEXT("Commands"), Commands))
+		{
+			for (const TSharedPtr<FJsonValue>& Value : *Commands)
+			{
+				const TSharedPtr<FJsonObject>* Object = nullptr;
+				if (!Value.IsValid() || !Value->TryGetObject(Object))
+				{
+					continue;
+				}
+				FFtpLoadCommandResult& Command = OutResult.Commands.AddDefaulted_GetRef();
+				Command.Command = (*Object)->GetStringField(TEXT("Command"));
+				Command.Count = (int64)(*Object)->GetNumberField(TEXT("Count"));
+				Command.Errors = (int64)(*Object)->GetNumberField(TEXT("Errors"));
+				Command.P50Ms = (*Object)->GetNumberField(TEXT("P50Ms"));
+				Command.P99Ms = (*Object)->GetNumberField(TEXT("P99Ms"));
+				Command.P999Ms = (*Object)->GetNumberField(TEXT("P999Ms"));
+				Command.MaxMs = (*Object)->GetNumberField(TEXT("MaxMs"));
+			}
+		}
+		return true;
+	}
+
+	bool CompareWithBaseline(const FFtpLoadResult& Result, const FFtpLoadResult& Baseline, double Tolerance, TArray<FString>& OutRegressions)
+	{
+		OutRegressions.Reset();
+
+		auto CheckLatency = [&OutRegressions, Tolerance](const FString& Command, const TCHAR* Name, double Value, double BaselineValue)
+		{
+			if (Value > BaselineValue * (1.0 + Tolerance) && Value - BaselineValue > LatencyNoiseFloorMs)
+			{
+				OutRegressions.Add(FString::Printf(TEXT("%s %s %.2f ms (baseline %.2f ms)"), *Command, Name, Value, BaselineValue));
+			}
+		};
+
+		for (const FFtpLoadCommandResult& BaselineCommand : Baseline.Commands)
+		{
+			const FFtpLoadCommandResult* Command = Result.Commands.FindByPredicate([&BaselineCommand](const FFtpLoadCommandResult& Candidate)
+			{
+				return Candidate.Command == BaselineCommand.Command;
+			});
+			if (Command == nullptr || BaselineCommand.Count == 0)
+			{
+				continue;
+			}
+			CheckLatency(Command->Command, TEXT("p50"), Command->P50Ms, BaselineCommand.P50Ms);
+			CheckLatency(Command->Command, TEXT("p99"), Command->P99Ms, BaselineCommand.P99Ms);
+		}
+
+		if (Result.OperationsPerSecond < Baseline.OperationsPerSecond * (1.0 - Tolerance))
+		{
+			OutRegressions.Add(FString::Printf(TEXT("throughput %.0f ops/s (baseline %.0f ops/s)"), Result.OperationsPerSecond, Baseline.OperationsPerSecond));
+		}
+
+		// 오류율은 절대값 1%p까지 허용
+		if (Result.ErrorRate > Baseline.ErrorRate + 0.01)
+		{
+			OutRegressions.Add(FString::Printf(TEXT("error rate %.2f%% (baseline %.2f%%)"), Result.ErrorRate * 100.0, Baseline.ErrorRate * 100.0));
+		}
+
+		const int64 Growth = Result.PeakUsedPhysical - Result.BaseUsedPhysical;
+		const int64 BaselineGrowth = Baseline.PeakUsedPhysical - Baseline.BaseUsedPhysical;
+		if (Growth > BaselineGrowth * (1.0 + Tolerance) && Growth - BaselineGrowth > MemoryNoiseFloorBytes)
+		{
+			OutRegressions.Add(FString::Printf(TEXT("memory growth %.1f MB (baseline %.1f MB)"), Growth / (1024.0 * 1024.0), BaselineGrowth / (1024.0 * 1024.0)));
+		}
+
+		return OutRegressions.Num() == 0;
+	}
+
+	FString DescribeResult(const FFtpLoadResult& Result)
+	{
+		FString Text = FString::Printf(TEXT("%d/%d clients, %lld ops in %.1f s (%.0f ops/s, %.1f MB/s), errors %.2f%%, peak %d sessions, memory +%.1f MB, cache %.1f MB"),
+			Result.ConnectedClients, Result.Clients, Result.Operations, Result.Seconds, Result.OperationsPerSecond, Result.MegabytesPerSecond,
+			Result.ErrorRate * 100.0, Result.PeakSessions, (Result.PeakUsedPhysical - Result.BaseUsedPhysical) / (1024.0 * 1024.0), Result.CacheBytes / (1024.0 * 1024.0));
+		for (const FFtpLoadCommandResult& Command : Result.Commands)
+		{
+			Text += FString::Printf(TEXT("\n  %-8s n=%-8lld err=%-6lld p50=%8.2f ms  p99=%8.2f ms  p999=%8.2f ms  max=%8.2f ms"),
+				*Command.Command, Command.Count, Command.Errors, Command.P50Ms, Command.P99Ms, Command.P999Ms, Command.MaxMs);
+		}
+		return Text;
+	}
+
+	const TCHAR* LexToString(EFtpLoadCommand Command)
+	{
+		switch (Command)
+		{
+		case EFtpLoadCommand::Connect:
+			return TEXT("Connect");
+		case EFtpLoadCommand::Login:
+			return TEXT("Login");
+		case EFtpLoadCommand::Epsv:
+			return TEXT("EPSV");
+		case EFtpLoadCommand::List:
+			return TEXT("LIST");
+		case EFtpLoadCommand::Retr:
+			return TEXT("RETR");
+		case EFtpLoadCommand::Stor:
+			return TEXT("STOR");
+		case EFtpLoadCommand::Size:
+			return TEXT("SIZE");
+		default:
+			return TEXT("Unknown");
+		}
+	}
+}
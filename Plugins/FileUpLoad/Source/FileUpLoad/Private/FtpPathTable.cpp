@@ -0,0 +1,224 @@
+#include "FtpPathTable.h"
+#include "FileUpLoadTrace.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/Crc.h"
+#include "Misc/PathViews.h"
+
+FFtpPathTable::FFtpPathTable(const FString& InRoot)
+	: Root(InRoot)
+{
+	// 루트 구분자는 조립할 때 한 번만 붙인다
+	while (Root.Len() > 1 && (Root.EndsWith(TEXT("/")) || Root.EndsWith(TEXT("\\"))))
+	{
+		Root.LeftChopInline(1);
+	}
+	Empty();
+}
+
+void FFtpPathTable::Empty()
+{
+	Names.Reset();
+	Files.Reset();
+	DirLookup.Reset();
+	Dirs.Reset();
+	Dirs.AddDefaulted();
+}
+
+int32 FFtpPathTable::AddName(FStringView Name)
+{
+	const int32 Offset = Names.Num();
+	Names.Append(Name.GetData(), Name.Len());
+	return Offset;
+}
+
+uint64 FFtpPathTable::MakeDirKey(int32 Parent, FStringView Name)
+{
+	return ((uint64)(uint32)Parent << 32) | FCrc::MemCrc32(Name.GetData(), Name.Len() * sizeof(TCHAR));
+}
+
+int32 FFtpPathTable::FindOrAddDirectory(int32 Parent, FStringView Name)
+{
+	const uint64 Key = MakeDirKey(Parent, Name);
+	int32* Head = DirLookup.Find(Key);
+	for (int32 Index = Head ? *Head : INDEX_NONE; Index != INDEX_NONE; Index = Dirs[Index].NextSameKey)
+	{
+		const FDirNode& Node = Dirs[Index];
+		if (Node.Parent == Parent && GetName(Node.NameOffset, Node.NameLength).Equals(Name, ESearchCase::CaseSensitive))
+		{
+			return Index;
+		}
+	}
+
+	const int32 NewIndex = Dirs.Num();
+	FDirNode& Node = Dirs.AddDefaulted_GetRef();
+	Node.Parent = Parent;
+	Node.NameOffset = AddName(Name);
+	Node.NameLength = Name.Len();
+	Node.NextSameKey = Head ? *Head : INDEX_NONE;
+	DirLookup.Add(Key, NewIndex);
+	return NewIndex;
+}
+
+int32 FFtpPathTable::AddFile(FStringView RelativePath, int64 Size, const FDateTime& Modified)
+{
+	int32 Dir = RootDirectory;
+	while (true)
+	{
+		int32 SlashIndex = INDEX_NONE;
+		for (int32 Index = 0; Index < RelativePath.Len(); ++Index)
+		{
+			if (RelativePath[Index] == TEXT('/') || RelativePath[Index] == TEXT('\\'))
+			{
+				SlashIndex = Index;
+				break;
+			}
+		}
+		if (SlashIndex == INDEX_NONE)
+		{
+			break;
+		}
+		if (SlashIndex > 0)
+		{
+			Dir = FindOrAddDirectory(Dir, RelativePath.Left(SlashIndex));
+		}
+		RelativePath.RightChopInline(SlashIndex + 1);
+	}
+
+	FFileEntry& Entry = Files.AddDefaulted_GetRef();
+	Entry.Dir = Dir;
+	Entry.NameOffset = AddName(RelativePath);
+	Entry.NameLength = RelativePath.Len();
+	Entry.Size = Size;
+	Entry.ModifiedTicks = Modified.GetTicks();
+	return Files.Num() - 1;
+}
+
+int32 FFtpPathTable::Scan()
+{
+	FTP_TRACE_SCOPE(Scan);
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	const int32 StartCount = Files.Num();
+
+	// 디렉토리 하나씩 비재귀로 훑는다 - 방문하는 쪽이 부모 노드를 이미 알고 있으므로 경로를 다시 쪼개지 않는다
+	TArray<int32> PendingDirs;
+	PendingDirs.Add(RootDirectory);
+
+	TStringBuilder<1024> DirPath;
+	while (PendingDirs.Num() > 0)
+	{
+		const int32 Dir = PendingDirs.Pop();
+
+		DirPath.Reset();
+		DirPath << Root;
+		if (Dir != RootDirectory)
+		{
+			DirPath << TEXT('/');
+			AppendDirectoryPath(Dir, DirPath);
+		}
+
+		PlatformFile.IterateDirectoryStat(*DirPath, [this, Dir, &PendingDirs](const TCHAR* FilenameOrDirectory, const FFileStatData& StatData)
+		{
+			const FStringView Name = FPathViews::GetCleanFilename(FilenameOrDirectory);
+			if (StatData.bIsDirectory)
+			{
+				PendingDirs.Add(FindOrAddDirectory(Dir, Name));
+			}
+			else
+			{
+				FFileEntry& Entry = Files.AddDefaulted_GetRef();
+				Entry.Dir = Dir;
+				Entry.NameOffset = AddName(Name);
+				Entry.NameLength = Name.Len();
+				Entry.Size = StatData.FileSize;
+				Entry.ModifiedTicks = StatData.ModificationTime.GetTicks();
+			}
+			return true;
+		});
+	}
+
+	Names.Shrink();
+	Files.Shrink();
+	Dirs.Shrink();
+	return Files.Num() - StartCount;
+}
+
+FStringView FFtpPathTable::GetFileName(int32 FileIndex) const
+{
+	const FFileEntry& Entry = Files[FileIndex];
+	return GetName(Entry.NameOffset, Entry.NameLength);
+}
+
+void FFtpPathTable::AppendDirectoryPath(int32 DirIndex, FStringBuilderBase& Out) const
+{
+	// 루트까지 올라가며 모은 뒤 거꾸로 붙인다 - 깊이가 깊지 않으면 힙을 쓰지 않는다
+	TArray<int32, TInlineAllocator<32>> Chain;
+	for (int32 Index = DirIndex; Index != RootDirectory && Index != INDEX_NONE; Index = Dirs[Index].Parent)
+	{
+		Chain.Add(Index);
+	}
+
+	for (int32 ChainIndex = Chain.Num() - 1; ChainIndex >= 0; --ChainIndex)
+	{
+		const FDirNode& Node = Dirs[Chain[ChainIndex]];
+		Out << GetName(Node.NameOffset, Node.NameLength);
+		if (ChainIndex > 0)
+		{
+			Out << TEXT('/');
+		}
+	}
+}
+
+void FFtpPathTable::AppendRelativePath(int32 FileIndex, FStringBuilderBase& Out) const
+{
+	const FFileEntry& Entry = Files[FileIndex];
+	if (Entry.Dir != RootDirectory)
+	{
+		AppendDirectoryPath(Entry.Dir, Out);
+		Out << TEXT('/');
+	}
+	Out << GetName(Entry.NameOffset, Entry.NameLength);
+}
+
+void FFtpPathTable::AppendFullPath(int32 FileIndex, FStringBuilderBase& Out) const
+{
+	Out << Root << TEXT('/');
+	AppendRelativePath(FileIndex, Out);
+}
+
+void FFtpPathTable::AppendRemotePath(int32 FileIndex, FStringView RemoteBase, FStringBuilderBase& Out) const
+{
+	// FString의 operator/와 같은 결과 - 기준 경로가 비어 있거나 '/'로 끝나면 구분자를 더하지 않는다
+	Out << RemoteBase;
+	if (RemoteBase.Len() > 0 && RemoteBase[RemoteBase.Len() - 1] != TEXT('/'))
+	{
+		Out << TEXT('/');
+	}
+	AppendRelativePath(FileIndex, Out);
+}
+
+FString FFtpPathTable::GetRelativePath(int32 FileIndex) const
+{
+	TStringBuilder<512> Builder;
+	AppendRelativePath(FileIndex, Builder);
+	return FString(Builder.ToView());
+}
+
+FString FFtpPathTable::GetFullPath(int32 FileIndex) const
+{
+	TStringBuilder<512> Builder;
+	AppendFullPath(FileIndex, Builder);
+	return FString(Builder.ToView());
+}
+
+FString FFtpPathTable::GetRemotePath(int32 FileIndex, FStringView RemoteBase) const
+{
+	TStringBuilder<512> Builder;
+	AppendRemotePath(FileIndex, RemoteBase, Builder);
+	return FString(Builder.ToView());
+}
+
+SIZE_T FFtpPathTable::GetAllocatedSize() const
+{
+	return Names.GetAllocatedSize() + Dirs.GetAllocatedSize() + Files.GetAllocatedSize() + DirLookup.GetAllocatedSize();
+}
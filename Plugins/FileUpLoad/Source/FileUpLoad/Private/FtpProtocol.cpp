@@ -0,0 +1,433 @@
+#include "FtpProtocol.h"
+
+namespace FtpProtocolInternal
+{
+	using FtpProtocol::MakeCommandKey;
+
+	struct FCommandEntry
+	{
+		uint32 Key;
+		EFtpCommand Command;
+	};
+
+	#define FTP_COMMAND_ENTRY(Verb, Command) { MakeCommandKey(Verb, sizeof(Verb) - 1), EFtpCommand::Command }
+
+	// 키 순서로 정렬된 명령 표 - 3글자 명령이 4글자보다 키가 작으므로 앞에 온다
+	static constexpr FCommandEntry CommandTable[] =
+	{
+		FTP_COMMAND_ENTRY("CWD", Cwd),
+		FTP_COMMAND_ENTRY("MKD", Mkd),
+		FTP_COMMAND_ENTRY("PWD", Pwd),
+		FTP_COMMAND_ENTRY("CDUP", Cdup),
+		FTP_COMMAND_ENTRY("DELE", Dele),
+		FTP_COMMAND_ENTRY("EPSV", Epsv),
+		FTP_COMMAND_ENTRY("FEAT", Feat),
+		FTP_COMMAND_ENTRY("LIST", List),
+		FTP_COMMAND_ENTRY("MDTM", Mdtm),
+		FTP_COMMAND_ENTRY("MLSD", Mlsd),
+		FTP_COMMAND_ENTRY("MODE", Mode),
+		FTP_COMMAND_ENTRY("NLST", Nlst),
+		FTP_COMMAND_ENTRY("NOOP", Noop),
+		FTP_COMMAND_ENTRY("OPTS", Opts),
+		FTP_COMMAND_ENTRY("PASS", Pass),
+		FTP_COMMAND_ENTRY("PASV", Pasv),
+		FTP_COMMAND_ENTRY("QUIT", Quit),
+		FTP_COMMAND_ENTRY("REST", Rest),
+		FTP_COMMAND_ENTRY("RETR", Retr),
+		FTP_COMMAND_ENTRY("RNFR", Rnfr),
+		FTP_COMMAND_ENTRY("RNTO", Rnto),
+		FTP_COMMAND_ENTRY("SIZE", Size),
+		FTP_COMMAND_ENTRY("STOR", Stor),
+		FTP_COMMAND_ENTRY("STRU", Stru),
+		FTP_COMMAND_ENTRY("SYST", Syst),
+		FTP_COMMAND_ENTRY("TYPE", Type),
+		FTP_COMMAND_ENTRY("USER", User),
+		FTP_COMMAND_ENTRY("XMKD", Mkd),
+		FTP_COMMAND_ENTRY("XPWD", Pwd),
+	};
+
+	#undef FTP_COMMAND_ENTRY
+
+	constexpr bool IsCommandTableSorted()
+	{
+		for (int32 Index = 1; Index < (int32)UE_ARRAY_COUNT(CommandTable); ++Index)
+		{
+			if (CommandTable[Index - 1].Key >= CommandTable[Index].Key)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+	static_assert(IsCommandTableSorted(), "FTP command table must be sorted by key");
+
+	// EFtpCommand 순서의 보내는 이름
+	static constexpr const ANSICHAR* CommandVerbs[] =
+	{
+		"", "USER", "PASS", "QUIT", "NOOP", "SYST", "FEAT", "OPTS", "TYPE", "MODE", "STRU", "PWD", "CWD", "CDUP",
+		"PASV", "EPSV", "REST", "SIZE", "MDTM", "LIST", "NLST", "MLSD", "RETR", "STOR", "MKD", "DELE",
+		"RNFR", "RNTO"
+	};
+	static_assert(UE_ARRAY_COUNT(CommandVerbs) == (int32)EFtpCommand::Count, "CommandVerbs must match EFtpCommand");
+
+	static const ANSICHAR* MonthNames[] = { "Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec" };
+
+	static FORCEINLINE bool IsDigit(ANSICHAR Char)
+	{
+		return Char >= '0' && Char <= '9';
+	}
+
+	static FORCEINLINE ANSICHAR ToUpper(ANSICHAR Char)
+	{
+		return (Char >= 'a' && Char <= 'z') ? Char - ('a' - 'A') : Char;
+	}
+
+	static FORCEINLINE bool HasReplyCode(FAnsiStringView Line)
+	{
+		return Line.Len() >= 3 && IsDigit(Line[0]) && IsDigit(Line[1]) && IsDigit(Line[2]);
+	}
+}
+
+FFtpLineReader::FFtpLineReader(int32 InMaxLineLength)
+	: MaxLineLength(FMath::Max(InMaxLineLength, 16))
+{
+	// 최대 길이 줄 하나가 남아 있어도 그만큼 더 받을 수 있는 크기
+	Buffer.SetNumUninitialized(MaxLineLength * 2 + 2);
+}
+
+uint8* FFtpLineReader::GetWriteBuffer(int32& OutCapacity)
+{
+	if (Start == End)
+	{
+		Start = End = ScanFrom = 0;
+	}
+	else if (End == Buffer.Num() && Start > 0)
+	{
+		// 꺼낸 줄 자리를 비우고 남은 바이트를 앞으로 당긴다
+		FMemory::Memmove(Buffer.GetData(), Buffer.GetData() + Start, End - Start);
+		ScanFrom -= Start;
+		End -= Start;
+		Start = 0;
+	}
+
+	OutCapacity = Buffer.Num() - End;
+	return (uint8*)Buffer.GetData() + End;
+}
+
+void FFtpLineReader::CommitWrite(int32 BytesWritten)
+{
+	End = FMath::Min(End + FMath::Max(BytesWritten, 0), Buffer.Num());
+}
+
+EFtpLineResult FFtpLineReader::NextLine(FAnsiStringView& OutLine)
+{
+	const ANSICHAR* Data = Buffer.GetData();
+	for (int32 Index = FMath::Max(ScanFrom, Start); Index < End; ++Index)
+	{
+		if (Data[Index] != '\n')
+		{
+			continue;
+		}
+
+		const int32 LineEnd = (Index > Start && Data[Index - 1] == '\r') ? Index - 1 : Index;
+		if (LineEnd - Start > MaxLineLength)
+		{
+			return EFtpLineResult::Overflow;
+		}
+
+		OutLine = FAnsiStringView(Data + Start, LineEnd - Start);
+		Start = ScanFrom = Index + 1;
+		return EFtpLineResult::Line;
+	}
+
+	ScanFrom = End;
+	return End - Start > MaxLineLength ? EFtpLineResult::Overflow : EFtpLineResult::NeedMore;
+}
+
+void FFtpLineReader::Reset()
+{
+	Start = End = ScanFrom = 0;
+}
+
+EFtpReplyResult FFtpReplyParser::Feed(FAnsiStringView Line)
+{
+	using namespace FtpProtocolInternal;
+
+	if (bComplete)
+	{
+		Reset();
+	}
+
+	if (NumLines++ == 0)
+	{
+		if (!HasReplyCode(Line) || (Line.Len() > 3 && Line[3] != ' ' && Line[3] != '-'))
+		{
+			return EFtpReplyResult::Malformed;
+		}
+
+		Code = (Line[0] - '0') * 100 + (Line[1] - '0') * 10 + (Line[2] - '0');
+		if (Line.Len() > 3 && Line[3] == '-')
+		{
+			bMultiLine = true;
+			return EFtpReplyResult::NeedMore;
+		}
+	}
+	else
+	{
+		// 여러 줄 응답은 같은 코드 + 공백(또는 코드만) 줄에서 끝난다
+		const bool bLastLine = HasReplyCode(Line) && (Line.Len() == 3 || Line[3] == ' ')
+			&& (Line[0] - '0') * 100 + (Line[1] - '0') * 10 + (Line[2] - '0') == Code;
+		if (!bLastLine)
+		{
+			return EFtpReplyResult::NeedMore;
+		}
+	}
+
+	Text = Line.Len() > 4 ? Line.RightChop(4) : FAnsiStringView();
+	bComplete = true;
+	return EFtpReplyResult::Complete;
+}
+
+void FFtpReplyParser::Reset()
+{
+	Code = 0;
+	NumLines = 0;
+	bMultiLine = false;
+	bComplete = false;
+	Text = FAnsiStringView();
+}
+
+FFtpMessageWriter::FFtpMessageWriter(int32 InitialCapacity)
+{
+	Buffer.Reserve(InitialCapacity);
+}
+
+ANSICHAR* FFtpMessageWriter::AddUninitialized(int32 Count)
+{
+	const int32 Offset = Buffer.AddUninitialized(Count);
+	return Buffer.GetData() + Offset;
+}
+
+FFtpMessageWriter& FFtpMessageWriter::Reset()
+{
+	// 메모리는 남겨 두고 길이만 되돌린다
+	Buffer.Reset();
+	return *this;
+}
+
+FFtpMessageWriter& FFtpMessageWriter::BeginReply(int32 Code, bool bContinued)
+{
+	ANSICHAR* Dest = AddUninitialized(4);
+	Dest[0] = '0' + (Code / 100) % 10;
+	Dest[1] = '0' + (Code / 10) % 10;
+	Dest[2] = '0' + Code % 10;
+	Dest[3] = bContinued ? '-' : ' ';
+	return *this;
+}
+
+FFtpMessageWriter& FFtpMessageWriter::BeginCommand(EFtpCommand Command)
+{
+	return Append(FtpProtocol::LexToString(Command));
+}
+
+FFtpMessageWriter& FFtpMessageWriter::AppendArgument(FAnsiStringView Argument)
+{
+	return Append(' ').Append(Argument);
+}
+
+FFtpMessageWriter& FFtpMessageWriter::Append(FAnsiStringView Text)
+{
+	if (Text.Len() > 0)
+	{
+		FMemory::Memcpy(AddUninitialized(Text.Len()), Text.GetData(), Text.Len());
+	}
+	return *this;
+}
+
+FFtpMessageWriter& FFtpMessageWriter::Append(ANSICHAR Char)
+{
+	Buffer.Add(Char);
+	return *this;
+}
+
+FFtpMessageWriter& FFtpMessageWriter::AppendUtf8(FStringView Text)
+{
+	if (Text.Len() > 0)
+	{
+		const int32 Length = FPlatformString::ConvertedLength<UTF8CHAR>(Text.GetData(), Text.Len());
+		FPlatformString::Convert((UTF8CHAR*)AddUninitialized(Length), Length, Text.GetData(), Text.Len());
+	}
+	return *this;
+}
+
+FFtpMessageWriter& FFtpMessageWriter::AppendInt(int64 Value, int32 MinDigits)
+{
+	ANSICHAR Digits[24];
+	int32 NumDigits = 0;
+	uint64 Magnitude = Value < 0 ? 0 - (uint64)Value : (uint64)Value;
+	do
+	{
+		Digits[NumDigits++] = '0' + (ANSICHAR)(Magnitude % 10);
+		Magnitude /= 10;
+	}
+	while (Magnitude > 0);
+
+	while (NumDigits < MinDigits && NumDigits < (int32)UE_ARRAY_COUNT(Digits) - 1)
+	{
+		Digits[NumDigits++] = '0';
+	}
+	if (Value < 0)
+	{
+		Digits[NumDigits++] = '-';
+	}
+
+	ANSICHAR* Dest = AddUninitialized(NumDigits);
+	for (int32 Index = 0; Index < NumDigits; ++Index)
+	{
+		Dest[Index] = Digits[NumDigits - 1 - Index];
+	}
+	return *this;
+}
+
+FFtpMessageWriter& FFtpMessageWriter::AppendTimestamp(const FDateTime& Time)
+{
+	return AppendInt(Time.GetYear(), 4).AppendInt(Time.GetMonth(), 2).AppendInt(Time.GetDay(), 2)
+		.AppendInt(Time.GetHour(), 2).AppendInt(Time.GetMinute(), 2).AppendInt(Time.GetSecond(), 2);
+}
+
+FFtpMessageWriter& FFtpMessageWriter::AppendListTime(const FDateTime& Time)
+{
+	return Append(FtpProtocolInternal::MonthNames[FMath::Clamp(Time.GetMonth(), 1, 12) - 1]).Append(' ')
+		.AppendInt(Time.GetDay(), 2).Append(' ').AppendInt(Time.GetHour(), 2).Append(':').AppendInt(Time.GetMinute(), 2);
+}
+
+FFtpMessageWriter& FFtpMessageWriter::EndLine()
+{
+	ANSICHAR* Dest = AddUninitialized(2);
+	Dest[0] = '\r';
+	Dest[1] = '\n';
+	return *this;
+}
+
+namespace FtpProtocol
+{
+	EFtpCommand LookupCommand(FAnsiStringView Verb)
+	{
+		using namespace FtpProtocolInternal;
+
+		if (Verb.Len() < 3 || Verb.Len() > 4)
+		{
+			return EFtpCommand::Unknown;
+		}
+
+		uint32 Key = 0;
+		for (int32 Index = 0; Index < Verb.Len(); ++Index)
+		{
+			Key = (Key << 8) | (uint8)ToUpper(Verb[Index]);
+		}
+
+		// 29개짜리 정렬 표 - 이분 탐색 다섯 번 안쪽
+		int32 Low = 0;
+		int32 High = (int32)UE_ARRAY_COUNT(CommandTable) - 1;
+		while (Low <= High)
+		{
+			const int32 Middle = (Low + High) / 2;
+			const uint32 MiddleKey = CommandTable[Middle].Key;
+			if (MiddleKey == Key)
+			{
+				return CommandTable[Middle].Command;
+			}
+			if (MiddleKey < Key)
+			{
+				Low = Middle + 1;
+			}
+			else
+			{
+				High = Middle - 1;
+			}
+		}
+		return EFtpCommand::Unknown;
+	}
+
+	bool ParseCommand(FAnsiStringView Line, FFtpCommandView& OutCommand)
+	{
+		int32 VerbStart = 0;
+		while (VerbStart < Line.Len() && Line[VerbStart] == ' ')
+		{
+			++VerbStart;
+		}
+		if (VerbStart == Line.Len())
+		{
+			return false;
+		}
+
+		int32 VerbEnd = VerbStart;
+		while (VerbEnd < Line.Len() && Line[VerbEnd] != ' ')
+		{
+			++VerbEnd;
+		}
+
+		OutCommand.Verb = Line.Mid(VerbStart, VerbEnd - VerbStart);
+		OutCommand.Argument = VerbEnd < Line.Len() ? Line.RightChop(VerbEnd + 1) : FAnsiStringView();
+		OutCommand.Command = LookupCommand(OutCommand.Verb);
+		return true;
+	}
+
+	void DecodeArgument(FAnsiStringView Utf8, FString& Out)
+	{
+		Out.Reset();
+		if (Utf8.Len() == 0)
+		{
+			return;
+		}
+
+		const UTF8CHAR* Source = (const UTF8CHAR*)Utf8.GetData();
+		const int32 Length = FPlatformString::ConvertedLength<TCHAR>(Source, Utf8.Len());
+		TArray<TCHAR>& Chars = Out.GetCharArray();
+		Chars.SetNumUninitialized(Length + 1);
+		FPlatformString::Convert(Chars.GetData(), Length, Source, Utf8.Len());
+		Chars[Length] = TEXT('\0');
+	}
+
+	bool EqualsIgnoreCase(FAnsiStringView A, FAnsiStringView B)
+	{
+		if (A.Len() != B.Len())
+		{
+			return false;
+		}
+		for (int32 Index = 0; Index < A.Len(); ++Index)
+		{
+			if (FtpProtocolInternal::ToUpper(A[Index]) != FtpProtocolInternal::ToUpper(B[Index]))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool ParseInt64(FAnsiStringView Text, int64& OutValue)
+	{
+		if (Text.Len() == 0 || Text.Len() > 18)
+		{
+			return false;
+		}
+
+		int64 Value = 0;
+		for (const ANSICHAR Char : Text)
+		{
+			if (!FtpProtocolInternal::IsDigit(Char))
+			{
+				return false;
+			}
+			Value = Value * 10 + (Char - '0');
+		}
+		OutValue = Value;
+		return true;
+	}
+
+	const ANSICHAR* LexToString(EFtpCommand Command)
+	{
+		const int32 Index = (int32)Command;
+		return Index >= 0 && Index < (int32)EFtpCommand::Count ? FtpProtocolInternal::CommandVerbs[Index] : "";
+	}
+}
@@ -0,0 +1,370 @@
+#include "FtpReadCache.h"
+#include "FileUpLoadStats.h"
+#include "FileUpLoadTrace.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformFilemanager.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/ScopeRWLock.h"
+#include "Hash/CityHash.h"
+
+#if PLATFORM_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Read Cache Hits"), STAT_FileUpLoad_ReadCacheHits, STATGROUP_FileUpLoad);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Read Cache Misses"), STAT_FileUpLoad_ReadCacheMisses, STATGROUP_FileUpLoad);
+DECLARE_MEMORY_STAT(TEXT("Read Cache Memory"), STAT_FileUpLoad_ReadCacheMemory, STATGROUP_FileUpLoad);
+
+FFtpReadCacheFile::~FFtpReadCacheFile()
+{
+#if PLATFORM_LINUX
+	if (Fd >= 0)
+	{
+		close(Fd);
+	}
+#endif
+}
+
+bool FFtpReadCacheFile::Open(const FString& Path)
+{
+#if PLATFORM_LINUX
+	Fd = open(TCHAR_TO_UTF8(*Path), O_RDONLY | O_CLOEXEC);
+	if (Fd < 0)
+	{
+		return false;
+	}
+	// 서버는 파일을 앞에서부터 보내므로 커널의 미리 읽기 창을 넓힌다
+	posix_fadvise(Fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+	return true;
+#else
+	Handle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenRead(*Path));
+	return Handle.IsValid();
+#endif
+}
+
+void FFtpReadCacheFile::ReadAhead(int64 Offset, int64 Length)
+{
+#if PLATFORM_LINUX
+	if (Fd >= 0)
+	{
+		posix_fadvise(Fd, Offset, Length, POSIX_FADV_WILLNEED);
+	}
+#endif
+}
+
+bool FFtpReadCacheFile::ReadAt(int64 Offset, uint8* Dest, int64 Length)
+{
+	FTP_TRACE_SCOPE(DiskRead);
+
+#if PLATFORM_LINUX
+	while (Length > 0)
+	{
+		const ssize_t Read = pread(Fd, Dest, Length, Offset);
+		if (Read < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		if (Read <= 0)
+		{
+			return false;
+		}
+		Dest += Read;
+		Offset += Read;
+		Length -= Read;
+	}
+	return true;
+#else
+	return Handle.IsValid() && Handle->Seek(Offset) && Handle->Read(Dest, Length);
+#endif
+}
+
+FFtpReadCache::FFtpReadCache(int64 InBudgetBytes)
+	: BudgetBytes(FMath::Max<int64>(InBudgetBytes, PageSize * NumShards))
+	, Hits(0)
+	, Misses(0)
+{
+	ShardBudgetBytes = BudgetBytes / NumShards;
+}
+
+FFtpReadCache::~FFtpReadCache()
+{
+	Empty();
+}
+
+bool FFtpReadCache::OpenFile(const FString& Path, FFileView& OutFile) const
+{
+	const FFileStatData Stat = FPlatformFileManager::Get().GetPlatformFile().GetStatData(*Path);
+	if (!Stat.bIsValid || Stat.bIsDirectory)
+	{
+		return false;
+	}
+
+	MakeFileView(Path, Stat.FileSize, Stat.ModificationTime, OutFile);
+	return true;
+}
+
+void FFtpReadCache::MakeFileView(const FString& Path, int64 Size, const FDateTime& Modified, FFileView& OutFile) const
+{
+	OutFile.Path = Path;
+	OutFile.Size = Size;
+	OutFile.Modified = Modified;
+
+	// 내용이 바뀌면(크기/시각) 또는 명시적으로 무효화되면 키가 달라진다
+	const FTCHARToUTF8 PathUtf8(*Path);
+	uint64 Key = CityHash64(PathUtf8.Get(), PathUtf8.Length());
+	Key = CityHash128to64(Uint128_64(Key, (uint64)Size));
+	Key = CityHash128to64(Uint128_64(Key, (uint64)Modified.GetTicks()));
+	Key = CityHash128to64(Uint128_64(Key, GetGeneration(Path)));
+	OutFile.FileKey = Key;
+}
+
+FFtpReadCache::FPendingFill::FPendingFill()
+	: Done(FPlatformProcess::GetSynchEventFromPool(true))
+{
+}
+
+FFtpReadCache::FPendingFill::~FPendingFill()
+{
+	FPlatformProcess::ReturnSynchEventToPool(Done);
+}
+
+FFtpReadCache::FPage FFtpReadCache::GetPage(const FFileView& File, int64 PageIndex, TUniquePtr<FFtpReadCacheFile>& Reader)
+{
+	const int64 NumPages = (File.Size + PageSize - 1) / PageSize;
+	if (PageIndex < 0 || PageIndex >= NumPages)
+	{
+		return nullptr;
+	}
+
+	const FPageKey Key{ File.FileKey, PageIndex };
+	FShard& Shard = GetShard(Key);
+	if (FPage Found = Find(Shard, Key))
+	{
+		++Hits;
+		INC_DWORD_STAT(STAT_FileUpLoad_ReadCacheHits);
+		return Found;
+	}
+
+	FPage Found;
+	TSharedPtr<FPendingFill, ESPMode::ThreadSafe> Wait;
+	TSharedPtr<FPendingFill, ESPMode::ThreadSafe> Claim;
+	BeginFill(Shard, Key, Found, Wait, Claim);
+	if (Wait.IsValid())
+	{
+		// 다른 세션이 같은 페이지를 읽는 중이면 그 결과를 같이 쓴다
+		Wait->Done->Wait();
+		Found = Wait->Data;
+	}
+	if (!Claim.IsValid())
+	{
+		if (Found.IsValid())
+		{
+			++Hits;
+			INC_DWORD_STAT(STAT_FileUpLoad_ReadCacheHits);
+		}
+		return Found;
+	}
+
+	++Misses;
+	INC_DWORD_STAT(STAT_FileUpLoad_ReadCacheMisses);
+
+	if (!Reader.IsValid())
+	{
+		Reader = MakeUnique<FFtpReadCacheFile>();
+		if (!Reader->Open(File.Path))
+		{
+			Reader.Reset();
+			EndFill(Shard, Key, Claim.ToSharedRef(), nullptr);
+			return nullptr;
+		}
+	}
+
+	// 요청 페이지와 뒤따르는 몇 페이지를 함께 읽는다 - 이미 있거나 누가 읽는 중인 페이지에서 멈춘다
+	const int64 LastPage = FMath::Min<int64>(PageIndex + ReadAheadPages, NumPages - 1);
+	Reader->ReadAhead(PageIndex * PageSize, (LastPage - PageIndex + 1) * PageSize);
+
+	FPage Requested;
+	for (int64 Page = PageIndex; Page <= LastPage; ++Page)
+	{
+		const FPageKey PageKey{ File.FileKey, Page };
+		FShard& PageShard = GetShard(PageKey);
+		TSharedPtr<FPendingFill, ESPMode::ThreadSafe> PageClaim = Claim;
+		if (Page != PageIndex)
+		{
+			FPage Existing;
+			TSharedPtr<FPendingFill, ESPMode::ThreadSafe> PageWait;
+			BeginFill(PageShard, PageKey, Existing, PageWait, PageClaim);
+			if (!PageClaim.IsValid())
+			{
+				break;
+			}
+		}
+
+		// 디스크 읽기는 잠금 밖에서 한다
+		const int64 Offset = Page * PageSize;
+		const int64 Length = FMath::Min<int64>(PageSize, File.Size - Offset);
+		TSharedRef<TArray<uint8>, ESPMode::ThreadSafe> Data = MakeShared<TArray<uint8>, ESPMode::ThreadSafe>();
+		Data->SetNumUninitialized((int32)Length);
+		const bool bRead = Reader->ReadAt(Offset, Data->GetData(), Length);
+
+		EndFill(PageShard, PageKey, PageClaim.ToSharedRef(), bRead ? FPage(Data) : FPage());
+		if (!bRead)
+		{
+			break;
+		}
+		if (Page == PageIndex)
+		{
+			Requested = Data;
+		}
+	}
+	return Requested;
+}
+
+FFtpReadCache::FPage FFtpReadCache::Find(FShard& Shard, const FPageKey& Key)
+{
+	FReadScopeLock ReadScope(Shard.Lock);
+	const int32* SlotIndex = Shard.Index.Find(Key);
+	if (SlotIndex == nullptr)
+	{
+		return nullptr;
+	}
+	// 참조 비트만 세운다 - 목록 순서를 바꾸지 않으므로 읽기 잠금으로 충분하다
+	FPlatformAtomics::AtomicStore_Relaxed(&Shard.Referenced[*SlotIndex], (int8)1);
+	return Shard.Slots[*SlotIndex].Data;
+}
+
+void FFtpReadCache::BeginFill(FShard& Shard, const FPageKey& Key, FPage& OutPage, TSharedPtr<FPendingFill, ESPMode::ThreadSafe>& OutWait, TSharedPtr<FPendingFill, ESPMode::ThreadSafe>& OutClaim)
+{
+	OutWait.Reset();
+	OutClaim.Reset();
+
+	FWriteScopeLock WriteScope(Shard.Lock);
+	if (const int32* SlotIndex = Shard.Index.Find(Key))
+	{
+		Shard.Referenced[*SlotIndex] = 1;
+		OutPage = Shard.Slots[*SlotIndex].Data;
+		return;
+	}
+	if (const FPendingFillRef* Pending = Shard.Filling.Find(Key))
+	{
+		OutWait = *Pending;
+		return;
+	}
+
+	FPendingFillRef Claim = MakeShared<FPendingFill, ESPMode::ThreadSafe>();
+	Shard.Filling.Add(Key, Claim);
+	OutClaim = Claim;
+}
+
+void FFtpReadCache::EndFill(FShard& Shard, const FPageKey& Key, const FPendingFillRef& Claim, const FPage& Data)
+{
+	{
+		FWriteScopeLock WriteScope(Shard.Lock);
+		if (Data.IsValid())
+		{
+			InsertLocked(Shard, Key, Data);
+		}
+		Shard.Filling.Remove(Key);
+	}
+
+	Claim->Data = Data;
+	Claim->Done->Trigger();
+}
+
+void FFtpReadCache::InsertLocked(FShard& Shard, const FPageKey& Key, const FPage& Data)
+{
+	if (Shard.Index.Contains(Key))
+	{
+		return;
+	}
+
+	const int64 Bytes = Data->Num();
+	while (Shard.Slots.Num() > 0 && Shard.Bytes + Bytes > ShardBudgetBytes)
+	{
+		EvictOne(Shard);
+	}
+
+	Shard.Index.Add(Key, Shard.Slots.Num());
+	Shard.Slots.Add(FSlot{ Key, Data });
+	Shard.Referenced.Add(0);
+	Shard.Bytes += Bytes;
+	INC_MEMORY_STAT_BY(STAT_FileUpLoad_ReadCacheMemory, Bytes);
+}
+
+void FFtpReadCache::EvictOne(FShard& Shard)
+{
+	// 두 번째 기회 - 참조 비트가 선 슬롯은 비트만 내리고 지나간다
+	while (true)
+	{
+		if (Shard.ClockHand >= Shard.Slots.Num())
+		{
+			Shard.ClockHand = 0;
+		}
+		if (Shard.Referenced[Shard.ClockHand] == 0)
+		{
+			break;
+		}
+		Shard.Referenced[Shard.ClockHand] = 0;
+		++Shard.ClockHand;
+	}
+
+	const int32 Victim = Shard.ClockHand;
+	const int64 Bytes = Shard.Slots[Victim].Data->Num();
+	Shard.Index.Remove(Shard.Slots[Victim].Key);
+	Shard.Bytes -= Bytes;
+	DEC_MEMORY_STAT_BY(STAT_FileUpLoad_ReadCacheMemory, Bytes);
+
+	// 마지막 슬롯을 빈자리로 옮긴다 (전송 중인 세션은 페이지 참조를 따로 들고 있다)
+	Shard.Slots.RemoveAtSwap(Victim);
+	Shard.Referenced.RemoveAtSwap(Victim);
+	if (Victim < Shard.Slots.Num())
+	{
+		Shard.Index[Shard.Slots[Victim].Key] = Victim;
+	}
+}
+
+void FFtpReadCache::Invalidate(const FString& Path)
+{
+	FWriteScopeLock WriteScope(GenerationLock);
+	// 한 번만 쓰이고 마는 경로(업로드 임시 파일 등)가 쌓이지 않게 한도를 넘으면 기록을 비운다
+	if (Generations.Num() >= MaxTrackedGenerations)
+	{
+		Generations.Reset();
+		BaseGeneration = ++LastGeneration;
+	}
+	Generations.Add(Path, ++LastGeneration);
+}
+
+uint32 FFtpReadCache::GetGeneration(const FString& Path) const
+{
+	FReadScopeLock ReadScope(GenerationLock);
+	const uint32* Generation = Generations.Find(Path);
+	return Generation ? *Generation : BaseGeneration;
+}
+
+void FFtpReadCache::Empty()
+{
+	for (FShard& Shard : Shards)
+	{
+		FWriteScopeLock WriteScope(Shard.Lock);
+		DEC_MEMORY_STAT_BY(STAT_FileUpLoad_ReadCacheMemory, Shard.Bytes);
+		Shard.Index.Empty();
+		Shard.Slots.Empty();
+		Shard.Referenced.Empty();
+		Shard.ClockHand = 0;
+		Shard.Bytes = 0;
+	}
+}
+
+int64 FFtpReadCache::GetCachedBytes() const
+{
+	int64 Total = 0;
+	for (const FShard& Shard : Shards)
+	{
+		FReadScopeLock ReadScope(Shard.Lock);
+		Total += Shard.Bytes;
+	}
+	return Total;
+}
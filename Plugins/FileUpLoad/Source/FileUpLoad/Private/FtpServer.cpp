@@ -0,0 +1,1181 @@
+#include "FtpServer.h"
+#include "FtpReadCache.h"
+#include "FtpVirtualFileSystem.h"
+#include "FtpIngestCommitter.h"
+#include "FtpAsyncFileWriter.h"
+#include "FtpBufferPool.h"
+#include "FtpSystem.h"
+#include "FtpProtocol.h"
+#include "FileUpLoadStats.h"
+#include "FileUpLoadTrace.h"
+#include "Async/Async.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformFilemanager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+#include "IPAddress.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Server Sessions"), STAT_FileUpLoad_ServerSessions, STATGROUP_FileUpLoad);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Server Commands"), STAT_FileUpLoad_ServerCommands, STATGROUP_FileUpLoad);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Server MB Sent"), STAT_FileUpLoad_ServerMegabytesSent, STATGROUP_FileUpLoad);
+DECLARE_FLOAT_ACCUMULATOR_STAT(TEXT("Server MB Received"), STAT_FileUpLoad_ServerMegabytesReceived, STATGROUP_FileUpLoad);
+
+namespace FtpServerInternal
+{
+	// 대기 단위 - 이 간격마다 서버 종료/유휴 시간을 확인한다
+	static const FTimespan PollInterval = FTimespan::FromMilliseconds(500);
+
+	// 반응 스레드가 새 연결을 기다리는 단위 - 쉬는 세션을 훑는 간격이기도 하다.
+	// 훑어서 읽을 세션이 없으면 최대 간격까지 두 배씩 늘리고, 일이 생기면 최소 간격으로 돌아간다
+	static const FTimespan ReactorMinInterval = FTimespan::FromMilliseconds(2);
+	static const FTimespan ReactorMaxInterval = FTimespan::FromMilliseconds(50);
+
+	// 수동 모드 데이터 연결을 기다리는 시간
+	static const FTimespan DataConnectTimeout = FTimespan::FromSeconds(10);
+
+	// 틀린 PASS의 응답을 늦추는 시간(작업 스레드를 잡지 않고 반응 스레드가 기다린다)과, 한 세션에서 허용하는 실패 수
+	static constexpr float LoginFailureDelaySeconds = 1.0f;
+	static constexpr int32 MaxLoginFailures = 3;
+
+	// 한 줄 명령의 최대 길이 - 넘으면 연결을 끊는다
+	static constexpr int32 MaxCommandLength = 4096;
+
+	// STOR 수신 단위 - 전송 동안만 버퍼 풀에서 빌리고, 받은 데이터는 비동기 쓰기의 풀 버퍼로 넘어간다
+	static constexpr int32 ReceiveChunkSize = 256 * 1024;
+
+	static ISocketSubsystem* GetSocketSubsystem()
+	{
+		return ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	}
+
+	static bool IsLoopbackAddress(const FInternetAddr& Addr)
+	{
+		uint32 Ip = 0;
+		Addr.GetIp(Ip);
+		return (Ip >> 24) == 127 || Addr.ToString(false) == TEXT("::1");
+	}
+
+	static void DestroySocket(FSocket*& Socket)
+	{
+		if (Socket != nullptr)
+		{
+			Socket->Close();
+			GetSocketSubsystem()->DestroySocket(Socket);
+			Socket = nullptr;
+		}
+	}
+}
+
+// 제어 연결 하나 - 반응 스레드와 작업 스레드 사이를 오가지만 한 번에 한 스레드만 만진다
+class FFtpServerSession
+{
+public:
+	FFtpServerSession(FFtpServer& InServer, FSocket* InControlSocket)
+		: Server(InServer)
+		, ControlSocket(InControlSocket)
+		, LineReader(FtpServerInternal::MaxCommandLength)
+	{
+	}
+
+	~FFtpServerSession()
+	{
+		FtpServerInternal::DestroySocket(PassiveSocket);
+		FtpServerInternal::DestroySocket(ControlSocket);
+	}
+
+	// 인사말을 보낸다
+	void Begin();
+
+	// 제어 연결에 읽을 것이(또는 끊김이) 와 있는지 - 기다리지 않는다
+	bool IsReadable() const;
+
+	// 늦춘 응답이 있으면 보낼 시각 - 그 전에는 읽지도 작업 스레드에 넘기지도 않는다
+	bool HasDeferredReply() const { return DeferredReplyCode != 0; }
+	double GetDeferredUntil() const { return DeferredUntil; }
+
+	// 조용한 시간이 IdleTimeoutSeconds를 넘었으면 421을 보내고 true
+	bool CheckIdleTimeout(double Now);
+
+	// 받은 바이트를 읽고 완성된 명령을 모두 처리한다 (늦춘 응답이 있으면 그것부터 보낸다). 세션을 닫아야 하면 false
+	bool Pump();
+
+private:
+	bool SendAll(FSocket* Socket, const uint8* Data, int64 Length);
+
+	// 고정 문구 응답
+	void Reply(int32 Code, FAnsiStringView Text);
+	// 가변 응답 - StartReply로 Writer에 이어 쓰고 SendReply로 보낸다
+	FFtpMessageWriter& StartReply(int32 Code);
+	void SendReply();
+
+	void HandleCommand(const FFtpCommandView& Command);
+
+	bool OpenPassive(bool bExtended);
+	FSocket* AcceptDataConnection();
+
+	void HandleList(EFtpCommand Command, const FString& Argument);
+	void HandleRetr(const FString& Argument);
+	void HandleStor(const FString& Argument);
+	void HandleMakeDirectory(const FString& Argument);
+	void HandleDelete(const FString& Argument);
+	void HandleRenameFrom(const FString& Argument);
+	void HandleRenameTo(const FString& Argument);
+
+	FFtpServer& Server;
+	FSocket* ControlSocket = nullptr;
+	FSocket* PassiveSocket = nullptr;
+
+	// 제어 연결 수신/송신 버퍼 - 세션 동안 재사용하며 명령마다 할당하지 않는다
+	FFtpLineReader LineReader;
+	FFtpMessageWriter Writer;
+	// 파일 시스템이 필요한 명령의 인자 (UTF-8을 풀어 쓴 것)
+	FString ArgumentText;
+	double LastActivityTime = 0.0;
+
+	FString PendingUser;
+	FString UserName;
+	bool bLoggedIn = false;
+	bool bQuit = false;
+	int64 RestartOffset = 0;
+	int32 FailedLogins = 0;
+
+	// 로그인 실패 응답(530/421)을 DeferredUntil까지 늦춘다
+	int32 DeferredReplyCode = 0;
+	double DeferredUntil = 0.0;
+
+	// RNFR로 고른 파일 - 바로 다음 명령이 RNTO가 아니면 잊는다
+	FString RenameFromLogical;
+	FString RenameFromLocal;
+
+	// 로그인한 사용자의 홈에 갇힌 파일 시스템 (로그인 전에는 없음)
+	TUniquePtr<FFtpVirtualFileSystem> Vfs;
+
+	// LIST/NLST/MLSD 출력 - 세션 동안 재사용
+	FFtpMessageWriter ListingWriter;
+};
+
+void FFtpServerSession::Begin()
+{
+	LastActivityTime = FPlatformTime::Seconds();
+	Reply(220, "FileUpLoad FTP server ready");
+}
+
+bool FFtpServerSession::IsReadable() const
+{
+	return ControlSocket->Wait(ESocketWaitConditions::WaitForRead, FTimespan::Zero());
+}
+
+bool FFtpServerSession::CheckIdleTimeout(double Now)
+{
+	if (Now - LastActivityTime <= Server.GetConfig().IdleTimeoutSeconds)
+	{
+		return false;
+	}
+	Reply(421, "Idle timeout");
+	return true;
+}
+
+bool FFtpServerSession::Pump()
+{
+	if (DeferredReplyCode != 0)
+	{
+		// 반응 스레드가 시간이 지난 뒤에 넘겼다 - 응답을 보내고 그동안 쌓인 명령을 이어서 처리한다
+		if (DeferredReplyCode == 421)
+		{
+			Reply(421, "Too many login failures");
+		}
+		else
+		{
+			Reply(530, "Login incorrect");
+		}
+		DeferredReplyCode = 0;
+	}
+	else
+	{
+		// 반응 스레드가 읽을 것이 있다고 본 뒤에만 불리므로 Recv는 막히지 않는다
+		int32 Capacity = 0;
+		uint8* Dest = LineReader.GetWriteBuffer(Capacity);
+		int32 BytesRead = 0;
+		if (!ControlSocket->Recv(Dest, Capacity, BytesRead) || BytesRead <= 0)
+		{
+			return false;
+		}
+		LineReader.CommitWrite(BytesRead);
+	}
+	LastActivityTime = FPlatformTime::Seconds();
+
+	FAnsiStringView Line;
+	FFtpCommandView Command;
+	while (!bQuit && !Server.IsStopping())
+	{
+		const EFtpLineResult Result = LineReader.NextLine(Line);
+		if (Result == EFtpLineResult::Overflow)
+		{
+			return false;
+		}
+		if (Result == EFtpLineResult::NeedMore)
+		{
+			return true;
+		}
+
+		INC_DWORD_STAT(STAT_FileUpLoad_ServerCommands);
+
+		// 줄 버퍼 위의 뷰로 나눈다 - 명령 하나에 문자열을 만들지 않는다
+		if (FtpProtocol::ParseCommand(Line, Command))
+		{
+			HandleCommand(Command);
+		}
+		LastActivityTime = FPlatformTime::Seconds();
+
+		// 늦춘 응답을 보내기 전에는 다음 명령을 처리하지 않는다 - 세션을 반응 스레드에 돌려준다
+		if (DeferredReplyCode != 0)
+		{
+			return !Server.IsStopping();
+		}
+	}
+	return false;
+}
+
+bool FFtpServerSession::SendAll(FSocket* Socket, const uint8* Data, int64 Length)
+{
+	while (Length > 0)
+	{
+		if (Server.IsStopping())
+		{
+			return false;
+		}
+
+		int32 BytesSent = 0;
+		if (!Socket->Send(Data, (int32)FMath::Min<int64>(Length, MAX_int32), BytesSent) || BytesSent <= 0)
+		{
+			return false;
+		}
+		Data += BytesSent;
+		Length -= BytesSent;
+	}
+	return true;
+}
+
+void FFtpServerSession::Reply(int32 Code, FAnsiStringView Text)
+{
+	StartReply(Code).Append(Text);
+	SendReply();
+}
+
+FFtpMessageWriter& FFtpServerSession::StartReply(int32 Code)
+{
+	return Writer.Reset().BeginReply(Code);
+}
+
+void FFtpServerSession::SendReply()
+{
+	Writer.EndLine();
+	SendAll(ControlSocket, Writer.GetData(), Writer.Num());
+}
+
+bool FFtpServerSession::OpenPassive(bool bExtended)
+{
+	FTP_TRACE_SCOPE(ServerPasv);
+
+	using namespace FtpServerInternal;
+
+	DestroySocket(PassiveSocket);
+
+	// 제어 연결이 들어온 로컬 주소에서 임의 포트로 듣는다
+	TSharedRef<FInternetAddr> LocalAddr = GetSocketSubsystem()->CreateInternetAddr();
+	ControlSocket->GetAddress(*LocalAddr);
+	LocalAddr->SetPort(0);
+
+	PassiveSocket = GetSocketSubsystem()->CreateSocket(NAME_Stream, TEXT("FtpServerPassive"), LocalAddr->GetProtocolType());
+	if (PassiveSocket == nullptr || !PassiveSocket->Bind(*LocalAddr) || !PassiveSocket->Listen(1))
+	{
+		DestroySocket(PassiveSocket);
+		Reply(425, "Cannot open passive connection");
+		return false;
+	}
+
+	const int32 Port = PassiveSocket->GetPortNo();
+	if (bExtended)
+	{
+		StartReply(229).Append("Entering Extended Passive Mode (|||").AppendInt(Port).Append("|)");
+	}
+	else
+	{
+		uint32 Ip = 0;
+		LocalAddr->GetIp(Ip);
+		StartReply(227).Append("Entering Passive Mode (")
+			.AppendInt((Ip >> 24) & 0xFF).Append(',').AppendInt((Ip >> 16) & 0xFF).Append(',')
+			.AppendInt((Ip >> 8) & 0xFF).Append(',').AppendInt(Ip & 0xFF).Append(',')
+			.AppendInt(Port >> 8).Append(',').AppendInt(Port & 0xFF).Append(')');
+	}
+	SendReply();
+	return true;
+}
+
+FSocket* FFtpServerSession::AcceptDataConnection()
+{
+	FTP_TRACE_SCOPE(ServerDataConnect);
+
+	if (PassiveSocket == nullptr)
+	{
+		return nullptr;
+	}
+
+	// 제어 연결의 상대와 다른 주소에서 온 연결은 버린다 - 다른 호스트가 수동 포트를 가로채지 못한다
+	TSharedRef<FInternetAddr> ControlPeer = FtpServerInternal::GetSocketSubsystem()->CreateInternetAddr();
+	ControlSocket->GetPeerAddress(*ControlPeer);
+	ControlPeer->SetPort(0);
+
+	FSocket* DataSocket = nullptr;
+	const double Deadline = FPlatformTime::Seconds() + FtpServerInternal::DataConnectTimeout.GetTotalSeconds();
+	while (DataSocket == nullptr && FPlatformTime::Seconds() < Deadline)
+	{
+		bool bPending = false;
+		const FTimespan Remaining = FTimespan::FromSeconds(Deadline - FPlatformTime::Seconds());
+		if (!PassiveSocket->WaitForPendingConnection(bPending, Remaining) || !bPending)
+		{
+			break;
+		}
+
+		DataSocket = PassiveSocket->Accept(TEXT("FtpServerData"));
+		if (DataSocket == nullptr)
+		{
+			break;
+		}
+
+		TSharedRef<FInternetAddr> DataPeer = FtpServerInternal::GetSocketSubsystem()->CreateInternetAddr();
+		DataSocket->GetPeerAddress(*DataPeer);
+		DataPeer->SetPort(0);
+		if (!(*DataPeer == *ControlPeer))
+		{
+			LogFtpMessage(FString::Printf(TEXT("Server: rejected data connection from %s"), *DataPeer->ToString(false)), true);
+			FtpServerInternal::DestroySocket(DataSocket);
+		}
+	}
+
+	// 수동 모드 리슨 소켓은 전송 한 번에 하나
+	FtpServerInternal::DestroySocket(PassiveSocket);
+	return DataSocket;
+}
+
+void FFtpServerSession::HandleCommand(const FFtpCommandView& Command)
+{
+	if (Command.Command != EFtpCommand::Rnto)
+	{
+		RenameFromLogical.Reset();
+		RenameFromLocal.Reset();
+	}
+
+	switch (Command.Command)
+	{
+	case EFtpCommand::User:
+		FtpProtocol::DecodeArgument(Command.Argument, PendingUser);
+		bLoggedIn = false;
+		Reply(331, "Password required");
+		return;
+	case EFtpCommand::Pass:
+	{
+		FTP_TRACE_SCOPE(ServerLogin);
+		FtpProtocol::DecodeArgument(Command.Argument, ArgumentText);
+		Vfs.Reset();
+		// 계정 잠금(AuthenticateUser)을 쓰지 않는다 - 그러면 네트워크의 누구나 실제 계정을 잠글 수 있다
+		if (!PendingUser.IsEmpty() && CheckUserPassword(PendingUser, ArgumentText))
+		{
+			// 권한과 홈 디렉토리는 로그인 때 한 번만 읽는다
+			Vfs = MakeUnique<FFtpVirtualFileSystem>(Server.GetConfig().RootDirectory, *GetUser(PendingUser));
+		}
+		// 비밀번호를 세션에 남기지 않는다
+		ArgumentText.Reset();
+
+		if (Vfs.IsValid() && Vfs->EnsureHomeDirectory())
+		{
+			UserName = PendingUser;
+			bLoggedIn = true;
+			Reply(230, "Login successful");
+		}
+		else
+		{
+			Vfs.Reset();
+			bLoggedIn = false;
+
+			// 대신 세션마다 실패 응답을 늦추고(반응 스레드가 기다렸다가 Pump로 보낸다), 여러 번 틀리면 연결을 끊는다
+			DeferredUntil = FPlatformTime::Seconds() + FtpServerInternal::LoginFailureDelaySeconds;
+			DeferredReplyCode = ++FailedLogins >= FtpServerInternal::MaxLoginFailures ? 421 : 530;
+			bQuit = DeferredReplyCode == 421;
+		}
+		return;
+	}
+	case EFtpCommand::Quit:
+		Reply(221, "Goodbye");
+		bQuit = true;
+		return;
+	case EFtpCommand::Noop:
+	case EFtpCommand::Opts:
+		Reply(200, "OK");
+		return;
+	case EFtpCommand::Syst:
+		Reply(215, "UNIX Type: L8");
+		return;
+	case EFtpCommand::Feat:
+	{
+		static const ANSICHAR Features[] = "211-Features:\r\n SIZE\r\n MDTM\r\n MLSD\r\n REST STREAM\r\n EPSV\r\n UTF8\r\n211 End\r\n";
+		SendAll(ControlSocket, (const uint8*)Features, sizeof(Features) - 1);
+		return;
+	}
+	case EFtpCommand::Unknown:
+		Reply(502, "Command not implemented");
+		return;
+	default:
+		break;
+	}
+
+	if (!bLoggedIn)
+	{
+		Reply(530, "Please login with USER and PASS");
+		return;
+	}
+
+	switch (Command.Command)
+	{
+	case EFtpCommand::Type:
+	case EFtpCommand::Mode:
+	case EFtpCommand::Stru:
+		// 항상 바이너리 스트림으로 보낸다
+		Reply(200, "OK");
+		break;
+	case EFtpCommand::Pwd:
+		StartReply(257).Append('"').AppendUtf8(Vfs->GetWorkingDirectory()).Append("\" is the current directory");
+		SendReply();
+		break;
+	case EFtpCommand::Cwd:
+	case EFtpCommand::Cdup:
+		if (Command.Command == EFtpCommand::Cdup)
+		{
+			ArgumentText = TEXT("..");
+		}
+		else
+		{
+			FtpProtocol::DecodeArgument(Command.Argument, ArgumentText);
+		}
+		if (Vfs->ChangeDirectory(ArgumentText))
+		{
+			Reply(250, "Directory changed");
+		}
+		else
+		{
+			Reply(550, "No such directory");
+		}
+		break;
+	case EFtpCommand::Pasv:
+	case EFtpCommand::Epsv:
+		OpenPassive(Command.Command == EFtpCommand::Epsv);
+		break;
+	case EFtpCommand::Rest:
+		if (!FtpProtocol::ParseInt64(Command.Argument, RestartOffset))
+		{
+			RestartOffset = 0;
+			Reply(501, "Invalid restart offset");
+			break;
+		}
+		StartReply(350).Append("Restarting at ").AppendInt(RestartOffset);
+		SendReply();
+		break;
+	case EFtpCommand::Size:
+	case EFtpCommand::Mdtm:
+	{
+		FtpProtocol::DecodeArgument(Command.Argument, ArgumentText);
+		const FFtpVfsEntry* Entry = Vfs->Resolve(ArgumentText);
+		if (Entry == nullptr || !Entry->bExists || Entry->bIsDirectory)
+		{
+			Reply(550, "No such file");
+			break;
+		}
+		if (Command.Command == EFtpCommand::Size)
+		{
+			StartReply(213).AppendInt(Entry->Size);
+		}
+		else
+		{
+			StartReply(213).AppendTimestamp(Entry->Modified);
+		}
+		SendReply();
+		break;
+	}
+	case EFtpCommand::List:
+	case EFtpCommand::Nlst:
+	case EFtpCommand::Mlsd:
+		FtpProtocol::DecodeArgument(Command.Argument, ArgumentText);
+		HandleList(Command.Command, ArgumentText);
+		break;
+	case EFtpCommand::Retr:
+		FtpProtocol::DecodeArgument(Command.Argument, ArgumentText);
+		HandleRetr(ArgumentText);
+		break;
+	case EFtpCommand::Stor:
+		FtpProtocol::DecodeArgument(Command.Argument, ArgumentText);
+		HandleStor(ArgumentText);
+		break;
+	case EFtpCommand::Mkd:
+		FtpProtocol::DecodeArgument(Command.Argument, ArgumentText);
+		HandleMakeDirectory(ArgumentText);
+		break;
+	case EFtpCommand::Dele:
+		FtpProtocol::DecodeArgument(Command.Argument, ArgumentText);
+		HandleDelete(ArgumentText);
+		break;
+	case EFtpCommand::Rnfr:
+		FtpProtocol::DecodeArgument(Command.Argument, ArgumentText);
+		HandleRenameFrom(ArgumentText);
+		break;
+	case EFtpCommand::Rnto:
+		FtpProtocol::DecodeArgument(Command.Argument, ArgumentText);
+		HandleRenameTo(ArgumentText);
+		break;
+	default:
+		Reply(502, "Command not implemented");
+		break;
+	}
+}
+
+void FFtpServerSession::HandleList(EFtpCommand Command, const FString& Argument)
+{
+	FTP_TRACE_SCOPE(ServerList);
+
+	if (!Vfs->HasPermission(EFtpVfsPermission::Read))
+	{
+		Reply(550, "Permission denied");
+		return;
+	}
+
+	// "LIST -la" 같은 ls 옵션은 무시한다
+	const bool bCurrentDirectory = Argument.IsEmpty() || Argument.StartsWith(TEXT("-"));
+	const FFtpVfsEntry* Entry = Vfs->Resolve(bCurrentDirectory ? FString(TEXT(".")) : Argument);
+	if (Entry == nullptr || !Entry->bExists || !Entry->bIsDirectory)
+	{
+		Reply(550, "No such directory");
+		return;
+	}
+
+	// 나열 중 CacheChild가 캐시를 비울 수 있으므로 먼저 복사한다
+	const FString DirectoryLogicalPath = Entry->LogicalPath;
+	const FString DirectoryLocalPath = Entry->LocalPath;
+
+	// 항목마다 문자열을 만들지 않고 재사용 버퍼에 UTF-8로 바로 쓴다
+	ListingWriter.Reset();
+	FPlatformFileManager::Get().GetPlatformFile().IterateDirectoryStat(*DirectoryLocalPath,
+		[this, Command, &DirectoryLogicalPath](const TCHAR* Path, const FFileStatData& Stat)
+		{
+			const FString Name = FPaths::GetCleanFilename(Path);
+			// 받는 중인 임시 파일은 보이지 않는다
+			if (FFtpIngestCommitter::IsTempFileName(Name))
+			{
+				return true;
+			}
+			Vfs->CacheChild(DirectoryLogicalPath, Name, Stat.bIsDirectory, Stat.FileSize, Stat.ModificationTime);
+
+			if (Command == EFtpCommand::Mlsd)
+			{
+				if (Stat.bIsDirectory)
+				{
+					ListingWriter.Append("type=dir;modify=");
+				}
+				else
+				{
+					ListingWriter.Append("type=file;size=").AppendInt(Stat.FileSize).Append(";modify=");
+				}
+				ListingWriter.AppendTimestamp(Stat.ModificationTime).Append("; ");
+			}
+			else if (Command != EFtpCommand::Nlst)
+			{
+				ListingWriter.Append(Stat.bIsDirectory ? "drwxr-xr-x 1 ftp ftp " : "-rw-r--r-- 1 ftp ftp ")
+					.AppendInt(Stat.bIsDirectory ? 0 : Stat.FileSize).Append(' ')
+					.AppendListTime(Stat.ModificationTime).Append(' ');
+			}
+			ListingWriter.AppendUtf8(Name).EndLine();
+			return true;
+		});
+
+	FSocket* DataSocket = AcceptDataConnection();
+	if (DataSocket == nullptr)
+	{
+		Reply(425, "Use PASV or EPSV first");
+		return;
+	}
+
+	Reply(150, "Here comes the directory listing");
+	const bool bSent = SendAll(DataSocket, ListingWriter.GetData(), ListingWriter.Num());
+	FtpServerInternal::DestroySocket(DataSocket);
+
+	if (bSent)
+	{
+		Reply(226, "Directory send OK");
+	}
+	else
+	{
+		Reply(426, "Transfer aborted");
+	}
+}
+
+void FFtpServerSession::HandleRetr(const FString& Argument)
+{
+	FTP_TRACE_SCOPE(ServerRetr);
+
+	const int64 StartOffset = RestartOffset;
+	RestartOffset = 0;
+
+	if (!Vfs->HasPermission(EFtpVfsPermission::Read))
+	{
+		Reply(550, "Permission denied");
+		return;
+	}
+
+	const FFtpVfsEntry* Entry = Vfs->Resolve(Argument);
+	if (Entry == nullptr || !Entry->bExists || Entry->bIsDirectory)
+	{
+		Reply(550, "No such file");
+		return;
+	}
+
+	// 세션 캐시의 stat 값으로 만든다 - RETR마다 다시 stat하지 않는다
+	FFtpReadCache& Cache = Server.GetReadCache();
+	FFtpReadCache::FFileView File;
+	Cache.MakeFileView(Entry->LocalPath, Entry->Size, Entry->Modified, File);
+	if (StartOffset > File.Size)
+	{
+		Reply(554, "Restart offset beyond end of file");
+		return;
+	}
+
+	FSocket* DataSocket = AcceptDataConnection();
+	if (DataSocket == nullptr)
+	{
+		Reply(425, "Use PASV or EPSV first");
+		return;
+	}
+
+	StartReply(150).Append("Opening BINARY mode data connection (").AppendInt(File.Size - StartOffset).Append(" bytes)");
+	SendReply();
+
+	// 캐시 페이지를 복사 없이 그대로 보낸다 - 미스일 때만 디스크를 읽는다
+	TUniquePtr<FFtpReadCacheFile> Reader;
+	int64 Offset = StartOffset;
+	bool bSuccess = true;
+	while (Offset < File.Size)
+	{
+		const FFtpReadCache::FPage Page = Cache.GetPage(File, Offset / FFtpReadCache::PageSize, Reader);
+		const int64 InPage = Offset % FFtpReadCache::PageSize;
+		if (!Page.IsValid() || InPage >= Page->Num() || !SendAll(DataSocket, Page->GetData() + InPage, Page->Num() - InPage))
+		{
+			bSuccess = false;
+			break;
+		}
+		Offset += Page->Num() - InPage;
+	}
+
+	FtpServerInternal::DestroySocket(DataSocket);
+	INC_FLOAT_STAT_BY(STAT_FileUpLoad_ServerMegabytesSent, (Offset - StartOffset) / (1024.0 * 1024.0));
+	TRACE_COUNTER_ADD(FtpServerBytesSent, Offset - StartOffset);
+
+	if (bSuccess)
+	{
+		Reply(226, "Transfer complete");
+	}
+	else
+	{
+		Reply(426, "Transfer aborted");
+	}
+}
+
+void FFtpServerSession::HandleStor(const FString& Argument)
+{
+	FTP_TRACE_SCOPE(ServerStor);
+
+	const int64 StartOffset = RestartOffset;
+	RestartOffset = 0;
+
+	if (!Vfs->HasPermission(EFtpVfsPermission::Write))
+	{
+		Reply(550, "Permission denied");
+		return;
+	}
+	if (StartOffset != 0)
+	{
+		Reply(554, "REST is not supported for STOR");
+		return;
+	}
+
+	const FFtpVfsEntry* Entry = Vfs->Resolve(Argument);
+	if (Entry == nullptr || Entry->bIsDirectory || Entry->LogicalPath == TEXT("/") || !FPaths::DirectoryExists(FPaths::GetPath(Entry->LocalPath)))
+	{
+		Reply(553, "Cannot store to that name");
+		return;
+	}
+
+	// 세션 캐시를 건드리기 전에 복사
+	const FString LogicalPath = Entry->LogicalPath;
+	const FString FinalPath = Entry->LocalPath;
+	const FString TempPath = FFtpIngestCommitter::MakeTempPath(FinalPath);
+
+	FSocket* DataSocket = AcceptDataConnection();
+	if (DataSocket == nullptr)
+	{
+		Reply(425, "Use PASV or EPSV first");
+		return;
+	}
+
+	Reply(150, "Ok to send data");
+
+	// 받는 동안 디스크 쓰기는 풀 스레드가 한다 - 수신 루프는 복사만 하고 다음 데이터를 읽는다
+	FFtpAsyncFileWriter Writer;
+	bool bSuccess = Writer.Open(TempPath);
+	FFtpPooledBuffer ReceiveBuffer = FFtpBufferPool::Acquire(FtpServerInternal::ReceiveChunkSize);
+	while (bSuccess)
+	{
+		if (Server.IsStopping())
+		{
+			bSuccess = false;
+			break;
+		}
+		if (!DataSocket->Wait(ESocketWaitConditions::WaitForRead, FtpServerInternal::PollInterval))
+		{
+			continue;
+		}
+
+		// 스트림 모드에서는 상대가 데이터 연결을 정상적으로 닫는 것이 파일의 끝이다.
+		// 끊김이나 리셋은 잘린 파일이므로 커밋하지 않고 451로 답한다
+		int32 BytesRead = 0;
+		if (!DataSocket->Recv(ReceiveBuffer.GetData(), ReceiveBuffer.GetSize(), BytesRead))
+		{
+			const ESocketErrors Error = FtpServerInternal::GetSocketSubsystem()->GetLastErrorCode();
+			if (Error == SE_EWOULDBLOCK)
+			{
+				continue;
+			}
+			// 엔진 스트림 소켓은 정상 종료(recv가 0)도 오류 코드 없이 false로 알린다
+			bSuccess = Error == SE_NO_ERROR;
+			break;
+		}
+		if (BytesRead == 0)
+		{
+			break;
+		}
+		Writer.Append(ReceiveBuffer.GetData(), BytesRead);
+	}
+	FtpServerInternal::DestroySocket(DataSocket);
+	ReceiveBuffer.Release();
+
+	const int64 Received = Writer.GetBytesWritten();
+	bSuccess = Writer.Close() && bSuccess;
+	INC_FLOAT_STAT_BY(STAT_FileUpLoad_ServerMegabytesReceived, Received / (1024.0 * 1024.0));
+	TRACE_COUNTER_ADD(FtpServerBytesReceived, Received);
+
+	// 다른 세션의 파일과 함께 sync된 뒤 제자리로 옮겨져야 성공으로 답한다
+	bSuccess = bSuccess && Server.GetIngestCommitter().Commit(TempPath, FinalPath);
+	if (!bSuccess)
+	{
+		FPlatformFileManager::Get().GetPlatformFile().DeleteFile(*TempPath);
+	}
+
+	Server.GetReadCache().Invalidate(FinalPath);
+	Vfs->Invalidate(LogicalPath);
+
+	if (bSuccess)
+	{
+		Reply(226, "Transfer complete");
+	}
+	else
+	{
+		Reply(451, "Transfer failed");
+	}
+}
+
+void FFtpServerSession::HandleMakeDirectory(const FString& Argument)
+{
+	if (!Vfs->HasPermission(EFtpVfsPermission::Write))
+	{
+		Reply(550, "Permission denied");
+		return;
+	}
+
+	const FFtpVfsEntry* Entry = Vfs->Resolve(Argument);
+	if (Entry == nullptr || Entry->bExists)
+	{
+		Reply(550, "Cannot create directory");
+		return;
+	}
+
+	const FString LogicalPath = Entry->LogicalPath;
+	if (!FPlatformFileManager::Get().GetPlatformFile().CreateDirectory(*Entry->LocalPath))
+	{
+		Reply(550, "Cannot create directory");
+		return;
+	}
+
+	Vfs->Invalidate(LogicalPath);
+	StartReply(257).Append('"').AppendUtf8(LogicalPath).Append("\" created");
+	SendReply();
+}
+
+void FFtpServerSession::HandleDelete(const FString& Argument)
+{
+	if (!Vfs->HasPermission(EFtpVfsPermission::Delete))
+	{
+		Reply(550, "Permission denied");
+		return;
+	}
+
+	const FFtpVfsEntry* Entry = Vfs->Resolve(Argument);
+	if (Entry == nullptr || !Entry->bExists || Entry->bIsDirectory)
+	{
+		Reply(550, "No such file");
+		return;
+	}
+
+	const FString LogicalPath = Entry->LogicalPath;
+	const FString LocalPath = Entry->LocalPath;
+	if (!FPlatformFileManager::Get().GetPlatformFile().DeleteFile(*LocalPath))
+	{
+		Reply(450, "Delete failed");
+		return;
+	}
+
+	Server.GetReadCache().Invalidate(LocalPath);
+	Vfs->Invalidate(LogicalPath);
+	Reply(250, "File deleted");
+}
+
+void FFtpServerSession::HandleRenameFrom(const FString& Argument)
+{
+	if (!Vfs->HasPermission(EFtpVfsPermission::Write))
+	{
+		Reply(550, "Permission denied");
+		return;
+	}
+
+	const FFtpVfsEntry* Entry = Vfs->Resolve(Argument);
+	if (Entry == nullptr || !Entry->bExists || Entry->bIsDirectory)
+	{
+		Reply(550, "No such file");
+		return;
+	}
+
+	RenameFromLogical = Entry->LogicalPath;
+	RenameFromLocal = Entry->LocalPath;
+	Reply(350, "Ready for RNTO");
+}
+
+void FFtpServerSession::HandleRenameTo(const FString& Argument)
+{
+	const FString FromLogical = MoveTemp(RenameFromLogical);
+	const FString FromLocal = MoveTemp(RenameFromLocal);
+	RenameFromLogical.Reset();
+	RenameFromLocal.Reset();
+
+	if (FromLocal.IsEmpty())
+	{
+		Reply(503, "RNFR required first");
+		return;
+	}
+
+	const FFtpVfsEntry* Entry = Vfs->Resolve(Argument);
+	if (Entry == nullptr || (Entry->bExists && Entry->bIsDirectory))
+	{
+		Reply(553, "Invalid target name");
+		return;
+	}
+
+	// 대상이 있으면 한 번에 바꾼다 - 클라이언트는 임시 이름으로 올린 뒤 이것으로 게시한다
+	const FString ToLogical = Entry->LogicalPath;
+	const FString ToLocal = Entry->LocalPath;
+	if (!FFtpIngestCommitter::ReplaceFile(FromLocal, ToLocal))
+	{
+		Reply(550, "Rename failed");
+		return;
+	}
+
+	Server.GetReadCache().Invalidate(FromLocal);
+	Server.GetReadCache().Invalidate(ToLocal);
+	Vfs->Invalidate(FromLogical);
+	Vfs->Invalidate(ToLogical);
+	Reply(250, "Rename successful");
+}
+
+FFtpServer::FFtpServer(const FFtpServerConfig& InConfig)
+	: Config(InConfig)
+	, ReadCache(MakeUnique<FFtpReadCache>(InConfig.CacheBytes))
+	, IngestCommitter(MakeUnique<FFtpIngestCommitter>())
+	, ReadyEvent(FPlatformProcess::GetSynchEventFromPool(false))
+	, bRunning(false)
+	, bStopping(false)
+	, NumSessions(0)
+{
+	Config.RootDirectory = FPaths::ConvertRelativePathToFull(Config.RootDirectory);
+}
+
+FFtpServer::~FFtpServer()
+{
+	Stop();
+	FPlatformProcess::ReturnSynchEventToPool(ReadyEvent);
+}
+
+bool FFtpServer::Start()
+{
+	using namespace FtpServerInternal;
+
+	if (bRunning)
+	{
+		return true;
+	}
+
+	EnsureFtpSystemInitialized();
+
+	if (!FPaths::DirectoryExists(Config.RootDirectory))
+	{
+		LogFtpMessage(FString::Printf(TEXT("Server root does not exist: %s"), *Config.RootDirectory), true);
+		return false;
+	}
+
+	TSharedRef<FInternetAddr> Addr = GetSocketSubsystem()->CreateInternetAddr();
+	bool bValidAddress = false;
+	Addr->SetIp(*Config.BindAddress, bValidAddress);
+	if (!bValidAddress)
+	{
+		LogFtpMessage(FString::Printf(TEXT("Invalid server bind address: %s"), *Config.BindAddress), true);
+		return false;
+	}
+	Addr->SetPort(Config.Port);
+
+	// 평문 인증이므로 루프백 밖으로 열 때는 기본 계정이 남아 있으면 거부한다
+	if (!IsLoopbackAddress(*Addr))
+	{
+		for (const FFtpUserConfig& User : GFtpUsers)
+		{
+			if (HasBuiltInCredentials(User))
+			{
+				LogFtpMessage(FString::Printf(TEXT("Refusing to listen on %s with built-in account '%s'; change its password or bind to 127.0.0.1"),
+					*Config.BindAddress, *User.Username), true);
+				return false;
+			}
+		}
+	}
+
+	ListenSocket = GetSocketSubsystem()->CreateSocket(NAME_Stream, TEXT("FtpServerListen"), Addr->GetProtocolType());
+	if (ListenSocket == nullptr)
+	{
+		LogFtpMessage(TEXT("Cannot create server socket"), true);
+		return false;
+	}
+
+	ListenSocket->SetReuseAddr(true);
+	if (!ListenSocket->Bind(*Addr) || !ListenSocket->Listen(128))
+	{
+		LogFtpMessage(FString::Printf(TEXT("Cannot listen on port %d"), Config.Port), true);
+		DestroySocket(ListenSocket);
+		return false;
+	}
+
+	BoundPort = ListenSocket->GetPortNo();
+	IngestCommitter->Start();
+	bStopping = false;
+	bRunning = true;
+	AcceptFuture = Async(EAsyncExecution::Thread, [this]()
+	{
+		AcceptLoop();
+	});
+	for (int32 Index = 0; Index < FMath::Max(Config.WorkerThreads, 1); ++Index)
+	{
+		WorkerFutures.Add(Async(EAsyncExecution::Thread, [this]()
+		{
+			WorkerLoop();
+		}));
+	}
+
+	LogFtpMessage(FString::Printf(TEXT("Server listening on %s:%d, root %s, cache %lld MB, %d workers"),
+		*Config.BindAddress, BoundPort, *Config.RootDirectory, Config.CacheBytes / (1024 * 1024), FMath::Max(Config.WorkerThreads, 1)));
+	return true;
+}
+
+void FFtpServer::Stop()
+{
+	if (!bRunning)
+	{
+		return;
+	}
+
+	bStopping = true;
+	if (AcceptFuture.IsValid())
+	{
+		AcceptFuture.Wait();
+	}
+	FtpServerInternal::DestroySocket(ListenSocket);
+
+	// 작업 스레드는 손에 든 명령을 끝내고(전송은 종료 플래그를 보고 멈춘다) 빠져나온다
+	ReadyEvent->Trigger();
+	for (TFuture<void>& WorkerFuture : WorkerFutures)
+	{
+		WorkerFuture.Wait();
+	}
+	WorkerFutures.Reset();
+
+	// 반응 스레드가 끝난 뒤 돌아온 세션과 아직 처리되지 않은 세션을 닫는다
+	FFtpServerSession* Session = nullptr;
+	while (ReturnedSessions.Dequeue(Session))
+	{
+		DestroySession(Session);
+	}
+	while (ReadySessions.Dequeue(Session))
+	{
+		DestroySession(Session);
+	}
+	IngestCommitter->Stop();
+
+	bRunning = false;
+	LogFtpMessage(TEXT("Server stopped"));
+}
+
+void FFtpServer::DestroySession(FFtpServerSession* Session)
+{
+	delete Session;
+	DEC_DWORD_STAT(STAT_FileUpLoad_ServerSessions);
+	TRACE_COUNTER_DECREMENT(FtpServerSessions);
+	--NumSessions;
+}
+
+void FFtpServer::AcceptLoop()
+{
+	// 쉬는 세션은 스레드를 잡지 않는다 - 이 스레드가 모두 훑어 명령이 온 세션만 작업 스레드에 넘긴다
+	// (엔진 소켓에는 여러 소켓을 한 번에 기다리는 API가 없어 리슨 소켓을 기다리는 사이사이 훑는다.
+	// 조용할 때는 기다리는 시간을 늘려 세션이 많아도 헛돌지 않는다)
+	TArray<FFtpServerSession*> IdleSessions;
+	double LastIdleCheck = FPlatformTime::Seconds();
+	FTimespan WaitInterval = FtpServerInternal::ReactorMinInterval;
+
+	while (!bStopping)
+	{
+		bool bActivity = false;
+		bool bPending = false;
+		if (ListenSocket->WaitForPendingConnection(bPending, WaitInterval) && bPending)
+		{
+			bActivity = true;
+			if (FSocket* ControlSocket = ListenSocket->Accept(TEXT("FtpServerControl")))
+			{
+				if (NumSessions.Load() >= Config.MaxSessions)
+				{
+					// 클라이언트의 동시 전송 수 조절기가 421을 보고 줄인다
+					const ANSICHAR Busy[] = "421 Too many connections\r\n";
+					int32 BytesSent = 0;
+					ControlSocket->Send((const uint8*)Busy, sizeof(Busy) - 1, BytesSent);
+					FtpServerInternal::DestroySocket(ControlSocket);
+				}
+				else
+				{
+					++NumSessions;
+					INC_DWORD_STAT(STAT_FileUpLoad_ServerSessions);
+					TRACE_COUNTER_INCREMENT(FtpServerSessions);
+
+					FFtpServerSession* Session = new FFtpServerSession(*this, ControlSocket);
+					Session->Begin();
+					IdleSessions.Add(Session);
+				}
+			}
+		}
+
+		// 작업 스레드가 명령을 끝내고 돌려준 세션
+		FFtpServerSession* Returned = nullptr;
+		while (ReturnedSessions.Dequeue(Returned))
+		{
+			// 방금 명령을 끝낸 세션은 곧 다음 명령이 올 가능성이 크다
+			IdleSessions.Add(Returned);
+			bActivity = true;
+		}
+
+		const double Now = FPlatformTime::Seconds();
+		const bool bCheckIdle = Now - LastIdleCheck >= FtpServerInternal::PollInterval.GetTotalSeconds();
+		if (bCheckIdle)
+		{
+			LastIdleCheck = Now;
+		}
+
+		bool bQueued = false;
+		for (int32 Index = IdleSessions.Num() - 1; Index >= 0; --Index)
+		{
+			FFtpServerSession* Session = IdleSessions[Index];
+			if (Session->HasDeferredReply())
+			{
+				// 로그인 실패 응답을 기다리는 세션은 그 시각이 지나야 작업 스레드로 간다
+				if (Now >= Session->GetDeferredUntil())
+				{
+					IdleSessions.RemoveAtSwap(Index);
+					ReadySessions.Enqueue(Session);
+					bQueued = true;
+				}
+			}
+			else if (Session->IsReadable())
+			{
+				IdleSessions.RemoveAtSwap(Index);
+				ReadySessions.Enqueue(Session);
+				bQueued = true;
+			}
+			else if (bCheckIdle && Session->CheckIdleTimeout(Now))
+			{
+				IdleSessions.RemoveAtSwap(Index);
+				DestroySession(Session);
+			}
+		}
+		if (bQueued)
+		{
+			ReadyEvent->Trigger();
+		}
+
+		WaitInterval = bQueued || bActivity
+			? FtpServerInternal::ReactorMinInterval
+			: FMath::Min(WaitInterval * 2, FtpServerInternal::ReactorMaxInterval);
+	}
+
+	for (FFtpServerSession* Session : IdleSessions)
+	{
+		DestroySession(Session);
+	}
+}
+
+void FFtpServer::WorkerLoop()
+{
+	while (!bStopping)
+	{
+		FFtpServerSession* Session = nullptr;
+		bool bMoreReady = false;
+		{
+			// 생산자는 반응 스레드 하나, 소비자는 이 잠금으로 한 번에 하나
+			FScopeLock ScopeLock(&ReadyLock);
+			ReadySessions.Dequeue(Session);
+			bMoreReady = !ReadySessions.IsEmpty();
+		}
+
+		if (Session == nullptr)
+		{
+			ReadyEvent->Wait(FtpServerInternal::PollInterval);
+			continue;
+		}
+
+		// 자동 리셋 이벤트라 한 번의 신호로 하나만 깨어난다 - 남은 세션이 있으면 다음 작업 스레드를 깨운다
+		if (bMoreReady)
+		{
+			ReadyEvent->Trigger();
+		}
+
+		if (Session->Pump())
+		{
+			ReturnedSessions.Enqueue(Session);
+		}
+		else
+		{
+			DestroySession(Session);
+		}
+	}
+	// 다른 작업 스레드도 종료 플래그를 보도록 신호를 넘긴다
+	ReadyEvent->Trigger();
+}
@@ -0,0 +1,647 @@
+#include "FtpSyncCommandlet.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/Parse.h"
+#include "HAL/PlatformTime.h"
+#include "FtpSystem.h"
+#include "FtpFanOutUpload.h"
+#include "FtpIntegrity.h"
+#include "FtpContentStore.h"
+#include "FtpDelta.h"
+#include "FtpTransferHistory.h"
+#include "FtpTransferPlan.h"
+#include "FtpChangeDiscovery.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "FtpServer.h"
+#include "FtpReadCache.h"
+#include "FtpLoadGenerator.h"
+#include "FtpDerivedDataStore.h"
+#include "FileUpLoad.h"
+#include "Modules/ModuleManager.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformProcess.h"
+
+namespace FtpSyncCommandlet
+{
+	enum EExitCode : int32
+	{
+		Success = 0,
+		InvalidJobSpec = 1,
+		TransferFailed = 2,
+		JobAborted = 3
+	};
+
+	// 상대 경로는 프로젝트 디렉토리 기준
+	static FString ResolveLocalPath(const FString& Path)
+	{
+		return FPaths::IsRelative(Path) ? FPaths::ProjectDir() / Path : Path;
+	}
+
+	// "Cache" 잡의 완료 함수들이 작업 스레드에서 채운다 - 기다림이 시간을 넘겨도 살아 있도록 공유한다
+	struct FCacheJobState
+	{
+		FCriticalSection Lock;
+		TArray<FString> GetFiles;
+		int32 Outstanding = 0;
+		int32 Succeeded = 0;
+		int32 Failed = 0;
+		int32 Missed = 0;
+	};
+
+	// [{ "Key": ..., "File": ... }] 목록
+	static bool ReadCacheEntries(const FJsonObject& Job, const TCHAR* Field, TArray<TPair<FString, FString>>& OutEntries)
+	{
+		const TArray<TSharedPtr<FJsonValue>>* Entries = nullptr;
+		if (!Job.TryGetArrayField(Field, Entries))
+		{
+			return true;
+		}
+		for (const TSharedPtr<FJsonValue>& Value : *Entries)
+		{
+			const TSharedPtr<FJsonObject>* Entry = nullptr;
+			FString Key;
+			FString File;
+			if (!Value.IsValid() || !Value->TryGetObject(Entry) || !(*Entry)->TryGetStringField(TEXT("Key"), Key) || !(*Entry)->TryGetStringField(TEXT("File"), File))
+			{
+				UE_LOG(LogTemp, Error, TEXT("FtpSync: \"%s\" entries need \"Key\" and \"File\""), Field);
+				return false;
+			}
+			OutEntries.Emplace(MoveTemp(Key), ResolveLocalPath(File));
+		}
+		return true;
+	}
+
+	// 빌드 산출물을 공유 파생 데이터 저장소(-FtpDerivedData=)에 넣고("Put") 꺼낸다("Get"). 미스는 실패로 세지 않는다
+	static FFtpSyncStats RunCacheJob(const FJsonObject& Job)
+	{
+		FFtpSyncStats Stats;
+
+		TArray<TPair<FString, FString>> PutEntries;
+		TArray<TPair<FString, FString>> GetEntries;
+		if (!ReadCacheEntries(Job, TEXT("Put"), PutEntries) || !ReadCacheEntries(Job, TEXT("Get"), GetEntries))
+		{
+			return FFtpSyncStats::Aborted();
+		}
+
+		FFtpDerivedDataStore* Store = FModuleManager::LoadModuleChecked<FFileUpLoadModule>(TEXT("FileUpLoad")).GetDerivedDataStore();
+		if (Store == nullptr)
+		{
+			UE_LOG(LogTemp, Error, TEXT("FtpSync: Cache jobs need -FtpDerivedData=<job spec.json> on the command line"));
+			return FFtpSyncStats::Aborted();
+		}
+
+		TSharedRef<FCacheJobState, ESPMode::ThreadSafe> State = MakeShared<FCacheJobState, ESPMode::ThreadSafe>();
+
+		TArray<FFtpCachePutRequest> Puts;
+		for (TPair<FString, FString>& Entry : PutEntries)
+		{
+			FFtpCachePutRequest& Request = Puts.AddDefaulted_GetRef();
+			Request.Key = MoveTemp(Entry.Key);
+			if (!FFileHelper::LoadFileToArray(Request.Data, *Entry.Value))
+			{
+				UE_LOG(LogTemp, Error, TEXT("FtpSync: cannot read %s for cache key %s"), *Entry.Value, *Request.Key);
+				Stats.FailCount++;
+				Puts.Pop();
+			}
+		}
+
+		TArray<FFtpCacheGetRequest> Gets;
+		for (TPair<FString, FString>& Entry : GetEntries)
+		{
+			FFtpCacheGetRequest& Request = Gets.AddDefaulted_GetRef();
+			Request.Key = MoveTemp(Entry.Key);
+			Request.UserData = State->GetFiles.Add(MoveTemp(Entry.Value));
+		}
+		State->Outstanding = Puts.Num() + Gets.Num();
+
+		Store->Put(MoveTemp(Puts), [State](FFtpCachePutResponse&& Response)
+		{
+			if (Response.Status != EFtpCacheStatus::Ok)
+			{
+				UE_LOG(LogTemp, Error, TEXT("FtpSync: cache put failed for %s"), *Response.Key);
+			}
+			FScopeLock ScopeLock(&State->Lock);
+			(Response.Status == EFtpCacheStatus::Ok ? State->Succeeded : State->Failed)++;
+			State->Outstanding--;
+		});
+
+		Store->Get(MoveTemp(Gets), [State](FFtpCacheGetResponse&& Response)
+		{
+			const FString& File = State->GetFiles[(int32)Response.UserData];
+			bool bSucceeded = false;
+			if (Response.Status == EFtpCacheStatus::Ok)
+			{
+				bSucceeded = FFileHelper::SaveArrayToFile(Response.Data, *File);
+				if (!bSucceeded)
+				{
+					UE_LOG(LogTemp, Error, TEXT("FtpSync: cannot write %s for cache key %s"), *File, *Response.Key);
+				}
+			}
+			else if (Response.Status == EFtpCacheStatus::Miss)
+			{
+				UE_LOG(LogTemp, Display, TEXT("FtpSync: cache miss for %s"), *Response.Key);
+			}
+			else
+			{
+				UE_LOG(LogTemp, Error, TEXT("FtpSync: cache get failed for %s"), *Response.Key);
+			}
+
+			FScopeLock ScopeLock(&State->Lock);
+			if (Response.Status == EFtpCacheStatus::Miss)
+			{
+				State->Missed++;
+			}
+			else
+			{
+				(bSucceeded ? State->Succeeded : State->Failed)++;
+			}
+			State->Outstanding--;
+		});
+
+		double TimeoutSeconds = 600.0;
+		Job.TryGetNumberField(TEXT("Seconds"), TimeoutSeconds);
+		Store->WaitForPending(TimeoutSeconds);
+
+		FScopeLock ScopeLock(&State->Lock);
+		if (State->Outstanding > 0)
+		{
+			UE_LOG(LogTemp, Error, TEXT("FtpSync: %d cache request(s) still running after %.0f s"), State->Outstanding, TimeoutSeconds);
+		}
+		UE_LOG(LogTemp, Display, TEXT("FtpSync: cache %d succeeded, %d failed, %d missed"), State->Succeeded, State->Failed + State->Outstanding, State->Missed);
+		Stats.SuccessCount += State->Succeeded;
+		Stats.FailCount += State->Failed + State->Outstanding;
+		return Stats;
+	}
+}
+
+UFtpSyncCommandlet::UFtpSyncCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = true;
+	LogToConsole = true;
+	ShowErrorCount = true;
+
+	HelpDescription = TEXT("Runs FTP push/pull/mirror jobs from a JSON job spec without the editor UI");
+	HelpUsage = TEXT("UnrealEditor-Cmd <Project> -run=FtpSync -JobSpec=<path.json>");
+	HelpParamNames.Add(TEXT("JobSpec"));
+	HelpParamDescriptions.Add(TEXT("Path to the JSON job spec"));
+}
+
+int32 UFtpSyncCommandlet::Main(const FString& Params)
+{
+	using namespace FtpSyncCommandlet;
+
+	FString JobSpecPath;
+	if (!FParse::Value(*Params, TEXT("JobSpec="), JobSpecPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("FtpSync: -JobSpec=<path.json> is required"));
+		return InvalidJobSpec;
+	}
+
+	FString JsonText;
+	if (!FFileHelper::LoadFileToString(JsonText, *JobSpecPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("FtpSync: cannot read job spec %s"), *JobSpecPath);
+		return InvalidJobSpec;
+	}
+
+	TSharedPtr<FJsonObject> Spec;
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(JsonText);
+	if (!FJsonSerializer::Deserialize(Reader, Spec) || !Spec.IsValid())
+	{
+		UE_LOG(LogTemp, Error, TEXT("FtpSync: invalid JSON in %s"), *JobSpecPath);
+		return InvalidJobSpec;
+	}
+
+	FString User;
+	FString Pass;
+	const TArray<TSharedPtr<FJsonValue>>* Jobs = nullptr;
+	if (!Spec->TryGetStringField(TEXT("User"), User) || !Spec->TryGetStringField(TEXT("Password"), Pass) || !Spec->TryGetArrayField(TEXT("Jobs"), Jobs))
+	{
+		UE_LOG(LogTemp, Error, TEXT("FtpSync: job spec needs \"User\", \"Password\" and \"Jobs\""));
+		return InvalidJobSpec;
+	}
+
+	const TSharedPtr<FJsonObject>* ServerObject = nullptr;
+	if (Spec->TryGetObjectField(TEXT("Server"), ServerObject))
+	{
+		(*ServerObject)->TryGetStringField(TEXT("Address"), GServerAddress);
+		(*ServerObject)->TryGetNumberField(TEXT("Port"), GServerPort);
+		(*ServerObject)->TryGetNumberField(TEXT("MaxConnections"), GServerMaxConnections);
+	}
+
+	// 전송된 바이트는 이력 리스너로 집계
+	TAtomic<int64> TotalBytes(0);
+	FDelegateHandle HistoryHandle = FFtpTransferHistory::Get().AddListener(FFtpTransferHistory::FOnTransferRecorded::FDelegate::CreateLambda(
+		[&TotalBytes](const FFtpTransferRecord& Record)
+		{
+			if (Record.bSuccess && Record.Direction != EFtpTransferDirection::Verify)
+			{
+				TotalBytes += Record.Bytes;
+			}
+		}));
+
+	const double StartTime = FPlatformTime::Seconds();
+	int32 TotalSuccess = 0;
+	int32 TotalFail = 0;
+	int32 TotalPending = 0;
+	int32 ExitCode = Success;
+
+	for (int32 JobIndex = 0; JobIndex < Jobs->Num(); ++JobIndex)
+	{
+		const TSharedPtr<FJsonObject>* JobObject = nullptr;
+		if (!(*Jobs)[JobIndex].IsValid() || !(*Jobs)[JobIndex]->TryGetObject(JobObject))
+		{
+			UE_LOG(LogTemp, Error, TEXT("FtpSync: job %d is not an object"), JobIndex);
+			ExitCode = FMath::Max<int32>(ExitCode, InvalidJobSpec);
+			continue;
+		}
+
+		FString Type;
+		FString Local;
+		FString Remote;
+		(*JobObject)->TryGetStringField(TEXT("Type"), Type);
+		(*JobObject)->TryGetStringField(TEXT("Local"), Local);
+		(*JobObject)->TryGetStringField(TEXT("Remote"), Remote);
+		Local = ResolveLocalPath(Local);
+
+		// 업로드 후 서버 해시와 비교 (다시 내려받지 않음)
+		bool bVerify = false;
+		(*JobObject)->TryGetBoolField(TEXT("Verify"), bVerify);
+
+		// "Store"가 있으면 Remote 아래 콘텐츠 주소 저장소에 해당 이름의 스냅샷으로 올리고 받는다
+		FString StoreManifest;
+		(*JobObject)->TryGetStringField(TEXT("Store"), StoreManifest);
+
+		// 큰 파일은 서버 서명 기준 블록 델타로 보낸다
+		bool bDelta = false;
+		(*JobObject)->TryGetBoolField(TEXT("Delta"), bDelta);
+
+		// Plan 잡이 저장한 계획 파일 - Push에 주면 다시 비교하지 않고 계획대로만 올린다
+		FString PlanPath;
+		(*JobObject)->TryGetStringField(TEXT("Plan"), PlanPath);
+
+		// 에셋 레지스트리 기준과 소스 컨트롤 상태로 바뀐 파일만 찾아 올린다
+		bool bDiscover = false;
+		(*JobObject)->TryGetBoolField(TEXT("Discover"), bDiscover);
+
+		UE_LOG(LogTemp, Display, TEXT("FtpSync: job %d %s %s <-> %s"), JobIndex, *Type, *Local, *Remote);
+
+		// 계획/발견으로 올린 잡은 트리 전체가 아니라 올린 파일만 검증한다
+		const FDateTime JobStart = FDateTime::UtcNow();
+		TArray<FFtpVerifyRequest> UploadedFiles;
+		bool bVerifyUploadedOnly = false;
+
+		FFtpSyncStats Stats;
+		if (Type.Equals(TEXT("Plan"), ESearchCase::IgnoreCase))
+		{
+			bool bMirrorDeletes = false;
+			(*JobObject)->TryGetBoolField(TEXT("MirrorDeletes"), bMirrorDeletes);
+
+			FFtpTransferPlan Plan;
+			if (!FtpPlanner::BuildPlan(Local, Remote, GServerAddress, User, Pass, bMirrorDeletes, Plan))
+			{
+				Stats.bAborted = true;
+			}
+			else
+			{
+				UE_LOG(LogTemp, Display, TEXT("FtpSync: plan %s"), *FtpPlanner::DescribePlan(Plan));
+
+				FString OutputPath;
+				if ((*JobObject)->TryGetStringField(TEXT("Output"), OutputPath) && !FtpPlanner::SavePlan(Plan, ResolveLocalPath(OutputPath)))
+				{
+					UE_LOG(LogTemp, Error, TEXT("FtpSync: cannot write plan %s"), *OutputPath);
+					Stats.FailCount++;
+				}
+
+				// 예상 전송량 상한 - 넘으면 잡을 실패로 처리해 CI가 멈추게 한다
+				int64 MaxBytes = 0;
+				if ((*JobObject)->TryGetNumberField(TEXT("MaxBytes"), MaxBytes) && MaxBytes > 0 && Plan.BytesToTransfer > MaxBytes)
+				{
+					UE_LOG(LogTemp, Error, TEXT("FtpSync: plan would transfer %lld bytes, over the MaxBytes budget of %lld"), Plan.BytesToTransfer, MaxBytes);
+					Stats.FailCount++;
+				}
+			}
+		}
+		else if (Type.Equals(TEXT("Push"), ESearchCase::IgnoreCase) && !PlanPath.IsEmpty())
+		{
+			FFtpTransferPlan Plan;
+			if (!FtpPlanner::LoadPlan(ResolveLocalPath(PlanPath), Plan))
+			{
+				UE_LOG(LogTemp, Error, TEXT("FtpSync: cannot load plan %s"), *PlanPath);
+				ExitCode = FMath::Max<int32>(ExitCode, InvalidJobSpec);
+				continue;
+			}
+			Stats = FtpPlanner::ExecutePlan(Plan, Pass);
+
+			bVerifyUploadedOnly = true;
+			for (const FFtpPlanEntry& Entry : Plan.Entries)
+			{
+				if (Entry.Action == EFtpPlanAction::Create || Entry.Action == EFtpPlanAction::Update)
+				{
+					FFtpVerifyRequest& Request = UploadedFiles.AddDefaulted_GetRef();
+					Request.LocalPath = Plan.Files.GetFullPath(Entry.FileIndex);
+					Request.RemotePath = Plan.Files.GetRemotePath(Entry.FileIndex, Plan.RemoteRoot);
+					Request.UploadedAfter = JobStart;
+				}
+			}
+		}
+		else if (Type.Equals(TEXT("Push"), ESearchCase::IgnoreCase) && !StoreManifest.IsEmpty())
+		{
+			Stats = FtpContentStore::PushSnapshot(Local, Remote, StoreManifest, User, Pass);
+		}
+		else if (Type.Equals(TEXT("Push"), ESearchCase::IgnoreCase) && bDiscover)
+		{
+			// 트리를 훑지 않고 레지스트리 기준/소스 컨트롤 열린 파일만 올린다
+			// 커맨드렛은 에디터처럼 레지스트리를 미리 채우지 않으므로 엔진 캐시로 한 번 채운다
+			IAssetRegistry::GetChecked().SearchAllAssets(true);
+			FFtpDiscoveryResult Discovery;
+			if (!FtpChangeDiscovery::DiscoverChanges(Local, Remote, EFtpDiscoverySource::AssetRegistry | EFtpDiscoverySource::SourceControl, Discovery))
+			{
+				ExitCode = FMath::Max<int32>(ExitCode, InvalidJobSpec);
+				continue;
+			}
+			Stats = FtpChangeDiscovery::UploadChanges(Discovery, Remote, GServerAddress, User, Pass);
+
+			bVerifyUploadedOnly = true;
+			const int32 NumDiscovered = Discovery.Files.IsValid() ? Discovery.Files->Num() : 0;
+			for (int32 FileIndex = 0; FileIndex < NumDiscovered; ++FileIndex)
+			{
+				FFtpVerifyRequest& Request = UploadedFiles.AddDefaulted_GetRef();
+				Request.LocalPath = Discovery.Files->GetFullPath(FileIndex);
+				Request.RemotePath = Discovery.Files->GetRemotePath(FileIndex, Remote);
+				Request.UploadedAfter = JobStart;
+			}
+		}
+		else if (Type.Equals(TEXT("Push"), ESearchCase::IgnoreCase) && bDelta)
+		{
+			Stats = FtpDelta::UploadFolder(Local, Remote, User, Pass);
+		}
+		else if (Type.Equals(TEXT("Push"), ESearchCase::IgnoreCase))
+		{
+			// 먼저 보낼 레벨/패키지 ("/Game/Maps/Arena")
+			TArray<FName> PriorityPackages;
+			const TArray<TSharedPtr<FJsonValue>>* Priority = nullptr;
+			if ((*JobObject)->TryGetArrayField(TEXT("Priority"), Priority))
+			{
+				for (const TSharedPtr<FJsonValue>& Value : *Priority)
+				{
+					FString PackageName;
+					if (Value.IsValid() && Value->TryGetString(PackageName))
+					{
+						PriorityPackages.Add(FName(*PackageName));
+					}
+				}
+			}
+			Stats = UploadToFtpServer(Local, Remote, GServerAddress, User, Pass, PriorityPackages);
+		}
+		else if (Type.Equals(TEXT("Serve"), ESearchCase::IgnoreCase))
+		{
+			// 서버 호스트에서 Local을 루트로 내장 FTP 서버를 띄운다 (Seconds가 0이면 프로세스가 끝날 때까지)
+			FFtpServerConfig ServerConfig;
+			ServerConfig.RootDirectory = Local;
+			(*JobObject)->TryGetStringField(TEXT("BindAddress"), ServerConfig.BindAddress);
+			(*JobObject)->TryGetNumberField(TEXT("Port"), ServerConfig.Port);
+			(*JobObject)->TryGetNumberField(TEXT("MaxSessions"), ServerConfig.MaxSessions);
+			(*JobObject)->TryGetNumberField(TEXT("WorkerThreads"), ServerConfig.WorkerThreads);
+			int64 CacheMB = 0;
+			if ((*JobObject)->TryGetNumberField(TEXT("CacheMB"), CacheMB) && CacheMB > 0)
+			{
+				ServerConfig.CacheBytes = CacheMB * 1024 * 1024;
+			}
+			double ServeSeconds = 0.0;
+			(*JobObject)->TryGetNumberField(TEXT("Seconds"), ServeSeconds);
+
+			FFtpServer FtpServer(ServerConfig);
+			if (!FtpServer.Start())
+			{
+				Stats.bAborted = true;
+			}
+			else
+			{
+				const double ServeStart = FPlatformTime::Seconds();
+				while (ServeSeconds <= 0.0 || FPlatformTime::Seconds() - ServeStart < ServeSeconds)
+				{
+					FPlatformProcess::Sleep(1.0f);
+				}
+				FtpServer.Stop();
+
+				const FFtpReadCache& Cache = FtpServer.GetReadCache();
+				UE_LOG(LogTemp, Display, TEXT("FtpSync: served with %llu cache hits, %llu misses"), Cache.GetHits(), Cache.GetMisses());
+			}
+		}
+		else if (Type.Equals(TEXT("Load"), ESearchCase::IgnoreCase))
+		{
+			// 많은 클라이언트로 FTP 서버에 부하를 걸고 명령별 지연을 기준과 비교한다
+			FFtpLoadConfig LoadConfig;
+			LoadConfig.User = User;
+			LoadConfig.Password = Pass;
+			(*JobObject)->TryGetStringField(TEXT("Host"), LoadConfig.Host);
+			(*JobObject)->TryGetNumberField(TEXT("Port"), LoadConfig.Port);
+			(*JobObject)->TryGetNumberField(TEXT("Clients"), LoadConfig.Clients);
+			(*JobObject)->TryGetNumberField(TEXT("Workers"), LoadConfig.Workers);
+			(*JobObject)->TryGetNumberField(TEXT("Seconds"), LoadConfig.DurationSeconds);
+			(*JobObject)->TryGetNumberField(TEXT("Files"), LoadConfig.NumFiles);
+			double ThinkMs = 0.0;
+			if ((*JobObject)->TryGetNumberField(TEXT("ThinkMs"), ThinkMs))
+			{
+				LoadConfig.ThinkTimeSeconds = FMath::Max(ThinkMs, 0.0) / 1000.0;
+			}
+			int32 FileKB = 0;
+			if ((*JobObject)->TryGetNumberField(TEXT("FileKB"), FileKB) && FileKB > 0)
+			{
+				LoadConfig.FileBytes = FileKB * 1024;
+			}
+			int32 StorKB = 0;
+			if ((*JobObject)->TryGetNumberField(TEXT("StorKB"), StorKB) && StorKB > 0)
+			{
+				LoadConfig.StorBytes = StorKB * 1024;
+			}
+			const TSharedPtr<FJsonObject>* MixObject = nullptr;
+			if ((*JobObject)->TryGetObjectField(TEXT("Mix"), MixObject))
+			{
+				double Weight = 0.0;
+				LoadConfig.LoginWeight = (*MixObject)->TryGetNumberField(TEXT("Login"), Weight) ? (float)Weight : 0.0f;
+				LoadConfig.ListWeight = (*MixObject)->TryGetNumberField(TEXT("List"), Weight) ? (float)Weight : 0.0f;
+				LoadConfig.StorWeight = (*MixObject)->TryGetNumberField(TEXT("Stor"), Weight) ? (float)Weight : 0.0f;
+				LoadConfig.RetrWeight = (*MixObject)->TryGetNumberField(TEXT("Retr"), Weight) ? (float)Weight : 0.0f;
+				LoadConfig.SizeWeight = (*MixObject)->TryGetNumberField(TEXT("Size"), Weight) ? (float)Weight : 0.0f;
+			}
+
+			// "Local"이 있으면 그 디렉토리로 같은 프로세스에 서버를 띄워 루프백으로 건다 (서버 메모리/세션도 잰다)
+			TUniquePtr<FFtpServer> LoadServer;
+			if ((*JobObject)->HasField(TEXT("Local")))
+			{
+				IFileManager::Get().MakeDirectory(*Local, true);
+				FFtpServerConfig ServerConfig;
+				ServerConfig.RootDirectory = Local;
+				ServerConfig.Port = 0;
+				ServerConfig.MaxSessions = LoadConfig.Clients + LoadConfig.Workers + 16;
+				(*JobObject)->TryGetNumberField(TEXT("MaxSessions"), ServerConfig.MaxSessions);
+				(*JobObject)->TryGetNumberField(TEXT("WorkerThreads"), ServerConfig.WorkerThreads);
+				int64 CacheMB = 0;
+				if ((*JobObject)->TryGetNumberField(TEXT("CacheMB"), CacheMB) && CacheMB > 0)
+				{
+					ServerConfig.CacheBytes = CacheMB * 1024 * 1024;
+				}
+
+				LoadServer = MakeUnique<FFtpServer>(ServerConfig);
+				if (!LoadServer->Start())
+				{
+					Stats.bAborted = true;
+				}
+				LoadConfig.Host = TEXT("127.0.0.1");
+				LoadConfig.Port = LoadServer->GetPort();
+			}
+
+			FFtpLoadResult LoadResult;
+			if (!Stats.bAborted && !FtpLoadGenerator::Run(LoadConfig, LoadServer.Get(), LoadResult))
+			{
+				Stats.bAborted = true;
+			}
+			if (LoadServer.IsValid())
+			{
+				LoadServer->Stop();
+			}
+
+			if (!Stats.bAborted)
+			{
+				UE_LOG(LogTemp, Display, TEXT("FtpSync: load %s"), *FtpLoadGenerator::DescribeResult(LoadResult));
+				Stats.SuccessCount = 1;
+
+				FString OutputPath;
+				if ((*JobObject)->TryGetStringField(TEXT("Output"), OutputPath) && !FtpLoadGenerator::SaveResult(LoadResult, ResolveLocalPath(OutputPath)))
+				{
+					Stats.FailCount++;
+				}
+
+				// 기준 파일이 없거나 "WriteBaseline"이면 이번 결과를 기준으로 남긴다
+				FString BaselinePath;
+				if ((*JobObject)->TryGetStringField(TEXT("Baseline"), BaselinePath))
+				{
+					BaselinePath = ResolveLocalPath(BaselinePath);
+					bool bWriteBaseline = false;
+					(*JobObject)->TryGetBoolField(TEXT("WriteBaseline"), bWriteBaseline);
+
+					FFtpLoadResult Baseline;
+					if (bWriteBaseline || !FPaths::FileExists(BaselinePath))
+					{
+						FtpLoadGenerator::SaveResult(LoadResult, BaselinePath);
+						UE_LOG(LogTemp, Display, TEXT("FtpSync: wrote load baseline %s"), *BaselinePath);
+					}
+					else if (FtpLoadGenerator::LoadResult(BaselinePath, Baseline))
+					{
+						double Tolerance = 0.2;
+						(*JobObject)->TryGetNumberField(TEXT("Tolerance"), Tolerance);
+
+						TArray<FString> Regressions;
+						if (!FtpLoadGenerator::CompareWithBaseline(LoadResult, Baseline, Tolerance, Regressions))
+						{
+							for (const FString& Regression : Regressions)
+							{
+								UE_LOG(LogTemp, Error, TEXT("FtpSync: load regression: %s"), *Regression);
+							}
+							Stats.FailCount += Regressions.Num();
+						}
+					}
+					else
+					{
+						Stats.FailCount++;
+					}
+				}
+			}
+		}
+		else if (Type.Equals(TEXT("ApplyDeltas"), ESearchCase::IgnoreCase))
+		{
+			// 서버 호스트에서 FTP 루트(Local)를 대상으로 실행하는 패치 단계
+			Stats = FtpDelta::ApplyPendingDeltas(Local);
+		}
+		else if (Type.Equals(TEXT("Cache"), ESearchCase::IgnoreCase))
+		{
+			Stats = RunCacheJob(**JobObject);
+		}
+		else if (Type.Equals(TEXT("Pull"), ESearchCase::IgnoreCase) && !StoreManifest.IsEmpty())
+		{
+			Stats = FtpContentStore::PullSnapshot(Remote, StoreManifest, Local, User, Pass);
+		}
+		else if (Type.Equals(TEXT("Pull"), ESearchCase::IgnoreCase))
+		{
+			Stats = UploadFromFtpServer(Remote, Local, GServerAddress, User, Pass);
+		}
+		else if (Type.Equals(TEXT("Mirror"), ESearchCase::IgnoreCase))
+		{
+			const TArray<TSharedPtr<FJsonValue>>* Servers = nullptr;
+			if ((*JobObject)->TryGetArrayField(TEXT("Servers"), Servers))
+			{
+				TArray<FFtpServerProfile> Targets;
+				ParseFtpServerProfiles(*Servers, Targets);
+
+				TArray<FFtpFanOutTargetResult> Results;
+				FtpFanOut::UploadToFtpServers(Local, Remote, Targets, Results, 2, bVerify);
+				for (const FFtpFanOutTargetResult& Result : Results)
+				{
+					Stats.SuccessCount += Result.SuccessCount;
+					Stats.FailCount += Result.FailCount;
+				}
+			}
+			else
+			{
+				Stats = UploadFolderStructure(Local, Remote, GServerAddress, User, Pass);
+			}
+		}
+		else
+		{
+			UE_LOG(LogTemp, Error, TEXT("FtpSync: unknown job type \"%s\""), *Type);
+			ExitCode = FMath::Max<int32>(ExitCode, InvalidJobSpec);
+			continue;
+		}
+
+		// 팬아웃은 자체적으로 검증하므로 단일 서버 업로드만 여기서 검증
+		const bool bFannedOut = Type.Equals(TEXT("Mirror"), ESearchCase::IgnoreCase) && (*JobObject)->HasField(TEXT("Servers"));
+		if (bVerify && !Stats.bAborted && !Type.Equals(TEXT("Pull"), ESearchCase::IgnoreCase) && !bFannedOut && StoreManifest.IsEmpty() && !bDelta
+			&& !Type.Equals(TEXT("ApplyDeltas"), ESearchCase::IgnoreCase) && !Type.Equals(TEXT("Plan"), ESearchCase::IgnoreCase)
+			&& !Type.Equals(TEXT("Serve"), ESearchCase::IgnoreCase) && !Type.Equals(TEXT("Load"), ESearchCase::IgnoreCase)
+			&& !Type.Equals(TEXT("Cache"), ESearchCase::IgnoreCase))
+		{
+			int32 VerifyFailCount = 0;
+			if (bVerifyUploadedOnly)
+			{
+				TArray<FFtpVerifyOutcome> Outcomes;
+				VerifyFailCount = UploadedFiles.Num() > 0 ? FtpIntegrity::VerifyFiles(MakeDefaultServerProfile(User), UploadedFiles, Outcomes) : 0;
+				UE_LOG(LogTemp, Display, TEXT("FtpSync: verified %d uploaded files, %d failed"), UploadedFiles.Num(), VerifyFailCount);
+			}
+			else
+			{
+				VerifyFailCount = FtpIntegrity::VerifyFolder(Local, Remote, MakeDefaultServerProfile(User)).FailCount;
+			}
+			Stats.SuccessCount -= VerifyFailCount;
+			Stats.FailCount += VerifyFailCount;
+		}
+
+		TotalSuccess += Stats.SuccessCount;
+		TotalFail += Stats.FailCount;
+		TotalPending += Stats.PendingCount;
+
+		if (Stats.bAborted)
+		{
+			ExitCode = FMath::Max<int32>(ExitCode, JobAborted);
+		}
+		else if (Stats.FailCount > 0)
+		{
+			ExitCode = FMath::Max<int32>(ExitCode, TransferFailed);
+		}
+	}
+
+	FFtpTransferHistory::Get().RemoveListener(HistoryHandle);
+
+	const double Elapsed = FPlatformTime::Seconds() - StartTime;
+	const int64 Bytes = TotalBytes.Load();
+	UE_LOG(LogTemp, Display, TEXT("FtpSync: %d job(s), %d succeeded, %d pending apply, %d failed, %lld bytes in %.2fs (%.2f MB/s), exit code %d"),
+		Jobs->Num(), TotalSuccess, TotalPending, TotalFail, Bytes, Elapsed, Elapsed > 0.0 ? (Bytes / (1024.0 * 1024.0)) / Elapsed : 0.0, ExitCode);
+
+	return ExitCode;
+}
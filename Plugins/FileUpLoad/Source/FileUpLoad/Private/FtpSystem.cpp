@@ -0,0 +1,1204 @@
+#include "FtpSystem.h"
+#include "FileUpLoadStats.h"
+#include "FileUpLoadTrace.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/Paths.h"
+#include "Misc/FileHelper.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformFilemanager.h"
+#include "HAL/FileManager.h"
+#include "Containers/Set.h"
+#include "FtpTransferHistory.h"
+#include "FtpAsyncFileWriter.h"
+#include "FtpCurlProcess.h"
+#include "FtpConcurrency.h"
+#include "FtpPathTable.h"
+#include "FtpUploadOrder.h"
+#include "FtpIngestCommitter.h"
+#include "FtpTransferPlan.h"
+#include "Misc/SecureHash.h"
+#include "HAL/PlatformMisc.h"
+#include "Misc/Guid.h"
+
+#if PLATFORM_LINUX || PLATFORM_MAC
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#elif PLATFORM_WINDOWS
+#include "Windows/AllowWindowsPlatformTypes.h"
+#include <sddl.h>
+#include "Windows/HideWindowsPlatformTypes.h"
+#endif
+
+// 전역 변수들
+TArray<FFtpUserConfig> GFtpUsers;
+FFtpSecurityConfig GFtpSecurityConfig;
+FString GServerAddress = TEXT("192.168.0.35");
+int32 GServerPort = 21;
+int32 GServerMaxConnections = 8;
+static TMap<FString, int32> GLoginAttempts;
+static TMap<FString, FDateTime> GLockoutTimes;
+// 위 두 맵 - 게임 스레드와 백그라운드 계획/발견/업로드 작업이 동시에 로그인한다 (재진입 가능)
+static FCriticalSection GLoginLock;
+
+DECLARE_CYCLE_STAT(TEXT("InitializeFtpSystem"), STAT_FileUpLoad_InitializeFtpSystem, STATGROUP_FileUpLoad);
+
+// FTP 시스템 초기화 - 처음 사용할 때 한 번만 실행된다 (스레드 안전)
+void EnsureFtpSystemInitialized()
+{
+	static FCriticalSection InitLock;
+	static TAtomic<bool> bInitialized(false);
+
+	if (bInitialized)
+	{
+		return;
+	}
+
+	FScopeLock ScopeLock(&InitLock);
+	if (bInitialized)
+	{
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_FileUpLoad_InitializeFtpSystem);
+
+	// 기본 사용자 설정
+	FFtpUserConfig TestUser;
+	TestUser.Username = TEXT("test");
+	TestUser.Password = TEXT("test");
+	TestUser.HomeDirectory = TEXT("/test");
+	TestUser.Permissions = { TEXT("Read"), TEXT("Write"), TEXT("Delete") };
+	GFtpUsers.Add(TestUser);
+
+	FFtpUserConfig AdminUser;
+	AdminUser.Username = TEXT("admin");
+	AdminUser.Password = TEXT("admin");
+	AdminUser.HomeDirectory = TEXT("/admin");
+	AdminUser.Permissions = { TEXT("Read"), TEXT("Write"), TEXT("Delete"), TEXT("Admin") };
+	GFtpUsers.Add(AdminUser);
+
+	// 보안/서버 설정은 전역 변수의 기본값을 그대로 사용한다 (커맨드렛 등에서 덮어쓴 값을 되돌리지 않도록)
+
+	bInitialized = true;
+	UE_LOG(LogTemp, Log, TEXT("FTP System initialized successfully"));
+}
+
+// 로그 출력 함수
+void LogFtpMessage(const FString& Message, bool bIsError)
+{
+	if (GFtpSecurityConfig.EnableLogging)
+	{
+		if (bIsError)
+		{
+			UE_LOG(LogTemp, Error, TEXT("FTP System: %s"), *Message);
+		}
+		else
+		{
+			UE_LOG(LogTemp, Log, TEXT("FTP System: %s"), *Message);
+		}
+	}
+}
+
+// 비밀번호만 비교한다 - 시도 기록과 잠금을 건드리지 않는다
+bool CheckUserPassword(const FString& Username, const FString& Password)
+{
+	const FFtpUserConfig* User = GetUser(Username);
+	return User != nullptr && User->Password.Equals(Password, ESearchCase::CaseSensitive);
+}
+
+// 초기화가 넣는 기본 계정(test/test, admin/admin)을 그대로 쓰는지
+bool HasBuiltInCredentials(const FFtpUserConfig& User)
+{
+	return (User.Username.Equals(TEXT("test"), ESearchCase::IgnoreCase) && User.Password.Equals(TEXT("test")))
+		|| (User.Username.Equals(TEXT("admin"), ESearchCase::IgnoreCase) && User.Password.Equals(TEXT("admin")));
+}
+
+// 사용자 인증
+bool AuthenticateUser(const FString& Username, const FString& Password)
+{
+	FScopeLock ScopeLock(&GLoginLock);
+
+	// 계정 잠금 확인
+	if (IsUserLocked(Username))
+	{
+		LogFtpMessage(FString::Printf(TEXT("Login attempt on locked account: %s"), *Username), true);
+		return false;
+	}
+
+	FFtpUserConfig* User = GetUser(Username);
+	if (User == nullptr)
+	{
+		RecordLoginAttempt(Username, false, TEXT("unknown"));
+		return false;
+	}
+
+	bool bIsValid = User->Password.Equals(Password, ESearchCase::CaseSensitive);
+	RecordLoginAttempt(Username, bIsValid, TEXT("unknown"));
+
+	if (bIsValid)
+	{
+		// 성공 시 로그인 시도 횟수 초기화
+		GLoginAttempts.Remove(Username);
+		GLockoutTimes.Remove(Username);
+	}
+
+	return bIsValid;
+}
+
+// 사용자 정보 조회
+FFtpUserConfig* GetUser(const FString& Username)
+{
+	EnsureFtpSystemInitialized();
+
+	for (FFtpUserConfig& User : GFtpUsers)
+	{
+		if (User.Username.Equals(Username, ESearchCase::IgnoreCase))
+		{
+			return &User;
+		}
+	}
+	return nullptr;
+}
+
+// 사용자 권한 확인
+bool HasPermission(const FString& Username, const FString& Permission)
+{
+	FFtpUserConfig* User = GetUser(Username);
+	if (User == nullptr)
+		return false;
+
+	return User->Permissions.Contains(Permission);
+}
+
+// 로그인 시도 기록
+void RecordLoginAttempt(const FString& Username, bool bSuccess, const FString& IpAddress)
+{
+	FScopeLock ScopeLock(&GLoginLock);
+
+	if (!bSuccess)
+	{
+		int32* AttemptsPtr = GLoginAttempts.Find(Username);
+		int32 Attempts = AttemptsPtr ? *AttemptsPtr + 1 : 1;
+		GLoginAttempts.Add(Username, Attempts);
+		
+		LogFtpMessage(FString::Printf(TEXT("Login failed: %s from %s, attempts: %d"), *Username, *IpAddress, Attempts), true);
+
+		if (Attempts >= GFtpSecurityConfig.MaxLoginAttempts)
+		{
+			FDateTime LockoutTime = FDateTime::UtcNow() + FTimespan::FromSeconds(GFtpSecurityConfig.LockoutDuration);
+			GLockoutTimes.Add(Username, LockoutTime);
+			
+			LogFtpMessage(FString::Printf(TEXT("Account locked: %s until %s"), *Username, *LockoutTime.ToString()), true);
+		}
+	}
+	else
+	{
+		LogFtpMessage(FString::Printf(TEXT("Login successful: %s from %s"), *Username, *IpAddress), false);
+	}
+}
+
+// 사용자 잠금 확인
+bool IsUserLocked(const FString& Username)
+{
+	FScopeLock ScopeLock(&GLoginLock);
+
+	FDateTime* LockoutTimePtr = GLockoutTimes.Find(Username);
+	if (LockoutTimePtr)
+	{
+		if (FDateTime::UtcNow() < *LockoutTimePtr)
+		{
+			return true;
+		}
+		else
+		{
+			// 잠금 시간이 지났으면 잠금 해제
+			GLockoutTimes.Remove(Username);
+			GLoginAttempts.Remove(Username);
+		}
+	}
+
+	return false;
+}
+
+// 다운로드 출력을 기다리다 curl 종료 여부를 다시 보는 간격
+static constexpr uint32 DownloadPollIntervalMs = 100;
+
+// 한 번의 curl 호출로 보내는 최대 파일 수 - 제어 연결과 TLS 세션을 파일들 사이에서 재사용한다
+static constexpr int32 UploadBatchSize = 32;
+
+// curl 실행 파일
+FString GetCurlExecutable()
+{
+#if PLATFORM_WINDOWS
+	return TEXT("curl.exe");
+#else
+	return TEXT("/usr/bin/curl");
+#endif
+}
+
+// curl 설정 파일(-K) 값 이스케이프
+FString EscapeCurlConfigValue(const FString& Value)
+{
+	return Value.Replace(TEXT("\\"), TEXT("\\\\")).Replace(TEXT("\""), TEXT("\\\""));
+}
+
+// 자격 증명/배치 파일은 Saved/FileUpLoad/Private 아래에 둔다
+FString GetCurlPrivateDir()
+{
+	return FPaths::ProjectSavedDir() / TEXT("FileUpLoad") / TEXT("Private");
+}
+
+// 처음부터 소유자만 읽을 수 있는 파일로 만든다 - 이미 있으면 실패한다 (다른 사용자가 미리 만든 파일을 쓰지 않는다)
+static bool WriteOwnerOnlyFile(const FString& FilePath, const FString& Contents)
+{
+	const FTCHARToUTF8 Utf8(*Contents);
+	IFileManager::Get().MakeDirectory(*FPaths::GetPath(FilePath), true);
+
+#if PLATFORM_LINUX || PLATFORM_MAC
+	const int Fd = open(TCHAR_TO_UTF8(*FilePath), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, S_IRUSR | S_IWUSR);
+	if (Fd < 0)
+	{
+		return false;
+	}
+	const bool bWritten = write(Fd, Utf8.Get(), Utf8.Length()) == (ssize_t)Utf8.Length();
+	close(Fd);
+#elif PLATFORM_WINDOWS
+	// 상속 없이 소유자에게만 모든 권한을 주는 DACL
+	PSECURITY_DESCRIPTOR Descriptor = nullptr;
+	if (!::ConvertStringSecurityDescriptorToSecurityDescriptorW(L"D:P(A;;FA;;;OW)", SDDL_REVISION_1, &Descriptor, nullptr))
+	{
+		return false;
+	}
+	SECURITY_ATTRIBUTES Attributes = { sizeof(SECURITY_ATTRIBUTES), Descriptor, FALSE };
+	HANDLE Handle = ::CreateFileW(*FPaths::MakePlatformFilename(FilePath), GENERIC_WRITE, 0, &Attributes, CREATE_NEW, FILE_ATTRIBUTE_NORMAL, nullptr);
+	::LocalFree(Descriptor);
+	if (Handle == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	DWORD BytesWritten = 0;
+	const bool bWritten = ::WriteFile(Handle, Utf8.Get(), (DWORD)Utf8.Length(), &BytesWritten, nullptr) && BytesWritten == (DWORD)Utf8.Length();
+	::CloseHandle(Handle);
+#else
+	const bool bWritten = FFileHelper::SaveStringToFile(Contents, *FilePath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM);
+#endif
+
+	if (!bWritten)
+	{
+		IFileManager::Get().Delete(*FilePath, false, true, true);
+	}
+	return bWritten;
+}
+
+// 커널 TLS 오프로드 - OpenSSL 3의 Options = KTLS를 읽을 설정 파일. 비밀이 없으므로 한 번 써 두고 재사용한다
+static FString GetKernelTlsConfigPath()
+{
+#if PLATFORM_LINUX
+	static FCriticalSection KtlsLock;
+	static FString ConfigPath;
+
+	if (!GFtpSecurityConfig.bEnableKernelTls)
+	{
+		return FString();
+	}
+
+	FScopeLock ScopeLock(&KtlsLock);
+	if (ConfigPath.IsEmpty())
+	{
+		const FString Path = FPaths::ConvertRelativePathToFull(GetCurlPrivateDir() / TEXT("openssl-ktls.cnf"));
+		const FString Contents =
+			TEXT("openssl_conf = openssl_init\n")
+			TEXT("[openssl_init]\nssl_conf = ssl_sect\n")
+			TEXT("[ssl_sect]\nsystem_default = system_default_sect\n")
+			TEXT("[system_default_sect]\nOptions = KTLS\n");
+
+		if (FFileHelper::SaveStringToFile(Contents, *Path))
+		{
+			ConfigPath = Path;
+			LogFtpMessage(TEXT("Kernel TLS offload requested for curl (OPENSSL_CONF)"));
+		}
+	}
+	return ConfigPath;
+#else
+	return FString();
+#endif
+}
+
+void GetCurlLaunchCommand(const FString& Params, FString& OutExecutable, FString& OutParams)
+{
+	// OPENSSL_CONF는 curl 하위 프로세스의 환경에만 넣는다 - 에디터 프로세스의 OpenSSL 설정은 건드리지 않는다
+	const FString KtlsConfig = GetKernelTlsConfigPath();
+	if (!KtlsConfig.IsEmpty())
+	{
+		OutExecutable = TEXT("/usr/bin/env");
+		OutParams = FString::Printf(TEXT("\"OPENSSL_CONF=%s\" \"%s\" %s"), *KtlsConfig, *GetCurlExecutable(), *Params);
+		return;
+	}
+
+	OutExecutable = GetCurlExecutable();
+	OutParams = Params;
+}
+
+// 자격 증명 설정 파일 - 열린 세션 범위가 하나라도 있는 동안만 디스크에 남는다
+static FCriticalSection GCurlConfigLock;
+static TMap<FString, FString> GCurlConfigFiles;
+static TArray<FString> GCurlConfigPaths;
+static int32 GCurlSessionScopes = 0;
+
+FFtpCurlSessionScope::FFtpCurlSessionScope()
+{
+	FScopeLock ScopeLock(&GCurlConfigLock);
+	++GCurlSessionScopes;
+}
+
+FFtpCurlSessionScope::~FFtpCurlSessionScope()
+{
+	FScopeLock ScopeLock(&GCurlConfigLock);
+	if (--GCurlSessionScopes > 0)
+	{
+		return;
+	}
+
+	for (const FString& ConfigPath : GCurlConfigPaths)
+	{
+		IFileManager::Get().Delete(*ConfigPath, false, true, true);
+	}
+	GCurlConfigPaths.Reset();
+	GCurlConfigFiles.Reset();
+}
+
+// 자격 증명과 TLS 옵션을 담은 curl 설정 파일 인자 (-K)
+// 비밀번호를 명령줄(프로세스 목록)에 남기지 않으며, 세션 범위 안에서는 같은 내용이면 파일을 재사용한다
+FString BuildCurlSessionArgs(const FString& Username, const FString& Password, bool bUseFtps)
+{
+	FString Contents = FString::Printf(TEXT("user = \"%s:%s\"\n"), *EscapeCurlConfigValue(Username), *EscapeCurlConfigValue(Password));
+	if (bUseFtps)
+	{
+		// AUTH TLS로 제어 연결을 올리고 PROT P로 데이터 연결도 암호화 - 실패하면 평문으로 내려가지 않는다
+		Contents += TEXT("ssl-reqd\n");
+		if (!GFtpSecurityConfig.CaCertPath.IsEmpty())
+		{
+			Contents += FString::Printf(TEXT("cacert = \"%s\"\n"), *EscapeCurlConfigValue(GFtpSecurityConfig.CaCertPath));
+		}
+		if (!GFtpSecurityConfig.bVerifyPeer)
+		{
+			Contents += TEXT("insecure\n");
+		}
+	}
+
+	const FString Key = FMD5::HashAnsiString(*Contents);
+
+	FScopeLock ScopeLock(&GCurlConfigLock);
+	ensureMsgf(GCurlSessionScopes > 0, TEXT("BuildCurlSessionArgs must be called inside an FFtpCurlSessionScope"));
+
+	if (const FString* Existing = GCurlConfigFiles.Find(Key))
+	{
+		return *Existing;
+	}
+
+	// 파일 이름은 내용과 무관하게 새로 뽑는다 - 이름으로 자격 증명을 추측할 수 없다
+	const FString ConfigPath = FPaths::ConvertRelativePathToFull(GetCurlPrivateDir() / (TEXT("curl-") + FGuid::NewGuid().ToString(EGuidFormats::Digits) + TEXT(".cfg")));
+	if (!WriteOwnerOnlyFile(ConfigPath, Contents))
+	{
+		LogFtpMessage(FString::Printf(TEXT("Failed to write curl config: %s"), *ConfigPath), true);
+		return FString();
+	}
+
+	const FString Args = FString::Printf(TEXT("-K \"%s\""), *ConfigPath);
+	GCurlConfigPaths.Add(ConfigPath);
+	GCurlConfigFiles.Add(Key, Args);
+	return Args;
+}
+
+// CURL 명령어 실행
+bool ExecuteCurlCommand(const FString& Command, FString& Output, FString& Error)
+{
+	int32 ReturnCode;
+	FString StdOut, StdErr;
+	FString Executable, Params;
+	GetCurlLaunchCommand(Command, Executable, Params);
+	
+	bool bSuccess = FPlatformProcess::ExecProcess(*Executable, *Params, &ReturnCode, &StdOut, &StdErr);
+	
+	Output = StdOut;
+	Error = StdErr;
+	
+	return bSuccess && ReturnCode == 0;
+}
+
+// 전송 이력 기록
+static void RecordTransfer(const FString& LocalPath, const FString& RemotePath, int64 Bytes, double DurationSeconds, EFtpTransferDirection Direction, bool bSuccess)
+{
+	FFtpTransferRecord Record;
+	Record.LocalPath = LocalPath;
+	Record.RemotePath = RemotePath;
+	Record.Bytes = Bytes;
+	Record.DurationSeconds = DurationSeconds;
+	Record.Timestamp = FDateTime::Now();
+	Record.Direction = Direction;
+	Record.bSuccess = bSuccess;
+	FFtpTransferHistory::Get().Record(Record);
+}
+
+// FTP URL 생성
+FString CreateFtpUrl(const FString& Username, const FString& RemotePath)
+{
+	FFtpUserConfig* User = GetUser(Username);
+	if (!User)
+		return TEXT("");
+
+	return CreateFtpUrl(MakeDefaultServerProfile(Username), RemotePath);
+}
+
+FString CreateFtpUrl(const FFtpServerProfile& Profile, const FString& RemotePath)
+{
+	FString BaseUrl = FString::Printf(TEXT("ftp://%s:%d"), *Profile.Address, Profile.Port);
+	
+	// 루트 디렉토리인 경우
+	if (RemotePath.IsEmpty() || RemotePath == TEXT("/"))
+	{
+		return BaseUrl + TEXT("/");
+	}
+	
+	if (RemotePath.StartsWith(TEXT("/")))
+	{
+		return BaseUrl + RemotePath;
+	}
+	else
+	{
+		return BaseUrl + TEXT("/") + RemotePath;
+	}
+}
+
+// 서버 프로필 파일 경로 (Saved/FileUpLoad/ServerProfiles.json)
+FString GetDefaultServerProfilesPath()
+{
+	return FPaths::ProjectSavedDir() / TEXT("FileUpLoad") / TEXT("ServerProfiles.json");
+}
+
+// 전역 서버 설정으로 만든 기본 프로필
+FFtpServerProfile MakeDefaultServerProfile(const FString& Username)
+{
+	FFtpServerProfile Profile;
+	Profile.Name = TEXT("Default");
+	Profile.Address = GServerAddress;
+	Profile.Port = GServerPort;
+	Profile.bUseFtps = GFtpSecurityConfig.bUseFtps;
+
+	if (FFtpUserConfig* User = GetUser(Username))
+	{
+		Profile.Username = User->Username;
+		Profile.Password = User->Password;
+	}
+	return Profile;
+}
+
+// JSON 배열에서 서버 프로필 읽기
+void ParseFtpServerProfiles(const TArray<TSharedPtr<FJsonValue>>& Servers, TArray<FFtpServerProfile>& OutProfiles)
+{
+	for (const TSharedPtr<FJsonValue>& Value : Servers)
+	{
+		const TSharedPtr<FJsonObject>* ServerObject = nullptr;
+		if (!Value.IsValid() || !Value->TryGetObject(ServerObject))
+		{
+			continue;
+		}
+
+		FFtpServerProfile Profile;
+		(*ServerObject)->TryGetStringField(TEXT("Name"), Profile.Name);
+		(*ServerObject)->TryGetStringField(TEXT("Address"), Profile.Address);
+		(*ServerObject)->TryGetNumberField(TEXT("Port"), Profile.Port);
+		(*ServerObject)->TryGetStringField(TEXT("User"), Profile.Username);
+		(*ServerObject)->TryGetStringField(TEXT("Password"), Profile.Password);
+		Profile.bUseFtps = GFtpSecurityConfig.bUseFtps;
+		(*ServerObject)->TryGetBoolField(TEXT("Ftps"), Profile.bUseFtps);
+
+		if (Profile.Address.IsEmpty())
+		{
+			continue;
+		}
+		if (Profile.Name.IsEmpty())
+		{
+			Profile.Name = Profile.Address;
+		}
+		OutProfiles.Add(Profile);
+	}
+}
+
+// 서버 프로필 목록 읽기
+// { "Servers": [ { "Name": "Mirror1", "Address": "10.0.0.2", "Port": 21, "User": "test", "Password": "test" } ] }
+bool LoadFtpServerProfiles(const FString& FilePath, TArray<FFtpServerProfile>& OutProfiles)
+{
+	FString JsonText;
+	if (!FFileHelper::LoadFileToString(JsonText, *FilePath))
+	{
+		LogFtpMessage(FString::Printf(TEXT("Server profiles not found: %s"), *FilePath), true);
+		return false;
+	}
+
+	TSharedPtr<FJsonObject> Root;
+	TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(JsonText);
+	if (!FJsonSerializer::Deserialize(Reader, Root) || !Root.IsValid())
+	{
+		LogFtpMessage(FString::Printf(TEXT("Invalid server profiles: %s"), *FilePath), true);
+		return false;
+	}
+
+	const TArray<TSharedPtr<FJsonValue>>* Servers = nullptr;
+	if (!Root->TryGetArrayField(TEXT("Servers"), Servers))
+	{
+		LogFtpMessage(FString::Printf(TEXT("Server profiles have no \"Servers\" array: %s"), *FilePath), true);
+		return false;
+	}
+
+	ParseFtpServerProfiles(*Servers, OutProfiles);
+
+	LogFtpMessage(FString::Printf(TEXT("Loaded %d server profile(s) from %s"), OutProfiles.Num(), *FilePath));
+	return OutProfiles.Num() > 0;
+}
+
+// FTP 파일 업로드
+bool UploadFile(const FString& Username, const FString& LocalPath, const FString& RemotePath)
+{
+	if (!HasPermission(Username, TEXT("Write")))
+	{
+		LogFtpMessage(FString::Printf(TEXT("Upload failed: User %s lacks write permission"), *Username), true);
+		return false;
+	}
+
+	if (!FPaths::FileExists(LocalPath))
+	{
+		LogFtpMessage(FString::Printf(TEXT("Upload failed: Local file does not exist: %s"), *LocalPath), true);
+		return false;
+	}
+
+	FFtpUserConfig* User = GetUser(Username);
+	if (!User)
+		return false;
+
+	FTP_TRACE_SCOPE(Upload);
+	FFtpTraceInFlightScope InFlight;
+
+	FString FtpUrl = CreateFtpUrl(Username, RemotePath);
+	FFtpCurlSessionScope CurlSession;
+	FString Command = FString::Printf(TEXT("%s -T \"%s\" \"%s\" --ftp-pasv --ftp-create-dirs"), 
+		*BuildCurlSessionArgs(User->Username, User->Password, GFtpSecurityConfig.bUseFtps), *LocalPath, *FtpUrl);
+
+	const double StartTime = FPlatformTime::Seconds();
+	FString Output, Error;
+	bool bSuccess = ExecuteCurlCommand(Command, Output, Error);
+
+	RecordTransfer(LocalPath, RemotePath, IFileManager::Get().FileSize(*LocalPath), FPlatformTime::Seconds() - StartTime, EFtpTransferDirection::Upload, bSuccess);
+
+	if (bSuccess)
+	{
+		LogFtpMessage(FString::Printf(TEXT("Upload successful: %s -> %s"), *LocalPath, *RemotePath), false);
+	}
+	else
+	{
+		LogFtpMessage(FString::Printf(TEXT("Upload failed: %s"), *Error), true);
+	}
+
+	return bSuccess;
+}
+
+// FTP 파일 일괄 업로드
+// 한 번의 curl 호출에 여러 파일을 넣어 제어 연결을 유지하고, FTPS에서는 TLS 세션을
+// 제어 연결과 모든 데이터 연결 사이에서 재개한다 (파일마다 전체 핸드셰이크를 하지 않음)
+bool UploadFilesBatch(const FString& Username, const TArray<FFtpUploadRequest>& Requests, TArray<bool>& OutSuccess, FFtpTransferSample* OutSample)
+{
+	OutSuccess.Init(false, Requests.Num());
+
+	if (!HasPermission(Username, TEXT("Write")))
+	{
+		LogFtpMessage(FString::Printf(TEXT("Upload failed: User %s lacks write permission"), *Username), true);
+		return false;
+	}
+
+	FFtpUserConfig* User = GetUser(Username);
+	if (!User)
+		return false;
+
+	// 요청 목록은 설정 파일로 넘긴다 - 명령줄 길이 제한을 피하고 경로가 프로세스 목록에 남지 않는다
+	FString BatchConfig;
+	TArray<int32> BatchIndices;
+	for (int32 Index = 0; Index < Requests.Num(); ++Index)
+	{
+		const FFtpUploadRequest& Request = Requests[Index];
+		if (!FPaths::FileExists(Request.LocalPath))
+		{
+			LogFtpMessage(FString::Printf(TEXT("Upload failed: Local file does not exist: %s"), *Request.LocalPath), true);
+			continue;
+		}
+
+		BatchConfig += FString::Printf(TEXT("upload-file = \"%s\"\nurl = \"%s\"\n"),
+			*EscapeCurlConfigValue(FPaths::ConvertRelativePathToFull(Request.LocalPath)),
+			*EscapeCurlConfigValue(CreateFtpUrl(Username, Request.RemotePath)));
+		BatchIndices.Add(Index);
+	}
+
+	if (BatchIndices.Num() == 0)
+	{
+		return false;
+	}
+
+	// 전송마다 한 줄씩 종료 코드, 마지막 응답 코드, 전송 시작까지 걸린 시간을 출력
+	// 뒤의 단계별 시간(접속, 첫 바이트, 전체)은 트레이스 이벤트로만 쓴다
+	BatchConfig += TEXT("write-out = \"%{exitcode} %{response_code} %{time_pretransfer} %{time_connect} %{time_starttransfer} %{time_total}\\n\"\n");
+
+	const FString BatchPath = FPaths::ConvertRelativePathToFull(FPaths::CreateTempFilename(*GetCurlPrivateDir(), TEXT("batch"), TEXT(".cfg")));
+	if (!FFileHelper::SaveStringToFile(BatchConfig, *BatchPath))
+	{
+		LogFtpMessage(FString::Printf(TEXT("Upload failed: cannot write batch file %s"), *BatchPath), true);
+		return false;
+	}
+
+	FFtpCurlSessionScope CurlSession;
+	FString Command = FString::Printf(TEXT("%s -K \"%s\" --ftp-pasv --ftp-create-dirs --silent --show-error"),
+		*BuildCurlSessionArgs(User->Username, User->Password, GFtpSecurityConfig.bUseFtps), *BatchPath);
+
+	FTP_TRACE_SCOPE(UploadBatch);
+	FFtpTraceInFlightScope InFlight(BatchIndices.Num());
+
+	const double StartTime = FPlatformTime::Seconds();
+	FString Output, Error;
+	const bool bAllSucceeded = ExecuteCurlCommand(Command, Output, Error);
+	const double Duration = FPlatformTime::Seconds() - StartTime;
+
+	IFileManager::Get().Delete(*BatchPath);
+
+	TArray<FString> Lines;
+	Output.ParseIntoArrayLines(Lines);
+
+	FFtpTransferSample Sample;
+	Sample.Seconds = Duration;
+	Sample.Files = Requests.Num();
+	Sample.FailedFiles = Requests.Num() - BatchIndices.Num();
+
+	for (int32 BatchIndex = 0; BatchIndex < BatchIndices.Num(); ++BatchIndex)
+	{
+		const int32 Index = BatchIndices[BatchIndex];
+		bool bSuccess = false;
+
+		if (Lines.IsValidIndex(BatchIndex))
+		{
+			TArray<FString> Fields;
+			Lines[BatchIndex].ParseIntoArray(Fields, TEXT(" "));
+
+			int32 ExitCode = -1;
+			int32 ResponseCode = 0;
+			if (Fields.Num() > 1)
+			{
+				LexFromString(ResponseCode, *Fields[1]);
+			}
+			if (Fields.Num() > 0 && Fields[0].IsNumeric())
+			{
+				LexFromString(ExitCode, *Fields[0]);
+				bSuccess = ExitCode == 0;
+			}
+			else
+			{
+				// %{exitcode}를 모르는 오래된 curl - 전송 완료 응답으로 판단
+				bSuccess = ResponseCode == 226 || ResponseCode == 250;
+			}
+
+			// 421 = 연결 수 제한, 7 = 연결 거부
+			Sample.bServerBusy |= ResponseCode == 421 || ExitCode == 7;
+
+			double PreTransfer = 0.0;
+			if (Fields.Num() > 2 && LexTryParseString(PreTransfer, *Fields[2]) && PreTransfer > 0.0)
+			{
+				Sample.LatencySeconds = Sample.LatencySeconds > 0.0 ? FMath::Min(Sample.LatencySeconds, PreTransfer) : PreTransfer;
+			}
+
+			double Connect = 0.0, StartTransfer = 0.0, Total = 0.0;
+			if (UE_TRACE_CHANNELEXPR_IS_ENABLED(FileUpLoadChannel) && Fields.Num() > 5
+				&& LexTryParseString(Connect, *Fields[3]) && LexTryParseString(StartTransfer, *Fields[4]) && LexTryParseString(Total, *Fields[5]))
+			{
+				FtpTrace::CurlTimings(Requests[Index].RemotePath, Connect, PreTransfer, StartTransfer, Total);
+			}
+		}
+		else
+		{
+			bSuccess = bAllSucceeded;
+		}
+
+		OutSuccess[Index] = bSuccess;
+
+		const FFtpUploadRequest& Request = Requests[Index];
+		const int64 FileSize = IFileManager::Get().FileSize(*Request.LocalPath);
+		RecordTransfer(Request.LocalPath, Request.RemotePath, FileSize, Duration / BatchIndices.Num(), EFtpTransferDirection::Upload, bSuccess);
+
+		if (bSuccess)
+		{
+			Sample.Bytes += FileSize;
+			LogFtpMessage(FString::Printf(TEXT("Upload successful: %s -> %s"), *Request.LocalPath, *Request.RemotePath), false);
+		}
+		else
+		{
+			++Sample.FailedFiles;
+			LogFtpMessage(FString::Printf(TEXT("Upload failed: %s %s"), *Request.LocalPath, *Error), true);
+		}
+	}
+
+	// 서버가 연결을 받자마자 끊으면 write-out 줄이 없고 오류 메시지에만 남는다
+	Sample.bServerBusy |= Error.Contains(TEXT("421"));
+
+	if (OutSample)
+	{
+		*OutSample = Sample;
+	}
+
+	return bAllSucceeded;
+}
+
+// FTP 파일 다운로드
+// curl은 표준 출력(-o -)으로만 내보내고 디스크 쓰기는 비동기 쓰기가 맡는다 - 느린 디스크가 수신을 막지 않는다
+// 같은 디렉토리의 임시 파일로 받고, curl이 성공하고 크기가 맞을 때만 기존 파일을 한 번에 바꾼다 (실패해도 기존 파일은 그대로)
+bool DownloadFile(const FString& Username, const FString& RemotePath, const FString& LocalPath, int64 ExpectedSize, FFtpTransferSample* OutSample)
+{
+	if (!HasPermission(Username, TEXT("Read")))
+	{
+		LogFtpMessage(FString::Printf(TEXT("Download failed: User %s lacks read permission"), *Username), true);
+		return false;
+	}
+
+	FFtpUserConfig* User = GetUser(Username);
+	if (!User)
+		return false;
+
+	FString FtpUrl = CreateFtpUrl(Username, RemotePath);
+	FFtpCurlSessionScope CurlSession;
+	FString Command = FString::Printf(TEXT("%s \"%s\" -o - --ftp-pasv --silent"), 
+		*BuildCurlSessionArgs(User->Username, User->Password, GFtpSecurityConfig.bUseFtps), *FtpUrl);
+
+	FTP_TRACE_SCOPE(Download);
+	FFtpTraceInFlightScope InFlight;
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	const FString TempPath = FFtpIngestCommitter::MakeTempPath(LocalPath);
+	FFtpAsyncFileWriter Writer;
+	FFtpCurlProcess Process;
+	bool bSuccess = Writer.Open(TempPath, ExpectedSize) && Process.Launch(Command, false);
+
+	int32 ReturnCode = -1;
+	double FirstByteTime = 0.0;
+	if (bSuccess)
+	{
+		TArray<uint8> Chunk;
+		while (true)
+		{
+			// 종료 여부를 먼저 보고 읽어야 마지막 출력을 놓치지 않는다
+			const bool bRunning = Process.IsRunning();
+			if (Process.ReadBinaryOutput(Chunk))
+			{
+				if (FirstByteTime == 0.0)
+				{
+					FirstByteTime = FPlatformTime::Seconds();
+				}
+				Writer.Append(Chunk.GetData(), Chunk.Num());
+				continue;
+			}
+			if (!bRunning)
+			{
+				break;
+			}
+			Process.WaitForOutput(DownloadPollIntervalMs);
+		}
+
+		FString Unused;
+		ReturnCode = Process.Wait(Unused);
+	}
+
+	const bool bWritten = Writer.Close();
+	const bool bSizeMatches = ExpectedSize < 0 || Writer.GetBytesWritten() == ExpectedSize;
+	bSuccess = bSuccess && ReturnCode == 0 && bWritten && bSizeMatches;
+	if (bSuccess && !FFtpIngestCommitter::ReplaceFile(TempPath, LocalPath))
+	{
+		LogFtpMessage(FString::Printf(TEXT("Download failed: cannot move %s into place"), *LocalPath), true);
+		bSuccess = false;
+	}
+	if (!bSuccess)
+	{
+		IFileManager::Get().Delete(*TempPath, false, true, true);
+		if (ReturnCode == 0 && !bSizeMatches)
+		{
+			LogFtpMessage(FString::Printf(TEXT("Download failed: %s is %lld bytes, expected %lld"), *RemotePath, Writer.GetBytesWritten(), ExpectedSize), true);
+		}
+	}
+
+	const double Duration = FPlatformTime::Seconds() - StartTime;
+	RecordTransfer(LocalPath, RemotePath, bSuccess ? Writer.GetBytesWritten() : 0, Duration, EFtpTransferDirection::Download, bSuccess);
+
+	if (OutSample)
+	{
+		OutSample->Bytes = bSuccess ? Writer.GetBytesWritten() : 0;
+		OutSample->Seconds = Duration;
+		OutSample->LatencySeconds = FirstByteTime > 0.0 ? FirstByteTime - StartTime : 0.0;
+		OutSample->Files = 1;
+		OutSample->FailedFiles = bSuccess ? 0 : 1;
+		// 표준 오류를 받지 않으므로 종료 코드로 판단: 7 = 연결 거부, 8 = 인사말 대신 온 421
+		OutSample->bServerBusy = ReturnCode == 7 || ReturnCode == 8;
+	}
+
+	if (bSuccess)
+	{
+		LogFtpMessage(FString::Printf(TEXT("Download successful: %s -> %s"), *RemotePath, *LocalPath), false);
+	}
+	else
+	{
+		LogFtpMessage(FString::Printf(TEXT("Download failed: %s (curl exit code %d)"), *RemotePath, ReturnCode), true);
+	}
+
+	return bSuccess;
+}
+
+// FTP 파일 목록 조회
+bool GetFileList(const FString& Username, const FString& RemotePath, TArray<FString>& FileList)
+{
+	if (!HasPermission(Username, TEXT("Read")))
+	{
+		LogFtpMessage(FString::Printf(TEXT("GetFileList failed: User %s lacks read permission"), *Username), true);
+		return false;
+	}
+
+	FFtpUserConfig* User = GetUser(Username);
+	if (!User)
+		return false;
+
+	// 루트 디렉토리부터 시작
+	FString FtpUrl = FString::Printf(TEXT("ftp://%s:%d/"), *GServerAddress, GServerPort);
+	FFtpCurlSessionScope CurlSession;
+	FString Command = FString::Printf(TEXT("%s \"%s\" --silent --show-error --ftp-pasv"), 
+		*BuildCurlSessionArgs(User->Username, User->Password, GFtpSecurityConfig.bUseFtps), *FtpUrl);
+
+	FString Output, Error;
+	bool bSuccess = ExecuteCurlCommand(Command, Output, Error);
+
+	if (bSuccess)
+	{
+		// 출력을 줄 단위로 분리
+		TArray<FString> Lines;
+		Output.ParseIntoArray(Lines, TEXT("\n"), true);
+		
+		for (const FString& Line : Lines)
+		{
+			if (!Line.IsEmpty())
+			{
+				FileList.Add(Line);
+			}
+		}
+
+		LogFtpMessage(FString::Printf(TEXT("GetFileList successful: %d files found"), FileList.Num()), false);
+	}
+	else
+	{
+		LogFtpMessage(FString::Printf(TEXT("GetFileList failed: %s"), *Error), true);
+	}
+
+	return bSuccess;
+}
+
+// 연결 테스트
+bool TestConnection(const FString& Username)
+{
+	FFtpUserConfig* User = GetUser(Username);
+	if (!User)
+	{
+		LogFtpMessage(FString::Printf(TEXT("TestConnection failed: Invalid user %s"), *Username), true);
+		return false;
+	}
+
+	// 더 간단한 연결 테스트 - 루트 디렉토리만 확인
+	FString FtpUrl = FString::Printf(TEXT("ftp://%s:%d/"), *GServerAddress, GServerPort);
+	FFtpCurlSessionScope CurlSession;
+	FString Command = FString::Printf(TEXT("%s \"%s\" --connect-timeout 10 --max-time 30 --silent --show-error --ftp-pasv --ftp-create-dirs"), 
+		*BuildCurlSessionArgs(User->Username, User->Password, GFtpSecurityConfig.bUseFtps), *FtpUrl);
+
+	FString Output, Error;
+	bool bSuccess = ExecuteCurlCommand(Command, Output, Error);
+
+	if (bSuccess)
+	{
+		LogFtpMessage(FString::Printf(TEXT("Connection test successful for user: %s"), *Username), false);
+	}
+	else
+	{
+		LogFtpMessage(FString::Printf(TEXT("Connection test failed for user %s: %s"), *Username, *Error), true);
+	}
+
+	return bSuccess;
+}
+
+FFtpSyncStats UploadSpecificFolder(const FString& LocalFolder, const FString& RemoteBaseDir, const FString& Server, const FString& User, const FString& Pass)
+{
+    UE_LOG(LogTemp, Log, TEXT("특정 폴더 업로드 시작: %s"), *LocalFolder);
+    
+    // 사용자 인증
+    if (!AuthenticateUser(User, Pass))
+    {
+        UE_LOG(LogTemp, Error, TEXT("사용자 인증 실패: %s"), *User);
+        return FFtpSyncStats::Aborted();
+    }
+    
+    // 특정 폴더의 모든 파일 찾기
+    FFtpPathTable AllFiles(LocalFolder);
+    AllFiles.Scan();
+    
+    UE_LOG(LogTemp, Log, TEXT("총 %d개 파일 발견"), AllFiles.Num());
+    
+    int32 SuccessCount = 0;
+    int32 FailCount = 0;
+    
+    for (int32 FileIndex = 0; FileIndex < AllFiles.Num(); FileIndex++)
+    {
+        const FString LocalFile = AllFiles.GetFullPath(FileIndex);
+        const FString RelativePath = AllFiles.GetRelativePath(FileIndex);
+        const FString RemoteFile = AllFiles.GetRemotePath(FileIndex, RemoteBaseDir);
+        
+        UE_LOG(LogTemp, Log, TEXT("업로드 중: %s -> %s"), *LocalFile, *RemoteFile);
+        
+        if (UploadFile(User, LocalFile, RemoteFile)) {
+            SuccessCount++;
+            UE_LOG(LogTemp, Log, TEXT("업로드 성공: %s"), *RelativePath);
+        } else {
+            FailCount++;
+            UE_LOG(LogTemp, Error, TEXT("업로드 실패: %s"), *RelativePath);
+        }
+    }
+    
+    UE_LOG(LogTemp, Log, TEXT("특정 폴더 업로드 완료: 성공 %d개, 실패 %d개"), SuccessCount, FailCount);
+    
+    return FFtpSyncStats(SuccessCount, FailCount);
+}
+
+FFtpSyncStats UploadFolderStructure(const FString& LocalFolder, const FString& RemoteBaseDir, const FString& Server, const FString& User, const FString& Pass)
+{
+    UE_LOG(LogTemp, Log, TEXT("폴더 구조 업로드 시작: %s"), *LocalFolder);
+    
+    // 사용자 인증
+    if (!AuthenticateUser(User, Pass))
+    {
+        UE_LOG(LogTemp, Error, TEXT("사용자 인증 실패: %s"), *User);
+        return FFtpSyncStats::Aborted();
+    }
+    
+    // 모든 파일 찾기 - 폴더는 경로 표의 디렉토리 노드로 함께 모인다 (중복 없음)
+    FFtpPathTable AllFiles(LocalFolder);
+    AllFiles.Scan();
+    
+    UE_LOG(LogTemp, Log, TEXT("총 %d개 파일, %d개 폴더 발견"), AllFiles.Num(), AllFiles.NumDirectories());
+    
+    int32 SuccessCount = 0;
+    int32 FailCount = 0;
+    
+    // 1단계: 모든 폴더 경로 준비
+    TStringBuilder<512> RemoteDir;
+    for (int32 DirIndex = 0; DirIndex < AllFiles.NumDirectories(); DirIndex++)
+    {
+        RemoteDir.Reset();
+        RemoteDir << RemoteBaseDir << TEXT('/');
+        AllFiles.AppendDirectoryPath(DirIndex, RemoteDir);
+        
+        UE_LOG(LogTemp, Verbose, TEXT("폴더 경로 준비: %s"), *RemoteDir);
+    }
+    
+    // 2단계: 모든 파일 업로드
+    for (int32 FileIndex = 0; FileIndex < AllFiles.Num(); FileIndex++)
+    {
+        const FString LocalFile = AllFiles.GetFullPath(FileIndex);
+        const FString RelativePath = AllFiles.GetRelativePath(FileIndex);
+        const FString RemoteFile = AllFiles.GetRemotePath(FileIndex, RemoteBaseDir);
+        
+        UE_LOG(LogTemp, Log, TEXT("업로드 중: %s -> %s"), *LocalFile, *RemoteFile);
+        
+        if (UploadFile(User, LocalFile, RemoteFile)) {
+            SuccessCount++;
+            UE_LOG(LogTemp, Log, TEXT("업로드 성공: %s"), *RelativePath);
+        } else {
+            FailCount++;
+            UE_LOG(LogTemp, Error, TEXT("업로드 실패: %s"), *RelativePath);
+        }
+    }
+    
+    UE_LOG(LogTemp, Log, TEXT("폴더 구조 업로드 완료: 성공 %d개, 실패 %d개"), SuccessCount, FailCount);
+    
+    return FFtpSyncStats(SuccessCount, FailCount);
+}
+
+FFtpSyncStats UploadFromFtpServer(const FString& RemotePath, const FString& LocalPath, const FString& Server, const FString& User, const FString& Pass)
+{
+    UE_LOG(LogTemp, Log, TEXT("=== FTP 서버에서 파일 다운로드 시작 ==="));
+    UE_LOG(LogTemp, Log, TEXT("FTP 서버 경로: %s"), *RemotePath);
+    UE_LOG(LogTemp, Log, TEXT("로컬 저장 경로: %s"), *LocalPath);
+    
+    // 사용자 인증
+    if (!AuthenticateUser(User, Pass))
+    {
+        UE_LOG(LogTemp, Error, TEXT("사용자 인증 실패: %s"), *User);
+        return FFtpSyncStats::Aborted();
+    }
+    
+    // 목록과 모든 다운로드가 자격 증명 파일 하나를 같이 쓰고, 끝나면 지운다
+    FFtpCurlSessionScope CurlSession;
+
+    // 1단계: FTP 서버에서 파일 목록 가져오기
+    TArray<FString> FileList;
+    if (!GetFileList(User, RemotePath, FileList)) {
+        UE_LOG(LogTemp, Error, TEXT("FTP 파일 목록 가져오기 실패"));
+        return FFtpSyncStats::Aborted();
+    }
+    
+    UE_LOG(LogTemp, Log, TEXT("FTP 서버에서 %d개 파일 발견"), FileList.Num());
+    
+    // 발견된 파일들 로그 출력
+    for (int32 i = 0; i < FileList.Num(); i++) {
+        UE_LOG(LogTemp, Log, TEXT("파일 %d: %s"), i, *FileList[i]);
+    }
+    
+    // 크기를 알면 받는 쪽이 미리 공간을 잡고 큰 파일은 O_DIRECT로 쓴다 (MLSD를 모르는 서버면 모르는 채로 받는다)
+    TMap<FString, int64> RemoteSizes;
+    if (!FtpPlanner::ListRemoteFileSizes(User, RemotePath, RemoteSizes)) {
+        UE_LOG(LogTemp, Warning, TEXT("파일 크기를 알 수 없어 크기 확인 없이 받습니다: %s"), *RemotePath);
+    }
+    
+    // 2단계: 각 파일 다운로드 - 동시에 받는 수는 서버별 조절기가 정한다
+    TAtomic<int32> SuccessCount(0);
+    TAtomic<int32> FailCount(0);
+    
+    TSharedRef<FFtpConcurrencyController> Controller = FtpConcurrency::GetController(Server, GServerMaxConnections);
+    FtpConcurrency::RunTransfers(*Controller, FileList.Num(), [&](int32 FileIndex) {
+        const FString& RemoteFile = FileList[FileIndex];
+        FString FullRemotePath = RemotePath / RemoteFile;
+        FString FullLocalPath = LocalPath / RemoteFile;
+        
+        UE_LOG(LogTemp, Log, TEXT("다운로드 중: %s -> %s"), *FullRemotePath, *FullLocalPath);
+        
+        const int64* RemoteSize = RemoteSizes.Find(RemoteFile);
+        FFtpTransferSample Sample;
+        if (DownloadFile(User, FullRemotePath, FullLocalPath, RemoteSize ? *RemoteSize : -1, &Sample)) {
+            SuccessCount++;
+            UE_LOG(LogTemp, Log, TEXT("다운로드 성공: %s"), *RemoteFile);
+        } else {
+            FailCount++;
+            UE_LOG(LogTemp, Error, TEXT("다운로드 실패: %s"), *RemoteFile);
+        }
+        return Sample;
+    });
+    
+    UE_LOG(LogTemp, Log, TEXT("=== FTP 다운로드 완료: 성공 %d개, 실패 %d개 (동시 전송 %d) ==="), SuccessCount.Load(), FailCount.Load(), Controller->GetLimit());
+    
+    return FFtpSyncStats(SuccessCount.Load(), FailCount.Load());
+}
+
+// 경로 표의 파일들을 업로드 (FileIndices가 없으면 전부)
+// 파일들을 묶어 한 curl 호출로 전송하고 (연결/TLS 세션 재사용), 묶음들을 조절기가 허용하는 만큼 동시에 보낸다
+FFtpSyncStats UploadPathTable(const FFtpPathTable& AllFiles, const TArray<int32>* FileIndices, const FString& RemotePath, const FString& Server, const FString& User)
+{
+    TSharedRef<FFtpConcurrencyController> Controller = FtpConcurrency::GetController(Server, GServerMaxConnections);
+    FFtpCurlSessionScope CurlSession;
+    
+    // 파일이 적을 때도 동시 전송이 가능하도록 묶음 크기를 줄인다
+    const int32 NumFiles = FileIndices ? FileIndices->Num() : AllFiles.Num();
+    const int32 BatchSize = FMath::Clamp(NumFiles / FMath::Max(Controller->GetMaxLimit(), 1), 1, UploadBatchSize);
+    const int32 NumBatches = (NumFiles + BatchSize - 1) / BatchSize;
+    
+    FtpTrace::Bookmark(FString::Printf(TEXT("FTP 업로드 시작: %d개 -> %s"), NumFiles, *RemotePath));
+    
+    TAtomic<int32> SuccessCount(0);
+    TAtomic<int32> FailCount(0);
+    
+    FtpConcurrency::RunTransfers(*Controller, NumBatches, [&](int32 BatchNumber) {
+        TArray<FFtpUploadRequest> Batch;
+        TArray<FString> RelativePaths;
+        
+        const int32 BatchStart = BatchNumber * BatchSize;
+        const int32 BatchEnd = FMath::Min(BatchStart + BatchSize, NumFiles);
+        // 경로 문자열은 지금 보내는 묶음에 대해서만 만든다
+        TStringBuilder<512> PathBuilder;
+        for (int32 Position = BatchStart; Position < BatchEnd; Position++) {
+            const int32 FileIndex = FileIndices ? (*FileIndices)[Position] : Position;
+            FFtpUploadRequest& Request = Batch.AddDefaulted_GetRef();
+            
+            PathBuilder.Reset();
+            AllFiles.AppendFullPath(FileIndex, PathBuilder);
+            Request.LocalPath = PathBuilder.ToString();
+            
+            PathBuilder.Reset();
+            AllFiles.AppendRemotePath(FileIndex, RemotePath, PathBuilder);
+            Request.RemotePath = PathBuilder.ToString();
+            
+            RelativePaths.Add(AllFiles.GetRelativePath(FileIndex));
+            
+            UE_LOG(LogTemp, Log, TEXT("업로드 중: %s -> %s"), *Request.LocalPath, *Request.RemotePath);
+        }
+        
+        TArray<bool> BatchSuccess;
+        FFtpTransferSample Sample;
+        Sample.Files = Batch.Num();
+        Sample.FailedFiles = Batch.Num();
+        UploadFilesBatch(User, Batch, BatchSuccess, &Sample);
+        
+        for (int32 Index = 0; Index < Batch.Num(); Index++) {
+            if (BatchSuccess[Index]) {
+                SuccessCount++;
+                UE_LOG(LogTemp, Log, TEXT("업로드 성공: %s"), *RelativePaths[Index]);
+            } else {
+                FailCount++;
+                UE_LOG(LogTemp, Error, TEXT("업로드 실패: %s"), *RelativePaths[Index]);
+            }
+        }
+        return Sample;
+    });
+    
+    UE_LOG(LogTemp, Log, TEXT("=== FTP 업로드 완료: 성공 %d개, 실패 %d개 (동시 전송 %d) ==="), SuccessCount.Load(), FailCount.Load(), Controller->GetLimit());
+    FtpTrace::Bookmark(FString::Printf(TEXT("FTP 업로드 완료: 성공 %d, 실패 %d"), SuccessCount.Load(), FailCount.Load()));
+    
+    return FFtpSyncStats(SuccessCount.Load(), FailCount.Load());
+}
+
+FFtpSyncStats UploadToFtpServer(const FString& LocalPath, const FString& RemotePath, const FString& Server, const FString& User, const FString& Pass, const TArray<FName>& PriorityPackages)
+{
+    UE_LOG(LogTemp, Log, TEXT("=== FTP 서버로 파일 업로드 시작 ==="));
+    UE_LOG(LogTemp, Log, TEXT("로컬 경로: %s"), *LocalPath);
+    UE_LOG(LogTemp, Log, TEXT("FTP 서버 경로: %s"), *RemotePath);
+    
+    // 사용자 인증
+    if (!AuthenticateUser(User, Pass))
+    {
+        UE_LOG(LogTemp, Error, TEXT("사용자 인증 실패: %s"), *User);
+        return FFtpSyncStats::Aborted();
+    }
+    
+    // 디렉토리 존재 확인
+    if (!FPaths::DirectoryExists(LocalPath)) {
+        UE_LOG(LogTemp, Error, TEXT("로컬 경로가 존재하지 않습니다: %s"), *LocalPath);
+        return FFtpSyncStats::Aborted();
+    }
+    
+    UE_LOG(LogTemp, Log, TEXT("로컬 경로 존재 확인됨: %s"), *LocalPath);
+    
+    // 1단계: 로컬 파일 목록 가져오기 - 한 번만 훑어 압축 경로 표에 담는다 (파일당 FString을 만들지 않음)
+    FFtpPathTable AllFiles(LocalPath);
+    AllFiles.Scan();
+    
+    UE_LOG(LogTemp, Log, TEXT("총 %d개 파일, %d개 폴더 발견 (경로 표 %.1f KB)"), AllFiles.Num(), AllFiles.NumDirectories(), AllFiles.GetAllocatedSize() / 1024.0);
+    
+    // 발견된 파일들 로그 출력 (Verbose일 때만 경로를 조립한다)
+    if (UE_LOG_ACTIVE(LogTemp, Verbose)) {
+        for (int32 i = 0; i < AllFiles.Num(); i++) {
+            UE_LOG(LogTemp, Verbose, TEXT("파일 %d: %s"), i, *AllFiles.GetRelativePath(i));
+        }
+    }
+    
+    // 2단계: 에셋 의존성 순서 정하기 - 잎 에셋부터, 우선 레벨이 쓰는 파일을 먼저
+    TArray<int32> UploadOrder;
+    FtpUploadOrder::OrderByDependencies(AllFiles, nullptr, PriorityPackages, UploadOrder);
+    
+    // 3단계: 각 파일을 FTP 서버로 업로드
+    return UploadPathTable(AllFiles, &UploadOrder, RemotePath, Server, User);
+}
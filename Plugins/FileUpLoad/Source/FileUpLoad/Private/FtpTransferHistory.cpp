@@ -0,0 +1,42 @@
+#include "FtpTransferHistory.h"
+#include "FileUpLoadTrace.h"
+#include "Misc/ScopeLock.h"
+
+FFtpTransferHistory& FFtpTransferHistory::Get()
+{
+	static FFtpTransferHistory Instance;
+	return Instance;
+}
+
+void FFtpTransferHistory::Record(const FFtpTransferRecord& Record)
+{
+	FScopeLock ScopeLock(&Lock);
+
+	// 오래된 기록부터 절반씩 정리
+	if (Records.Num() >= MaxRecords)
+	{
+		Records.RemoveAt(0, MaxRecords / 2, false);
+	}
+	Records.Add(Record);
+
+	FtpTrace::TransferRecorded(Record);
+	OnTransferRecorded.Broadcast(Record);
+}
+
+void FFtpTransferHistory::GetRecords(TArray<FFtpTransferRecord>& OutRecords) const
+{
+	FScopeLock ScopeLock(&Lock);
+	OutRecords = Records;
+}
+
+FDelegateHandle FFtpTransferHistory::AddListener(FOnTransferRecorded::FDelegate&& Delegate)
+{
+	FScopeLock ScopeLock(&Lock);
+	return OnTransferRecorded.Add(MoveTemp(Delegate));
+}
+
+void FFtpTransferHistory::RemoveListener(FDelegateHandle Handle)
+{
+	FScopeLock ScopeLock(&Lock);
+	OnTransferRecorded.Remove(Handle);
+}
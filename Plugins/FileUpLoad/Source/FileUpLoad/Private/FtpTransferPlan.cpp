@@ -0,0 +1,743 @@
+#include "FtpTransferPlan.h"
+#include "FtpConcurrency.h"
+#include "FtpTransferHistory.h"
+#include "FtpUploadOrder.h"
+#include "Dom/JsonObject.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+FFtpTransferPlan::FFtpTransferPlan()
+	: Files(FString())
+{
+}
+
+namespace FtpPlanner
+{
+	// 비용 추정에 쓰는 최근 업로드 기록 수와 최소 표본 수
+	constexpr int32 MaxCostSamples = 4096;
+	constexpr int32 MinCostSamples = 8;
+
+	// write-out 구분 줄 - 목록 본문과 섞이지 않도록 제어 문자로 시작
+	static const TCHAR* ListingMarker = TEXT("\x01ftpplan ");
+
+	struct FRemoteFile
+	{
+		int64 Size = -1;
+		FDateTime Modified;
+	};
+
+	// 이력이 없는 새 프로세스(CI)를 위해 마지막 추정값을 저장해 둔다
+	static FString GetCostModelPath()
+	{
+		return FPaths::ProjectSavedDir() / TEXT("FileUpLoad") / TEXT("TransferCost.json");
+	}
+
+	static FString MakeDirectoryUrl(const FString& User, const FString& RemoteRoot, const FString& RelativeDir)
+	{
+		FString Url = CreateFtpUrl(User, RelativeDir.IsEmpty() ? RemoteRoot : RemoteRoot / RelativeDir);
+		if (!Url.EndsWith(TEXT("/")))
+		{
+			Url += TEXT("/");
+		}
+		return Url;
+	}
+
+	// "type=file;size=123;modify=20240101120000; name" 한 줄
+	static bool ParseMlsdLine(const FString& Line, FString& OutName, bool& bOutIsDirectory, FRemoteFile& OutFile)
+	{
+		int32 SpaceIndex = INDEX_NONE;
+		if (!Line.FindChar(TEXT(' '), SpaceIndex) || SpaceIndex == 0)
+		{
+			return false;
+		}
+
+		OutName = Line.Mid(SpaceIndex + 1);
+		if (OutName.IsEmpty())
+		{
+			return false;
+		}
+
+		TArray<FString> Facts;
+		Line.Left(SpaceIndex).ParseIntoArray(Facts, TEXT(";"));
+
+		FString Type;
+		for (const FString& Fact : Facts)
+		{
+			FString Key, Value;
+			if (!Fact.Split(TEXT("="), &Key, &Value))
+			{
+				continue;
+			}
+
+			if (Key.Equals(TEXT("type"), ESearchCase::IgnoreCase))
+			{
+				Type = Value.ToLower();
+			}
+			else if (Key.Equals(TEXT("size"), ESearchCase::IgnoreCase))
+			{
+				LexFromString(OutFile.Size, *Value);
+			}
+			else if (Key.Equals(TEXT("modify"), ESearchCase::IgnoreCase) && Value.Len() >= 14)
+			{
+				// YYYYMMDDHHMMSS[.sss], UTC
+				int32 Year = 0, Month = 0, Day = 0, Hour = 0, Minute = 0, Second = 0;
+				LexFromString(Year, *Value.Mid(0, 4));
+				LexFromString(Month, *Value.Mid(4, 2));
+				LexFromString(Day, *Value.Mid(6, 2));
+				LexFromString(Hour, *Value.Mid(8, 2));
+				LexFromString(Minute, *Value.Mid(10, 2));
+				LexFromString(Second, *Value.Mid(12, 2));
+				if (FDateTime::Validate(Year, Month, Day, Hour, Minute, Second, 0))
+				{
+					OutFile.Modified = FDateTime(Year, Month, Day, Hour, Minute, Second);
+				}
+			}
+		}
+
+		// 현재/상위 디렉토리 항목은 건너뛴다
+		if (Type == TEXT("cdir") || Type == TEXT("pdir") || OutName == TEXT(".") || OutName == TEXT(".."))
+		{
+			return false;
+		}
+
+		bOutIsDirectory = Type == TEXT("dir");
+		return Type == TEXT("file") || bOutIsDirectory;
+	}
+
+	// 원격 트리를 MLSD로 나열 - 같은 깊이의 디렉토리들은 한 번의 curl 호출로 묶는다
+	// bRecursive가 false면 루트 디렉토리만 나열한다
+	static bool ListRemoteTree(const FString& User, const FString& RemoteRoot, TMap<FString, FRemoteFile>& OutFiles, bool bRecursive = true)
+	{
+		FFtpUserConfig* UserConfig = GetUser(User);
+		if (!UserConfig)
+		{
+			return false;
+		}
+
+		TArray<FString> Pending;
+		Pending.Add(FString());
+
+		while (Pending.Num() > 0)
+		{
+			const int32 ChunkSize = FMath::Min(Pending.Num(), MaxDirectoriesPerListing);
+			TArray<FString> Chunk(Pending.GetData(), ChunkSize);
+			Pending.RemoveAt(0, ChunkSize);
+
+			FString ListConfig = TEXT("request = \"MLSD\"\n");
+			ListConfig += FString::Printf(TEXT("write-out = \"\\n%s%%{exitcode} %%{response_code}\\n\"\n"), ListingMarker);
+			for (const FString& Directory : Chunk)
+			{
+				ListConfig += FString::Printf(TEXT("url = \"%s\"\n"), *EscapeCurlConfigValue(MakeDirectoryUrl(User, RemoteRoot, Directory)));
+			}
+
+			const FString ListPath = FPaths::ConvertRelativePathToFull(FPaths::CreateTempFilename(*GetCurlPrivateDir(), TEXT("plan"), TEXT(".cfg")));
+			if (!FFileHelper::SaveStringToFile(ListConfig, *ListPath))
+			{
+				LogFtpMessage(FString::Printf(TEXT("Plan failed: cannot write %s"), *ListPath), true);
+				return false;
+			}
+
+			FFtpCurlSessionScope CurlSession;
+			const FString Command = FString::Printf(TEXT("%s -K \"%s\" --ftp-pasv --silent"),
+				*BuildCurlSessionArgs(UserConfig->Username, UserConfig->Password, GFtpSecurityConfig.bUseFtps), *ListPath);
+
+			FString Output, Error;
+			ExecuteCurlCommand(Command, Output, Error);
+			IFileManager::Get().Delete(*ListPath);
+
+			TArray<FString> Lines;
+			Output.ParseIntoArrayLines(Lines);
+
+			int32 DirectoryIndex = 0;
+			TArray<TPair<FString, FRemoteFile>> DirectoryFiles;
+			TArray<FString> DirectorySubdirs;
+			for (const FString& Line : Lines)
+			{
+				if (DirectoryIndex >= Chunk.Num())
+				{
+					break;
+				}
+
+				if (Line.StartsWith(ListingMarker))
+				{
+					TArray<FString> Fields;
+					Line.Mid(FCString::Strlen(ListingMarker)).ParseIntoArray(Fields, TEXT(" "));
+					int32 ExitCode = -1;
+					int32 ResponseCode = 0;
+					if (Fields.Num() > 0)
+					{
+						LexFromString(ExitCode, *Fields[0]);
+					}
+					if (Fields.Num() > 1)
+					{
+						LexFromString(ResponseCode, *Fields[1]);
+					}
+
+					// MLSD를 모르는 서버 - 나열 결과를 믿을 수 없다
+					if (ResponseCode == 500 || ResponseCode == 502 || ResponseCode == 504)
+					{
+						LogFtpMessage(FString::Printf(TEXT("Plan: server does not support MLSD (%d)"), ResponseCode), true);
+						return false;
+					}
+
+					// 없는 디렉토리(550, curl 9/78)만 비어 있는 것으로 본다 - 접속 거부, 로그인 실패, 시간 초과, 중단된 전송을
+					// 빈 디렉토리로 보면 계획이 모든 파일을 Create로 잡는다
+					const bool bMissingDirectory = ResponseCode == 550 || ExitCode == 9 || ExitCode == 78;
+					if (!bMissingDirectory && (ExitCode != 0 || ResponseCode == 0 || ResponseCode == 421 || ResponseCode == 426 || ResponseCode == 530))
+					{
+						LogFtpMessage(FString::Printf(TEXT("Plan: remote listing failed (curl %d, response %d) %s"), ExitCode, ResponseCode, *Error), true);
+						return false;
+					}
+
+					const FString& Directory = Chunk[DirectoryIndex];
+					for (TPair<FString, FRemoteFile>& File : DirectoryFiles)
+					{
+						OutFiles.Add(Directory.IsEmpty() ? File.Key : Directory / File.Key, File.Value);
+					}
+					for (const FString& Subdir : DirectorySubdirs)
+					{
+						if (bRecursive)
+						{
+							Pending.Add(Directory.IsEmpty() ? Subdir : Directory / Subdir);
+						}
+					}
+
+					DirectoryFiles.Reset();
+					DirectorySubdirs.Reset();
+					++DirectoryIndex;
+					continue;
+				}
+
+				FString Name;
+				bool bIsDirectory = false;
+				FRemoteFile File;
+				if (ParseMlsdLine(Line, Name, bIsDirectory, File))
+				{
+					if (bIsDirectory)
+					{
+						DirectorySubdirs.Add(Name);
+					}
+					else
+					{
+						DirectoryFiles.Emplace(Name, File);
+					}
+				}
+			}
+
+			if (DirectoryIndex < Chunk.Num())
+			{
+				// 연결이 끊기는 등 나열이 중간에 멈췄다
+				LogFtpMessage(FString::Printf(TEXT("Plan: remote listing incomplete (%d/%d directories) %s"), DirectoryIndex, Chunk.Num(), *Error), true);
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool ListRemoteFileSizes(const FString& User, const FString& RemoteDirectory, TMap<FString, int64>& OutSizes)
+	{
+		TMap<FString, FRemoteFile> RemoteFiles;
+		if (!ListRemoteTree(User, RemoteDirectory, RemoteFiles, false))
+		{
+			return false;
+		}
+
+		OutSizes.Reserve(RemoteFiles.Num());
+		for (const TPair<FString, FRemoteFile>& File : RemoteFiles)
+		{
+			OutSizes.Add(File.Key, File.Value.Size);
+		}
+		return true;
+	}
+
+	bool BuildPlan(const FString& LocalPath, const FString& RemotePath, const FString& Server, const FString& User, const FString& Pass, bool bMirrorDeletes, FFtpTransferPlan& OutPlan)
+	{
+		OutPlan = FFtpTransferPlan();
+		OutPlan.LocalRoot = LocalPath;
+		OutPlan.RemoteRoot = RemotePath;
+		OutPlan.Server = Server;
+		OutPlan.User = User;
+		OutPlan.CreatedAt = FDateTime::UtcNow();
+		OutPlan.bMirrorDeletes = bMirrorDeletes;
+
+		if (!AuthenticateUser(User, Pass))
+		{
+			LogFtpMessage(FString::Printf(TEXT("Plan failed: authentication failed for %s"), *User), true);
+			return false;
+		}
+
+		if (!FPaths::DirectoryExists(LocalPath))
+		{
+			LogFtpMessage(FString::Printf(TEXT("Plan failed: Local path does not exist: %s"), *LocalPath), true);
+			return false;
+		}
+
+		const double StartTime = FPlatformTime::Seconds();
+
+		OutPlan.Files = FFtpPathTable(LocalPath);
+		OutPlan.Files.Scan();
+		const int32 NumLocalFiles = OutPlan.Files.Num();
+
+		TMap<FString, FRemoteFile> RemoteFiles;
+		OutPlan.bRemoteListed = ListRemoteTree(User, RemotePath, RemoteFiles);
+		if (!OutPlan.bRemoteListed)
+		{
+			LogFtpMessage(TEXT("Plan: remote state unknown, every file is planned as Create"), true);
+			RemoteFiles.Reset();
+		}
+
+		OutPlan.Entries.Reserve(NumLocalFiles);
+		TStringBuilder<512> RelativePath;
+		for (int32 FileIndex = 0; FileIndex < NumLocalFiles; ++FileIndex)
+		{
+			RelativePath.Reset();
+			OutPlan.Files.AppendRelativePath(FileIndex, RelativePath);
+
+			FFtpPlanEntry& Entry = OutPlan.Entries.AddDefaulted_GetRef();
+			Entry.FileIndex = FileIndex;
+			Entry.LocalSize = OutPlan.Files.GetFileSize(FileIndex);
+
+			FRemoteFile Remote;
+			if (!RemoteFiles.RemoveAndCopyValue(FString(RelativePath.ToView()), Remote))
+			{
+				Entry.Action = EFtpPlanAction::Create;
+				continue;
+			}
+
+			Entry.RemoteSize = Remote.Size;
+			Entry.RemoteModified = Remote.Modified;
+
+			// 업로드하면 서버 시각은 업로드 시점이 되므로, 로컬이 그보다 새로우면 이후에 바뀐 것
+			const bool bSizeDiffers = Remote.Size >= 0 && Remote.Size != Entry.LocalSize;
+			const bool bLocalNewer = Remote.Modified.GetTicks() > 0
+				&& (OutPlan.Files.GetFileModified(FileIndex) - Remote.Modified).GetTotalSeconds() > ClockSkewSeconds;
+			Entry.Action = (bSizeDiffers || bLocalNewer) ? EFtpPlanAction::Update : EFtpPlanAction::Skip;
+		}
+
+		// 남은 원격 파일은 서버에만 있다
+		if (bMirrorDeletes)
+		{
+			for (const TPair<FString, FRemoteFile>& Orphan : RemoteFiles)
+			{
+				FFtpPlanEntry& Entry = OutPlan.Entries.AddDefaulted_GetRef();
+				Entry.FileIndex = OutPlan.Files.AddFile(Orphan.Key);
+				Entry.Action = EFtpPlanAction::Delete;
+				Entry.RemoteSize = Orphan.Value.Size;
+				Entry.RemoteModified = Orphan.Value.Modified;
+			}
+		}
+
+		for (const FFtpPlanEntry& Entry : OutPlan.Entries)
+		{
+			switch (Entry.Action)
+			{
+			case EFtpPlanAction::Create:
+				++OutPlan.NumCreate;
+				OutPlan.BytesToTransfer += FMath::Max<int64>(Entry.LocalSize, 0);
+				break;
+			case EFtpPlanAction::Update:
+				++OutPlan.NumUpdate;
+				OutPlan.BytesToTransfer += FMath::Max<int64>(Entry.LocalSize, 0);
+				break;
+			case EFtpPlanAction::Delete:
+				++OutPlan.NumDelete;
+				break;
+			default:
+				++OutPlan.NumSkip;
+				break;
+			}
+		}
+
+		EstimateCost(OutPlan);
+
+		LogFtpMessage(FString::Printf(TEXT("Plan %s -> %s built in %.2fs: %s"), *LocalPath, *RemotePath, FPlatformTime::Seconds() - StartTime, *DescribePlan(OutPlan)));
+		return true;
+	}
+
+	void EstimateCost(FFtpTransferPlan& Plan)
+	{
+		TArray<FFtpTransferRecord> Records;
+		FFtpTransferHistory::Get().GetRecords(Records);
+
+		// 최근 업로드로 "시간 = 파일당 비용 + 바이트 / 처리량" 을 최소제곱으로 맞춘다
+		double SumX = 0.0, SumY = 0.0, SumXX = 0.0, SumXY = 0.0;
+		int32 Samples = 0;
+		for (int32 Index = Records.Num() - 1; Index >= 0 && Samples < MaxCostSamples; --Index)
+		{
+			const FFtpTransferRecord& Record = Records[Index];
+			if (Record.Direction != EFtpTransferDirection::Upload || !Record.bSuccess || Record.DurationSeconds <= 0.0)
+			{
+				continue;
+			}
+
+			const double X = (double)Record.Bytes;
+			const double Y = Record.DurationSeconds;
+			SumX += X;
+			SumY += Y;
+			SumXX += X * X;
+			SumXY += X * Y;
+			++Samples;
+		}
+
+		double SecondsPerByte = 0.0;
+		double Overhead = 0.0;
+		const double Denominator = Samples * SumXX - SumX * SumX;
+		if (Samples >= MinCostSamples && Denominator > 0.0)
+		{
+			SecondsPerByte = (Samples * SumXY - SumX * SumY) / Denominator;
+			Overhead = FMath::Max(0.0, (SumY - SecondsPerByte * SumX) / Samples);
+		}
+
+		if (SecondsPerByte > 0.0)
+		{
+			Plan.ThroughputBytesPerSecond = 1.0 / SecondsPerByte;
+			Plan.PerFileOverheadSeconds = Overhead;
+		}
+		else
+		{
+			// 이 프로세스의 이력이 부족하면 지난 실행에서 저장한 값, 그것도 없으면 기본값
+			Plan.ThroughputBytesPerSecond = DefaultThroughputBytesPerSecond;
+			Plan.PerFileOverheadSeconds = DefaultPerFileOverheadSeconds;
+
+			FString JsonText;
+			TSharedPtr<FJsonObject> Saved;
+			if (FFileHelper::LoadFileToString(JsonText, *GetCostModelPath())
+				&& FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(JsonText), Saved) && Saved.IsValid())
+			{
+				Saved->TryGetNumberField(TEXT("ThroughputBytesPerSecond"), Plan.ThroughputBytesPerSecond);
+				Saved->TryGetNumberField(TEXT("PerFileOverheadSeconds"), Plan.PerFileOverheadSeconds);
+				Plan.ThroughputBytesPerSecond = FMath::Max(Plan.ThroughputBytesPerSecond, 1.0);
+			}
+		}
+
+		// 이력의 시간은 연결 하나 기준이므로 현재 동시 전송 수로 나눈다
+		Plan.EstimatedConcurrency = FMath::Max(1, FtpConcurrency::GetController(Plan.Server, GServerMaxConnections)->GetLimit());
+		Plan.EstimatedSeconds = (Plan.GetNumTransfers() * Plan.PerFileOverheadSeconds + Plan.BytesToTransfer / Plan.ThroughputBytesPerSecond) / Plan.EstimatedConcurrency;
+	}
+
+	static void SaveCostModel(const FFtpTransferPlan& Plan)
+	{
+		TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+		Root->SetNumberField(TEXT("ThroughputBytesPerSecond"), Plan.ThroughputBytesPerSecond);
+		Root->SetNumberField(TEXT("PerFileOverheadSeconds"), Plan.PerFileOverheadSeconds);
+		Root->SetStringField(TEXT("Updated"), FDateTime::UtcNow().ToIso8601());
+
+		FString JsonText;
+		FJsonSerializer::Serialize(Root, TJsonWriterFactory<>::Create(&JsonText));
+		FFileHelper::SaveStringToFile(JsonText, *GetCostModelPath());
+	}
+
+	static int32 DeleteRemoteFiles(const FFtpTransferPlan& Plan, const TArray<int32>& FileIndices)
+	{
+		FFtpUserConfig* UserConfig = GetUser(Plan.User);
+		if (!UserConfig || FileIndices.Num() == 0)
+		{
+			return FileIndices.Num();
+		}
+
+		if (!HasPermission(Plan.User, TEXT("Delete")))
+		{
+			LogFtpMessage(FString::Printf(TEXT("Plan delete skipped: User %s lacks delete permission"), *Plan.User), true);
+			return FileIndices.Num();
+		}
+
+		FString DeleteConfig;
+		TStringBuilder<512> RemotePath;
+		for (const int32 FileIndex : FileIndices)
+		{
+			RemotePath.Reset();
+			Plan.Files.AppendRemotePath(FileIndex, Plan.RemoteRoot, RemotePath);
+			FString CommandPath(RemotePath.ToView());
+			CommandPath.RemoveFromStart(TEXT("/"));
+			DeleteConfig += FString::Printf(TEXT("quote = \"*DELE %s\"\n"), *EscapeCurlConfigValue(CommandPath));
+		}
+
+		const FString DeletePath = FPaths::ConvertRelativePathToFull(FPaths::CreateTempFilename(*GetCurlPrivateDir(), TEXT("plan"), TEXT(".cfg")));
+		if (!FFileHelper::SaveStringToFile(DeleteConfig, *DeletePath))
+		{
+			return FileIndices.Num();
+		}
+
+		FFtpCurlSessionScope CurlSession;
+		// 응답은 -v 출력의 "< 250" 줄 수로 센다
+		const FString Command = FString::Printf(TEXT("%s -K \"%s\" \"%s\" --list-only --ftp-pasv --silent --verbose"),
+			*BuildCurlSessionArgs(UserConfig->Username, UserConfig->Password, GFtpSecurityConfig.bUseFtps), *DeletePath, *CreateFtpUrl(Plan.User, TEXT("/")));
+
+		FString Output, Error;
+		ExecuteCurlCommand(Command, Output, Error);
+		IFileManager::Get().Delete(*DeletePath);
+
+		TArray<FString> Lines;
+		Error.ParseIntoArrayLines(Lines);
+
+		int32 Deleted = 0;
+		bool bAfterDele = false;
+		for (const FString& Line : Lines)
+		{
+			if (Line.StartsWith(TEXT("> ")))
+			{
+				bAfterDele = Line.StartsWith(TEXT("> DELE "));
+			}
+			else if (bAfterDele && Line.StartsWith(TEXT("< 250")))
+			{
+				++Deleted;
+				bAfterDele = false;
+			}
+		}
+
+		LogFtpMessage(FString::Printf(TEXT("Plan: deleted %d/%d remote file(s)"), Deleted, FileIndices.Num()), Deleted < FileIndices.Num());
+		return FileIndices.Num() - Deleted;
+	}
+
+	FFtpSyncStats ExecutePlan(const FFtpTransferPlan& Plan, const FString& Pass)
+	{
+		if (!AuthenticateUser(Plan.User, Pass))
+		{
+			LogFtpMessage(FString::Printf(TEXT("Plan execution failed: authentication failed for %s"), *Plan.User), true);
+			return FFtpSyncStats::Aborted();
+		}
+
+		TArray<int32> UploadIndices;
+		TArray<int32> DeleteIndices;
+		UploadIndices.Reserve(Plan.GetNumTransfers());
+		for (const FFtpPlanEntry& Entry : Plan.Entries)
+		{
+			if (Entry.Action == EFtpPlanAction::Create || Entry.Action == EFtpPlanAction::Update)
+			{
+				UploadIndices.Add(Entry.FileIndex);
+			}
+			else if (Entry.Action == EFtpPlanAction::Delete && Plan.bMirrorDeletes)
+			{
+				DeleteIndices.Add(Entry.FileIndex);
+			}
+		}
+
+		LogFtpMessage(FString::Printf(TEXT("Executing plan %s -> %s: %s"), *Plan.LocalRoot, *Plan.RemoteRoot, *DescribePlan(Plan)));
+
+		const double StartTime = FPlatformTime::Seconds();
+		FFtpSyncStats Stats;
+		if (UploadIndices.Num() > 0)
+		{
+			// 의존성이 먼저 도착하도록 - 중간에 멈춰도 도착한 맵은 쓸 수 있다
+			TArray<int32> OrderedIndices;
+			FtpUploadOrder::OrderByDependencies(Plan.Files, &UploadIndices, TArray<FName>(), OrderedIndices);
+			Stats = UploadPathTable(Plan.Files, &OrderedIndices, Plan.RemoteRoot, Plan.Server, Plan.User);
+		}
+
+		const int32 DeleteFailures = DeleteRemoteFiles(Plan, DeleteIndices);
+		Stats.SuccessCount += DeleteIndices.Num() - DeleteFailures;
+		Stats.FailCount += DeleteFailures;
+
+		const double Elapsed = FPlatformTime::Seconds() - StartTime;
+		LogFtpMessage(FString::Printf(TEXT("Plan executed in %.1fs (estimated %.1fs)"), Elapsed, Plan.EstimatedSeconds));
+
+		// 이번 실행 기록으로 비용 모델을 갱신해 다음 프로세스의 추정에 쓴다
+		if (UploadIndices.Num() > 0)
+		{
+			FFtpTransferPlan Measured;
+			Measured.Server = Plan.Server;
+			EstimateCost(Measured);
+			SaveCostModel(Measured);
+		}
+
+		return Stats;
+	}
+
+	FString SerializePlan(const FFtpTransferPlan& Plan)
+	{
+		TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+		Root->SetStringField(TEXT("Local"), Plan.LocalRoot);
+		Root->SetStringField(TEXT("Remote"), Plan.RemoteRoot);
+		Root->SetStringField(TEXT("Server"), Plan.Server);
+		Root->SetStringField(TEXT("User"), Plan.User);
+		Root->SetStringField(TEXT("Created"), Plan.CreatedAt.ToIso8601());
+		Root->SetBoolField(TEXT("RemoteListed"), Plan.bRemoteListed);
+		Root->SetBoolField(TEXT("MirrorDeletes"), Plan.bMirrorDeletes);
+
+		TSharedRef<FJsonObject> Summary = MakeShared<FJsonObject>();
+		Summary->SetNumberField(TEXT("Create"), Plan.NumCreate);
+		Summary->SetNumberField(TEXT("Update"), Plan.NumUpdate);
+		Summary->SetNumberField(TEXT("Skip"), Plan.NumSkip);
+		Summary->SetNumberField(TEXT("Delete"), Plan.NumDelete);
+		Summary->SetNumberField(TEXT("Bytes"), (double)Plan.BytesToTransfer);
+		Summary->SetNumberField(TEXT("ThroughputBytesPerSecond"), Plan.ThroughputBytesPerSecond);
+		Summary->SetNumberField(TEXT("PerFileOverheadSeconds"), Plan.PerFileOverheadSeconds);
+		Summary->SetNumberField(TEXT("Concurrency"), Plan.EstimatedConcurrency);
+		Summary->SetNumberField(TEXT("EstimatedSeconds"), Plan.EstimatedSeconds);
+		Root->SetObjectField(TEXT("Summary"), Summary);
+
+		TArray<TSharedPtr<FJsonValue>> Entries;
+		Entries.Reserve(Plan.Entries.Num());
+		for (const FFtpPlanEntry& Entry : Plan.Entries)
+		{
+			TSharedRef<FJsonObject> Item = MakeShared<FJsonObject>();
+			Item->SetStringField(TEXT("Path"), Plan.Files.GetRelativePath(Entry.FileIndex));
+			Item->SetStringField(TEXT("Action"), LexToString(Entry.Action));
+			Item->SetNumberField(TEXT("Size"), (double)Entry.LocalSize);
+			if (Entry.RemoteSize >= 0)
+			{
+				Item->SetNumberField(TEXT("RemoteSize"), (double)Entry.RemoteSize);
+			}
+			if (Entry.RemoteModified.GetTicks() > 0)
+			{
+				Item->SetStringField(TEXT("RemoteModified"), Entry.RemoteModified.ToIso8601());
+			}
+			Entries.Add(MakeShared<FJsonValueObject>(Item));
+		}
+		Root->SetArrayField(TEXT("Entries"), Entries);
+
+		FString JsonText;
+		FJsonSerializer::Serialize(Root, TJsonWriterFactory<>::Create(&JsonText));
+		return JsonText;
+	}
+
+	bool ParsePlan(const FString& JsonText, FFtpTransferPlan& OutPlan)
+	{
+		TSharedPtr<FJsonObject> Root;
+		if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(JsonText), Root) || !Root.IsValid())
+		{
+			return false;
+		}
+
+		OutPlan = FFtpTransferPlan();
+		Root->TryGetStringField(TEXT("Local"), OutPlan.LocalRoot);
+		Root->TryGetStringField(TEXT("Remote"), OutPlan.RemoteRoot);
+		Root->TryGetStringField(TEXT("Server"), OutPlan.Server);
+		Root->TryGetStringField(TEXT("User"), OutPlan.User);
+		Root->TryGetBoolField(TEXT("RemoteListed"), OutPlan.bRemoteListed);
+		Root->TryGetBoolField(TEXT("MirrorDeletes"), OutPlan.bMirrorDeletes);
+
+		FString Created;
+		if (Root->TryGetStringField(TEXT("Created"), Created))
+		{
+			FDateTime::ParseIso8601(*Created, OutPlan.CreatedAt);
+		}
+
+		const TSharedPtr<FJsonObject>* Summary = nullptr;
+		if (Root->TryGetObjectField(TEXT("Summary"), Summary))
+		{
+			(*Summary)->TryGetNumberField(TEXT("ThroughputBytesPerSecond"), OutPlan.ThroughputBytesPerSecond);
+			(*Summary)->TryGetNumberField(TEXT("PerFileOverheadSeconds"), OutPlan.PerFileOverheadSeconds);
+			(*Summary)->TryGetNumberField(TEXT("Concurrency"), OutPlan.EstimatedConcurrency);
+			(*Summary)->TryGetNumberField(TEXT("EstimatedSeconds"), OutPlan.EstimatedSeconds);
+		}
+
+		const TArray<TSharedPtr<FJsonValue>>* Entries = nullptr;
+		if (OutPlan.LocalRoot.IsEmpty() || !Root->TryGetArrayField(TEXT("Entries"), Entries))
+		{
+			return false;
+		}
+
+		OutPlan.Files = FFtpPathTable(OutPlan.LocalRoot);
+		OutPlan.Entries.Reserve(Entries->Num());
+		for (const TSharedPtr<FJsonValue>& Value : *Entries)
+		{
+			const TSharedPtr<FJsonObject>* Item = nullptr;
+			FString Path;
+			FString ActionText;
+			if (!Value.IsValid() || !Value->TryGetObject(Item) || !(*Item)->TryGetStringField(TEXT("Path"), Path) || !(*Item)->TryGetStringField(TEXT("Action"), ActionText))
+			{
+				continue;
+			}
+
+			FFtpPlanEntry Entry;
+			if (ActionText == LexToString(EFtpPlanAction::Create))
+			{
+				Entry.Action = EFtpPlanAction::Create;
+			}
+			else if (ActionText == LexToString(EFtpPlanAction::Update))
+			{
+				Entry.Action = EFtpPlanAction::Update;
+			}
+			else if (ActionText == LexToString(EFtpPlanAction::Delete))
+			{
+				Entry.Action = EFtpPlanAction::Delete;
+			}
+			else
+			{
+				Entry.Action = EFtpPlanAction::Skip;
+			}
+
+			(*Item)->TryGetNumberField(TEXT("Size"), Entry.LocalSize);
+			(*Item)->TryGetNumberField(TEXT("RemoteSize"), Entry.RemoteSize);
+			FString RemoteModified;
+			if ((*Item)->TryGetStringField(TEXT("RemoteModified"), RemoteModified))
+			{
+				FDateTime::ParseIso8601(*RemoteModified, Entry.RemoteModified);
+			}
+
+			Entry.FileIndex = OutPlan.Files.AddFile(Path, Entry.LocalSize);
+			OutPlan.Entries.Add(Entry);
+
+			switch (Entry.Action)
+			{
+			case EFtpPlanAction::Create:
+				++OutPlan.NumCreate;
+				OutPlan.BytesToTransfer += FMath::Max<int64>(Entry.LocalSize, 0);
+				break;
+			case EFtpPlanAction::Update:
+				++OutPlan.NumUpdate;
+				OutPlan.BytesToTransfer += FMath::Max<int64>(Entry.LocalSize, 0);
+				break;
+			case EFtpPlanAction::Delete:
+				++OutPlan.NumDelete;
+				break;
+			default:
+				++OutPlan.NumSkip;
+				break;
+			}
+		}
+
+		return true;
+	}
+
+	bool SavePlan(const FFtpTransferPlan& Plan, const FString& FilePath)
+	{
+		if (!FFileHelper::SaveStringToFile(SerializePlan(Plan), *FilePath))
+		{
+			LogFtpMessage(FString::Printf(TEXT("Cannot write plan %s"), *FilePath), true);
+			return false;
+		}
+		return true;
+	}
+
+	bool LoadPlan(const FString& FilePath, FFtpTransferPlan& OutPlan)
+	{
+		FString JsonText;
+		if (!FFileHelper::LoadFileToString(JsonText, *FilePath) || !ParsePlan(JsonText, OutPlan))
+		{
+			LogFtpMessage(FString::Printf(TEXT("Cannot read plan %s"), *FilePath), true);
+			return false;
+		}
+		return true;
+	}
+
+	FString DescribePlan(const FFtpTransferPlan& Plan)
+	{
+		const int64 Seconds = FMath::CeilToInt64(Plan.EstimatedSeconds);
+		return FString::Printf(TEXT("%d create, %d update, %d skip, %d delete, %.1f MB, ETA %lldm %llds%s"),
+			Plan.NumCreate, Plan.NumUpdate, Plan.NumSkip, Plan.NumDelete, Plan.BytesToTransfer / (1024.0 * 1024.0),
+			Seconds / 60, Seconds % 60, Plan.bRemoteListed ? TEXT("") : TEXT(" (remote not listed)"));
+	}
+
+	const TCHAR* LexToString(EFtpPlanAction Action)
+	{
+		switch (Action)
+		{
+		case EFtpPlanAction::Create:
+			return TEXT("Create");
+		case EFtpPlanAction::Update:
+			return TEXT("Update");
+		case EFtpPlanAction::Delete:
+			return TEXT("Delete");
+		default:
+			return TEXT("Skip");
+		}
+	}
+}
@@ -0,0 +1,197 @@
+#include "FtpUploadOrder.h"
+#include "FtpPathTable.h"
+#include "FtpSystem.h"
+#include "FileUpLoadStats.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Editor.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Order Uploads By Dependencies"), STAT_FileUpLoad_OrderUploads, STATGROUP_FileUpLoad);
+
+namespace FtpUploadOrder
+{
+	// 패키지 하나를 이루는 파일들
+	struct FPackageFiles
+	{
+		FName PackageName;
+		// .uexp/.ubulk/.uptnl - 헤더보다 먼저 보낸다
+		TArray<int32, TInlineAllocator<2>> Companions;
+		// .uasset/.umap
+		int32 Header = INDEX_NONE;
+		bool bIsMap = false;
+		// 같은 업로드에 들어 있는 의존 패키지 (FPackageFiles 인덱스)
+		TArray<int32> Dependencies;
+	};
+
+	static bool IsHeaderExtension(const FString& Extension)
+	{
+		return Extension == TEXT("uasset") || Extension == TEXT("umap");
+	}
+
+	static bool IsCompanionExtension(const FString& Extension)
+	{
+		return Extension == TEXT("uexp") || Extension == TEXT("ubulk") || Extension == TEXT("uptnl");
+	}
+
+	// 의존성부터 내보내는 반복 깊이 우선 탐색 (순환은 먼저 만난 쪽에서 끊는다)
+	static void EmitPostOrder(TArray<FPackageFiles>& Packages, int32 Root, TBitArray<>& Visited, TArray<int32>& OutOrder)
+	{
+		if (Visited[Root])
+		{
+			return;
+		}
+
+		struct FFrame
+		{
+			int32 Package;
+			int32 NextDependency;
+		};
+		TArray<FFrame, TInlineAllocator<64>> Stack;
+		Stack.Add({ Root, 0 });
+		Visited[Root] = true;
+
+		while (Stack.Num() > 0)
+		{
+			FFrame& Top = Stack.Last();
+			const FPackageFiles& Package = Packages[Top.Package];
+			if (Top.NextDependency < Package.Dependencies.Num())
+			{
+				const int32 Dependency = Package.Dependencies[Top.NextDependency++];
+				if (!Visited[Dependency])
+				{
+					Visited[Dependency] = true;
+					Stack.Add({ Dependency, 0 });
+				}
+				continue;
+			}
+
+			OutOrder.Append(Package.Companions);
+			if (Package.Header != INDEX_NONE)
+			{
+				OutOrder.Add(Package.Header);
+			}
+			Stack.Pop();
+		}
+	}
+
+	void OrderByDependencies(const FFtpPathTable& Files, const TArray<int32>* FileIndices, const TArray<FName>& PriorityPackages, TArray<int32>& OutOrder)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_FileUpLoad_OrderUploads);
+
+		const int32 NumFiles = FileIndices ? FileIndices->Num() : Files.Num();
+		OutOrder.Reset(NumFiles);
+
+		IAssetRegistry* AssetRegistry = IAssetRegistry::Get();
+		if (AssetRegistry == nullptr)
+		{
+			for (int32 Position = 0; Position < NumFiles; ++Position)
+			{
+				OutOrder.Add(FileIndices ? (*FileIndices)[Position] : Position);
+			}
+			return;
+		}
+
+		// 1) 파일을 패키지로 묶는다
+		TArray<FPackageFiles> Packages;
+		TMap<FName, int32> PackageLookup;
+		TArray<int32> OtherFiles;
+		TStringBuilder<512> PathBuilder;
+		for (int32 Position = 0; Position < NumFiles; ++Position)
+		{
+			const int32 FileIndex = FileIndices ? (*FileIndices)[Position] : Position;
+
+			PathBuilder.Reset();
+			Files.AppendFullPath(FileIndex, PathBuilder);
+			const FString FullPath(PathBuilder.ToView());
+			const FString Extension = FPaths::GetExtension(FullPath);
+
+			const bool bHeader = IsHeaderExtension(Extension);
+			FString PackageNameText;
+			if ((!bHeader && !IsCompanionExtension(Extension)) || !FPackageName::TryConvertFilenameToLongPackageName(FPaths::ChangeExtension(FullPath, TEXT("uasset")), PackageNameText))
+			{
+				OtherFiles.Add(FileIndex);
+				continue;
+			}
+
+			const FName PackageName(*PackageNameText);
+			int32* Existing = PackageLookup.Find(PackageName);
+			const int32 PackageIndex = Existing ? *Existing : Packages.Num();
+			if (Existing == nullptr)
+			{
+				PackageLookup.Add(PackageName, PackageIndex);
+				Packages.AddDefaulted_GetRef().PackageName = PackageName;
+			}
+
+			FPackageFiles& Package = Packages[PackageIndex];
+			if (bHeader)
+			{
+				Package.Header = FileIndex;
+				Package.bIsMap = Extension == TEXT("umap");
+			}
+			else
+			{
+				Package.Companions.Add(FileIndex);
+			}
+		}
+
+		if (AssetRegistry->IsLoadingAssets())
+		{
+			LogFtpMessage(TEXT("Asset registry is still scanning; upload order may be incomplete"));
+		}
+
+		// 2) 이번 업로드 안의 하드 의존성만 남긴다
+		TArray<FName> Dependencies;
+		for (FPackageFiles& Package : Packages)
+		{
+			Dependencies.Reset();
+			AssetRegistry->GetDependencies(Package.PackageName, Dependencies, UE::AssetRegistry::EDependencyCategory::Package, UE::AssetRegistry::EDependencyQuery::Hard);
+			for (const FName& Dependency : Dependencies)
+			{
+				if (const int32* DependencyIndex = PackageLookup.Find(Dependency))
+				{
+					Package.Dependencies.Add(*DependencyIndex);
+				}
+			}
+		}
+
+		// 3) 우선 패키지 -> 맵 -> 나머지 순으로 뿌리를 잡아 잎부터 내보낸다
+		TBitArray<> Visited(false, Packages.Num());
+		for (const FName& Priority : PriorityPackages)
+		{
+			if (const int32* PackageIndex = PackageLookup.Find(Priority))
+			{
+				EmitPostOrder(Packages, *PackageIndex, Visited, OutOrder);
+			}
+		}
+		for (int32 PackageIndex = 0; PackageIndex < Packages.Num(); ++PackageIndex)
+		{
+			if (Packages[PackageIndex].bIsMap)
+			{
+				EmitPostOrder(Packages, PackageIndex, Visited, OutOrder);
+			}
+		}
+		for (int32 PackageIndex = 0; PackageIndex < Packages.Num(); ++PackageIndex)
+		{
+			EmitPostOrder(Packages, PackageIndex, Visited, OutOrder);
+		}
+
+		OutOrder.Append(OtherFiles);
+
+		LogFtpMessage(FString::Printf(TEXT("Ordered %d file(s) in %d package(s) by dependencies (%d priority)"), NumFiles, Packages.Num(), PriorityPackages.Num()));
+	}
+
+	FName GetEditorLevelPackage()
+	{
+		check(IsInGameThread());
+
+		if (GEditor == nullptr)
+		{
+			return NAME_None;
+		}
+
+		const UWorld* World = GEditor->GetEditorWorldContext().World();
+		return World ? World->GetOutermost()->GetFName() : NAME_None;
+	}
+}
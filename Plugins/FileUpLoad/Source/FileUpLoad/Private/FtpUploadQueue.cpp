@@ -0,0 +1,135 @@
+#include "FtpUploadQueue.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/Paths.h"
+#include "FtpSystem.h"
+
+FFtpUploadQueue::FFtpUploadQueue(const FString& InUsername, int32 InMaxBatchFiles)
+	: Username(InUsername)
+	, MaxBatchFiles(FMath::Max(InMaxBatchFiles, 1))
+	, WorkEvent(FPlatformProcess::GetSynchEventFromPool(false))
+	, Thread(nullptr)
+	, bStopping(false)
+	, NumInFlight(0)
+	, NumUploaded(0)
+	, NumFailed(0)
+{
+	Thread = FRunnableThread::Create(this, TEXT("FtpUploadQueue"));
+}
+
+FFtpUploadQueue::~FFtpUploadQueue()
+{
+	if (Thread != nullptr)
+	{
+		Thread->Kill(true);
+		delete Thread;
+		Thread = nullptr;
+	}
+
+	FPlatformProcess::ReturnSynchEventToPool(WorkEvent);
+	WorkEvent = nullptr;
+}
+
+void FFtpUploadQueue::Enqueue(const FString& LocalPath, const FString& RemotePath)
+{
+	{
+		FScopeLock ScopeLock(&Lock);
+
+		bool bAlreadyPending = false;
+		PendingPaths.Add(LocalPath, &bAlreadyPending);
+		if (bAlreadyPending)
+		{
+			return;
+		}
+
+		FFtpUploadRequest& Request = Pending.AddDefaulted_GetRef();
+		Request.LocalPath = LocalPath;
+		Request.RemotePath = RemotePath;
+	}
+
+	WorkEvent->Trigger();
+}
+
+int32 FFtpUploadQueue::GetNumPending() const
+{
+	FScopeLock ScopeLock(&Lock);
+	return Pending.Num();
+}
+
+bool FFtpUploadQueue::WaitUntilIdle(double TimeoutSeconds) const
+{
+	const double EndTime = FPlatformTime::Seconds() + TimeoutSeconds;
+	while (GetNumPending() > 0 || NumInFlight.Load() > 0)
+	{
+		if (FPlatformTime::Seconds() >= EndTime)
+		{
+			return false;
+		}
+		FPlatformProcess::Sleep(0.05f);
+	}
+	return true;
+}
+
+uint32 FFtpUploadQueue::Run()
+{
+	while (!bStopping)
+	{
+		WorkEvent->Wait();
+
+		while (!bStopping)
+		{
+			// 대기 중인 요청을 최대 MaxBatchFiles개 꺼낸다 - 전송 중에 같은 파일이 다시 바뀌면 새로 큐에 들어온다
+			TArray<FFtpUploadRequest> Batch;
+			{
+				FScopeLock ScopeLock(&Lock);
+				if (Pending.Num() == 0)
+				{
+					break;
+				}
+				const int32 NumTaken = FMath::Min(Pending.Num(), MaxBatchFiles);
+				Batch.Reserve(NumTaken);
+				for (int32 Index = 0; Index < NumTaken; ++Index)
+				{
+					PendingPaths.Remove(Pending[Index].LocalPath);
+					Batch.Add(MoveTemp(Pending[Index]));
+				}
+				Pending.RemoveAt(0, NumTaken, false);
+				NumInFlight += Batch.Num();
+			}
+
+			// 임시 파일처럼 큐에 있는 동안 사라진 경우
+			const int32 NumQueued = Batch.Num();
+			Batch.RemoveAll([](const FFtpUploadRequest& Request) { return !FPaths::FileExists(Request.LocalPath); });
+
+			if (Batch.Num() == 1)
+			{
+				const bool bSuccess = UploadFile(Username, Batch[0].LocalPath, Batch[0].RemotePath);
+				NumUploaded += bSuccess ? 1 : 0;
+				NumFailed += bSuccess ? 0 : 1;
+			}
+			else if (Batch.Num() > 1)
+			{
+				TArray<bool> BatchSuccess;
+				UploadFilesBatch(Username, Batch, BatchSuccess);
+				for (const bool bSuccess : BatchSuccess)
+				{
+					NumUploaded += bSuccess ? 1 : 0;
+					NumFailed += bSuccess ? 0 : 1;
+				}
+			}
+
+			NumInFlight -= NumQueued;
+		}
+	}
+
+	return 0;
+}
+
+void FFtpUploadQueue::Stop()
+{
+	bStopping = true;
+	WorkEvent->Trigger();
+}
@@ -0,0 +1,268 @@
+#include "FtpVirtualFileSystem.h"
+#include "FtpSystem.h"
+#include "FileUpLoadStats.h"
+#include "HAL/PlatformFilemanager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Paths.h"
+
+#if PLATFORM_LINUX || PLATFORM_MAC
+#include <limits.h>
+#include <stdlib.h>
+#endif
+
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("VFS Path Cache Hits"), STAT_FileUpLoad_VfsCacheHits, STATGROUP_FileUpLoad);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("VFS Path Cache Misses"), STAT_FileUpLoad_VfsCacheMisses, STATGROUP_FileUpLoad);
+
+namespace FtpVfs
+{
+	// 심볼릭 링크를 모두 푼 절대 경로 - 다른 플랫폼에서는 그대로
+	static FString GetRealPath(const FString& Path)
+	{
+#if PLATFORM_LINUX || PLATFORM_MAC
+		ANSICHAR Resolved[PATH_MAX];
+		if (realpath(TCHAR_TO_UTF8(*Path), Resolved) != nullptr)
+		{
+			return UTF8_TO_TCHAR(Resolved);
+		}
+#endif
+		return Path;
+	}
+}
+
+FFtpVirtualFileSystem::FFtpVirtualFileSystem(const FString& InServerRoot, const FFtpUserConfig& User)
+	: WorkingDirectory(TEXT("/"))
+{
+	FString HomeLogical;
+	if (!NormalizeLogicalPath(TEXT("/"), User.HomeDirectory, HomeLogical))
+	{
+		HomeLogical = TEXT("/");
+	}
+	HomeDirectory = FPaths::ConvertRelativePathToFull(InServerRoot / HomeLogical.RightChop(1));
+	FPaths::NormalizeDirectoryName(HomeDirectory);
+
+	for (const FString& Permission : User.Permissions)
+	{
+		if (Permission == TEXT("Read"))
+		{
+			Permissions |= EFtpVfsPermission::Read;
+		}
+		else if (Permission == TEXT("Write"))
+		{
+			Permissions |= EFtpVfsPermission::Write;
+		}
+		else if (Permission == TEXT("Delete"))
+		{
+			Permissions |= EFtpVfsPermission::Delete;
+		}
+		else if (Permission == TEXT("Admin"))
+		{
+			Permissions |= EFtpVfsPermission::Admin;
+		}
+	}
+}
+
+bool FFtpVirtualFileSystem::EnsureHomeDirectory()
+{
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	if (!PlatformFile.DirectoryExists(*HomeDirectory) && !PlatformFile.CreateDirectoryTree(*HomeDirectory))
+	{
+		LogFtpMessage(FString::Printf(TEXT("Cannot create home directory %s"), *HomeDirectory), true);
+		return false;
+	}
+
+	HomeRealPath = FtpVfs::GetRealPath(HomeDirectory) / TEXT("");
+	return true;
+}
+
+bool FFtpVirtualFileSystem::NormalizeLogicalPath(const FString& Base, const FString& Argument, FString& OutLogicalPath)
+{
+	// 역슬래시/드라이브 문자는 로컬 경로 조립에서 다르게 해석될 수 있다
+	int32 Unused = 0;
+	if (Argument.FindChar(TEXT('\\'), Unused) || Argument.FindChar(TEXT(':'), Unused) || Argument.FindChar(TEXT('\0'), Unused))
+	{
+		return false;
+	}
+
+	TArray<FStringView, TInlineAllocator<32>> Parts;
+	auto AddParts = [&Parts](FStringView Path)
+	{
+		while (Path.Len() > 0)
+		{
+			int32 Slash = INDEX_NONE;
+			const FStringView Part = Path.FindChar(TEXT('/'), Slash) ? Path.Left(Slash) : Path;
+			Path.RightChopInline(Slash == INDEX_NONE ? Path.Len() : Slash + 1);
+
+			if (Part.IsEmpty() || Part == TEXT("."))
+			{
+				continue;
+			}
+			if (Part == TEXT(".."))
+			{
+				// 루트에서 멈춘다 - 홈 밖으로 나갈 수 없다
+				if (Parts.Num() > 0)
+				{
+					Parts.Pop();
+				}
+				continue;
+			}
+			Parts.Add(Part);
+		}
+	};
+
+	if (!Argument.StartsWith(TEXT("/")))
+	{
+		AddParts(Base);
+	}
+	AddParts(Argument);
+
+	TStringBuilder<256> Builder;
+	for (const FStringView& Part : Parts)
+	{
+		Builder << TEXT('/') << Part;
+	}
+	OutLogicalPath = Parts.Num() > 0 ? FString(Builder.ToView()) : FString(TEXT("/"));
+	return true;
+}
+
+const FFtpVfsEntry* FFtpVirtualFileSystem::Resolve(const FString& Argument)
+{
+	const FString* CachedLogical = ArgumentCache.Find(Argument);
+	FString LogicalPath;
+	if (CachedLogical != nullptr)
+	{
+		LogicalPath = *CachedLogical;
+	}
+	else
+	{
+		if (!NormalizeLogicalPath(WorkingDirectory, Argument, LogicalPath))
+		{
+			return nullptr;
+		}
+		if (ArgumentCache.Num() >= MaxCachedPaths)
+		{
+			ArgumentCache.Reset();
+		}
+		ArgumentCache.Add(Argument, LogicalPath);
+	}
+
+	FFtpVfsEntry* Entry = FindOrAddEntry(LogicalPath);
+	if (Entry == nullptr)
+	{
+		return nullptr;
+	}
+
+	if (FPlatformTime::Seconds() - Entry->StatTime > StatTtlSeconds)
+	{
+		INC_DWORD_STAT(STAT_FileUpLoad_VfsCacheMisses);
+		Stat(*Entry);
+	}
+	else
+	{
+		INC_DWORD_STAT(STAT_FileUpLoad_VfsCacheHits);
+	}
+
+	if (!Entry->bInsideHomeChecked)
+	{
+		if (!IsInsideHome(Entry->LocalPath, Entry->bExists))
+		{
+			EntryCache.Remove(LogicalPath);
+			return nullptr;
+		}
+		Entry->bInsideHomeChecked = true;
+	}
+	return Entry;
+}
+
+bool FFtpVirtualFileSystem::ChangeDirectory(const FString& Argument)
+{
+	const FFtpVfsEntry* Entry = Resolve(Argument);
+	if (Entry == nullptr || !Entry->bExists || !Entry->bIsDirectory)
+	{
+		return false;
+	}
+
+	if (WorkingDirectory != Entry->LogicalPath)
+	{
+		WorkingDirectory = Entry->LogicalPath;
+		// 상대 경로 인수의 의미가 바뀐다
+		ArgumentCache.Reset();
+	}
+	return true;
+}
+
+void FFtpVirtualFileSystem::CacheChild(const FString& DirectoryLogicalPath, const FString& Name, bool bIsDirectory, int64 Size, const FDateTime& Modified)
+{
+	const FString LogicalPath = DirectoryLogicalPath == TEXT("/") ? TEXT("/") + Name : DirectoryLogicalPath / Name;
+	FFtpVfsEntry* Entry = FindOrAddEntry(LogicalPath);
+	if (Entry != nullptr)
+	{
+		Entry->bExists = true;
+		Entry->bIsDirectory = bIsDirectory;
+		Entry->Size = bIsDirectory ? -1 : Size;
+		Entry->Modified = Modified;
+		Entry->StatTime = FPlatformTime::Seconds();
+	}
+}
+
+void FFtpVirtualFileSystem::Invalidate(const FString& LogicalPath)
+{
+	EntryCache.Remove(LogicalPath);
+	// 부모 디렉토리의 수정 시각도 바뀐다
+	EntryCache.Remove(FPaths::GetPath(LogicalPath).IsEmpty() ? FString(TEXT("/")) : FPaths::GetPath(LogicalPath));
+}
+
+void FFtpVirtualFileSystem::InvalidateAll()
+{
+	ArgumentCache.Reset();
+	EntryCache.Reset();
+}
+
+FFtpVfsEntry* FFtpVirtualFileSystem::FindOrAddEntry(const FString& LogicalPath)
+{
+	if (FFtpVfsEntry* Existing = EntryCache.Find(LogicalPath))
+	{
+		return Existing;
+	}
+
+	if (EntryCache.Num() >= MaxCachedPaths)
+	{
+		EntryCache.Reset();
+	}
+
+	FFtpVfsEntry& Entry = EntryCache.Add(LogicalPath);
+	Entry.LogicalPath = LogicalPath;
+	Entry.LocalPath = LogicalPath == TEXT("/") ? HomeDirectory : HomeDirectory + LogicalPath;
+	return &Entry;
+}
+
+void FFtpVirtualFileSystem::Stat(FFtpVfsEntry& Entry) const
+{
+	const FFileStatData StatData = FPlatformFileManager::Get().GetPlatformFile().GetStatData(*Entry.LocalPath);
+	Entry.bExists = StatData.bIsValid;
+	Entry.bIsDirectory = StatData.bIsValid && StatData.bIsDirectory;
+	Entry.Size = StatData.bIsValid && !StatData.bIsDirectory ? StatData.FileSize : -1;
+	Entry.Modified = StatData.ModificationTime;
+	Entry.StatTime = FPlatformTime::Seconds();
+	// 링크가 바뀌었을 수 있으므로 다시 확인한다
+	Entry.bInsideHomeChecked = false;
+}
+
+bool FFtpVirtualFileSystem::IsInsideHome(const FString& LocalPath, bool bExists) const
+{
+#if PLATFORM_LINUX || PLATFORM_MAC
+	if (HomeRealPath.IsEmpty())
+	{
+		return true;
+	}
+
+	// 아직 없는 경로(STOR 대상)는 부모 디렉토리로 판단한다
+	const FString Existing = bExists ? LocalPath : FPaths::GetPath(LocalPath);
+	const FString RealPath = FtpVfs::GetRealPath(Existing) / TEXT("");
+	if (!RealPath.StartsWith(HomeRealPath, ESearchCase::CaseSensitive))
+	{
+		LogFtpMessage(FString::Printf(TEXT("Rejected path outside home: %s"), *LocalPath), true);
+		return false;
+	}
+#endif
+	return true;
+}
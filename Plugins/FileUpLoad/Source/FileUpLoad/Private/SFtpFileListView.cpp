@@ -0,0 +1,190 @@
+#include "SFtpFileListView.h"
+#include "Widgets/Input/SSearchBox.h"
+#include "Widgets/Layout/SBox.h"
+#include "Widgets/Text/STextBlock.h"
+#include "Widgets/Views/SHeaderRow.h"
+
+#define LOCTEXT_NAMESPACE "FFileUpLoadModule"
+
+namespace FtpFileListView
+{
+	FText GetStatusText(EFtpListEntryStatus Status)
+	{
+		switch (Status)
+		{
+		case EFtpListEntryStatus::Pending:   return LOCTEXT("FtpListStatusPending", "Pending");
+		case EFtpListEntryStatus::Succeeded: return LOCTEXT("FtpListStatusSucceeded", "Succeeded");
+		case EFtpListEntryStatus::Failed:    return LOCTEXT("FtpListStatusFailed", "Failed");
+		case EFtpListEntryStatus::PlanCreate: return LOCTEXT("FtpListStatusPlanCreate", "Create");
+		case EFtpListEntryStatus::PlanUpdate: return LOCTEXT("FtpListStatusPlanUpdate", "Update");
+		case EFtpListEntryStatus::PlanSkip:   return LOCTEXT("FtpListStatusPlanSkip", "Skip");
+		case EFtpListEntryStatus::PlanDelete: return LOCTEXT("FtpListStatusPlanDelete", "Delete");
+		default:                             return FText::GetEmpty();
+		}
+	}
+}
+
+// 목록 행 - 경로/크기/시간은 생성 시 고정하고 상태만 매 프레임 모델에서 읽는다
+class SFtpFileListRow : public SMultiColumnTableRow<FFtpListItemPtr>
+{
+public:
+	SLATE_BEGIN_ARGS(SFtpFileListRow) {}
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs, const TSharedRef<STableViewBase>& InOwnerTable, FFtpListItemPtr InItem, TSharedPtr<FFtpFileListModel> InModel)
+	{
+		Item = InItem;
+		Model = InModel;
+
+		SMultiColumnTableRow<FFtpListItemPtr>::Construct(FSuperRowType::FArguments(), InOwnerTable);
+	}
+
+	virtual TSharedRef<SWidget> GenerateWidgetForColumn(const FName& ColumnName) override
+	{
+		const int32 Index = Item->Index;
+
+		if (ColumnName == FFtpListColumns::Path)
+		{
+			return SNew(STextBlock).Text(FText::FromString(Model->GetPath(Index)));
+		}
+		if (ColumnName == FFtpListColumns::Size)
+		{
+			return SNew(STextBlock).Text(FText::AsMemory(Model->GetSize(Index)));
+		}
+		if (ColumnName == FFtpListColumns::Time)
+		{
+			return SNew(STextBlock).Text(FText::AsDateTime(Model->GetTime(Index)));
+		}
+		if (ColumnName == FFtpListColumns::Status)
+		{
+			return SNew(STextBlock).Text(this, &SFtpFileListRow::GetStatusText);
+		}
+
+		return SNullWidget::NullWidget;
+	}
+
+private:
+	FText GetStatusText() const
+	{
+		return FtpFileListView::GetStatusText(Model->GetStatus(Item->Index));
+	}
+
+	FFtpListItemPtr Item;
+	TSharedPtr<FFtpFileListModel> Model;
+};
+
+SFtpFileListView::~SFtpFileListView()
+{
+	if (Model.IsValid())
+	{
+		Model->OnViewChanged().Remove(ViewChangedHandle);
+	}
+}
+
+void SFtpFileListView::Construct(const FArguments& InArgs)
+{
+	Model = InArgs._Model;
+	check(Model.IsValid());
+
+	ViewChangedHandle = Model->OnViewChanged().AddSP(this, &SFtpFileListView::HandleViewChanged);
+
+	ChildSlot
+	[
+		SNew(SVerticalBox)
+		+ SVerticalBox::Slot()
+		.AutoHeight()
+		.Padding(0, 0, 0, 5)
+		[
+			SNew(SHorizontalBox)
+			+ SHorizontalBox::Slot()
+			.FillWidth(1.0f)
+			[
+				SNew(SSearchBox)
+				.OnTextChanged(this, &SFtpFileListView::OnFilterTextChanged)
+			]
+			+ SHorizontalBox::Slot()
+			.AutoWidth()
+			.VAlign(VAlign_Center)
+			.Padding(10, 0, 0, 0)
+			[
+				SNew(STextBlock)
+				.Text(this, &SFtpFileListView::GetCountText)
+			]
+		]
+		+ SVerticalBox::Slot()
+		.FillHeight(1.0f)
+		[
+			SAssignNew(ListView, SListView<FFtpListItemPtr>)
+			.ListItemsSource(Model->GetVisibleItems())
+			.OnGenerateRow(this, &SFtpFileListView::OnGenerateRow)
+			.SelectionMode(ESelectionMode::Multi)
+			.HeaderRow
+			(
+				SNew(SHeaderRow)
+				+ SHeaderRow::Column(FFtpListColumns::Path)
+				.DefaultLabel(InArgs._PathColumnLabel)
+				.FillWidth(0.6f)
+				.SortMode(this, &SFtpFileListView::GetColumnSortMode, FFtpListColumns::Path)
+				.OnSort(this, &SFtpFileListView::OnSortModeChanged)
+				+ SHeaderRow::Column(FFtpListColumns::Size)
+				.DefaultLabel(LOCTEXT("FtpListSizeColumn", "Size"))
+				.FillWidth(0.12f)
+				.SortMode(this, &SFtpFileListView::GetColumnSortMode, FFtpListColumns::Size)
+				.OnSort(this, &SFtpFileListView::OnSortModeChanged)
+				+ SHeaderRow::Column(FFtpListColumns::Time)
+				.DefaultLabel(LOCTEXT("FtpListTimeColumn", "Time"))
+				.FillWidth(0.18f)
+				.SortMode(this, &SFtpFileListView::GetColumnSortMode, FFtpListColumns::Time)
+				.OnSort(this, &SFtpFileListView::OnSortModeChanged)
+				+ SHeaderRow::Column(FFtpListColumns::Status)
+				.DefaultLabel(LOCTEXT("FtpListStatusColumn", "Status"))
+				.FillWidth(0.1f)
+				.SortMode(this, &SFtpFileListView::GetColumnSortMode, FFtpListColumns::Status)
+				.OnSort(this, &SFtpFileListView::OnSortModeChanged)
+			)
+		]
+	];
+}
+
+void SFtpFileListView::Tick(const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime)
+{
+	SCompoundWidget::Tick(AllottedGeometry, InCurrentTime, InDeltaTime);
+
+	// 쌓인 변경을 한 번에 반영 - 목록이 바뀌면 HandleViewChanged가 새로고침을 요청한다
+	Model->FlushPending();
+}
+
+TSharedRef<ITableRow> SFtpFileListView::OnGenerateRow(FFtpListItemPtr Item, const TSharedRef<STableViewBase>& OwnerTable)
+{
+	return SNew(SFtpFileListRow, OwnerTable, Item, Model);
+}
+
+void SFtpFileListView::OnFilterTextChanged(const FText& InFilterText)
+{
+	Model->SetFilter(InFilterText.ToString());
+}
+
+void SFtpFileListView::OnSortModeChanged(EColumnSortPriority::Type SortPriority, const FName& ColumnId, EColumnSortMode::Type InSortMode)
+{
+	Model->SetSort(ColumnId, InSortMode);
+}
+
+EColumnSortMode::Type SFtpFileListView::GetColumnSortMode(FName ColumnId) const
+{
+	return Model->GetSortColumn() == ColumnId ? Model->GetSortMode() : EColumnSortMode::None;
+}
+
+FText SFtpFileListView::GetCountText() const
+{
+	return FText::Format(LOCTEXT("FtpListCount", "{0} / {1}"), FText::AsNumber(Model->GetVisibleItems()->Num()), FText::AsNumber(Model->Num()));
+}
+
+void SFtpFileListView::HandleViewChanged()
+{
+	if (ListView.IsValid())
+	{
+		ListView->RequestListRefresh();
+	}
+}
+
+#undef LOCTEXT_NAMESPACE
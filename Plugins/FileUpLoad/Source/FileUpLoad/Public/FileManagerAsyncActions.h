@@ -0,0 +1,122 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Kismet/BlueprintAsyncActionBase.h"
+#include "FileManagerAsyncActions.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FFileManagerAsyncPathsEvent, const TArray<FString>&, Paths);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FFileManagerAsyncProgressEvent, int64, BytesDone, int64, BytesTotal);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FFileManagerAsyncResultEvent, bool, bSuccess);
+
+/**
+ * UFileManager 비동기 노드 공통 부분
+ * 작업은 백그라운드 스레드에서 돌고, 모든 출력 핀은 게임 스레드에서 불린다.
+ * 노드가 돌려주는 액션 객체의 Cancel로 중단할 수 있다.
+ */
+UCLASS(Abstract)
+class FILEUPLOAD_API UFileManagerAsyncActionBase : public UBlueprintAsyncActionBase
+{
+    GENERATED_BODY()
+
+public:
+    UFileManagerAsyncActionBase();
+
+    // 진행 중인 작업 취소 - 완료 핀 대신 OnCancelled가 불린다
+    UFUNCTION(BlueprintCallable, Category = "File Management|Async")
+    void Cancel();
+
+    UFUNCTION(BlueprintPure, Category = "File Management|Async")
+    bool IsCancelRequested() const;
+
+    virtual void Activate() override;
+
+protected:
+    // 백그라운드 스레드에서 실행되는 본 작업
+    virtual void RunInBackground() {}
+
+    // 게임 스레드로 넘겨 실행 (액션이 이미 끝났으면 버린다)
+    void RunOnGameThread(TFunction<void()>&& Callback);
+
+    // 마지막 출력 핀을 부른 뒤 호출 - 게임 스레드 전용
+    void Finish();
+
+    TSharedRef<TAtomic<bool>, ESPMode::ThreadSafe> CancelFlag;
+};
+
+/**
+ * 파일/디렉토리 목록 비동기 노드
+ * 결과를 BatchSize개씩 OnBatch로 흘려 보내고, 끝나면 전체 목록으로 OnCompleted를 부른다.
+ */
+UCLASS()
+class FILEUPLOAD_API UFileManagerListAsyncAction : public UFileManagerAsyncActionBase
+{
+    GENERATED_BODY()
+
+public:
+    UPROPERTY(BlueprintAssignable)
+    FFileManagerAsyncPathsEvent OnBatch;
+
+    UPROPERTY(BlueprintAssignable)
+    FFileManagerAsyncPathsEvent OnCompleted;
+
+    // 취소 시점까지 찾은 목록
+    UPROPERTY(BlueprintAssignable)
+    FFileManagerAsyncPathsEvent OnCancelled;
+
+    UFUNCTION(BlueprintCallable, Category = "File Management|Async", meta = (BlueprintInternalUseOnly = "true", AdvancedDisplay = "BatchSize"))
+    static UFileManagerListAsyncAction* FindFilesRecursivelyAsync(const FString& DirectoryPath, const TArray<FString>& FilePatterns, int32 BatchSize = 256);
+
+    UFUNCTION(BlueprintCallable, Category = "File Management|Async", meta = (BlueprintInternalUseOnly = "true", AdvancedDisplay = "BatchSize"))
+    static UFileManagerListAsyncAction* GetSubDirectoriesAsync(const FString& DirectoryPath, int32 BatchSize = 256);
+
+protected:
+    virtual void RunInBackground() override;
+
+private:
+    void FlushBatch(TArray<FString>& Batch);
+
+    FString DirectoryPath;
+    TArray<FString> FilePatterns;
+    int32 BatchSize = 256;
+    bool bDirectoriesOnly = false;
+
+    // 게임 스레드에서만 쌓는다
+    TArray<FString> Found;
+};
+
+/**
+ * 파일 복사/이동 비동기 노드
+ * 청크 단위로 옮기며 OnProgress를 부르고, 취소되면 쓰다 만 대상 파일을 지운다.
+ */
+UCLASS()
+class FILEUPLOAD_API UFileManagerTransferAsyncAction : public UFileManagerAsyncActionBase
+{
+    GENERATED_BODY()
+
+public:
+    UPROPERTY(BlueprintAssignable)
+    FFileManagerAsyncProgressEvent OnProgress;
+
+    UPROPERTY(BlueprintAssignable)
+    FFileManagerAsyncResultEvent OnCompleted;
+
+    UPROPERTY(BlueprintAssignable)
+    FFileManagerAsyncResultEvent OnCancelled;
+
+    UFUNCTION(BlueprintCallable, Category = "File Management|Async", meta = (BlueprintInternalUseOnly = "true"))
+    static UFileManagerTransferAsyncAction* CopyFileAsync(const FString& SourcePath, const FString& DestPath);
+
+    UFUNCTION(BlueprintCallable, Category = "File Management|Async", meta = (BlueprintInternalUseOnly = "true"))
+    static UFileManagerTransferAsyncAction* MoveFileAsync(const FString& SourcePath, const FString& DestPath);
+
+protected:
+    virtual void RunInBackground() override;
+
+private:
+    // 청크 복사 - 취소되거나 실패하면 false
+    bool CopyChunked();
+
+    FString SourcePath;
+    FString DestPath;
+    bool bMove = false;
+};
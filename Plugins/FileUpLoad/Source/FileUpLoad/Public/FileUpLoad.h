@@ -3,6 +3,7 @@
 #pragma once
 
 #include "Modules/ModuleManager.h"
+#include "Async/Future.h"
 #include "Framework/Docking/TabManager.h"
 #include "Widgets/Docking/SDockTab.h"
 
@@ -24,8 +25,8 @@ private:
 
 	void RegisterMenus();
 	
-	// FTP 시스템 초기화
-	void InitializeFtpSystem();
+	// 스타일은 탭이 처음 열릴 때 초기화
+	void EnsureStyleInitialized();
 	
 	// 탭 스폰 함수들
 	TSharedRef<SDockTab> SpawnFileUploadTab(const FSpawnTabArgs& SpawnTabArgs);
@@ -33,10 +34,56 @@ private:
 	TSharedRef<SDockTab> SpawnFileManagerTab(const FSpawnTabArgs& SpawnTabArgs);
 	TSharedRef<SDockTab> SpawnUploadHistoryTab(const FSpawnTabArgs& SpawnTabArgs);
 
+	// Content 감시 모드 켜기/끄기
+	void ToggleContentWatch();
+
+	// Content 업로드 드라이런 계획 만들기/실행 (백그라운드)
+	void BuildContentPlan();
+	void ExecuteContentPlan();
+	void ShowPlan(const TSharedPtr<struct FFtpTransferPlan>& Plan);
+
+	// 에디터가 아는 변경분(저장/레지스트리/소스 컨트롤)만 올리기 - Content를 훑지 않음
+	void UploadContentChanges();
+
+	// 엔진 초기화가 끝나면 명령줄로 켠 선택 기능(쿡 스트리밍)을 시작한다
+	void StartOptionalServices();
+
+	// -FtpStreamCook=<작업 명세.json>으로 시작한 쿡 스트리밍을 엔진 종료 직전에 정리
+	void FinishCookStreaming();
+
+	// 백그라운드 작업 시작 - 종료 때 기다릴 수 있게 모아 둔다. 작업 안에서는 모듈을 직접 만지지 않는다
+	void RunInBackground(TUniqueFunction<void()> Work);
+	// 백그라운드 작업이 끝난 뒤 게임 스레드에서 모듈을 만진다 - 모듈이 이미 내려갔으면 건너뛴다
+	static void ReturnToGameThread(const TWeakPtr<FFileUpLoadModule*, ESPMode::ThreadSafe>& WeakSelf, TUniqueFunction<void(FFileUpLoadModule&)> Callback);
+
 	public:
     bool UploadFile(const FString& LocalPath, const FString& RemoteUrl, const FString& User, const FString& Pass);
 
+	// -FtpDerivedData=<작업 명세.json>으로 여는 공유 파생 데이터 저장소 - 처음 부를 때 연다 (게임 스레드). 없으면 nullptr
+	class FFtpDerivedDataStore* GetDerivedDataStore();
+
 private:
 	TSharedPtr<class FUICommandList> PluginCommands;
 	TSharedPtr<FTabManager> FileUpLoadTabManager;
+	TSharedPtr<class FFtpDirectoryWatcher> ContentWatcher;
+	TUniquePtr<class FFtpCookStreamer> CookStreamer;
+	TUniquePtr<class FFtpDerivedDataStore> DerivedDataStore;
+	FDelegateHandle PostEngineInitHandle;
+	FDelegateHandle EnginePreExitHandle;
+	bool bDerivedDataStoreChecked = false;
+
+	// 완료 콜백이 모듈에 닿아도 되는지 - ShutdownModule이 먼저 끊고 남은 작업을 기다린다
+	TSharedPtr<FFileUpLoadModule*, ESPMode::ThreadSafe> Lifetime;
+	TArray<TFuture<void>> BackgroundTasks;
+
+	// 마지막 드라이런 계획과 그 목록
+	TSharedPtr<struct FFtpTransferPlan> ContentPlan;
+	TSharedPtr<class FFtpFileListModel> PlanModel;
+	TSharedPtr<class SBox> PlanListBox;
+	FText PlanSummary;
+	bool bPlanBusy = false;
+
+	// 커맨드렛 실행 시에는 UI를 등록하지 않는다
+	bool bUIRegistered = false;
+	bool bStyleInitialized = false;
 };
@@ -0,0 +1,6 @@
+#pragma once
+
+#include "Stats/Stats.h"
+
+// stat FileUpLoad 로 확인하는 플러그인 통계 그룹
+DECLARE_STATS_GROUP(TEXT("FileUpLoad"), STATGROUP_FileUpLoad, STATCAT_Advanced);
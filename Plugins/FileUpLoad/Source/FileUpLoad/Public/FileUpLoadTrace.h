@@ -0,0 +1,60 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CountersTrace.h"
+
+struct FFtpTransferRecord;
+
+// Unreal Insights에서 -trace=cpu,counters,FileUpLoad 로 켜는 플러그인 트레이스 채널
+UE_TRACE_CHANNEL_EXTERN(FileUpLoadChannel, FILEUPLOAD_API);
+
+// FileUpLoad 채널이 켜져 있을 때만 남는 CPU 구간 ("Ftp_Scan" 등으로 타임라인에 보인다)
+#define FTP_TRACE_SCOPE(Name) TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL(Ftp_##Name, FileUpLoadChannel)
+
+// 카운터 - 진행 중인 전송 수와 누적 바이트
+TRACE_DECLARE_INT_COUNTER_EXTERN(FtpInFlightTransfers);
+TRACE_DECLARE_MEMORY_COUNTER_EXTERN(FtpBytesUploaded);
+TRACE_DECLARE_MEMORY_COUNTER_EXTERN(FtpBytesDownloaded);
+TRACE_DECLARE_INT_COUNTER_EXTERN(FtpServerSessions);
+TRACE_DECLARE_MEMORY_COUNTER_EXTERN(FtpServerBytesSent);
+TRACE_DECLARE_MEMORY_COUNTER_EXTERN(FtpServerBytesReceived);
+// 전송 버퍼 풀에서 빌려 간 바이트 (FFtpBufferPool)
+TRACE_DECLARE_MEMORY_COUNTER_EXTERN(FtpBufferPoolInUse);
+
+/**
+ * FTP 전송 트레이스 이벤트
+ *
+ * CPU 구간은 이 프로세스 안의 단계(스캔, 해시, 서버 로그인/PASV, 전송, 디스크 I/O)를 보여 준다.
+ * 클라이언트 전송은 curl 프로세스 안에서 접속/로그인/PASV가 일어나므로, curl이 알려 준 단계별 시간을
+ * CurlTimings 이벤트로 남기고 전송 한 건이 끝날 때마다 Transfer 이벤트를 남긴다.
+ */
+namespace FtpTrace
+{
+	// 전송 기록 한 건 (FFtpTransferHistory::Record가 부른다) - 바이트 카운터도 함께 올린다
+	FILEUPLOAD_API void TransferRecorded(const FFtpTransferRecord& Record);
+
+	// curl write-out의 단계별 시간 (초): 접속 완료, 전송 직전(로그인+PASV 끝), 첫 바이트, 전체
+	FILEUPLOAD_API void CurlTimings(const FString& RemotePath, double ConnectSeconds, double PreTransferSeconds, double StartTransferSeconds, double TotalSeconds);
+
+	// 동기화 시작/끝 같은 타임라인 책갈피
+	FILEUPLOAD_API void Bookmark(const FString& Text);
+}
+
+// 진행 중인 전송 수 카운터를 구간 동안 올려 둔다
+struct FFtpTraceInFlightScope
+{
+	explicit FFtpTraceInFlightScope(int32 InCount = 1)
+		: Count(InCount)
+	{
+		TRACE_COUNTER_ADD(FtpInFlightTransfers, Count);
+	}
+
+	~FFtpTraceInFlightScope()
+	{
+		TRACE_COUNTER_SUBTRACT(FtpInFlightTransfers, Count);
+	}
+
+	int32 Count;
+};
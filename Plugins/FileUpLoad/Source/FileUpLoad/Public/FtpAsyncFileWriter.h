@@ -0,0 +1,95 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include "FtpBufferPool.h"
+
+class FEvent;
+class IFileHandle;
+
+/**
+ * 수신 루프를 디스크에 묶지 않는 비동기 로컬 파일 쓰기
+ *
+ * Append는 정렬된 풀 버퍼(FFtpBufferPool)에 복사만 하고 돌아오며, 가득 찬 버퍼는 스레드 풀 작업이 모아서 쓴다.
+ * 버퍼 크기는 예상 크기에 맞추거나(모르면 64KB부터 키운다) 하므로 작은 파일이 4MB 슬랩을 잡지 않는다.
+ * 쓰지 못하고 쌓인 바이트는 풀 예산을 열린 쓰기 수로 나눈 몫까지만 허용하고, 넘거나 풀 예산이 차면 Append가 기다리므로
+ * 수신 루프도 함께 늦춰진다.
+ * Linux에서는 미리 공간을 잡고(fallocate), 연속 버퍼를 pwritev 한 번으로 묶고,
+ * 아주 큰 파일은 O_DIRECT로, 그 외 큰 파일은 쓴 구간을 페이지 캐시에서 바로 내려 캐시를 밀어내지 않는다.
+ */
+class FILEUPLOAD_API FFtpAsyncFileWriter
+{
+public:
+	// 버퍼 크기 범위와 정렬 (O_DIRECT 요구 사항 - 모든 슬랩 크기가 정렬의 배수라 버퍼 위치도 정렬된다)
+	static constexpr int32 MinBufferSize = FFtpBufferPool::MinSlabSize;
+	static constexpr int32 MaxBufferSize = FFtpBufferPool::MaxSlabSize;
+	static constexpr int32 BufferAlignment = FFtpBufferPool::Alignment;
+
+	// 이 크기 이상으로 예상되는 파일은 O_DIRECT (Linux)
+	static constexpr int64 DirectIoThreshold = 1024LL * 1024 * 1024;
+
+	// 이만큼 쓴 뒤부터는 지난 구간을 페이지 캐시에서 내린다 (Linux)
+	static constexpr int64 DropCacheThreshold = 256LL * 1024 * 1024;
+
+	FFtpAsyncFileWriter();
+	~FFtpAsyncFileWriter();
+
+	FFtpAsyncFileWriter(const FFtpAsyncFileWriter&) = delete;
+	FFtpAsyncFileWriter& operator=(const FFtpAsyncFileWriter&) = delete;
+
+	// InExpectedSize를 알면 미리 공간을 잡고 버퍼 크기도 맞춘다 (모르면 -1)
+	bool Open(const FString& InPath, int64 InExpectedSize = -1);
+
+	// 데이터 추가 - 복사 후 바로 반환
+	void Append(const uint8* Data, int64 Size);
+
+	// 남은 데이터를 쓰고 최종 크기로 맞춘 뒤 닫는다. 쓰기 중 오류가 있었으면 false
+	bool Close();
+
+	int64 GetBytesWritten() const { return Offset; }
+
+private:
+	struct FBuffer
+	{
+		FFtpPooledBuffer Slab;
+		uint8* Data = nullptr;
+		int64 FileOffset = 0;
+		int32 Length = 0;
+	};
+
+	void Submit(FBuffer* Buffer);
+	void Drain();
+	void WriteBatch(const TArray<FBuffer*>& Batch);
+	void WaitForInFlight(int64 MaxBytes);
+
+	// 다음 버퍼 크기 - 남은 예상 크기에 맞추고, 모르면 앞 버퍼보다 한 단계 키운다
+	int32 ChooseNextBufferSize() const;
+	// 이 쓰기가 디스크를 기다리며 쥐고 있어도 되는 바이트 (풀 예산 / 열린 쓰기 수)
+	int64 GetMaxInFlightBytes(int32 NextBufferSize) const;
+
+	static FBuffer* AcquireBuffer(int32 Size);
+	static void ReleaseBuffer(FBuffer* Buffer);
+
+	FString Path;
+	int64 Offset = 0;
+	int64 ExpectedSize = -1;
+	int32 LastBufferSize = 0;
+	FBuffer* Current = nullptr;
+
+	TQueue<FBuffer*, EQueueMode::Mpsc> Submitted;
+	TAtomic<int64> InFlightBytes;
+	TAtomic<int32> ActiveDrains;
+	TAtomic<bool> bDraining;
+	TAtomic<bool> bWriteFailed;
+	FEvent* ProgressEvent = nullptr;
+
+	// Linux 백엔드
+	int32 FileDescriptor = -1;
+	bool bDirectIo = false;
+	int64 CacheDroppedUpTo = 0;
+
+	// 다른 플랫폼 백엔드
+	TUniquePtr<IFileHandle> FileHandle;
+
+	bool bOpen = false;
+};
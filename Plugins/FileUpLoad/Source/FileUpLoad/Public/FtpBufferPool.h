@@ -0,0 +1,98 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FFtpBufferPool;
+
+// 풀에서 빌린 버퍼 - 소멸하면 풀로 돌아간다. 이동만 된다
+class FILEUPLOAD_API FFtpPooledBuffer
+{
+public:
+	FFtpPooledBuffer() = default;
+	~FFtpPooledBuffer();
+
+	FFtpPooledBuffer(FFtpPooledBuffer&& Other);
+	FFtpPooledBuffer& operator=(FFtpPooledBuffer&& Other);
+
+	FFtpPooledBuffer(const FFtpPooledBuffer&) = delete;
+	FFtpPooledBuffer& operator=(const FFtpPooledBuffer&) = delete;
+
+	bool IsValid() const { return Data != nullptr; }
+	uint8* GetData() const { return Data; }
+	// 슬랩 크기 - 요청한 크기 이상
+	int32 GetSize() const { return Size; }
+
+	// 소멸을 기다리지 않고 먼저 돌려준다
+	void Release();
+
+private:
+	friend class FFtpBufferPool;
+
+	uint8* Data = nullptr;
+	int32 Size = 0;
+	int32 SizeClass = 0;
+};
+
+struct FFtpBufferPoolStats
+{
+	int64 BudgetBytes = 0;
+	// 할당된 슬랩 전체 (빌려 준 것 + 캐시에 남은 것)
+	int64 CommittedBytes = 0;
+	int64 InUseBytes = 0;
+	int32 InUseBuffers = 0;
+	// 전역 빈 목록의 슬랩 수 (스레드 캐시는 세지 않는다)
+	int32 FreeBuffers = 0;
+	uint64 Acquires = 0;
+	// 예산이 차서 기다린 횟수와, 기다려도 풀리지 않아 예산을 넘겨 준 횟수
+	uint64 Waits = 0;
+	uint64 Overcommits = 0;
+};
+
+/**
+ * 전송, 복사, 해시 경로가 같이 쓰는 고정 크기 정렬 버퍼 풀
+ *
+ * 슬랩은 64KB/256KB/1MB/4MB 네 가지이고 모두 4096 정렬이다 (O_DIRECT에 그대로 쓸 수 있다).
+ * 반납된 작은 슬랩(1MB 이하)은 스레드마다 조금씩 캐시해 다시 쓰고, 나머지는 전역 빈 목록으로 간다.
+ * 할당된 슬랩 전체는 전역 예산(기본 256MB) 안에 머문다. 예산이 차면 Acquire는 다른 스레드의 캐시까지 거둬 와서
+ * 다른 크기의 빈 슬랩을 먼저 해제하고, 그래도 모자라면 반납을 기다린다 - 이것이 전송 스케줄러와 수신 루프에 걸리는 백프레셔다.
+ * 버퍼를 쥔 채 서로를 기다리는 교착을 피하려고 MaxWaitSeconds를 넘기면 예산을 넘겨 주고 Overcommits로 센다.
+ * 한 번 넘겨 받은 스레드는 이후 MaxWaitSeconds 동안 기다리지 않고 바로 넘겨 받는다 (버퍼마다 5초씩 멈추지 않게).
+ */
+class FILEUPLOAD_API FFtpBufferPool
+{
+public:
+	static constexpr int32 Alignment = 4096;
+	static constexpr int32 MinSlabSize = 64 * 1024;
+	static constexpr int32 MaxSlabSize = 4 * 1024 * 1024;
+
+	// 명령줄 -FtpBufferBudgetMB=<N>이 있으면 처음 쓸 때 그 값으로 시작한다
+	static constexpr int64 DefaultBudgetBytes = 256LL * 1024 * 1024;
+
+	// 예산이 찬 Acquire가 기다리는 최대 시간
+	static constexpr double MaxWaitSeconds = 5.0;
+
+	// MinSize 이상인 가장 작은 슬랩을 빌린다. 예산이 차면 기다린다. MinSize는 MaxSlabSize 이하여야 한다
+	static FFtpPooledBuffer Acquire(int32 MinSize);
+
+	// 기다리지 않는다 - 예산이 차 있으면 빈 핸들
+	static FFtpPooledBuffer TryAcquire(int32 MinSize);
+
+	// 새 전송을 시작하기 전에 스케줄러가 부른다. Bytes만큼 예산이 빌 때까지 기다린다. 시간 안에 비면 true
+	static bool WaitForCapacity(int64 Bytes, double TimeoutSeconds = MaxWaitSeconds);
+	static bool HasCapacity(int64 Bytes);
+
+	// 예산 변경 - 줄이면 빈 슬랩부터 해제하고, 빌려 간 슬랩은 반납될 때 해제한다
+	static void SetBudgetBytes(int64 Bytes);
+	static int64 GetBudgetBytes();
+
+	// 전역 빈 목록을 모두 해제한다 (큰 작업이 끝난 뒤)
+	static void Trim();
+
+	static FFtpBufferPoolStats GetStats();
+
+private:
+	friend class FFtpPooledBuffer;
+
+	static FFtpPooledBuffer AcquireInternal(int32 MinSize, bool bWait);
+	static void Release(uint8* Data, int32 SizeClass);
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FtpSystem.h"
+
+class FFtpPathTable;
+
+// 업로드할 파일을 어디서 찾을지
+enum class EFtpDiscoverySource : uint8
+{
+	None = 0,
+	// 이 에디터 세션에서 저장된 패키지 (PackageSavedWithContextEvent)
+	SavedPackages = 1 << 0,
+	// 에셋 레지스트리의 패키지 크기/저장 해시를 마지막 업로드 기준과 비교
+	AssetRegistry = 1 << 1,
+	// 소스 컨트롤에서 체크아웃/추가/수정된 파일 (열린 체인지리스트)
+	SourceControl = 1 << 2,
+	// 저장 안 된 패키지 - 디스크에 없으니 올리지 않고 알리기만 한다
+	DirtyPackages = 1 << 3,
+	All = SavedPackages | AssetRegistry | SourceControl | DirtyPackages,
+};
+ENUM_CLASS_FLAGS(EFtpDiscoverySource);
+
+// 변경 발견 결과 - Files는 발견된 파일만 담은 경로 표다
+struct FILEUPLOAD_API FFtpDiscoveryResult
+{
+	TSharedPtr<FFtpPathTable> Files;
+
+	// 저장 안 된 패키지 (올라가지 않음)
+	TArray<FString> UnsavedPackages;
+	// 소스 컨트롤에서 삭제로 표시됐거나 저장 기록 뒤 사라진 파일 (원격은 지우지 않음)
+	TArray<FString> MissingFiles;
+
+	int32 NumFromSaved = 0;
+	int32 NumFromAssetRegistry = 0;
+	int32 NumFromSourceControl = 0;
+	double Seconds = 0.0;
+
+	// 업로드 성공 뒤 기록할 값들 (UploadChanges가 쓴다)
+	double DiscoveryTime = 0.0;
+	// 로컬 루트와 원격 경로 - 저장 기록은 대상마다 따로 지운다
+	FString TargetKey;
+	FString BaselinePath;
+	TMap<FName, FString> RegistrySnapshot;
+};
+
+/**
+ * 에디터가 이미 아는 정보로 업로드할 파일 찾기
+ *
+ * 저장 이벤트로 모은 패키지, 에셋 레지스트리의 패키지 데이터(마지막 업로드 때와 크기/저장 해시 비교),
+ * 소스 컨트롤 상태 캐시(열린 파일만 갱신)를 합쳐 경로 표를 만든다. 파일 시스템을 재귀로 훑지 않고
+ * 발견된 파일마다 stat 한 번만 하므로, 에셋 하나를 고쳤다면 프로젝트 크기와 관계없이 바로 업로드가 시작된다.
+ * 에셋 레지스트리 기준이 아직 없으면 이번 상태를 기준으로만 남긴다 (전체 업로드는 일반 Push/업로드로).
+ * 저장 기록은 원격 대상마다 어디까지 올렸는지를 따로 두므로, 한 대상에 올려도 다른 대상의 발견에서는 빠지지 않는다.
+ */
+namespace FtpChangeDiscovery
+{
+	// 저장 이벤트 구독 (모듈 시작/종료 시)
+	void StartTracking();
+	void StopTracking();
+
+	// LocalRoot 아래에서 RemotePath로 마지막 업로드 뒤 바뀐 파일을 찾는다 (게임 스레드 전용, 끝날 때까지 막힌다 - 커맨드렛용)
+	bool DiscoverChanges(const FString& LocalRoot, const FString& RemotePath, EFtpDiscoverySource Sources, FFtpDiscoveryResult& OutResult);
+
+	// 에디터용 - 게임 스레드에서는 더티 패키지만 보고, 소스 컨트롤 상태 갱신은 비동기 명령으로,
+	// 레지스트리 비교와 파일 stat은 워커에서 한다. 끝나면 게임 스레드에서 OnComplete (실패하면 null)
+	void DiscoverChangesAsync(const FString& LocalRoot, const FString& RemotePath, EFtpDiscoverySource Sources, TFunction<void(TSharedPtr<FFtpDiscoveryResult>)> OnComplete);
+
+	// 발견된 파일을 의존성 순서로 올리고, 모두 성공하면 저장 기록을 비우고 레지스트리 기준을 갱신한다 (아무 스레드)
+	FFtpSyncStats UploadChanges(const FFtpDiscoveryResult& Discovery, const FString& RemotePath, const FString& Server, const FString& User, const FString& Pass, const TArray<FName>& PriorityPackages = TArray<FName>());
+
+	// 로그/UI용 한 줄 요약
+	FString DescribeResult(const FFtpDiscoveryResult& Discovery);
+}
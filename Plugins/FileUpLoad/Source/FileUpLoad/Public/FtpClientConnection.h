@@ -0,0 +1,80 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FtpProtocol.h"
+
+class FSocket;
+class FInternetAddr;
+
+// 파일 단위 명령의 결과
+enum class EFtpClientResult : uint8
+{
+	Ok,
+	// 서버가 550으로 답함 - 연결은 그대로 쓸 수 있다
+	NotFound,
+	// 연결 오류나 예상 밖 응답 - 연결을 끊었다
+	Failed
+};
+
+/**
+ * 프로세스 안에서 소켓으로 직접 여는 FTP 제어 연결
+ *
+ * curl 하위 프로세스 없이 로그인한 연결 하나를 계속 쓰므로, 작은 파일을 많이 주고받을 때 파일마다
+ * 프로세스 생성과 로그인 왕복이 들지 않는다. 데이터 연결은 EPSV 수동 모드만 쓰고 TLS는 지원하지 않는다.
+ * 한 스레드만 쓴다고 본다.
+ */
+class FILEUPLOAD_API FFtpClientConnection
+{
+public:
+	FFtpClientConnection();
+	~FFtpClientConnection();
+
+	FFtpClientConnection(const FFtpClientConnection&) = delete;
+	FFtpClientConnection& operator=(const FFtpClientConnection&) = delete;
+
+	// 접속, 로그인, 바이너리 모드까지
+	bool Connect(const FInternetAddr& InServerAddr, const FString& User, const FString& Password);
+	void Disconnect();
+	bool IsConnected() const { return Control != nullptr; }
+
+	// 파일 전체를 OutData로 받는다. MaxBytes보다 크면 Failed
+	EFtpClientResult Retrieve(const FString& RemotePath, TArray<uint8>& OutData, int64 MaxBytes);
+
+	// Data를 RemotePath로 올린다. 상위 디렉토리가 없으면 NotFound
+	EFtpClientResult Store(const FString& RemotePath, const uint8* Data, int64 Size);
+
+	// 파일 크기 - 없으면 NotFound
+	EFtpClientResult GetSize(const FString& RemotePath, int64& OutSize);
+
+	// RNFR/RNTO - 대상이 있으면 서버가 한 번에 바꾼다. 원본이 없거나 서버가 이름을 거절하면 NotFound
+	EFtpClientResult Rename(const FString& FromPath, const FString& ToPath);
+
+	// 파일 삭제 - 없으면 NotFound
+	EFtpClientResult Delete(const FString& RemotePath);
+
+	// 디렉토리 생성. 이미 있어도 true (550은 구분하지 않는다)
+	bool MakeDirectory(const FString& RemotePath);
+
+	// 서버 주소 해석 (IP 또는 호스트 이름)
+	static TSharedPtr<FInternetAddr> ResolveAddress(const FString& Host, int32 Port);
+
+private:
+	// Writer에 만든 명령 줄을 보낸다
+	bool SendCommand();
+	bool SendPathCommand(EFtpCommand Command, const FString& Path);
+	bool ReadReply(int32& OutCode);
+	bool ExpectReply(int32 ExpectedCode);
+
+	// EPSV로 데이터 연결을 연다
+	FSocket* OpenDataConnection();
+
+	TSharedPtr<FInternetAddr> ServerAddr;
+	FSocket* Control = nullptr;
+
+	FFtpLineReader Reader;
+	FFtpReplyParser Parser;
+	FFtpMessageWriter Writer;
+
+	// 마지막 완성 응답의 글 - 다음 수신 전까지만 유효
+	FAnsiStringView LastReplyText;
+};
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Function.h"
+#include "FtpSystem.h"
+
+class FEvent;
+
+/**
+ * 서버별 AIMD 동시 전송 수 조절기
+ *
+ * 창(WindowSeconds)마다 처리량, 실패율, 지연을 보고 동시 전송 수를 정한다.
+ * 문제가 없고 처리량이 늘면 1씩 늘리고(가산 증가), 421/연결 거부, 실패율 증가,
+ * 지연 급증(큐잉) 중 하나라도 보이면 줄인다(곱셈 감소). 421이 나온 수는 그 서버의 상한으로 기억한다.
+ */
+class FILEUPLOAD_API FFtpConcurrencyController
+{
+public:
+	static constexpr int32 MinLimit = 1;
+	static constexpr int32 InitialLimit = 2;
+
+	// 판단 주기
+	static constexpr double WindowSeconds = 2.0;
+
+	// 421/연결 거부일 때와 그 외 혼잡 신호일 때의 감소 비율
+	static constexpr double BusyDecrease = 0.5;
+	static constexpr double CongestionDecrease = 0.75;
+
+	// 창 안의 실패율이 이 값을 넘으면 감소
+	static constexpr double MaxErrorRate = 0.1;
+
+	// 지연이 기준(최소 관측값)의 이 배수를 넘으면 감소
+	static constexpr double MaxLatencyInflation = 2.0;
+
+	// 늘린 뒤 처리량이 이만큼도 오르지 않으면 더 늘리지 않고 머문다
+	static constexpr double MinThroughputGain = 0.05;
+
+	// 머무는 동안 이 창 수마다 한 번씩 다시 늘려 본다 (링크 상태가 바뀌었을 수 있음)
+	static constexpr int32 ProbeIntervalWindows = 5;
+
+	// 421로 배운 상한을 이 시간 동안 421이 없으면 1씩 풀어 준다
+	static constexpr double CeilingRelaxSeconds = 30.0;
+
+	FFtpConcurrencyController(const FString& InServerKey, int32 InMaxLimit);
+	~FFtpConcurrencyController();
+
+	FFtpConcurrencyController(const FFtpConcurrencyController&) = delete;
+	FFtpConcurrencyController& operator=(const FFtpConcurrencyController&) = delete;
+
+	// 자리가 날 때까지 기다린 뒤 전송 하나를 시작한다
+	void Acquire();
+
+	// 전송 하나를 끝내고 측정값을 반영한다
+	void Release(const FFtpTransferSample& Sample);
+
+	// 설정된 서버 연결 수 제한 (0 이하면 바꾸지 않음)
+	void SetMaxLimit(int32 InMaxLimit);
+
+	int32 GetLimit() const;
+	int32 GetMaxLimit() const;
+	const FString& GetServerKey() const { return ServerKey; }
+
+private:
+	void EvaluateWindow(double Now);
+	void SetLimit(int32 NewLimit, const TCHAR* Reason);
+	int32 GetEffectiveMax() const;
+
+	FString ServerKey;
+	mutable FCriticalSection Lock;
+	FEvent* SlotEvent = nullptr;
+
+	int32 Limit = InitialLimit;
+	int32 MaxLimit = 1;
+	int32 LearnedCeiling = 0;
+	int32 Active = 0;
+
+	// 현재 창
+	double WindowStart = 0.0;
+	int64 WindowBytes = 0;
+	int32 WindowFiles = 0;
+	int32 WindowFailed = 0;
+	double WindowLatencySum = 0.0;
+	int32 WindowLatencyCount = 0;
+	bool bWindowBusy = false;
+
+	// 지난 판단
+	double MinLatency = 0.0;
+	double LastThroughput = 0.0;
+	bool bLastWasIncrease = false;
+	int32 HoldWindows = 0;
+	double LastBusyTime = 0.0;
+};
+
+namespace FtpConcurrency
+{
+	// 서버별 조절기 - 한 프로세스 안에서는 배운 값이 다음 전송으로 이어진다
+	TSharedRef<FFtpConcurrencyController> GetController(const FString& ServerKey, int32 MaxConnections);
+
+	// 0..NumItems-1 전송을 조절기가 허용하는 만큼 동시에 실행하고 모두 끝날 때까지 기다린다
+	void RunTransfers(FFtpConcurrencyController& Controller, int32 NumItems, TFunctionRef<FFtpTransferSample(int32)> Transfer);
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FtpSystem.h"
+
+// 매니페스트 항목 - 트리 안의 경로 하나가 어떤 객체를 가리키는지
+struct FFtpManifestEntry
+{
+	FString Path;
+	FString Hash;
+	int64 Size = 0;
+};
+
+// 콘텐츠 주소 업로드 결과
+struct FFtpContentStoreStats : public FFtpSyncStats
+{
+	int32 UniqueObjects = 0;
+	int32 UploadedObjects = 0;
+	int64 UploadedBytes = 0;
+	int64 SkippedBytes = 0;
+};
+
+/**
+ * 콘텐츠 주소 기반 중복 제거 원격 저장소
+ *
+ *   <Root>/cas/<해시 앞 2자리>/<SHA-1>   파일 내용 (한 번만 저장)
+ *   <Root>/manifests/<이름>.json         경로 -> 해시 매핑
+ *
+ * 업로드 전에 필요한 샤드 디렉토리만 나열해 이미 있는 객체는 건너뛰므로,
+ * 새 브랜치 스냅샷을 올려도 실제로 새로운 내용만 전송된다.
+ * 객체는 임시 이름으로 올린 뒤 RNFR/RNTO로 게시하므로 최종 이름에는 완전한 내용만 나타난다.
+ * 내려받은 객체는 해시를 다시 계산해 맞을 때만 로컬 파일을 바꾼다.
+ */
+namespace FtpContentStore
+{
+	// 로컬 폴더를 객체로 올리고 매니페스트를 게시. 모든 객체가 올라간 경우에만 매니페스트를 쓴다
+	FFtpContentStoreStats PushSnapshot(const FString& LocalPath, const FString& RemoteRoot, const FString& ManifestName, const FString& User, const FString& Pass);
+
+	// 매니페스트를 받아 로컬 폴더로 복원. 같은 객체는 한 번만 내려받고 나머지는 로컬에서 복사한다
+	FFtpSyncStats PullSnapshot(const FString& RemoteRoot, const FString& ManifestName, const FString& LocalPath, const FString& User, const FString& Pass);
+
+	// 객체 경로 (<Root>/cas/ab/abcdef...)
+	FString GetObjectPath(const FString& RemoteRoot, const FString& Hash);
+
+	// 매니페스트 직렬화
+	FString SerializeManifest(const FString& ManifestName, const TArray<FFtpManifestEntry>& Entries);
+	bool ParseManifest(const FString& JsonText, TArray<FFtpManifestEntry>& OutEntries);
+}
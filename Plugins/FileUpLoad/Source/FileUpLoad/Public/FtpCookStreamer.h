@@ -0,0 +1,107 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+
+class FFtpUploadQueue;
+class FRunnableThread;
+class FEvent;
+class UPackage;
+class FObjectPostSaveContext;
+
+// 쿡 스트리밍 설정 - 계정/서버는 FtpSync 작업 명세와 같은 필드를 쓴다
+struct FFtpCookStreamSettings
+{
+	FString User;
+	FString Password;
+
+	// 쿡 출력 루트 (플랫폼 디렉토리들의 부모) - 기본값은 Saved/Cooked
+	FString CookedRoot;
+	// 원격 루트 - 그 아래에 플랫폼 디렉토리가 그대로 놓인다
+	FString RemoteRoot = TEXT("upload/cooked");
+
+	// 마지막 정리 때 서버에만 남은 파일을 지운다 (쿡이 끝까지 간 플랫폼만)
+	bool bMirrorDeletes = true;
+
+	// 패키지 파일들의 크기가 이 시간 동안 그대로면 다 쓰였다고 본다
+	double StableSeconds = 0.5;
+	// 저장 이벤트 뒤 이 시간 안에 파일이 나타나지 않으면 정리 단계에 맡긴다
+	double MissingTimeoutSeconds = 30.0;
+	// 업로드 큐가 curl 한 번에 묶어 보내는 최대 파일 수
+	int32 BatchFiles = 16;
+};
+
+/**
+ * 쿡이 진행되는 동안 쿡된 패키지를 바로 올리는 스트리밍 업로더
+ *
+ * 쿡 저장(PackageSavedWithContextEvent, IsCooking)마다 헤더 경로를 받아 두고, 패키지 작성기가 비동기로 쓰는
+ * 헤더와 .uexp/.ubulk 등의 크기가 StableSeconds 동안 변하지 않으면 업로드 큐에 넣는다. Finish에서는 남은 전송을
+ * 기다린 뒤 플랫폼마다 전송 계획(FtpPlanner)을 만들어 놓친 파일(에셋 레지스트리, 셰이더 라이브러리 등 쿡 끝에
+ * 쓰이는 파일 포함)을 올리고, 쿡이 끝까지 간 플랫폼이면 서버에만 남은 파일을 지운다.
+ *
+ * 쿡 커맨드렛에 -FtpStreamCook=<작업 명세.json>을 넘기면 엔진 초기화가 끝날 때(OnPostEngineInit) 켜지고 엔진 종료 직전에 정리한다.
+ * 느슨한(loose) 쿡 출력만 다룬다 - Zen 저장소로 쿡하면 디스크에 패키지 파일이 없으므로 정리 단계만 의미가 있다.
+ */
+class FILEUPLOAD_API FFtpCookStreamer : public FRunnable
+{
+public:
+	explicit FFtpCookStreamer(const FFtpCookStreamSettings& InSettings);
+	virtual ~FFtpCookStreamer();
+
+	// 작업 명세(User/Password/Server + "StreamCook" 객체)를 읽는다. Server가 있으면 전역 서버 설정도 바꾼다
+	static bool LoadSettings(const FString& JobSpecPath, FFtpCookStreamSettings& OutSettings);
+
+	bool Start();
+
+	// 남은 전송을 기다리고 플랫폼별 정리 업로드/삭제를 한다. 모두 성공하면 true
+	bool Finish();
+
+	bool IsStreaming() const { return SavedHandle.IsValid(); }
+
+	// FRunnable interface
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+	// 저장 이벤트를 받았지만 아직 다 쓰이지 않은 패키지
+	struct FWaitingPackage
+	{
+		double FirstSeenTime = 0.0;
+		double LastChangeTime = 0.0;
+		// 헤더와 동반 파일 크기를 섞은 값 - 파일이 생기거나 커지면 바뀐다
+		int64 LastSignature = MIN_int64;
+	};
+
+	void OnPackageSaved(const FString& PackageFilename, UPackage* Package, FObjectPostSaveContext SaveContext);
+
+	// 대기 중인 패키지를 한 번 훑어 다 쓰인 것은 큐에 넣는다
+	void PollWaiting(double Now);
+	int64 GetPackageSignature(const FString& HeaderPath) const;
+	void EnqueuePackage(const FString& HeaderPath);
+	FString MakeRemotePath(const FString& LocalPath) const;
+
+	// 쿡이 플랫폼 출력의 마지막 단계(개발용 에셋 레지스트리)까지 썼는지
+	bool IsPlatformCookComplete(const FString& Platform) const;
+
+	FFtpCookStreamSettings Settings;
+	// 이보다 나중에 쓰인 에셋 레지스트리만 이번 쿡의 완료로 본다
+	FDateTime StartUtc;
+
+	// 게임/저장 스레드가 넣고 감시 스레드가 꺼낸다
+	FCriticalSection InboxLock;
+	TArray<FString> Inbox;
+	TSet<FString> Platforms;
+
+	// 감시 스레드 전용
+	TMap<FString, FWaitingPackage> Waiting;
+	TAtomic<int32> NumWaiting;
+	TAtomic<int32> NumStreamedPackages;
+	TAtomic<int32> NumMissingPackages;
+
+	TUniquePtr<FFtpUploadQueue> UploadQueue;
+	FDelegateHandle SavedHandle;
+
+	FEvent* WorkEvent = nullptr;
+	FRunnableThread* Thread = nullptr;
+	TAtomic<bool> bStopping;
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/PlatformProcess.h"
+
+/**
+ * 표준 입력을 파이프로 연결한 curl 프로세스
+ * "-T -"로 띄우면 디스크를 다시 읽지 않고 메모리의 데이터를 그대로 흘려 보낼 수 있다.
+ */
+class FILEUPLOAD_API FFtpCurlProcess
+{
+public:
+	FFtpCurlProcess() = default;
+	~FFtpCurlProcess();
+
+	FFtpCurlProcess(const FFtpCurlProcess&) = delete;
+	FFtpCurlProcess& operator=(const FFtpCurlProcess&) = delete;
+
+	// curl 실행 - bWithStdIn이면 Write()로 표준 입력에 쓸 수 있다
+	bool Launch(const FString& Params, bool bWithStdIn);
+
+	// 표준 입력으로 전송 (프로세스가 죽었으면 false)
+	bool Write(const uint8* Data, int64 Size);
+
+	// 표준 입력을 닫아 curl에 EOF를 알린다
+	void CloseStdIn();
+
+	// 종료까지 기다린 뒤 종료 코드 반환 (실행 실패 시 -1)
+	int32 Wait(FString& OutOutput);
+
+	// "-o -"로 받은 바이너리 출력을 읽는다 (막히지 않음). 읽은 것이 있으면 true
+	bool ReadBinaryOutput(TArray<uint8>& OutData);
+
+	// 출력이 오거나 curl이 끝나거나 TimeoutMs가 지날 때까지 잠든다 (Linux는 파이프를 poll로 기다린다)
+	void WaitForOutput(uint32 TimeoutMs);
+
+	bool IsRunning();
+
+private:
+	void DrainOutput();
+
+	FProcHandle ProcHandle;
+	void* StdInRead = nullptr;
+	void* StdInWrite = nullptr;
+	void* StdOutRead = nullptr;
+	void* StdOutWrite = nullptr;
+	FString Output;
+};
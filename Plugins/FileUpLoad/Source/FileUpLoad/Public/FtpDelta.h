@@ -0,0 +1,82 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Hash/Blake3.h"
+#include "FtpSystem.h"
+
+// 블록 강한 체크섬 - BLAKE3 앞 16바이트
+struct FFtpStrongSum
+{
+	uint8 Bytes[16];
+
+	bool operator==(const FFtpStrongSum& Other) const
+	{
+		return FMemory::Memcmp(Bytes, Other.Bytes, sizeof(Bytes)) == 0;
+	}
+};
+
+// 파일 서명 - 서버에 "<파일>.ftpsig"로 함께 보관된다
+struct FFtpFileSignature
+{
+	int32 BlockSize = 0;
+	int64 FileSize = 0;
+	FBlake3Hash FileHash;
+	TArray<uint32> WeakSums;
+	TArray<FFtpStrongSum> StrongSums;
+};
+
+/**
+ * rsync 방식 블록 델타 전송
+ *
+ * 서버에 있는 이전 버전의 서명(롤링 약한 체크섬 + BLAKE3 블록 해시)을 받아
+ * 새 파일에서 일치하는 블록은 참조로, 나머지만 바이트로 담은 패치를 만든다.
+ * 패치는 "<파일>.ftpdelta"로 올라가고, 받는 쪽(ApplyPendingDeltas)이 기존 파일에 적용한 뒤 서명을 갱신한다.
+ * 그래서 델타 업로드는 적용되기 전까지 "대기"이고, 델타가 아닌 업로드는 서버의 옛 서명을 먼저 지운다.
+ */
+namespace FtpDelta
+{
+	// 이보다 작은 파일은 그냥 통째로 보낸다
+	constexpr int64 MinDeltaFileSize = 16 * 1024 * 1024;
+
+	// 패치가 원본의 이 비율을 넘으면 델타의 이득이 없으므로 전체 전송
+	constexpr double MaxPatchRatio = 0.5;
+
+	extern const TCHAR* SignatureExtension;
+	extern const TCHAR* DeltaExtension;
+
+	// 파일 크기에 맞는 블록 크기 (sqrt(크기), 4KB~256KB)
+	int32 ChooseBlockSize(int64 FileSize);
+
+	// 서명 계산/저장/읽기
+	bool ComputeSignature(const FString& FilePath, FFtpFileSignature& OutSignature);
+	bool SaveSignature(const FFtpFileSignature& Signature, const FString& SignaturePath);
+	bool LoadSignature(const FString& SignaturePath, FFtpFileSignature& OutSignature);
+
+	// 기존 파일 서명과 새 파일로 패치 생성. OutLiteralBytes는 패치에 그대로 담긴 바이트 수
+	bool CreateDeltaPatch(const FFtpFileSignature& BaseSignature, const FString& NewFilePath, const FString& PatchPath, int64& OutLiteralBytes);
+
+	// 패치 적용 - 결과의 크기와 해시가 패치에 기록된 값과 다르면 실패
+	// KnownBaseHash가 주어지면 기존 파일 해시를 다시 계산하지 않는다
+	bool ApplyDeltaPatch(const FString& BasePath, const FString& PatchPath, const FString& OutPath, const FBlake3Hash* KnownBaseHash = nullptr);
+
+	enum class EUploadResult : uint8
+	{
+		Failed,
+		// 파일 전체가 올라감
+		Uploaded,
+		// 서버 파일과 같아 보내지 않음
+		Unchanged,
+		// 패치만 올라감 - 받는 쪽이 ApplyPendingDeltas를 돌려야 반영된다
+		Pending
+	};
+
+	// 파일 하나를 델타로 업로드 (서명이 없거나 이득이 없으면 전체 전송 + 서명 업로드)
+	EUploadResult UploadFileDelta(const FString& Username, const FString& LocalPath, const FString& RemotePath);
+
+	// 폴더 업로드 - 큰 파일만 델타, 나머지는 일괄 업로드
+	FFtpSyncStats UploadFolder(const FString& LocalPath, const FString& RemotePath, const FString& User, const FString& Pass);
+
+	// 받는 쪽 패치 단계 - 로컬 루트 아래의 .ftpdelta를 모두 적용. 적용한 수와 실패한 수 반환
+	// 실패한 패치는 서명과 함께 지운다 - 다음 푸시가 서명을 찾지 못해 파일 전체를 보낸다
+	FFtpSyncStats ApplyPendingDeltas(const FString& LocalRoot);
+}
@@ -0,0 +1,239 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include "Templates/Function.h"
+
+class FEvent;
+class FInternetAddr;
+class FFtpClientConnection;
+
+enum class EFtpCacheStatus : uint8
+{
+	Ok,
+	// 어느 계층에도 없음
+	Miss,
+	// 서버에 닿지 못했거나 전송이 실패함 - 있는지 없는지 모른다
+	Error
+};
+
+// 값을 찾은 계층
+enum class EFtpCacheSource : uint8
+{
+	None,
+	Local,
+	Remote
+};
+
+struct FFtpCacheGetRequest
+{
+	FString Key;
+	// 호출자가 응답을 요청과 맞추는 데 쓰는 값 - 그대로 돌려준다
+	uint64 UserData = 0;
+};
+
+struct FFtpCacheGetResponse
+{
+	FString Key;
+	uint64 UserData = 0;
+	EFtpCacheStatus Status = EFtpCacheStatus::Miss;
+	EFtpCacheSource Source = EFtpCacheSource::None;
+	TArray<uint8> Data;
+};
+
+struct FFtpCachePutRequest
+{
+	FString Key;
+	TArray<uint8> Data;
+	uint64 UserData = 0;
+};
+
+struct FFtpCachePutResponse
+{
+	FString Key;
+	uint64 UserData = 0;
+	// 로컬 계층에 쓰였고 (원격 쓰기를 켰으면) 서버에도 있으면 Ok
+	EFtpCacheStatus Status = EFtpCacheStatus::Error;
+};
+
+using FOnFtpCacheGetComplete = TFunction<void(FFtpCacheGetResponse&&)>;
+using FOnFtpCachePutComplete = TFunction<void(FFtpCachePutResponse&&)>;
+
+// 공유 파생 데이터 저장소 설정 - 계정/서버는 FtpSync 작업 명세와 같은 필드를 쓴다
+struct FFtpDerivedDataSettings
+{
+	FString User;
+	FString Password;
+
+	// 원격 루트 - 그 아래에 키 해시 앞 두 글자로 나눈 디렉토리가 놓인다
+	FString RemoteRoot = TEXT("ddc");
+
+	// 로컬 계층 루트 - 기본값은 Saved/FtpDerivedData
+	FString LocalRoot;
+	// 로컬 계층 상한 - 넘으면 오래 쓰지 않은 레코드부터 지운다
+	int64 LocalBudgetBytes = 4LL * 1024 * 1024 * 1024;
+
+	// 서버 연결(= 동시 원격 요청) 수
+	int32 Connections = 4;
+
+	// 원격에 없던 키를 이 시간 동안 다시 묻지 않는다
+	double NegativeCacheSeconds = 300.0;
+
+	// 이보다 큰 레코드는 받지 않는다
+	int64 MaxRecordBytes = 256LL * 1024 * 1024;
+
+	// 끄면 읽기 전용 - Put은 로컬 계층에만 쓴다 (CI만 서버에 쓰게 할 때)
+	bool bRemoteWrites = true;
+};
+
+struct FFtpDerivedDataStats
+{
+	uint64 LocalHits = 0;
+	uint64 RemoteHits = 0;
+	uint64 Misses = 0;
+	// 부정 캐시로 서버에 묻지 않고 답한 미스
+	uint64 NegativeHits = 0;
+	uint64 Errors = 0;
+	uint64 Puts = 0;
+	uint64 RemotePuts = 0;
+	// 서버에 이미 있어서 보내지 않은 Put
+	uint64 RemotePutsSkipped = 0;
+	uint64 BytesDownloaded = 0;
+	uint64 BytesUploaded = 0;
+};
+
+/**
+ * FTP 서버를 공유 계층으로 쓰는 파생 데이터 캐시 저장소
+ *
+ *   <Local>/<ab>/<해시>    로컬 계층 (LocalBudgetBytes 안에서 LRU로 정리)
+ *   <Remote>/<ab>/<해시>   공유 계층 - 해시는 키의 BLAKE3, ab는 그 앞 두 글자
+ *
+ * Get/Put은 요청 묶음을 받아 바로 돌아오고, 요청마다 완료 함수를 한 번 부른다 (작업 스레드에서).
+ * Get은 쓰는 중인 Put, 로컬 계층, 부정 캐시 순으로 보고 남은 키만 연결 스레드들에 넘긴다. 연결 스레드는
+ * 로그인한 제어 연결(FFtpClientConnection)을 계속 쓰므로 키마다 curl 프로세스나 로그인 왕복이 들지 않는다.
+ * 서버에서 받은 레코드는 로컬 계층에 남긴다. Put은 로컬에 먼저 쓰고, 서버에 같은 레코드가 없을 때만 임시 이름으로 올린 뒤
+ * RNFR/RNTO로 바꾼다. 레코드에는 크기와 BLAKE3가 들어 있어 잘리거나 깨진 값은 미스로 처리한다 (부정 캐시에는 넣지 않는다).
+ *
+ * 엔진 DDC 그래프(DerivedDataBackends)는 플러그인이 새 저장소 종류를 등록할 수 없으므로 이 저장소는 엔진 DDC를
+ * 대신하지 않는다. 모듈(FFileUpLoadModule::GetDerivedDataStore)을 통해 쓰며, FtpSync 커맨드렛의 "Cache" 잡이
+ * 빌드 스크립트의 산출물을 이것으로 넣고 꺼낸다.
+ */
+class FILEUPLOAD_API FFtpDerivedDataStore
+{
+public:
+	explicit FFtpDerivedDataStore(const FFtpDerivedDataSettings& InSettings);
+	~FFtpDerivedDataStore();
+
+	FFtpDerivedDataStore(const FFtpDerivedDataStore&) = delete;
+	FFtpDerivedDataStore& operator=(const FFtpDerivedDataStore&) = delete;
+
+	// 작업 명세(User/Password/Server + "DerivedData" 객체)를 읽는다. Server가 있으면 전역 서버 설정도 바꾼다
+	static bool LoadSettings(const FString& JobSpecPath, FFtpDerivedDataSettings& OutSettings);
+
+	bool Start();
+	bool IsRunning() const { return Workers.Num() > 0; }
+
+	void Get(TArray<FFtpCacheGetRequest> Requests, FOnFtpCacheGetComplete OnComplete);
+	void Put(TArray<FFtpCachePutRequest> Requests, FOnFtpCachePutComplete OnComplete = nullptr);
+
+	// 진행 중인 Get/Put이 모두 끝날 때까지 기다린다. 시간 안에 끝나면 true
+	bool WaitForPending(double TimeoutSeconds) const;
+
+	FFtpDerivedDataStats GetStats() const;
+
+	// 키 -> 레코드 이름 (BLAKE3 16진수)
+	static FString MakeRecordName(const FString& Key);
+
+private:
+	class FConnectionWorker;
+	friend class FConnectionWorker;
+
+	using FSharedBytes = TSharedPtr<TArray<uint8>, ESPMode::ThreadSafe>;
+
+	struct FOperation
+	{
+		FString Key;
+		FString Name;
+		uint64 UserData = 0;
+		// Put만 - 저장할 값 (레코드 인코딩은 연결 스레드가 한다)
+		FSharedBytes Value;
+		TSharedPtr<FOnFtpCacheGetComplete, ESPMode::ThreadSafe> OnGet;
+		TSharedPtr<FOnFtpCachePutComplete, ESPMode::ThreadSafe> OnPut;
+	};
+
+	// 로컬/쓰는 중/부정 캐시로 답하고, 남은 키는 원격 큐에 넣는다
+	void ResolveLocally(TArray<FFtpCacheGetRequest>& Requests, const TSharedPtr<FOnFtpCacheGetComplete, ESPMode::ThreadSafe>& OnComplete);
+
+	void Enqueue(TQueue<FOperation, EQueueMode::Mpsc>& Queue, FOperation&& Operation);
+	// Get을 Put보다 먼저 꺼낸다
+	bool Dequeue(FOperation& OutOperation, bool& bOutIsPut);
+
+	// 연결 스레드에서 실행
+	void ProcessGet(FFtpClientConnection& Connection, FOperation& Operation);
+	void ProcessPut(FFtpClientConnection& Connection, FOperation& Operation);
+	bool EnsureConnected(FFtpClientConnection& Connection);
+	// 원격 루트와 샤드 디렉토리를 만든다 - STOR가 디렉토리 없음으로 실패했을 때만 부른다
+	bool EnsureRemoteDirectory(FFtpClientConnection& Connection, const FString& Name);
+
+	void CompleteGet(FOperation& Operation, EFtpCacheStatus Status, EFtpCacheSource Source, TArray<uint8>&& Data);
+	void CompletePut(FOperation& Operation, EFtpCacheStatus Status);
+
+	// 레코드 = 헤더(매직, 버전, 크기, BLAKE3) + 값
+	static void EncodeRecord(const TArray<uint8>& Value, TArray<uint8>& OutRecord);
+	static bool DecodeRecord(const TArray<uint8>& Record, TArray<uint8>& OutValue);
+
+	FString GetLocalPath(const FString& Name) const;
+	FString GetRemotePath(const FString& Name) const;
+	bool ReadLocal(const FString& Name, TArray<uint8>& OutRecord) const;
+	void WriteLocal(const FString& Name, const TArray<uint8>& Record);
+
+	// 로컬 계층을 예산의 90%까지 줄인다 (백그라운드, 한 번에 하나)
+	void RequestTrim();
+	void TrimLocal();
+
+	bool IsNegative(const FString& Name);
+	void AddNegative(const FString& Name);
+	void RemoveNegative(const FString& Name);
+
+	FFtpDerivedDataSettings Settings;
+	TSharedPtr<FInternetAddr> ServerAddr;
+
+	TArray<TUniquePtr<FConnectionWorker>> Workers;
+	FEvent* WorkEvent = nullptr;
+	// Start 전과 소멸 중에는 true
+	TAtomic<bool> bStopping;
+
+	// 생산자는 여럿, 꺼내는 쪽은 DequeueLock으로 하나씩
+	TQueue<FOperation, EQueueMode::Mpsc> GetQueue;
+	TQueue<FOperation, EQueueMode::Mpsc> PutQueue;
+	FCriticalSection DequeueLock;
+	TAtomic<int32> NumQueued;
+
+	// 요청을 받은 뒤 완료 함수를 부르기 전까지의 Get/Put 수 (로컬 단계 포함)
+	TAtomic<int32> NumOutstanding;
+
+	// 로컬에 다 쓰기 전의 Put 값 - 같은 키 Get이 바로 읽어 간다
+	FCriticalSection PendingPutLock;
+	TMap<FString, FSharedBytes> PendingPuts;
+
+	FCriticalSection NegativeLock;
+	TMap<FString, double> NegativeExpiry;
+
+	// 서버에 닿지 않으면 이 시각(FPlatformTime::Cycles64)까지 원격 요청을 바로 실패시킨다
+	TAtomic<uint64> RemoteRetryCycles;
+
+	TAtomic<int64> LocalBytes;
+	TAtomic<bool> bTrimming;
+
+	// 통계
+	TAtomic<uint64> LocalHits;
+	TAtomic<uint64> RemoteHits;
+	TAtomic<uint64> Misses;
+	TAtomic<uint64> NegativeHits;
+	TAtomic<uint64> Errors;
+	TAtomic<uint64> Puts;
+	TAtomic<uint64> RemotePuts;
+	TAtomic<uint64> RemotePutsSkipped;
+	TAtomic<uint64> BytesDownloaded;
+	TAtomic<uint64> BytesUploaded;
+};
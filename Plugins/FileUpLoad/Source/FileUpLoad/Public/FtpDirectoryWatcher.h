@@ -0,0 +1,56 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+
+class FFtpUploadQueue;
+struct FFileChangeData;
+
+// 감시 대상 루트 - 로컬 디렉토리와 대응하는 원격 디렉토리
+struct FFtpWatchRoot
+{
+	FString LocalDirectory;
+	FString RemoteDirectory;
+};
+
+/**
+ * IDirectoryWatcher(Linux에서는 inotify)로 설정된 루트를 감시하고
+ * 변경된 파일만 업로드 큐에 넣는 감시 모드
+ *
+ * 애셋 저장처럼 임시 파일 쓰기 + 이름 변경이 연달아 오는 경우를 위해
+ * 경로별로 마지막 변경 시각을 모아 두었다가 DebounceSeconds 동안 조용해진 경로만 내보낸다.
+ */
+class FILEUPLOAD_API FFtpDirectoryWatcher
+{
+public:
+	FFtpDirectoryWatcher(const FString& InUsername, const TArray<FFtpWatchRoot>& InRoots);
+	~FFtpDirectoryWatcher();
+
+	bool Start();
+	void Stop();
+	bool IsWatching() const { return WatchHandles.Num() > 0; }
+
+	// 마지막 변경 후 업로드까지 기다리는 시간
+	float DebounceSeconds = 1.0f;
+
+private:
+	struct FPendingChange
+	{
+		double LastChangeTime = 0.0;
+		int32 RootIndex = INDEX_NONE;
+	};
+
+	void OnDirectoryChanged(const TArray<FFileChangeData>& Changes, int32 RootIndex);
+	bool Tick(float DeltaTime);
+	bool ShouldIgnore(const FString& Path) const;
+
+	FString Username;
+	TArray<FFtpWatchRoot> Roots;
+
+	// 디바운스 대기 중인 변경 - 경로 단위로 합쳐진다
+	TMap<FString, FPendingChange> PendingChanges;
+
+	TArray<FDelegateHandle> WatchHandles;
+	FTSTicker::FDelegateHandle TickHandle;
+	TUniquePtr<FFtpUploadQueue> UploadQueue;
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "FtpSystem.h"
+#include "FtpBufferPool.h"
+
+struct FFtpLocalDigest;
+
+// 대상 서버별 전송 결과
+struct FFtpFanOutTargetResult
+{
+	FString TargetName;
+	int32 SuccessCount = 0;
+	int32 FailCount = 0;
+	int32 RetryCount = 0;
+	int32 VerifyFailCount = 0;
+};
+
+/**
+ * 같은 파일을 여러 FTP 미러로 동시에 올리는 팬아웃 업로드
+ * 대상마다 전용 스레드를 써서 느린 미러가 다른 미러와 태스크 그래프 작업 스레드를 막지 않는다.
+ * 파일 하나는 한 번만 읽어 공유 버퍼에 두고 각 대상의 curl 표준 입력으로 흘려 보내며, 실패한 대상만 같은 버퍼로 다시 시도한다.
+ * 폴더는 대상마다 curl 한 번에 묶어 올리고(로그인/TLS 세션 한 번), 실패한 파일만 다시 묶는다.
+ */
+namespace FtpFanOut
+{
+	// 이 크기 이하 파일은 풀 슬랩 여러 개에 한 번만 읽어 두고 모든 대상과 재시도가 그 메모리를 쓴다 (풀 예산이 모자라면 스트리밍).
+	// 넘는 파일은 청크 단위로 읽어 대상마다 따로 쌓는 창으로 흘려 보내고, 창보다 뒤처진 대상은 스스로 읽어 따라간다
+	constexpr int64 MaxSharedBufferBytes = 16 * FFtpBufferPool::MaxSlabSize;
+
+	// 파일 하나를 모든 대상으로 업로드. OutTargetSuccess/OutTargetAttempts는 Targets와 같은 순서
+	// OutDigest를 주면 보내는 데이터로 해시를 함께 계산한다 (추가 디스크 읽기 없음)
+	bool UploadFileToServers(const FString& LocalPath, const FString& RemotePath, const TArray<FFtpServerProfile>& Targets, TArray<bool>& OutTargetSuccess, int32 MaxRetries = 2, TArray<int32>* OutTargetAttempts = nullptr, FFtpLocalDigest* OutDigest = nullptr);
+
+	// 폴더 전체를 모든 대상으로 업로드 (막힌다). bVerify면 끝난 뒤 대상별로 서버 해시와 비교하고 불일치는 실패로 센다
+	void UploadToFtpServers(const FString& LocalPath, const FString& RemotePath, const TArray<FFtpServerProfile>& Targets, TArray<FFtpFanOutTargetResult>& OutResults, int32 MaxRetries = 2, bool bVerify = false);
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include "Misc/DateTime.h"
+#include "Widgets/Views/SHeaderRow.h"
+
+// 목록 항목 상태
+enum class EFtpListEntryStatus : uint8
+{
+	None,
+	Pending,
+	Succeeded,
+	Failed,
+	// 드라이런 계획의 동작 (실행하면 Succeeded/Failed로 바뀐다)
+	PlanCreate,
+	PlanUpdate,
+	PlanSkip,
+	PlanDelete
+};
+
+// 목록 컬럼 ID
+struct FILEUPLOAD_API FFtpListColumns
+{
+	static const FName Path;
+	static const FName Size;
+	static const FName Time;
+	static const FName Status;
+};
+
+// SListView 항목 - 모델의 행 인덱스만 보관한다
+struct FFtpListItem
+{
+	int32 Index;
+
+	explicit FFtpListItem(int32 InIndex)
+		: Index(InIndex)
+	{
+	}
+};
+
+typedef TSharedPtr<FFtpListItem> FFtpListItemPtr;
+
+/**
+ * 파일 관리자/업로드 이력 탭이 공유하는 평면 SoA(struct-of-arrays) 목록 모델
+ *
+ * 추가/상태 변경은 어느 스레드에서나 큐에 넣을 수 있고, 게임 스레드의 FlushPending()에서
+ * 한 번에 반영된다. 정렬과 필터는 스레드 풀에서 인덱스 배열만 만들어 돌려주므로
+ * 위젯은 보이는 행만 생성하고 전체를 다시 만들지 않는다.
+ */
+class FILEUPLOAD_API FFtpFileListModel : public TSharedFromThis<FFtpFileListModel>
+{
+public:
+	DECLARE_MULTICAST_DELEGATE(FOnViewChanged);
+
+	// bInUniquePaths가 true면 같은 경로의 재추가는 기존 행을 갱신한다 (파일 관리자)
+	explicit FFtpFileListModel(bool bInUniquePaths = true);
+
+	// 항목 추가/상태 변경 요청 (스레드 안전)
+	void EnqueueAdd(const FString& Path, int64 Size, const FDateTime& Time, EFtpListEntryStatus Status);
+	void EnqueueStatus(const FString& Path, EFtpListEntryStatus Status);
+
+	// 대기 중인 변경을 반영한다 (게임 스레드). 보이는 목록이 바뀌면 true
+	bool FlushPending();
+
+	// 정렬/필터 설정 (게임 스레드) - 백그라운드에서 보이는 목록을 다시 계산한다
+	void SetSort(FName Column, EColumnSortMode::Type Mode);
+	void SetFilter(const FString& InFilter);
+
+	FName GetSortColumn() const { return SortColumn; }
+	EColumnSortMode::Type GetSortMode() const { return SortMode; }
+
+	// 보이는 항목 (SListView의 ListItemsSource)
+	const TArray<FFtpListItemPtr>* GetVisibleItems() const { return &VisibleItems; }
+	int32 Num() const { return Paths.Num(); }
+
+	// 행 데이터 조회 (게임 스레드)
+	const FString& GetPath(int32 Index) const { return Paths[Index]; }
+	int64 GetSize(int32 Index) const { return Sizes[Index]; }
+	const FDateTime& GetTime(int32 Index) const { return Times[Index]; }
+	EFtpListEntryStatus GetStatus(int32 Index) const { return Statuses[Index]; }
+
+	FOnViewChanged& OnViewChanged() { return ViewChangedEvent; }
+
+private:
+	struct FPendingOp
+	{
+		FString Path;
+		int64 Size = 0;
+		FDateTime Time;
+		EFtpListEntryStatus Status = EFtpListEntryStatus::None;
+		bool bIsAdd = false;
+	};
+
+	// 프레임당 반영할 최대 변경 수
+	static constexpr int32 MaxOpsPerFlush = 20000;
+
+	// 이보다 많은 행이 한 번에 추가되면 끼워 넣기 대신 백그라운드 재정렬
+	static constexpr int32 IncrementalInsertLimit = 256;
+
+	bool PassesFilter(int32 Index, const FString& Filter) const;
+	static bool CompareRows(const FFtpFileListModel& Model, FName Column, EColumnSortMode::Type Mode, int32 A, int32 B);
+
+	void RequestRebuildView();
+	void ApplyView(uint32 Generation, int32 SnapshotNum, TArray<int32>&& Indices);
+	void InsertVisible(int32 Index);
+
+	// SoA 컬럼 - 게임 스레드에서만 쓰고, 백그라운드는 DataLock 읽기 잠금으로만 읽는다
+	TArray<FString> Paths;
+	TArray<int64> Sizes;
+	TArray<FDateTime> Times;
+	TArray<EFtpListEntryStatus> Statuses;
+	FRWLock DataLock;
+
+	// 행마다 한 번만 만드는 항목 핸들
+	TArray<FFtpListItemPtr> Handles;
+	TMap<FString, int32> PathToIndex;
+
+	TArray<FFtpListItemPtr> VisibleItems;
+	TQueue<FPendingOp, EQueueMode::Mpsc> PendingOps;
+
+	bool bUniquePaths;
+	FName SortColumn;
+	EColumnSortMode::Type SortMode;
+	FString FilterText;
+	uint32 ViewGeneration;
+	bool bRebuildInFlight;
+
+	FOnViewChanged ViewChangedEvent;
+};
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+
+class FEvent;
+
+/**
+ * 서버 STOR 수신 파일의 그룹 커밋
+ *
+ * 세션은 임시 파일에 다 받은 뒤 Commit을 부르고 기다린다. 커밋 스레드는 짧은 시간 동안 모인 파일들을 한 번에
+ * 디스크에 내린 뒤(Linux: 장치마다 syncfs 한 번, 적으면 파일마다 fdatasync) 최종 경로로 원자적으로 이름을 바꾸고
+ * 바뀐 디렉토리들을 fsync한다. 그래서 읽는 쪽은 덜 받은 파일을 볼 수 없고, 226 응답은 파일이 내구성 있게 남은 뒤에만 나간다.
+ */
+class FILEUPLOAD_API FFtpIngestCommitter
+{
+public:
+	// 첫 요청이 들어온 뒤 다른 세션의 파일을 더 모으는 시간
+	static constexpr double MaxBatchDelaySeconds = 0.005;
+
+	// 한 번에 커밋할 최대 파일 수
+	static constexpr int32 MaxBatchFiles = 512;
+
+	// 이 수 이상이면 파일마다 fdatasync하지 않고 장치마다 syncfs 한 번 (Linux)
+	static constexpr int32 SyncFileSystemMinFiles = 16;
+
+	FFtpIngestCommitter();
+	~FFtpIngestCommitter();
+
+	FFtpIngestCommitter(const FFtpIngestCommitter&) = delete;
+	FFtpIngestCommitter& operator=(const FFtpIngestCommitter&) = delete;
+
+	void Start();
+
+	// 남은 요청을 모두 처리하고 스레드를 멈춘다
+	void Stop();
+
+	// TempPath를 내구성 있게 FinalPath로 옮긴다 - 끝날 때까지 기다린다
+	bool Commit(const FString& TempPath, const FString& FinalPath);
+
+	// 같은 디렉토리 안의 임시 파일 이름 (이름 바꾸기가 원자적이도록)
+	static FString MakeTempPath(const FString& FinalPath);
+	static bool IsTempFileName(const FString& FileName);
+
+	// TempPath로 FinalPath를 원자적으로 바꾼다 (POSIX rename, Windows MoveFileExW) - 중간에 대상이 사라지는 순간이 없다
+	static bool ReplaceFile(const FString& TempPath, const FString& FinalPath);
+
+private:
+	struct FRequest
+	{
+		FString TempPath;
+		FString FinalPath;
+		FEvent* DoneEvent = nullptr;
+		bool bSuccess = false;
+	};
+
+	void CommitLoop();
+	void CommitBatch(TArray<FRequest*>& Batch);
+
+	FCriticalSection Lock;
+	TArray<FRequest*> Pending;
+	FEvent* WakeEvent = nullptr;
+	TFuture<void> CommitFuture;
+	TAtomic<bool> bStopping;
+	bool bStarted = false;
+};
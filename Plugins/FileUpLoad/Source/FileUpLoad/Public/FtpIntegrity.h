@@ -0,0 +1,98 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/SecureHash.h"
+#include "FtpSystem.h"
+
+// 로컬 파일 요약값 - 서버가 지원하는 어떤 해시 명령과도 비교할 수 있도록 한 번에 모두 계산한다
+struct FFtpLocalDigest
+{
+	int64 Size = 0;
+	FString Md5;
+	FString Sha1;
+	uint32 Crc32 = 0;
+	bool bValid = false;
+};
+
+/**
+ * 전송 중인 데이터를 받아 MD5/SHA-1/CRC32를 함께 계산한다
+ * 스트리밍 업로드에서 보내는 청크를 그대로 넣으면 디스크를 다시 읽지 않아도 된다.
+ */
+class FILEUPLOAD_API FFtpDigestBuilder
+{
+public:
+	FFtpDigestBuilder();
+
+	void Update(const uint8* Data, int64 Size);
+	FFtpLocalDigest Finalize();
+
+private:
+	FMD5 Md5;
+	FSHA1 Sha1;
+	uint32 Crc32 = 0;
+	int64 Size = 0;
+};
+
+// 서버 측 확인 방법 (강한 것부터)
+enum class EFtpVerifyMethod : uint8
+{
+	None,
+	Hash,
+	XSha1,
+	XMd5,
+	XCrc,
+	SizeAndTime
+};
+
+// 검증 결과
+enum class EFtpVerifyResult : uint8
+{
+	Verified,
+	Mismatch,
+	Missing,
+	Unverifiable
+};
+
+// 검증 요청 한 건 - Digest가 유효하면 그대로 쓰고, 아니면 필요할 때만 로컬에서 계산한다
+struct FFtpVerifyRequest
+{
+	FString LocalPath;
+	FString RemotePath;
+	FFtpLocalDigest Digest;
+	FDateTime UploadedAfter = FDateTime::MinValue();
+};
+
+struct FFtpVerifyOutcome
+{
+	FString LocalPath;
+	FString RemotePath;
+	EFtpVerifyMethod Method = EFtpVerifyMethod::None;
+	EFtpVerifyResult Result = EFtpVerifyResult::Unverifiable;
+	FString LocalValue;
+	FString RemoteValue;
+};
+
+/**
+ * 다시 내려받지 않고 서버 측 해시와 비교하는 전송 후 무결성 검증
+ * HASH / XSHA1 / XMD5 / XCRC 중 서버가 지원하는 가장 강한 명령을 쓰고,
+ * 아무것도 없으면 SIZE + MDTM으로 대신한다. 원격 디렉토리 단위로 curl 한 번에 묶어 묻는다.
+ */
+namespace FtpIntegrity
+{
+	// 한 번의 curl 호출에 넣는 최대 파일 수
+	constexpr int32 MaxFilesPerQuery = 128;
+
+	// SIZE + MDTM 비교 시 허용하는 서버/로컬 시계 차이
+	constexpr double ClockSkewSeconds = 120.0;
+
+	// 로컬 파일을 한 번 읽어 요약값 계산
+	bool ComputeLocalDigest(const FString& LocalPath, FFtpLocalDigest& OutDigest);
+
+	// 파일 목록 검증. 결과는 Requests와 같은 순서이고 전송 이력에 Verify로 기록된다. 불일치/누락 수 반환
+	int32 VerifyFiles(const FFtpServerProfile& Server, const TArray<FFtpVerifyRequest>& Requests, TArray<FFtpVerifyOutcome>& OutOutcomes);
+
+	// 로컬 폴더 전체를 원격 폴더와 비교
+	FFtpSyncStats VerifyFolder(const FString& LocalPath, const FString& RemotePath, const FFtpServerProfile& Server);
+
+	const TCHAR* LexToString(EFtpVerifyMethod Method);
+}
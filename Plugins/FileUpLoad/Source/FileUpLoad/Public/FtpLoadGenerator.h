@@ -0,0 +1,104 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FFtpServer;
+
+// 부하 생성기가 재는 명령 종류
+enum class EFtpLoadCommand : uint8
+{
+	Connect,
+	Login,
+	Epsv,
+	List,
+	Retr,
+	Stor,
+	Size,
+	Count
+};
+
+// 부하 설정 - 클라이언트마다 제어 연결 하나를 유지하며 작업 비율대로 명령을 보낸다
+struct FFtpLoadConfig
+{
+	FString Host = TEXT("127.0.0.1");
+	int32 Port = 2121;
+	FString User;
+	FString Password;
+
+	// 동시에 붙어 있는 세션 수
+	int32 Clients = 1000;
+	// 명령을 보내는 스레드 수 - 동시에 진행 중인 명령의 상한
+	int32 Workers = 64;
+	double DurationSeconds = 30.0;
+	// 한 클라이언트의 작업 예정 시각 사이 평균 간격 (0.5~1.5배로 흔든다) - 앞 작업이 늦어도 예정은 밀리지 않는다
+	double ThinkTimeSeconds = 0.05;
+
+	// 작업 비율 (Login은 끊고 다시 접속 + 로그인)
+	float LoginWeight = 1.0f;
+	float ListWeight = 4.0f;
+	float StorWeight = 2.0f;
+	float RetrWeight = 6.0f;
+	float SizeWeight = 6.0f;
+
+	// 준비 단계에 올려 두는 RETR/SIZE 대상 파일
+	int32 NumFiles = 64;
+	int32 FileBytes = 256 * 1024;
+	// STOR 한 번에 보내는 크기
+	int32 StorBytes = 64 * 1024;
+};
+
+// 명령 하나의 지연 분포
+struct FFtpLoadCommandResult
+{
+	FString Command;
+	int64 Count = 0;
+	int64 Errors = 0;
+	double P50Ms = 0.0;
+	double P99Ms = 0.0;
+	double P999Ms = 0.0;
+	double MaxMs = 0.0;
+};
+
+struct FFtpLoadResult
+{
+	TArray<FFtpLoadCommandResult> Commands;
+	int32 Clients = 0;
+	int32 ConnectedClients = 0;
+	double Seconds = 0.0;
+	int64 Operations = 0;
+	double OperationsPerSecond = 0.0;
+	double MegabytesPerSecond = 0.0;
+	double ErrorRate = 0.0;
+
+	// 서버와 같은 프로세스에서 잰 값 - 시작 전 대비 증가분과 최고치
+	int64 BaseUsedPhysical = 0;
+	int64 PeakUsedPhysical = 0;
+	int32 PeakSessions = 0;
+	int64 CacheBytes = 0;
+};
+
+/**
+ * FTP 서버 경로의 다중 클라이언트 부하 생성기
+ *
+ * Clients개의 세션을 Workers개 스레드에 나눠 붙이고, 각 스레드는 자기 클라이언트 중 예정 시각이 가장 이른 것부터
+ * 작업 비율에 따라 LIST/RETR/STOR/SIZE/재로그인 중 하나를 보낸다. 작업의 첫 명령 지연은 실제로 보낸 때가 아니라 예정 시각부터
+ * 재므로, 서버가 느려 같은 스레드의 다른 작업이 밀려도 그 대기가 빠지지 않는다 (coordinated omission).
+ * 명령별 지연은 스레드마다 로그-선형 히스토그램에 할당 없이 모았다가 끝에 합쳐 p50/p99/p999를 낸다. 내장 서버를 같은 프로세스에서 돌리면(Server) 세션 수,
+ * 읽기 캐시, 프로세스 메모리의 최고치도 함께 기록한다.
+ */
+namespace FtpLoadGenerator
+{
+	// 부하를 걸고 결과를 돌려준다. Server는 같은 프로세스의 내장 서버(없으면 nullptr)
+	bool Run(const FFtpLoadConfig& Config, const FFtpServer* Server, FFtpLoadResult& OutResult);
+
+	bool SaveResult(const FFtpLoadResult& Result, const FString& FilePath);
+	bool LoadResult(const FString& FilePath, FFtpLoadResult& OutResult);
+
+	// 기준보다 Tolerance(0.2 = 20%) 넘게 나빠진 항목을 OutRegressions에 담는다. 없으면 true
+	bool CompareWithBaseline(const FFtpLoadResult& Result, const FFtpLoadResult& Baseline, double Tolerance, TArray<FString>& OutRegressions);
+
+	// 로그용 여러 줄 요약
+	FString DescribeResult(const FFtpLoadResult& Result);
+
+	const TCHAR* LexToString(EFtpLoadCommand Command);
+}
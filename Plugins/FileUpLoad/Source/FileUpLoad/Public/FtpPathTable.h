@@ -0,0 +1,84 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/DateTime.h"
+#include "Misc/StringBuilder.h"
+
+/**
+ * 스캔/전송 큐용 압축 경로 표
+ *
+ * 디렉토리는 (부모, 이름) 노드로 한 번만 저장하고, 파일은 (디렉토리, 이름) 인덱스만 가진다.
+ * 이름 문자는 모두 하나의 배열(아레나)에 이어 붙이므로 파일당 FString 할당이 없다.
+ * 상대/원격/전체 경로는 필요할 때 호출자의 문자열 빌더에 조립한다.
+ */
+class FILEUPLOAD_API FFtpPathTable
+{
+public:
+	static constexpr int32 RootDirectory = 0;
+
+	explicit FFtpPathTable(const FString& InRoot);
+
+	// 루트 아래를 재귀로 훑어 파일을 추가한다. 추가한 파일 수 반환
+	int32 Scan();
+
+	// 루트 기준 상대 경로("A/B/C.uasset")로 파일 하나 추가
+	int32 AddFile(FStringView RelativePath, int64 Size = -1, const FDateTime& Modified = FDateTime());
+
+	// 디렉토리 노드 찾기/추가 (같은 부모 아래 같은 이름이면 같은 노드)
+	int32 FindOrAddDirectory(int32 Parent, FStringView Name);
+
+	int32 Num() const { return Files.Num(); }
+	int32 NumDirectories() const { return Dirs.Num(); }
+
+	const FString& GetRoot() const { return Root; }
+	int64 GetFileSize(int32 FileIndex) const { return Files[FileIndex].Size; }
+	FDateTime GetFileModified(int32 FileIndex) const { return FDateTime(Files[FileIndex].ModifiedTicks); }
+	int32 GetFileDirectory(int32 FileIndex) const { return Files[FileIndex].Dir; }
+	FStringView GetFileName(int32 FileIndex) const;
+
+	// 경로 조립 - Out 뒤에 이어 붙인다 (비우지 않음)
+	void AppendDirectoryPath(int32 DirIndex, FStringBuilderBase& Out) const;
+	void AppendRelativePath(int32 FileIndex, FStringBuilderBase& Out) const;
+	void AppendFullPath(int32 FileIndex, FStringBuilderBase& Out) const;
+	void AppendRemotePath(int32 FileIndex, FStringView RemoteBase, FStringBuilderBase& Out) const;
+
+	// 편의용 - 결과 FString 하나만 할당
+	FString GetRelativePath(int32 FileIndex) const;
+	FString GetFullPath(int32 FileIndex) const;
+	FString GetRemotePath(int32 FileIndex, FStringView RemoteBase) const;
+
+	// 표가 차지하는 메모리 (통계/로그용)
+	SIZE_T GetAllocatedSize() const;
+
+	void Empty();
+
+private:
+	struct FDirNode
+	{
+		int32 Parent = INDEX_NONE;
+		int32 NameOffset = 0;
+		int32 NameLength = 0;
+		// 같은 (부모, 이름 해시) 키를 가진 다음 노드 - 해시 충돌 체인
+		int32 NextSameKey = INDEX_NONE;
+	};
+
+	struct FFileEntry
+	{
+		int32 Dir = RootDirectory;
+		int32 NameOffset = 0;
+		int32 NameLength = 0;
+		int64 Size = -1;
+		// 수정 시각 (UTC, FDateTime 틱)
+		int64 ModifiedTicks = 0;
+	};
+
+	int32 AddName(FStringView Name);
+	FStringView GetName(int32 Offset, int32 Length) const { return FStringView(Names.GetData() + Offset, Length); }
+	static uint64 MakeDirKey(int32 Parent, FStringView Name);
+
+	FString Root;
+	TArray<TCHAR> Names;
+	TArray<FDirNode> Dirs;
+	TArray<FFileEntry> Files;
+	TMap<uint64, int32> DirLookup;
+};
@@ -0,0 +1,200 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/StringView.h"
+#include "Misc/DateTime.h"
+
+// 제어 연결 명령 - 같은 뜻의 옛 이름(XPWD, XMKD)은 같은 값으로 모인다
+enum class EFtpCommand : uint8
+{
+	Unknown,
+	User,
+	Pass,
+	Quit,
+	Noop,
+	Syst,
+	Feat,
+	Opts,
+	Type,
+	Mode,
+	Stru,
+	Pwd,
+	Cwd,
+	Cdup,
+	Pasv,
+	Epsv,
+	Rest,
+	Size,
+	Mdtm,
+	List,
+	Nlst,
+	Mlsd,
+	Retr,
+	Stor,
+	Mkd,
+	Dele,
+	Rnfr,
+	Rnto,
+	Count
+};
+
+// 파싱한 명령 한 줄 - 뷰는 줄을 담은 버퍼(FFtpLineReader)가 다음 줄로 넘어가기 전까지만 유효하다
+struct FFtpCommandView
+{
+	EFtpCommand Command = EFtpCommand::Unknown;
+	FAnsiStringView Verb;
+	// 첫 공백 뒤 전부 (파일 이름의 공백 유지), UTF-8
+	FAnsiStringView Argument;
+};
+
+enum class EFtpLineResult : uint8
+{
+	// 완성된 줄을 돌려줌
+	Line,
+	// 줄 끝이 아직 오지 않음 - 더 받아야 한다
+	NeedMore,
+	// MaxLineLength를 넘었음 - 연결을 끊어야 한다
+	Overflow
+};
+
+/**
+ * 제어 연결 바이트를 줄 단위로 자르는 고정 크기 수신 버퍼
+ *
+ * 소켓에서 GetWriteBuffer()로 받은 자리에 바로 읽어 넣고 CommitWrite로 알린다. NextLine은 CR/LF를 뺀 줄을
+ * 버퍼 안의 뷰로 돌려주며 복사하지 않는다. 버퍼는 생성할 때 한 번만 잡고, 앞쪽이 비면 남은 바이트를 당겨 쓴다.
+ */
+class FILEUPLOAD_API FFtpLineReader
+{
+public:
+	explicit FFtpLineReader(int32 InMaxLineLength = 4096);
+
+	// 받을 자리와 그 크기. 반환한 자리는 다음 NextLine 전까지 앞서 돌려준 줄 뷰를 덮어쓸 수 있다
+	uint8* GetWriteBuffer(int32& OutCapacity);
+	void CommitWrite(int32 BytesWritten);
+
+	EFtpLineResult NextLine(FAnsiStringView& OutLine);
+
+	// 아직 줄로 꺼내지 않은 바이트가 있는지
+	bool HasPendingBytes() const { return End > Start; }
+
+	void Reset();
+
+private:
+	TArray<ANSICHAR> Buffer;
+	int32 Start = 0;
+	int32 End = 0;
+	// Start 이후 이미 줄 끝이 없음을 확인한 위치 - 같은 바이트를 다시 훑지 않는다
+	int32 ScanFrom = 0;
+	int32 MaxLineLength;
+};
+
+enum class EFtpReplyResult : uint8
+{
+	// 여러 줄 응답의 중간 줄
+	NeedMore,
+	// 마지막 줄까지 받음 - GetCode/GetText로 읽는다
+	Complete,
+	// 응답 코드로 시작하지 않는 첫 줄
+	Malformed
+};
+
+/**
+ * 응답을 줄 단위로 받아 조립하는 파서 (RFC 959 4.2)
+ *
+ * "123-"로 시작하면 같은 코드의 "123 " 줄까지 이어지는 여러 줄 응답이다. 줄을 하나씩 Feed하면 되고,
+ * 응답 하나가 여러 번의 수신에 걸쳐 와도 상태를 들고 있으므로 다시 훑지 않는다.
+ */
+class FILEUPLOAD_API FFtpReplyParser
+{
+public:
+	EFtpReplyResult Feed(FAnsiStringView Line);
+
+	int32 GetCode() const { return Code; }
+	// 마지막 줄에서 코드와 구분자를 뺀 부분 - Feed에 넘긴 줄의 뷰
+	FAnsiStringView GetText() const { return Text; }
+	int32 GetNumLines() const { return NumLines; }
+	bool IsMultiLine() const { return bMultiLine; }
+
+	void Reset();
+
+private:
+	int32 Code = 0;
+	int32 NumLines = 0;
+	bool bMultiLine = false;
+	// 끝난 응답 뒤에 오는 줄은 새 응답으로 시작한다
+	bool bComplete = false;
+	FAnsiStringView Text;
+};
+
+/**
+ * 나가는 명령/응답을 조립하는 재사용 버퍼
+ *
+ * Reset은 길이만 0으로 돌리고 메모리는 그대로 둔다. 숫자, 시각, UTF-8 변환을 모두 버퍼에 직접 써서
+ * 메시지마다 FString이나 임시 버퍼를 만들지 않는다.
+ */
+class FILEUPLOAD_API FFtpMessageWriter
+{
+public:
+	explicit FFtpMessageWriter(int32 InitialCapacity = 512);
+
+	FFtpMessageWriter& Reset();
+
+	// "227 " 또는 여러 줄 응답의 첫 줄 "211-"
+	FFtpMessageWriter& BeginReply(int32 Code, bool bContinued = false);
+	// "RETR" - 인자는 AppendArgument로
+	FFtpMessageWriter& BeginCommand(EFtpCommand Command);
+	FFtpMessageWriter& AppendArgument(FAnsiStringView Argument);
+
+	FFtpMessageWriter& Append(FAnsiStringView Text);
+	FFtpMessageWriter& Append(ANSICHAR Char);
+	FFtpMessageWriter& AppendUtf8(FStringView Text);
+	// MinDigits보다 짧으면 앞을 0으로 채운다
+	FFtpMessageWriter& AppendInt(int64 Value, int32 MinDigits = 0);
+	// MDTM/MLSD 형식 "YYYYMMDDHHMMSS"
+	FFtpMessageWriter& AppendTimestamp(const FDateTime& Time);
+	// LIST 형식 "Mon DD HH:MM"
+	FFtpMessageWriter& AppendListTime(const FDateTime& Time);
+
+	// 줄 끝(CRLF)을 붙인다
+	FFtpMessageWriter& EndLine();
+
+	const uint8* GetData() const { return (const uint8*)Buffer.GetData(); }
+	int32 Num() const { return Buffer.Num(); }
+	FAnsiStringView GetView() const { return FAnsiStringView(Buffer.GetData(), Buffer.Num()); }
+
+private:
+	ANSICHAR* AddUninitialized(int32 Count);
+
+	TArray<ANSICHAR> Buffer;
+};
+
+namespace FtpProtocol
+{
+	// 명령 표 키 - 대문자 4글자까지를 32비트로 묶는다 (컴파일 타임에 계산)
+	constexpr uint32 MakeCommandKey(const ANSICHAR* Verb, int32 Length)
+	{
+		uint32 Key = 0;
+		for (int32 Index = 0; Index < Length && Index < 4; ++Index)
+		{
+			Key = (Key << 8) | (uint8)Verb[Index];
+		}
+		return Key;
+	}
+
+	// 대소문자 구분 없이 명령을 찾는다. 없으면 Unknown
+	FILEUPLOAD_API EFtpCommand LookupCommand(FAnsiStringView Verb);
+
+	// "VERB argument" 한 줄을 나눈다. 빈 줄이면 false
+	FILEUPLOAD_API bool ParseCommand(FAnsiStringView Line, FFtpCommandView& OutCommand);
+
+	// UTF-8 인자를 Out에 풀어 쓴다 - Out의 메모리를 재사용한다
+	FILEUPLOAD_API void DecodeArgument(FAnsiStringView Utf8, FString& Out);
+
+	// 대소문자 구분 없는 비교 (ASCII)
+	FILEUPLOAD_API bool EqualsIgnoreCase(FAnsiStringView A, FAnsiStringView B);
+
+	// 10진수 (음수 불가). 숫자가 아니거나 넘치면 false
+	FILEUPLOAD_API bool ParseInt64(FAnsiStringView Text, int64& OutValue);
+
+	FILEUPLOAD_API const ANSICHAR* LexToString(EFtpCommand Command);
+}
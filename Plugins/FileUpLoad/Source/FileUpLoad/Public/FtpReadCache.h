@@ -0,0 +1,156 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class IFileHandle;
+class FEvent;
+
+// 캐시 미스를 채우는 읽기 전용 파일 - Linux에서는 순차 읽기 힌트와 미리 읽기(posix_fadvise)를 준다
+class FILEUPLOAD_API FFtpReadCacheFile
+{
+public:
+	FFtpReadCacheFile() = default;
+	~FFtpReadCacheFile();
+
+	FFtpReadCacheFile(const FFtpReadCacheFile&) = delete;
+	FFtpReadCacheFile& operator=(const FFtpReadCacheFile&) = delete;
+
+	bool Open(const FString& Path);
+
+	// 커널에 [Offset, Offset+Length) 구간을 미리 읽어 두라고 알린다 (다른 플랫폼에서는 아무 일도 안 함)
+	void ReadAhead(int64 Offset, int64 Length);
+
+	bool ReadAt(int64 Offset, uint8* Dest, int64 Length);
+
+private:
+#if PLATFORM_LINUX
+	int Fd = -1;
+#else
+	TUniquePtr<IFileHandle> Handle;
+#endif
+};
+
+/**
+ * 서버 RETR용 페이지 읽기 캐시
+ *
+ * 파일을 PageSize 단위 페이지로 나눠 메모리 상한(BudgetBytes) 안에서 보관한다.
+ * 샤드마다 읽기/쓰기 잠금을 두고 조회는 읽기 잠금만 잡으며, 교체는 참조 비트를 쓰는 CLOCK(LRU 근사)으로 한다.
+ * 미스는 페이지마다 "채우는 중" 표시만 남기고 잠금 밖에서 읽는다 - 같은 페이지를 원하는 세션만 기다리고 샤드의 다른 페이지는 막히지 않는다.
+ * 페이지 키에 파일 크기/수정 시각/무효화 세대가 들어가므로 쓰기가 일어나면 옛 페이지는 더 이상 맞지 않고 밀려난다.
+ * 같은 야간 빌드를 여러 에이전트가 동시에 받아도 디스크는 페이지당 한 번만 읽는다.
+ */
+class FILEUPLOAD_API FFtpReadCache
+{
+public:
+	static constexpr int64 PageSize = 1024 * 1024;
+	static constexpr int32 NumShards = 16;
+
+	// 캐시 미스 때 요청 페이지 뒤로 함께 읽어 둘 페이지 수
+	static constexpr int32 ReadAheadPages = 4;
+
+	using FPage = TSharedPtr<const TArray<uint8>, ESPMode::ThreadSafe>;
+
+	// 열린 파일 한 개 - 세션이 RETR 동안 들고 있는다
+	struct FFileView
+	{
+		FString Path;
+		int64 Size = 0;
+		FDateTime Modified;
+		// 경로/크기/수정 시각/세대를 합친 키
+		uint64 FileKey = 0;
+	};
+
+	explicit FFtpReadCache(int64 InBudgetBytes);
+	~FFtpReadCache();
+
+	FFtpReadCache(const FFtpReadCache&) = delete;
+	FFtpReadCache& operator=(const FFtpReadCache&) = delete;
+
+	// 파일 정보를 읽어 FileView를 만든다. 파일이 없거나 디렉토리면 false
+	bool OpenFile(const FString& Path, FFileView& OutFile) const;
+
+	// 호출자가 이미 stat한 값으로 FileView를 만든다
+	void MakeFileView(const FString& Path, int64 Size, const FDateTime& Modified, FFileView& OutFile) const;
+
+	// 페이지 하나 - 없으면 디스크에서 읽어 넣는다. Reader는 호출자가 들고 있는 파일 핸들(처음엔 비어 있어도 됨)
+	FPage GetPage(const FFileView& File, int64 PageIndex, TUniquePtr<FFtpReadCacheFile>& Reader);
+
+	// 쓰기/삭제/이름 변경 후 호출 - 이 경로의 기존 페이지는 다시 맞지 않는다
+	void Invalidate(const FString& Path);
+
+	void Empty();
+
+	int64 GetBudgetBytes() const { return BudgetBytes; }
+	int64 GetCachedBytes() const;
+	uint64 GetHits() const { return Hits.Load(); }
+	uint64 GetMisses() const { return Misses.Load(); }
+
+private:
+	struct FPageKey
+	{
+		uint64 FileKey = 0;
+		int64 PageIndex = 0;
+
+		bool operator==(const FPageKey& Other) const { return FileKey == Other.FileKey && PageIndex == Other.PageIndex; }
+		friend uint32 GetTypeHash(const FPageKey& Key) { return HashCombine(GetTypeHash(Key.FileKey), GetTypeHash(Key.PageIndex)); }
+	};
+
+	struct FSlot
+	{
+		FPageKey Key;
+		FPage Data;
+	};
+
+	// 디스크에서 읽고 있는 페이지 - 같은 페이지를 원하는 세션은 Done을 기다린다
+	struct FPendingFill
+	{
+		FPendingFill();
+		~FPendingFill();
+
+		FEvent* Done = nullptr;
+		// 읽기가 실패하면 비어 있다
+		FPage Data;
+	};
+	using FPendingFillRef = TSharedRef<FPendingFill, ESPMode::ThreadSafe>;
+
+	struct FShard
+	{
+		mutable FRWLock Lock;
+		TMap<FPageKey, int32> Index;
+		// 채우는 중인 페이지 (Lock 아래에서만 바꾼다)
+		TMap<FPageKey, FPendingFillRef> Filling;
+		TArray<FSlot> Slots;
+		// 조회가 읽기 잠금 아래에서 세우는 참조 비트 (Slots와 같은 인덱스)
+		TArray<int8> Referenced;
+		int32 ClockHand = 0;
+		int64 Bytes = 0;
+	};
+
+	FShard& GetShard(const FPageKey& Key) { return Shards[GetTypeHash(Key) % NumShards]; }
+
+	FPage Find(FShard& Shard, const FPageKey& Key);
+	// 캐시에 있으면 OutPage, 다른 세션이 채우는 중이면 OutWait, 아니면 이 호출자가 채우기로 하고 OutClaim을 돌려준다
+	void BeginFill(FShard& Shard, const FPageKey& Key, FPage& OutPage, TSharedPtr<FPendingFill, ESPMode::ThreadSafe>& OutWait, TSharedPtr<FPendingFill, ESPMode::ThreadSafe>& OutClaim);
+	// 읽은 페이지를 넣고(실패면 빈 페이지) 기다리는 세션을 깨운다
+	void EndFill(FShard& Shard, const FPageKey& Key, const FPendingFillRef& Claim, const FPage& Data);
+	// Lock을 쓰기로 잡은 상태에서 부른다
+	void InsertLocked(FShard& Shard, const FPageKey& Key, const FPage& Data);
+	void EvictOne(FShard& Shard);
+
+	uint32 GetGeneration(const FString& Path) const;
+
+	int64 BudgetBytes = 0;
+	int64 ShardBudgetBytes = 0;
+	FShard Shards[NumShards];
+
+	// 무효화된 경로만 기록한다. 기록이 MaxTrackedGenerations를 넘으면 모두 잊고 기본 세대를 올린다
+	// (세대 값은 계속 증가하므로 잊은 경로의 옛 페이지 키도 다시 맞지 않는다)
+	static constexpr int32 MaxTrackedGenerations = 16384;
+	mutable FRWLock GenerationLock;
+	TMap<FString, uint32> Generations;
+	uint32 BaseGeneration = 0;
+	uint32 LastGeneration = 0;
+
+	TAtomic<uint64> Hits;
+	TAtomic<uint64> Misses;
+};
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "Containers/Queue.h"
+
+class FEvent;
+class FSocket;
+class FFtpServerSession;
+class FFtpReadCache;
+class FFtpIngestCommitter;
+
+// 플러그인 내장 FTP 서버 설정
+struct FFtpServerConfig
+{
+	// 듣는 주소 - 기본은 루프백. 다른 주소에서는 기본 계정(test/admin)이 남아 있으면 시작하지 않는다
+	FString BindAddress = TEXT("127.0.0.1");
+	int32 Port = 2121;
+	// 서버가 내보내는 로컬 디렉토리
+	FString RootDirectory;
+	// 읽기 캐시 메모리 상한
+	int64 CacheBytes = 512LL * 1024 * 1024;
+	// 넘으면 새 연결에 421로 답한다. 쉬는 세션은 스레드를 잡지 않으므로 메모리만 든다
+	int32 MaxSessions = 1024;
+	// 명령을 처리하는 작업 스레드 수 - 데이터 전송도 여기서 하므로 동시 전송 수의 상한이다
+	int32 WorkerThreads = 32;
+	// 제어 연결이 이 시간 동안 조용하면 끊는다
+	double IdleTimeoutSeconds = 300.0;
+};
+
+/**
+ * 빌드 에이전트 배포용 최소 FTP 서버
+ *
+ * 쉬는 제어 연결은 반응 스레드 하나가 모두 지켜보고, 명령이 온 세션만 고정 크기 작업 스레드 풀에 넘겨 처리한 뒤 돌려받는다.
+ * 연결 수가 늘어도 스레드 수는 WorkerThreads + 1로 고정된다. 데이터 연결은 수동 모드(PASV/EPSV)만 지원한다.
+ * RETR은 공유 읽기 캐시의 페이지를 그대로 소켓에 보내므로 같은 파일을 받는 세션들이 디스크를 다시 읽지 않는다.
+ * STOR은 임시 파일로 비동기로 받아 그룹 커밋(모아서 sync 후 원자적 이름 바꾸기)이 끝난 뒤에만 226으로 답한다.
+ * 로그인은 GFtpUsers 계정을 쓰고, 각 사용자는 RootDirectory 아래 자기 HomeDirectory에 갇힌다.
+ * 로그인 실패는 계정 잠금 대신 세션 단위로 늦추고 끊으며, 데이터 연결은 제어 연결과 같은 주소에서 온 것만 받는다.
+ */
+class FILEUPLOAD_API FFtpServer
+{
+public:
+	explicit FFtpServer(const FFtpServerConfig& InConfig);
+	~FFtpServer();
+
+	FFtpServer(const FFtpServer&) = delete;
+	FFtpServer& operator=(const FFtpServer&) = delete;
+
+	// 리슨 소켓을 열고 접속 스레드를 시작한다
+	bool Start();
+
+	// 새 연결을 막고 모든 세션이 끝날 때까지 기다린다
+	void Stop();
+
+	bool IsRunning() const { return bRunning; }
+	int32 GetPort() const { return BoundPort; }
+	int32 GetNumSessions() const { return NumSessions.Load(); }
+	const FFtpServerConfig& GetConfig() const { return Config; }
+	FFtpReadCache& GetReadCache() const { return *ReadCache; }
+	FFtpIngestCommitter& GetIngestCommitter() const { return *IngestCommitter; }
+
+	// 세션 스레드가 끝날지 확인할 때 쓴다
+	bool IsStopping() const { return bStopping; }
+
+private:
+	// 새 연결을 받고 쉬는 세션을 훑어 명령이 온 세션을 ReadySessions에 넣는다
+	void AcceptLoop();
+	void WorkerLoop();
+	void DestroySession(FFtpServerSession* Session);
+
+	FFtpServerConfig Config;
+	TUniquePtr<FFtpReadCache> ReadCache;
+	TUniquePtr<FFtpIngestCommitter> IngestCommitter;
+
+	FSocket* ListenSocket = nullptr;
+	int32 BoundPort = 0;
+	TFuture<void> AcceptFuture;
+	TArray<TFuture<void>> WorkerFutures;
+
+	// 반응 스레드 -> 작업 스레드 (소비는 ReadyLock 아래에서)
+	TQueue<FFtpServerSession*, EQueueMode::Spsc> ReadySessions;
+	FCriticalSection ReadyLock;
+	FEvent* ReadyEvent = nullptr;
+	// 작업 스레드 -> 반응 스레드 (명령을 끝내고 다시 쉬는 세션)
+	TQueue<FFtpServerSession*, EQueueMode::Mpsc> ReturnedSessions;
+
+	TAtomic<bool> bRunning;
+	TAtomic<bool> bStopping;
+	TAtomic<int32> NumSessions;
+
+	friend class FFtpServerSession;
+};
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "FtpSyncCommandlet.generated.h"
+
+/**
+ * CI용 헤드리스 동기화 커맨드렛
+ *
+ * UnrealEditor-Cmd <Project> -run=FtpSync -JobSpec=<path.json>
+ *
+ * {
+ *   "User": "test", "Password": "test",
+ *   "Server": { "Address": "192.168.0.35", "Port": 21, "MaxConnections": 8 },
+ *   "Jobs": [
+ *     { "Type": "Push",   "Local": "Content", "Remote": "upload/content", "Verify": true },
+ *     { "Type": "Pull",   "Remote": "upload/content", "Local": "Saved/ftp_download" },
+ *     { "Type": "Mirror", "Local": "Content", "Remote": "upload/content", "Servers": [ ... ] },
+ *     { "Type": "Push",   "Local": "Content", "Remote": "store", "Store": "main-1234" },
+ *     { "Type": "Push",   "Local": "Content/Maps", "Remote": "upload/maps", "Delta": true },
+ *     { "Type": "Push",   "Local": "Content", "Remote": "upload/content", "Priority": [ "/Game/Maps/Arena" ] },
+ *     { "Type": "Push",   "Local": "Content", "Remote": "upload/content", "Discover": true },
+ *     { "Type": "ApplyDeltas", "Local": "/srv/ftp" },
+ *     { "Type": "Cache",  "Put": [ { "Key": "shaders-win64-1234", "File": "Build/Shaders.bin" } ],
+ *       "Get": [ { "Key": "shaders-win64-1233", "File": "Saved/Shaders.bin" } ] },
+ *     { "Type": "Plan",   "Local": "Content", "Remote": "upload/content", "Output": "Saved/plan.json", "MaxBytes": 1073741824 },
+ *     { "Type": "Push",   "Plan": "Saved/plan.json" },
+ *     { "Type": "Serve",  "Local": "/srv/ftp", "BindAddress": "0.0.0.0", "Port": 2121, "CacheMB": 2048, "MaxSessions": 1024, "Seconds": 0 },
+ *     { "Type": "Load",   "Local": "Saved/ftp_load", "Clients": 2000, "Workers": 128, "Seconds": 60, "ThinkMs": 50,
+ *       "Mix": { "Login": 1, "List": 4, "Stor": 2, "Retr": 6, "Size": 6 }, "Baseline": "Build/FtpLoadBaseline.json", "Tolerance": 0.2 }
+ *   ]
+ * }
+ *
+ * 상대 로컬 경로는 프로젝트 디렉토리 기준이다. Mirror에 "Servers"가 있으면 팬아웃 업로드를 사용한다.
+ * "Store"가 있으면 Remote를 콘텐츠 주소 저장소 루트로 보고 그 이름의 스냅샷으로 올리거나(Push) 복원한다(Pull).
+ * "Delta"가 true이면 큰 파일은 블록 델타(.ftpdelta)로 올리고, 서버 호스트에서 ApplyDeltas 잡이 이를 적용한다.
+ * "Verify"가 true이면 업로드 후 서버 해시(HASH/XSHA1/XMD5/XCRC, 없으면 SIZE+MDTM)로 검증하고 불일치는 실패로 센다.
+ * "Plan"은 서버를 MLSD로 나열해 올릴/건너뛸/지울 파일과 예상 시간을 JSON으로 남기기만 한다.
+ *   "MaxBytes"를 넘으면 실패, "MirrorDeletes"가 true이면 서버에만 있는 파일을 Delete로 잡는다.
+ *   Push에 "Plan"을 주면 그 계획의 경로/서버로 계획된 파일만 올린다.
+ * "Serve"는 Local을 루트로 내장 FTP 서버를 띄운다. RETR은 메모리 읽기 캐시("CacheMB")를 거치고,
+ *   STOR은 그룹 커밋으로 디스크에 내린 뒤 응답한다. "Seconds"가 0이면 멈추지 않는다.
+ *   "BindAddress"가 없으면 127.0.0.1에서만 듣고, 다른 주소는 기본 계정(test/admin)이 남아 있으면 시작하지 않는다.
+ *   "WorkerThreads"는 명령과 전송을 처리하는 스레드 수다 (쉬는 연결은 스레드를 쓰지 않는다).
+ * "Cache"는 -FtpDerivedData=<작업 명세.json>으로 연 공유 파생 데이터 저장소에 파일을 키로 넣고(Put) 꺼낸다(Get).
+ *   미스는 실패로 세지 않고 로그만 남긴다. "Seconds"(기본 600)까지 기다린다.
+ * "Discover"가 true이면 Content를 훑지 않고, 마지막 Discover 업로드 뒤 에셋 레지스트리에서 크기/저장 해시가 바뀐 패키지와
+ *   소스 컨트롤에서 열린 파일만 올린다. 처음 실행은 기준만 남긴다.
+ * "Load"는 Local을 루트로 같은 프로세스에 서버를 띄우고(Local이 없으면 "Host"/"Port"의 서버에) Clients개 세션으로
+ *   Mix 비율의 명령을 보내 명령별 p50/p99/p999, 처리량, 오류율, 메모리를 잰다. "Baseline"이 있으면 그 결과와 비교해
+ *   "Tolerance"보다 나빠진 항목마다 실패로 세고, 파일이 없거나 "WriteBaseline"이 true이면 이번 결과를 기준으로 쓴다.
+ * 일반 Push는 에셋 의존성 순서(잎 에셋부터)로 보내며, "Priority" 패키지와 그 의존성을 가장 먼저 보낸다.
+ * Push/Pull의 동시 전송 수는 2에서 시작해 처리량/오류/지연을 보고 스스로 맞추며 "MaxConnections"를 넘지 않는다.
+ * 종료 코드: 0 성공, 1 잡 명세 오류, 2 일부 전송 실패, 3 인증 실패 등으로 잡 중단
+ */
+UCLASS()
+class FILEUPLOAD_API UFtpSyncCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UFtpSyncCommandlet();
+
+	// UCommandlet interface
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,171 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/DateTime.h"
+
+class FJsonValue;
+class FFtpPathTable;
+
+// FTP 사용자 설정 구조체
+struct FFtpUserConfig
+{
+    FString Username;
+    FString Password;
+    FString HomeDirectory;
+    TArray<FString> Permissions;
+
+    FFtpUserConfig()
+    {
+        Username = TEXT("");
+        Password = TEXT("");
+        HomeDirectory = TEXT("/");
+        Permissions = { TEXT("Read") };
+    }
+};
+
+// 보안 설정 구조체
+struct FFtpSecurityConfig
+{
+    int32 MaxLoginAttempts = 5;
+    int32 LockoutDuration = 300; // 5분
+    bool EnableLogging = true;
+
+    // 명시적 FTPS (AUTH TLS + PROT P)
+    bool bUseFtps = false;
+    bool bVerifyPeer = true;
+    FString CaCertPath;
+
+    // Linux에서 OpenSSL 3의 커널 TLS 오프로드 사용 (curl 하위 프로세스에 적용)
+    bool bEnableKernelTls = false;
+
+    FFtpSecurityConfig()
+    {
+        MaxLoginAttempts = 5;
+        LockoutDuration = 300;
+        EnableLogging = true;
+    }
+};
+
+// FTP 서버 프로필 - 여러 미러로 동시에 올릴 때 대상 하나
+struct FFtpServerProfile
+{
+    FString Name;
+    FString Address;
+    int32 Port = 21;
+    FString Username;
+    FString Password;
+    bool bUseFtps = false;
+};
+
+// 업로드 요청 한 건
+struct FFtpUploadRequest
+{
+    FString LocalPath;
+    FString RemotePath;
+};
+
+// 폴더 단위 동기화 결과
+struct FFtpSyncStats
+{
+    int32 SuccessCount = 0;
+    int32 FailCount = 0;
+    // 올라갔지만 받는 쪽 처리(델타 적용)가 끝나야 완료되는 파일
+    int32 PendingCount = 0;
+    bool bAborted = false;
+
+    FFtpSyncStats() = default;
+
+    FFtpSyncStats(int32 InSuccessCount, int32 InFailCount)
+        : SuccessCount(InSuccessCount)
+        , FailCount(InFailCount)
+    {
+    }
+
+    // 인증 실패 등으로 시작하지 못한 경우
+    static FFtpSyncStats Aborted()
+    {
+        FFtpSyncStats Stats;
+        Stats.bAborted = true;
+        return Stats;
+    }
+};
+
+// 전송 한 건(또는 일괄 전송 한 번)의 측정값 - 동시 전송 수 조절에 쓴다
+struct FFtpTransferSample
+{
+    int64 Bytes = 0;
+    double Seconds = 0.0;
+    // 명령 왕복 지연 (업로드: 전송 시작 전까지, 다운로드: 첫 바이트까지). 모르면 0
+    double LatencySeconds = 0.0;
+    int32 Files = 1;
+    int32 FailedFiles = 0;
+    // 서버가 연결 수 제한(421)이나 연결 거부로 응답
+    bool bServerBusy = false;
+};
+
+// 전역 변수들 (FtpSystem.cpp)
+extern TArray<FFtpUserConfig> GFtpUsers;
+extern FFtpSecurityConfig GFtpSecurityConfig;
+extern FString GServerAddress;
+extern int32 GServerPort;
+// 서버가 허용하는 동시 연결 수 - 동시 전송 수 조절의 상한
+extern int32 GServerMaxConnections;
+
+// curl 세션 묶음 - 이 범위가 열려 있는 동안 BuildCurlSessionArgs가 만든 자격 증명 파일을 재사용하고,
+// 마지막 범위가 닫히면 모두 지운다. BuildCurlSessionArgs부터 curl이 끝날 때까지 범위를 열어 둔다
+struct FFtpCurlSessionScope
+{
+    FFtpCurlSessionScope();
+    ~FFtpCurlSessionScope();
+
+    FFtpCurlSessionScope(const FFtpCurlSessionScope&) = delete;
+    FFtpCurlSessionScope& operator=(const FFtpCurlSessionScope&) = delete;
+};
+
+// FTP 시스템 초기화 (지연, 중복 호출 안전)
+void EnsureFtpSystemInitialized();
+
+// 로그 출력
+void LogFtpMessage(const FString& Message, bool bIsError = false);
+
+// 사용자 인증/권한
+bool AuthenticateUser(const FString& Username, const FString& Password);
+// 잠금 기록 없이 비밀번호만 확인 (네트워크 상대가 실제 계정을 잠그지 못하게 내장 서버가 쓴다)
+bool CheckUserPassword(const FString& Username, const FString& Password);
+bool HasBuiltInCredentials(const FFtpUserConfig& User);
+FFtpUserConfig* GetUser(const FString& Username);
+bool HasPermission(const FString& Username, const FString& Permission);
+void RecordLoginAttempt(const FString& Username, bool bSuccess, const FString& IpAddress);
+bool IsUserLocked(const FString& Username);
+
+// CURL 기반 전송
+FString GetCurlExecutable();
+// curl을 띄울 실행 파일과 인자 - 커널 TLS가 켜져 있으면 OPENSSL_CONF를 curl 환경에만 넣는 래퍼를 거친다
+void GetCurlLaunchCommand(const FString& Params, FString& OutExecutable, FString& OutParams);
+FString BuildCurlSessionArgs(const FString& Username, const FString& Password, bool bUseFtps);
+FString EscapeCurlConfigValue(const FString& Value);
+FString GetCurlPrivateDir();
+bool ExecuteCurlCommand(const FString& Command, FString& Output, FString& Error);
+FString CreateFtpUrl(const FString& Username, const FString& RemotePath);
+FString CreateFtpUrl(const FFtpServerProfile& Profile, const FString& RemotePath);
+bool UploadFile(const FString& Username, const FString& LocalPath, const FString& RemotePath);
+bool UploadFilesBatch(const FString& Username, const TArray<FFtpUploadRequest>& Requests, TArray<bool>& OutSuccess, FFtpTransferSample* OutSample = nullptr);
+bool DownloadFile(const FString& Username, const FString& RemotePath, const FString& LocalPath, int64 ExpectedSize = -1, FFtpTransferSample* OutSample = nullptr);
+bool GetFileList(const FString& Username, const FString& RemotePath, TArray<FString>& FileList);
+bool TestConnection(const FString& Username);
+
+// 서버 프로필
+void ParseFtpServerProfiles(const TArray<TSharedPtr<FJsonValue>>& Servers, TArray<FFtpServerProfile>& OutProfiles);
+bool LoadFtpServerProfiles(const FString& FilePath, TArray<FFtpServerProfile>& OutProfiles);
+FString GetDefaultServerProfilesPath();
+FFtpServerProfile MakeDefaultServerProfile(const FString& Username);
+
+// 폴더 단위 동기화
+FFtpSyncStats UploadSpecificFolder(const FString& LocalFolder, const FString& RemoteBaseDir, const FString& Server, const FString& User, const FString& Pass);
+FFtpSyncStats UploadFolderStructure(const FString& LocalFolder, const FString& RemoteBaseDir, const FString& Server, const FString& User, const FString& Pass);
+FFtpSyncStats UploadFromFtpServer(const FString& RemotePath, const FString& LocalPath, const FString& Server, const FString& User, const FString& Pass);
+// PriorityPackages(예: 지금 올리는 레벨)와 그 의존성을 먼저 보내고, 나머지도 에셋 의존성 순서로 보낸다
+FFtpSyncStats UploadToFtpServer(const FString& LocalPath, const FString& RemotePath, const FString& Server, const FString& User, const FString& Pass, const TArray<FName>& PriorityPackages = TArray<FName>());
+
+// 이미 훑은 경로 표로 업로드 (FileIndices가 없으면 전부, 인증은 호출자가 이미 했다고 본다)
+FFtpSyncStats UploadPathTable(const FFtpPathTable& Files, const TArray<int32>* FileIndices, const FString& RemotePath, const FString& Server, const FString& User);
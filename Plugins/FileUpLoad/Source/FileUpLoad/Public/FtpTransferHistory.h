@@ -0,0 +1,55 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/DateTime.h"
+
+// 전송 방향
+enum class EFtpTransferDirection : uint8
+{
+	Upload,
+	Download,
+	// 전송 후 무결성 검증 (bSuccess = 서버 값과 일치)
+	Verify
+};
+
+// 전송 한 건의 기록
+struct FFtpTransferRecord
+{
+	FString LocalPath;
+	FString RemotePath;
+	int64 Bytes = 0;
+	double DurationSeconds = 0.0;
+	FDateTime Timestamp;
+	EFtpTransferDirection Direction = EFtpTransferDirection::Upload;
+	bool bSuccess = false;
+};
+
+/**
+ * 업로드/다운로드 결과를 모아두는 전송 이력 저장소
+ * 전송 스레드 어디서든 기록할 수 있고, 리스너는 기록 스레드에서 호출된다.
+ */
+class FILEUPLOAD_API FFtpTransferHistory
+{
+public:
+	DECLARE_MULTICAST_DELEGATE_OneParam(FOnTransferRecorded, const FFtpTransferRecord&);
+
+	static FFtpTransferHistory& Get();
+
+	// 전송 결과 기록 (스레드 안전)
+	void Record(const FFtpTransferRecord& Record);
+
+	// 현재까지의 기록 복사본
+	void GetRecords(TArray<FFtpTransferRecord>& OutRecords) const;
+
+	// 리스너 등록/해제 (스레드 안전)
+	FDelegateHandle AddListener(FOnTransferRecorded::FDelegate&& Delegate);
+	void RemoveListener(FDelegateHandle Handle);
+
+private:
+	// 보관할 최대 기록 수
+	static constexpr int32 MaxRecords = 200000;
+
+	mutable FCriticalSection Lock;
+	TArray<FFtpTransferRecord> Records;
+	FOnTransferRecorded OnTransferRecorded;
+};
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/DateTime.h"
+#include "FtpPathTable.h"
+#include "FtpSystem.h"
+
+// 계획된 동작
+enum class EFtpPlanAction : uint8
+{
+	// 서버에 없음
+	Create,
+	// 크기가 다르거나 로컬이 더 새로움
+	Update,
+	// 같다고 판단
+	Skip,
+	// 서버에만 있음 (미러 삭제가 켜졌을 때만)
+	Delete
+};
+
+// 계획 한 줄 - 경로는 계획의 경로 표 인덱스
+struct FFtpPlanEntry
+{
+	int32 FileIndex = INDEX_NONE;
+	EFtpPlanAction Action = EFtpPlanAction::Skip;
+	int64 LocalSize = -1;
+	int64 RemoteSize = -1;
+	FDateTime RemoteModified;
+};
+
+/**
+ * 드라이런 전송 계획
+ * 로컬 스캔 결과(경로 표)를 그대로 들고 있으므로 실행할 때 다시 훑지 않는다.
+ */
+struct FILEUPLOAD_API FFtpTransferPlan
+{
+	FFtpTransferPlan();
+
+	FString LocalRoot;
+	FString RemoteRoot;
+	FString User;
+	FString Server;
+	FDateTime CreatedAt;
+
+	// MLSD로 서버 상태를 읽었는지 - false면 모든 파일이 Create로 잡힌다
+	bool bRemoteListed = false;
+	bool bMirrorDeletes = false;
+
+	FFtpPathTable Files;
+	TArray<FFtpPlanEntry> Entries;
+
+	int32 NumCreate = 0;
+	int32 NumUpdate = 0;
+	int32 NumSkip = 0;
+	int32 NumDelete = 0;
+	int64 BytesToTransfer = 0;
+
+	// 전송 이력으로 추정한 비용
+	double ThroughputBytesPerSecond = 0.0;
+	double PerFileOverheadSeconds = 0.0;
+	int32 EstimatedConcurrency = 1;
+	double EstimatedSeconds = 0.0;
+
+	int32 GetNumTransfers() const { return NumCreate + NumUpdate; }
+};
+
+namespace FtpPlanner
+{
+	// 서버 시각과 로컬 시각의 허용 오차 - 이보다 로컬이 새로워야 Update
+	constexpr double ClockSkewSeconds = 120.0;
+
+	// 이력이 없을 때 쓰는 보수적인 기본값
+	constexpr double DefaultThroughputBytesPerSecond = 10.0 * 1024 * 1024;
+	constexpr double DefaultPerFileOverheadSeconds = 0.05;
+
+	// 한 번의 curl 호출로 나열하는 최대 디렉토리 수
+	constexpr int32 MaxDirectoriesPerListing = 64;
+
+	// 원격 디렉토리 하나의 파일 크기 (MLSD, 하위 디렉토리는 내려가지 않는다). MLSD를 모르는 서버면 false
+	bool ListRemoteFileSizes(const FString& User, const FString& RemoteDirectory, TMap<FString, int64>& OutSizes);
+
+	// 로컬을 훑고 서버를 MLSD로 나열해 비교한다
+	bool BuildPlan(const FString& LocalPath, const FString& RemotePath, const FString& Server, const FString& User, const FString& Pass, bool bMirrorDeletes, FFtpTransferPlan& OutPlan);
+
+	// 전송 이력으로 처리량/파일당 비용을 다시 추정한다
+	void EstimateCost(FFtpTransferPlan& Plan);
+
+	// 계획 실행 - Create/Update만 올리고, 미러 삭제가 켜져 있으면 Delete도 수행
+	FFtpSyncStats ExecutePlan(const FFtpTransferPlan& Plan, const FString& Pass);
+
+	// CI용 JSON (경로는 루트 기준 상대 경로)
+	FString SerializePlan(const FFtpTransferPlan& Plan);
+	bool ParsePlan(const FString& JsonText, FFtpTransferPlan& OutPlan);
+	bool SavePlan(const FFtpTransferPlan& Plan, const FString& FilePath);
+	bool LoadPlan(const FString& FilePath, FFtpTransferPlan& OutPlan);
+
+	// 한 줄 요약 ("12 create, 3 update, ... 1.2 GB, ETA 4m 10s")
+	FString DescribePlan(const FFtpTransferPlan& Plan);
+
+	const TCHAR* LexToString(EFtpPlanAction Action);
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FFtpPathTable;
+
+/**
+ * 에셋 의존성 순서로 업로드 순서 정하기
+ *
+ * 에셋 레지스트리의 하드 패키지 의존성을 따라 잎(의존성이 없는) 패키지부터 보낸다.
+ * 우선 패키지(지금 올리는 레벨 등)와 그 의존성이 먼저, 다음 나머지 맵, 다음 나머지 패키지, 마지막에 에셋이 아닌 파일이다.
+ * 한 패키지의 .uexp/.ubulk 등은 .uasset/.umap보다 먼저 보내서 헤더만 있고 내용이 없는 상태가 생기지 않게 한다.
+ * 그래서 동기화가 중간에 멈춰도 서버에 도착한 레벨은 의존성이 모두 있는 상태다.
+ */
+namespace FtpUploadOrder
+{
+	// FileIndices(없으면 전부)를 보낼 순서로 정렬해 OutOrder에 담는다
+	// 에셋 레지스트리가 없으면(로드 전 등) 원래 순서를 그대로 쓴다. 스레드 안전
+	void OrderByDependencies(const FFtpPathTable& Files, const TArray<int32>* FileIndices, const TArray<FName>& PriorityPackages, TArray<int32>& OutOrder);
+
+	// 에디터에서 지금 열려 있는 레벨 패키지 (게임 스레드 전용, 없으면 NAME_None)
+	FName GetEditorLevelPackage();
+}
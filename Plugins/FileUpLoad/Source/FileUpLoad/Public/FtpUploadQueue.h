@@ -0,0 +1,52 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "FtpSystem.h"
+
+class FRunnableThread;
+class FEvent;
+
+/**
+ * 변경된 파일만 받아 순서대로 업로드하는 작업 큐
+ * 같은 로컬 경로가 대기 중이면 하나로 합쳐지고, 전송은 전용 스레드에서 수행된다.
+ * MaxBatchFiles가 1보다 크면 밀려 있는 요청을 그만큼씩 묶어 curl 한 번으로 보낸다.
+ */
+class FILEUPLOAD_API FFtpUploadQueue : public FRunnable
+{
+public:
+	explicit FFtpUploadQueue(const FString& InUsername, int32 InMaxBatchFiles = 1);
+	virtual ~FFtpUploadQueue();
+
+	// 업로드 요청 추가 (스레드 안전)
+	void Enqueue(const FString& LocalPath, const FString& RemotePath);
+
+	int32 GetNumPending() const;
+
+	// 대기 중이거나 전송 중인 요청이 모두 끝날 때까지 기다린다. 시간 안에 끝나면 true
+	bool WaitUntilIdle(double TimeoutSeconds) const;
+
+	int32 GetNumUploaded() const { return NumUploaded.Load(); }
+	int32 GetNumFailed() const { return NumFailed.Load(); }
+
+	// FRunnable interface
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+private:
+	FString Username;
+	int32 MaxBatchFiles;
+
+	mutable FCriticalSection Lock;
+	TArray<FFtpUploadRequest> Pending;
+	TSet<FString> PendingPaths;
+
+	FEvent* WorkEvent;
+	FRunnableThread* Thread;
+	TAtomic<bool> bStopping;
+
+	// 꺼내서 전송 중인 요청 수 (Pending에는 없음)
+	TAtomic<int32> NumInFlight;
+	TAtomic<int32> NumUploaded;
+	TAtomic<int32> NumFailed;
+};
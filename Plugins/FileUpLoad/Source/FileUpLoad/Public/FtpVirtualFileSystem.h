@@ -0,0 +1,95 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/DateTime.h"
+
+struct FFtpUserConfig;
+
+// 세션 권한 (FFtpUserConfig::Permissions 문자열을 로그인 때 한 번만 해석한다)
+enum class EFtpVfsPermission : uint8
+{
+	None = 0,
+	Read = 1 << 0,
+	Write = 1 << 1,
+	Delete = 1 << 2,
+	Admin = 1 << 3
+};
+ENUM_CLASS_FLAGS(EFtpVfsPermission);
+
+// 해석된 경로 하나
+struct FFtpVfsEntry
+{
+	// 홈 기준 논리 경로 ("/a/b.uasset")
+	FString LogicalPath;
+	// 실제 로컬 경로
+	FString LocalPath;
+	bool bExists = false;
+	bool bIsDirectory = false;
+	int64 Size = -1;
+	FDateTime Modified;
+	// 마지막으로 stat한 시각 (FPlatformTime::Seconds)
+	double StatTime = 0.0;
+	// 심볼릭 링크를 푼 실제 경로가 홈 안인지 확인했는지
+	bool bInsideHomeChecked = false;
+};
+
+/**
+ * 사용자별 chroot 가상 파일 시스템 - 서버 세션마다 하나
+ *
+ * 사용자의 HomeDirectory("/test")를 서버 루트 아래 실제 디렉토리로 잡고 그 밖으로는 나갈 수 없다.
+ * ".."는 홈 루트에서 멈추고, 역슬래시/NUL/드라이브 문자가 든 경로는 거부하며,
+ * Linux/Mac에서는 심볼릭 링크를 따라 홈 밖을 가리키는 경로도 거부한다.
+ * 같은 인수의 정규화 결과와 stat 결과를 세션 안에서 캐시하므로 반복되는 CWD/LIST/STOR/RETR가 문자열 처리와 stat을 다시 하지 않는다.
+ */
+class FILEUPLOAD_API FFtpVirtualFileSystem
+{
+public:
+	// 캐시 크기 상한 - 넘으면 비우고 다시 채운다
+	static constexpr int32 MaxCachedPaths = 4096;
+
+	// stat 결과를 믿는 시간 - 다른 세션이 바꾼 파일도 이 시간 안에 보인다
+	static constexpr double StatTtlSeconds = 2.0;
+
+	FFtpVirtualFileSystem(const FString& InServerRoot, const FFtpUserConfig& User);
+
+	// 홈 디렉토리가 없으면 만든다
+	bool EnsureHomeDirectory();
+
+	const FString& GetHomeDirectory() const { return HomeDirectory; }
+	const FString& GetWorkingDirectory() const { return WorkingDirectory; }
+
+	bool HasPermission(EFtpVfsPermission Permission) const { return EnumHasAllFlags(Permissions, Permission); }
+
+	// 인수를 현재 디렉토리 기준으로 해석한다. 홈 밖이거나 잘못된 경로면 nullptr
+	// 반환값은 다음 Resolve/Invalidate 호출 전까지만 유효하다
+	const FFtpVfsEntry* Resolve(const FString& Argument);
+
+	// 디렉토리가 있으면 현재 디렉토리를 바꾼다
+	bool ChangeDirectory(const FString& Argument);
+
+	// 디렉토리 나열 결과로 자식 항목들의 stat 캐시를 채운다 (LIST 뒤 RETR/SIZE가 stat하지 않게)
+	void CacheChild(const FString& DirectoryLogicalPath, const FString& Name, bool bIsDirectory, int64 Size, const FDateTime& Modified);
+
+	// 이 세션이 바꾼 경로 (STOR/DELE/RNTO 등)
+	void Invalidate(const FString& LogicalPath);
+	void InvalidateAll();
+
+	// Base에서 Argument를 따라간 논리 경로. 허용하지 않는 문자가 있으면 false
+	static bool NormalizeLogicalPath(const FString& Base, const FString& Argument, FString& OutLogicalPath);
+
+private:
+	FFtpVfsEntry* FindOrAddEntry(const FString& LogicalPath);
+	void Stat(FFtpVfsEntry& Entry) const;
+	bool IsInsideHome(const FString& LocalPath, bool bExists) const;
+
+	FString HomeDirectory;
+	// 심볼릭 링크를 푼 홈 경로 (비교용, 끝에 '/')
+	FString HomeRealPath;
+	FString WorkingDirectory;
+	EFtpVfsPermission Permissions = EFtpVfsPermission::None;
+
+	// 현재 디렉토리에서의 인수 -> 논리 경로 (CWD가 바뀌면 비운다)
+	TMap<FString, FString> ArgumentCache;
+	// 논리 경로 -> 해석/stat 결과
+	TMap<FString, FFtpVfsEntry> EntryCache;
+};
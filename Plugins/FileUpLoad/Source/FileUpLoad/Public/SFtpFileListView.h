@@ -0,0 +1,40 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/Views/SListView.h"
+#include "FtpFileListModel.h"
+
+/**
+ * FFtpFileListModel을 보여주는 가상화 목록 위젯
+ * 보이는 행만 생성하며, 모델이 바뀌면 RequestListRefresh만 호출한다.
+ */
+class FILEUPLOAD_API SFtpFileListView : public SCompoundWidget
+{
+public:
+	SLATE_BEGIN_ARGS(SFtpFileListView)
+		: _PathColumnLabel(NSLOCTEXT("FFileUpLoadModule", "FtpListPathColumn", "Path"))
+		{}
+		SLATE_ARGUMENT(TSharedPtr<FFtpFileListModel>, Model)
+		SLATE_ARGUMENT(FText, PathColumnLabel)
+	SLATE_END_ARGS()
+
+	virtual ~SFtpFileListView();
+
+	void Construct(const FArguments& InArgs);
+
+	// SWidget interface
+	virtual void Tick(const FGeometry& AllottedGeometry, const double InCurrentTime, const float InDeltaTime) override;
+
+private:
+	TSharedRef<ITableRow> OnGenerateRow(FFtpListItemPtr Item, const TSharedRef<STableViewBase>& OwnerTable);
+	void OnFilterTextChanged(const FText& InFilterText);
+	void OnSortModeChanged(EColumnSortPriority::Type SortPriority, const FName& ColumnId, EColumnSortMode::Type InSortMode);
+	EColumnSortMode::Type GetColumnSortMode(FName ColumnId) const;
+	FText GetCountText() const;
+	void HandleViewChanged();
+
+	TSharedPtr<FFtpFileListModel> Model;
+	TSharedPtr<SListView<FFtpListItemPtr>> ListView;
+	FDelegateHandle ViewChangedHandle;
+};